@@ -612,7 +612,9 @@ std::string wallet_status_banner(const alpha::NodeStatusReport& node) {
   text += "Bind: " + node.p2p.bind_host + ":" + std::to_string(node.p2p.bind_port) + "\n";
   text += "Proxy Port: " + std::to_string(node.p2p.proxy_port) + "\n";
   text += "Peers: " + std::to_string(node.p2p.peer_count) + "\n";
-  text += "Outbound queue: " + std::to_string(node.p2p.outbound_queue) + "\n";
+  text += "Outbound queue: " + std::to_string(node.p2p.outbound_queue) + "/" +
+          std::to_string(node.p2p.outbound_capacity) + " (rejected " +
+          std::to_string(node.p2p.outbound_rejected) + ")\n";
   text += "Seen events: " + std::to_string(node.p2p.seen_event_count) + "\n";
   text += "Sync ticks: " + std::to_string(node.p2p.sync_tick_count) + "\n\n";
 
@@ -692,7 +692,9 @@ void refresh_node_status_view(AppState* state) {
   text += "Bind: " + node.p2p.bind_host + ":" + std::to_string(node.p2p.bind_port) + "\r\n";
   text += "Proxy Port: " + std::to_string(node.p2p.proxy_port) + "\r\n";
   text += "Peers: " + std::to_string(node.p2p.peer_count) + "\r\n";
-  text += "Outbound queue: " + std::to_string(node.p2p.outbound_queue) + "\r\n";
+  text += "Outbound queue: " + std::to_string(node.p2p.outbound_queue) + "/" +
+          std::to_string(node.p2p.outbound_capacity) + " (rejected " +
+          std::to_string(node.p2p.outbound_rejected) + ")\r\n";
   text += "Seen events: " + std::to_string(node.p2p.seen_event_count) + "\r\n";
   text += "Sync ticks: " + std::to_string(node.p2p.sync_tick_count) + "\r\n\r\n";
 
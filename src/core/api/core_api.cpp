@@ -1,5 +1,7 @@
 #include "core/api/core_api.hpp"
 
+#include <utility>
+
 namespace alpha {
 
 Result CoreApi::init(const InitConfig& config) {
@@ -121,6 +123,23 @@ Result CoreApi::unlock_wallet(std::string_view passphrase) {
   return service_.unlock_wallet(passphrase);
 }
 
+void CoreApi::prepare_unlock_async(std::string passphrase, std::function<void(Result)> on_ready) {
+  service_.prepare_unlock_async(std::move(passphrase), std::move(on_ready));
+}
+
+void CoreApi::prepare_backup_async(std::string backup_path, std::string password,
+                                   std::function<void(Result)> on_ready) {
+  service_.prepare_backup_async(std::move(backup_path), std::move(password), std::move(on_ready));
+}
+
+void CoreApi::begin_wallet_task(std::string_view operation) {
+  service_.begin_wallet_task(operation);
+}
+
+void CoreApi::finish_wallet_task(const Result& result) {
+  service_.finish_wallet_task(result);
+}
+
 Result CoreApi::recover_wallet(std::string_view backup_path, std::string_view backup_password,
                                std::string_view new_local_passphrase) {
   return service_.recover_wallet(backup_path, backup_password, new_local_passphrase);
@@ -151,6 +170,38 @@ std::vector<EventEnvelope> CoreApi::sync_tick() {
   return service_.sync_tick();
 }
 
+Result CoreApi::check_blocks() {
+  return service_.check_blocks();
+}
+
+Result CoreApi::claim_block_rewards() {
+  return service_.claim_block_rewards();
+}
+
+std::vector<EventEnvelope> CoreApi::network_tick() {
+  return service_.network_tick();
+}
+
+Result CoreApi::save_peers() {
+  return service_.save_peers();
+}
+
+void CoreApi::set_change_listener(std::function<void(const StoreChange&)> listener) {
+  service_.set_change_listener(std::move(listener));
+}
+
+Result CoreApi::write_snapshot() {
+  return service_.write_snapshot();
+}
+
+Result CoreApi::ingest_remote_event(const EventEnvelope& event) {
+  return service_.ingest_remote_event(event);
+}
+
+std::vector<Result> CoreApi::ingest_remote_events(const std::vector<EventEnvelope>& events) {
+  return service_.ingest_remote_events(events);
+}
+
 ProfileSummary CoreApi::profile() const {
   return service_.profile();
 }
@@ -163,6 +214,14 @@ NodeStatusReport CoreApi::node_status() const {
   return service_.node_status();
 }
 
+std::uint64_t CoreApi::state_generation() const {
+  return service_.state_generation();
+}
+
+std::uint64_t CoreApi::status_generation() const {
+  return service_.status_generation();
+}
+
 std::int64_t CoreApi::local_reward_balance() const {
   return service_.local_reward_balance();
 }
@@ -183,6 +242,14 @@ MiningTemplate CoreApi::mining_template() const {
   return service_.mining_template();
 }
 
+std::vector<MiningJob> CoreApi::mining_jobs() const {
+  return service_.mining_jobs();
+}
+
+Result CoreApi::submit_mining_solution(std::uint64_t block_index, std::string_view nonce) {
+  return service_.submit_mining_solution(block_index, nonce);
+}
+
 std::string CoreApi::hashspec_console() const {
   return service_.hashspec_console();
 }
@@ -1,5 +1,6 @@
 #pragma once
 
+#include <functional>
 #include <optional>
 #include <string_view>
 #include <vector>
@@ -46,6 +47,10 @@ public:
   Result import_key_backup(std::string_view backup_path, std::string_view password);
   Result lock_wallet();
   Result unlock_wallet(std::string_view passphrase);
+  void prepare_unlock_async(std::string passphrase, std::function<void(Result)> on_ready);
+  void prepare_backup_async(std::string backup_path, std::string password, std::function<void(Result)> on_ready);
+  void begin_wallet_task(std::string_view operation);
+  void finish_wallet_task(const Result& result);
   Result recover_wallet(std::string_view backup_path, std::string_view backup_password,
                         std::string_view new_local_passphrase);
   Result prepare_genesis_reset();
@@ -57,15 +62,28 @@ public:
 
   std::vector<RecipeSummary> search(const SearchQuery& query);
   std::vector<EventEnvelope> sync_tick();
+  Result check_blocks();
+  Result claim_block_rewards();
+  std::vector<EventEnvelope> network_tick();
+  Result save_peers();
+  Result write_snapshot();
+  void set_change_listener(std::function<void(const StoreChange&)> listener);
+  Result ingest_remote_event(const EventEnvelope& event);
+  std::vector<Result> ingest_remote_events(const std::vector<EventEnvelope>& events);
 
   ProfileSummary profile() const;
   AnonymityStatus anonymity_status() const;
   NodeStatusReport node_status() const;
+  // See AlphaService::state_generation; safe to read without serializing.
+  std::uint64_t state_generation() const;
+  std::uint64_t status_generation() const;
   std::int64_t local_reward_balance() const;
   std::vector<RewardBalanceSummary> reward_balances() const;
   std::vector<RewardTransactionSummary> reward_transactions() const;
   ReceiveAddressInfo receive_info() const;
   MiningTemplate mining_template() const;
+  std::vector<MiningJob> mining_jobs() const;
+  Result submit_mining_solution(std::uint64_t block_index, std::string_view nonce);
   std::string hashspec_console() const;
   std::string soup_address() const;
   std::string public_key() const;
@@ -2,10 +2,12 @@
 
 #include <algorithm>
 #include <array>
+#include <charconv>
 #include <cstdint>
 #include <filesystem>
 #include <fstream>
 #include <random>
+#include <span>
 #include <sstream>
 #include <unordered_map>
 #include <vector>
@@ -77,6 +79,66 @@ std::string xor_stream(std::string_view input, std::string_view key) {
   return out;
 }
 
+#ifdef GOT_SOUP_HAVE_SODIUM
+void append_hex(std::string& out, const unsigned char* bytes, std::size_t size) {
+  static constexpr char kHex[] = "0123456789abcdef";
+  for (std::size_t i = 0; i < size; ++i) {
+    out.push_back(kHex[(bytes[i] >> 4U) & 0x0FU]);
+    out.push_back(kHex[bytes[i] & 0x0FU]);
+  }
+}
+#endif
+
+// Incremental form of CryptoEngine::hash_bytes so multi-part inputs
+// ("payload::public_key") are hashed without building the concatenation.
+class DigestWriter {
+public:
+  explicit DigestWriter(bool production) : production_(production) {
+#ifdef GOT_SOUP_HAVE_SODIUM
+    if (production_) {
+      crypto_generichash_init(&state_, nullptr, 0, crypto_generichash_BYTES);
+    }
+#endif
+  }
+
+  void update(std::string_view part) {
+#ifdef GOT_SOUP_HAVE_SODIUM
+    if (production_) {
+      crypto_generichash_update(&state_, reinterpret_cast<const unsigned char*>(part.data()),
+                                static_cast<unsigned long long>(part.size()));
+      return;
+    }
+#endif
+    for (unsigned char c : part) {
+      fnv_ ^= static_cast<std::uint64_t>(c);
+      fnv_ *= 1099511628211ULL;
+    }
+  }
+
+  // Appends the lowercase hex digest; the compatibility digest is unpadded.
+  void finish_hex(std::string& out) {
+#ifdef GOT_SOUP_HAVE_SODIUM
+    if (production_) {
+      std::array<unsigned char, crypto_generichash_BYTES> digest{};
+      crypto_generichash_final(&state_, digest.data(), digest.size());
+      append_hex(out, digest.data(), digest.size());
+      return;
+    }
+#endif
+    std::array<char, 16> text{};
+    const auto [end, ec] = std::to_chars(text.data(), text.data() + text.size(), fnv_, 16);
+    (void)ec;
+    out.append(text.data(), end);
+  }
+
+private:
+  bool production_ = false;
+  std::uint64_t fnv_ = 1469598103934665603ULL;
+#ifdef GOT_SOUP_HAVE_SODIUM
+  crypto_generichash_state state_{};
+#endif
+};
+
 std::string random_bytes_raw(std::size_t bytes) {
   std::random_device rd;
   std::mt19937_64 gen(rd());
@@ -161,6 +223,21 @@ std::string serialize_identity(const IdentityKeyPair& key_pair) {
 
 #ifdef GOT_SOUP_HAVE_SODIUM
 
+bool decode_hex_into(std::string_view hex, std::span<unsigned char> out) {
+  if (hex.size() != out.size() * 2U) {
+    return false;
+  }
+  for (std::size_t i = 0; i < out.size(); ++i) {
+    const int hi = from_hex_digit(hex[i * 2U]);
+    const int lo = from_hex_digit(hex[(i * 2U) + 1U]);
+    if (hi < 0 || lo < 0) {
+      return false;
+    }
+    out[i] = static_cast<unsigned char>((hi << 4U) | lo);
+  }
+  return true;
+}
+
 std::array<unsigned char, crypto_pwhash_SALTBYTES> salt_from_string(std::string_view salt_input) {
   std::array<unsigned char, crypto_pwhash_SALTBYTES> salt{};
   crypto_generichash(salt.data(), salt.size(),
@@ -178,16 +255,67 @@ bool derive_argon2id_key(std::string_view passphrase,
                        crypto_pwhash_ALG_ARGON2ID13) == 0;
 }
 
+// Argon2id through the session cache; the vault salt is random per persist, so
+// entries are keyed by the raw salt bytes.
+bool derive_argon2id_key_cached(KdfSessionCache& cache, std::string_view passphrase,
+                                const std::array<unsigned char, crypto_pwhash_SALTBYTES>& salt,
+                                std::array<unsigned char, crypto_secretbox_KEYBYTES>& out_key) {
+  const std::string key_hex = cache.get_or_derive(
+      "argon2id-vault", passphrase,
+      std::string_view{reinterpret_cast<const char*>(salt.data()), salt.size()}, [&] {
+        std::array<unsigned char, crypto_secretbox_KEYBYTES> key{};
+        if (!derive_argon2id_key(passphrase, salt, key)) {
+          return std::string{};
+        }
+        std::string hex = to_hex(std::string_view{reinterpret_cast<const char*>(key.data()), key.size()});
+        sodium_memzero(key.data(), key.size());
+        return hex;
+      });
+  return decode_hex_into(key_hex, out_key);
+}
+
 #endif
 
+// CryptoEngine::derive_vault_key() with the hash mode passed in, so it can
+// run from a snapshot.
+std::string derive_vault_key_with(KdfSessionCache& cache, bool production, std::string_view passphrase,
+                                  std::string_view salt) {
+  const auto derive = [&] {
+#ifdef GOT_SOUP_HAVE_SODIUM
+    if (production) {
+      const auto salt_arr = salt_from_string(salt);
+      std::array<unsigned char, crypto_secretbox_KEYBYTES> key{};
+      if (derive_argon2id_key(passphrase, salt_arr, key)) {
+        std::string hex = to_hex(std::string_view{reinterpret_cast<const char*>(key.data()), key.size()});
+        sodium_memzero(key.data(), key.size());
+        return hex;
+      }
+    }
+#endif
+    // Compatibility derivation fallback.
+    std::string hex;
+    DigestWriter writer(production);
+    writer.update(std::string{passphrase} + "::" + std::string{salt} + "::argon2id-placeholder");
+    writer.finish_hex(hex);
+    return hex;
+  };
+  return cache.get_or_derive(production ? "vault-key:production" : "vault-key:compatibility", passphrase, salt,
+                             derive);
+}
+
 }  // namespace
 
+CryptoEngine::~CryptoEngine() {
+  wipe_signing_key();
+}
+
 Result CryptoEngine::initialize(std::string_view app_data_dir, std::string_view passphrase,
                                 bool production_swap_requested) {
   app_data_dir_ = std::string{app_data_dir};
   production_swap_requested_ = production_swap_requested;
   production_mode_active_ = false;
   ready_ = false;
+  wipe_signing_key();
 
   if (passphrase.empty()) {
     return Result::failure("Passphrase is required to unlock the local identity vault.");
@@ -223,6 +351,7 @@ Result CryptoEngine::initialize(std::string_view app_data_dir, std::string_view
   }
 
   ready_ = true;
+  load_signing_key();
   last_unlocked_unix_ = util::unix_timestamp_now();
   if (production_mode_active_) {
     return Result::success("Identity vault created (production swap active).", "production");
@@ -259,7 +388,7 @@ Result CryptoEngine::unlock_from_vault(std::string_view passphrase) {
     std::copy(salt_bytes.begin(), salt_bytes.end(), salt.begin());
 
     std::array<unsigned char, crypto_secretbox_KEYBYTES> key{};
-    if (!derive_argon2id_key(passphrase, salt, key)) {
+    if (!derive_argon2id_key_cached(kdf_cache_, passphrase, salt, key)) {
       return Result::failure("Failed to derive production vault key (Argon2id).");
     }
 
@@ -279,6 +408,7 @@ Result CryptoEngine::unlock_from_vault(std::string_view passphrase) {
 
     production_mode_active_ = true;
     ready_ = true;
+    load_signing_key();
     last_unlocked_unix_ = util::unix_timestamp_now();
     return Result::success("Identity vault unlocked (production swap active).", "production");
   }
@@ -308,6 +438,7 @@ Result CryptoEngine::unlock_from_vault(std::string_view passphrase) {
 #endif
 
   ready_ = true;
+  load_signing_key();
   last_unlocked_unix_ = util::unix_timestamp_now();
   if (production_swap_requested_) {
     return Result::success("Identity vault unlocked in compatibility mode; production swap pending.",
@@ -337,7 +468,7 @@ Result CryptoEngine::persist_identity_vault(std::string_view passphrase) {
     randombytes_buf(salt.data(), salt.size());
 
     std::array<unsigned char, crypto_secretbox_KEYBYTES> key{};
-    if (!derive_argon2id_key(passphrase, salt, key)) {
+    if (!derive_argon2id_key_cached(kdf_cache_, passphrase, salt, key)) {
       return Result::failure("Failed to derive production vault key (Argon2id).");
     }
 
@@ -388,7 +519,7 @@ Result CryptoEngine::generate_identity(bool prefer_production_keys) {
                                                    public_key.size()});
     identity_.private_key = to_hex(std::string_view{reinterpret_cast<const char*>(private_key.data()),
                                                     private_key.size()});
-    identity_.cid.value = "cid-" + hash_bytes(identity_.public_key).substr(0, 20);
+    identity_.cid.value = cid_for_public_key(identity_.public_key);
     return Result::success("Generated production identity.");
   }
 #endif
@@ -396,7 +527,7 @@ Result CryptoEngine::generate_identity(bool prefer_production_keys) {
   production_mode_active_ = false;
   identity_.private_key = random_hex(32);
   identity_.public_key = hash_bytes(identity_.private_key + ":public");
-  identity_.cid.value = "cid-" + hash_bytes(identity_.public_key).substr(0, 20);
+  identity_.cid.value = cid_for_public_key(identity_.public_key);
   return Result::success("Generated compatibility identity.");
 }
 
@@ -446,16 +577,18 @@ Result CryptoEngine::verify_identity_backup(std::string_view backup_path, std::s
   if (backup_path.empty()) {
     return Result::failure("Key backup verification failed: backup path is required.");
   }
+  return verify_identity_backup(snapshot_backup(backup_path), password);
+}
+
+Result CryptoEngine::verify_identity_backup(const KdfSnapshot& backup, std::string_view password) const {
   if (password.empty()) {
     return Result::failure("Key backup verification failed: backup password is required.");
   }
-
-  const std::string file_text = read_file(std::filesystem::path{std::string{backup_path}});
-  if (file_text.empty()) {
+  if (backup.file_text.empty()) {
     return Result::failure("Key backup verification failed: backup file could not be read.");
   }
 
-  const auto values = parse_key_values(file_text);
+  const auto values = parse_key_values(backup.file_text);
   if (!values.contains("format") || values.at("format") != kBackupFormat) {
     return Result::failure("Key backup verification failed: unsupported backup format.");
   }
@@ -463,7 +596,7 @@ Result CryptoEngine::verify_identity_backup(std::string_view backup_path, std::s
     return Result::failure("Key backup verification failed: missing salt/cipher fields.");
   }
 
-  const std::string key = derive_vault_key(password, "backup:" + values.at("salt"));
+  const std::string key = derive_vault_key_with(kdf_cache_, backup.production, password, "backup:" + values.at("salt"));
   const std::string cipher = from_hex(values.at("cipher"));
   if (cipher.empty()) {
     return Result::failure("Key backup verification failed: cipher payload is invalid.");
@@ -537,16 +670,19 @@ Result CryptoEngine::import_identity_backup(std::string_view backup_path, std::s
   }
 
   ready_ = true;
+  load_signing_key();
   last_unlocked_unix_ = util::unix_timestamp_now();
   return Result::success("Key import completed.", identity_.cid.value);
 }
 
 Result CryptoEngine::lock_identity() {
+  kdf_cache_.wipe();
   if (!ready_) {
     return Result::success("Wallet already locked.");
   }
 
   ready_ = false;
+  wipe_signing_key();
   identity_.private_key.clear();
   last_locked_unix_ = util::unix_timestamp_now();
   return Result::success("Wallet locked.");
@@ -576,6 +712,7 @@ Result CryptoEngine::nuke_identity(std::string_view local_passphrase, bool produ
   }
 
   ready_ = true;
+  load_signing_key();
   last_unlocked_unix_ = util::unix_timestamp_now();
   last_locked_unix_ = 0;
   return Result::success("Identity key nuked and replaced.", identity_.cid.value);
@@ -589,92 +726,228 @@ std::string CryptoEngine::vault_path() const {
 }
 
 std::string CryptoEngine::derive_vault_key(std::string_view passphrase, std::string_view salt) const {
+  return derive_vault_key_with(kdf_cache_, production_hash_active(), passphrase, salt);
+}
+
+CryptoEngine::KdfSnapshot CryptoEngine::snapshot_vault() const {
+  return {
+      .file_text = read_file(std::filesystem::path{app_data_dir_} / std::string{kVaultFileName}),
+      .vault_salt = std::filesystem::path{app_data_dir_}.string(),
+      .production = production_hash_active(),
+  };
+}
+
+CryptoEngine::KdfSnapshot CryptoEngine::snapshot_backup(std::string_view backup_path) const {
+  return {
+      .file_text = backup_path.empty() ? std::string{} : read_file(std::filesystem::path{std::string{backup_path}}),
+      .vault_salt = {},
+      .production = production_hash_active(),
+  };
+}
+
+Result CryptoEngine::prewarm_unlock(std::string_view passphrase) const {
+  return prewarm_unlock(snapshot_vault(), passphrase);
+}
+
+Result CryptoEngine::prewarm_unlock(const KdfSnapshot& vault, std::string_view passphrase) const {
+  if (passphrase.empty()) {
+    return Result::failure("Vault key derivation failed: passphrase is required.");
+  }
+  if (vault.file_text.empty()) {
+    return Result::failure("Vault key derivation failed: identity vault could not be read.");
+  }
+
 #ifdef GOT_SOUP_HAVE_SODIUM
-  if (production_mode_active_ || production_swap_requested_) {
-    const auto salt_arr = salt_from_string(salt);
+  const auto values = parse_key_values(vault.file_text);
+  if (values.contains("format") && values.at("format") == kProdVaultFormat && values.contains("salt")) {
+    const std::string salt_bytes = from_hex(values.at("salt"));
+    if (salt_bytes.size() != crypto_pwhash_SALTBYTES) {
+      return Result::failure("Vault key derivation failed: production vault salt is invalid.");
+    }
+    std::array<unsigned char, crypto_pwhash_SALTBYTES> salt{};
+    std::copy(salt_bytes.begin(), salt_bytes.end(), salt.begin());
     std::array<unsigned char, crypto_secretbox_KEYBYTES> key{};
-    if (derive_argon2id_key(passphrase, salt_arr, key)) {
-      return to_hex(std::string_view{reinterpret_cast<const char*>(key.data()), key.size()});
+    const bool derived = derive_argon2id_key_cached(kdf_cache_, passphrase, salt, key);
+    sodium_memzero(key.data(), key.size());
+    if (!derived) {
+      return Result::failure("Failed to derive production vault key (Argon2id).");
     }
+    return Result::success("Vault key derived.", "production");
   }
 #endif
 
-  // Compatibility derivation fallback.
-  return hash_bytes(std::string{passphrase} + "::" + std::string{salt} + "::argon2id-placeholder");
+  (void)derive_vault_key_with(kdf_cache_, vault.production, passphrase, vault.vault_salt);
+  return Result::success("Vault key derived.", "compatibility");
 }
 
-std::string CryptoEngine::hash_bytes(std::string_view payload) const {
+void CryptoEngine::configure_kdf_cache(KdfCacheConfig config) {
+  kdf_cache_.configure(config);
+}
+
+void CryptoEngine::wipe_kdf_cache() {
+  kdf_cache_.wipe();
+}
+
+KdfCacheStats CryptoEngine::kdf_cache_stats() const {
+  return kdf_cache_.stats();
+}
+
+bool CryptoEngine::production_hash_active() const {
 #ifdef GOT_SOUP_HAVE_SODIUM
-  if (production_mode_active_ || production_swap_requested_) {
-    std::array<unsigned char, crypto_generichash_BYTES> digest{};
-    crypto_generichash(digest.data(), digest.size(), reinterpret_cast<const unsigned char*>(payload.data()),
-                       static_cast<unsigned long long>(payload.size()), nullptr, 0);
-    return to_hex(std::string_view{reinterpret_cast<const char*>(digest.data()), digest.size()});
-  }
+  return production_mode_active_ || production_swap_requested_;
+#else
+  return false;
 #endif
+}
 
-  std::uint64_t hash = 1469598103934665603ULL;
-  for (unsigned char c : payload) {
-    hash ^= static_cast<std::uint64_t>(c);
-    hash *= 1099511628211ULL;
-  }
+std::string CryptoEngine::hash_bytes(std::string_view payload) const {
+  std::string out;
+  hash_bytes_into(payload, out);
+  return out;
+}
 
-  std::ostringstream out;
-  out << std::hex << hash;
-  return out.str();
+void CryptoEngine::hash_bytes_into(std::string_view payload, std::string& out) const {
+  out.clear();
+  DigestWriter writer(production_hash_active());
+  writer.update(payload);
+  writer.finish_hex(out);
 }
 
 std::string CryptoEngine::content_id(std::string_view payload) const {
-  return "evt-" + hash_bytes(payload);
+  std::string out;
+  content_id_into(payload, out);
+  return out;
+}
+
+void CryptoEngine::content_id_into(std::string_view payload, std::string& out) const {
+  out.assign("evt-");
+  DigestWriter writer(production_hash_active());
+  writer.update(payload);
+  writer.finish_hex(out);
 }
 
 std::string CryptoEngine::sign(std::string_view payload) const {
+  std::string out;
+  sign_into(payload, out);
+  return out;
+}
+
+bool CryptoEngine::sign_into(std::string_view payload, std::string& out) const {
+  out.clear();
   if (!ready_) {
-    return {};
+    return false;
   }
 
 #ifdef GOT_SOUP_HAVE_SODIUM
   if (production_mode_active_) {
-    const std::string private_key = from_hex(identity_.private_key);
-    if (private_key.size() != crypto_sign_SECRETKEYBYTES) {
-      return {};
+    if (!signing_key_loaded_) {
+      return false;
     }
 
     std::array<unsigned char, crypto_sign_BYTES> signature{};
     crypto_sign_detached(signature.data(), nullptr,
                          reinterpret_cast<const unsigned char*>(payload.data()),
-                         static_cast<unsigned long long>(payload.size()),
-                         reinterpret_cast<const unsigned char*>(private_key.data()));
-    return to_hex(std::string_view{reinterpret_cast<const char*>(signature.data()), signature.size()});
+                         static_cast<unsigned long long>(payload.size()), signing_key_.data());
+    append_hex(out, signature.data(), signature.size());
+    return true;
   }
 #endif
 
-  return hash_bytes(std::string{payload} + "::" + identity_.public_key);
+  DigestWriter writer(production_hash_active());
+  writer.update(payload);
+  writer.update("::");
+  writer.update(identity_.public_key);
+  writer.finish_hex(out);
+  return true;
+}
+
+bool CryptoEngine::sign_many(std::span<const std::string> payloads,
+                             std::vector<std::string>& signatures) const {
+  signatures.resize(payloads.size());
+  bool all_signed = true;
+  for (std::size_t i = 0; i < payloads.size(); ++i) {
+    all_signed = sign_into(payloads[i], signatures[i]) && all_signed;
+  }
+  return all_signed;
+}
+
+void CryptoEngine::load_signing_key() {
+  wipe_signing_key();
+#ifdef GOT_SOUP_HAVE_SODIUM
+  static_assert(kSigningKeyBytes == crypto_sign_SECRETKEYBYTES);
+  if (!production_mode_active_ || !decode_hex_into(identity_.private_key, signing_key_)) {
+    sodium_memzero(signing_key_.data(), signing_key_.size());
+    return;
+  }
+  // Best effort: RLIMIT_MEMLOCK may refuse, the key is still wiped on lock.
+  (void)sodium_mlock(signing_key_.data(), signing_key_.size());
+  signing_key_loaded_ = true;
+#endif
+}
+
+void CryptoEngine::wipe_signing_key() {
+#ifdef GOT_SOUP_HAVE_SODIUM
+  if (signing_key_loaded_) {
+    // sodium_munlock zeroes the region before unlocking it.
+    (void)sodium_munlock(signing_key_.data(), signing_key_.size());
+  } else {
+    sodium_memzero(signing_key_.data(), signing_key_.size());
+  }
+#else
+  std::ranges::fill(signing_key_, static_cast<unsigned char>(0));
+#endif
+  signing_key_loaded_ = false;
 }
 
 bool CryptoEngine::verify(std::string_view payload, std::string_view signature,
                           std::string_view public_key) const {
+  return verify_decoded(payload, signature, decode_public_key(public_key));
+}
+
+CryptoEngine::PublicKeyMaterial CryptoEngine::decode_public_key(std::string_view public_key) const {
+  PublicKeyMaterial key;
+  key.hex = std::string{public_key};
 #ifdef GOT_SOUP_HAVE_SODIUM
   if (production_mode_active_) {
-    const std::string sig_bytes = from_hex(signature);
-    const std::string public_key_bytes = from_hex(public_key);
+    key.raw = from_hex(public_key);
+  }
+#endif
+  return key;
+}
 
-    if (sig_bytes.size() != crypto_sign_BYTES || public_key_bytes.size() != crypto_sign_PUBLICKEYBYTES) {
+bool CryptoEngine::verify_decoded(std::string_view payload, std::string_view signature,
+                                  const PublicKeyMaterial& key) const {
+#ifdef GOT_SOUP_HAVE_SODIUM
+  if (production_mode_active_) {
+    if (signature.size() != crypto_sign_BYTES * 2U || key.raw.size() != crypto_sign_PUBLICKEYBYTES) {
+      return false;
+    }
+
+    std::array<unsigned char, crypto_sign_BYTES> sig_bytes{};
+    if (!decode_hex_into(signature, sig_bytes)) {
       return false;
     }
 
     return crypto_sign_verify_detached(
-               reinterpret_cast<const unsigned char*>(sig_bytes.data()),
-               reinterpret_cast<const unsigned char*>(payload.data()),
+               sig_bytes.data(), reinterpret_cast<const unsigned char*>(payload.data()),
                static_cast<unsigned long long>(payload.size()),
-               reinterpret_cast<const unsigned char*>(public_key_bytes.data())) == 0;
+               reinterpret_cast<const unsigned char*>(key.raw.data())) == 0;
   }
 #endif
 
-  const std::string expected = hash_bytes(std::string{payload} + "::" + std::string{public_key});
+  DigestWriter writer(production_hash_active());
+  writer.update(payload);
+  writer.update("::");
+  writer.update(key.hex);
+  std::string expected;
+  writer.finish_hex(expected);
   return expected == signature;
 }
 
+std::string CryptoEngine::cid_for_public_key(std::string_view public_key) const {
+  return "cid-" + hash_bytes(public_key).substr(0, 20);
+}
+
 std::string CryptoEngine::core_phase_status() const {
   if (!ready_) {
     return "Core Phase 1 pending: wallet is locked or crypto engine not initialized.";
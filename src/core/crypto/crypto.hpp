@@ -1,8 +1,13 @@
 #pragma once
 
+#include <array>
+#include <cstddef>
+#include <span>
 #include <string>
 #include <string_view>
+#include <vector>
 
+#include "core/crypto/kdf_cache.hpp"
 #include "core/model/types.hpp"
 
 namespace alpha {
@@ -15,6 +20,17 @@ struct IdentityKeyPair {
 
 class CryptoEngine {
 public:
+  // Public key decoded once so bulk verification does not re-parse hex per event.
+  struct PublicKeyMaterial {
+    std::string hex;
+    std::string raw;
+  };
+
+  CryptoEngine() = default;
+  CryptoEngine(const CryptoEngine&) = delete;
+  CryptoEngine& operator=(const CryptoEngine&) = delete;
+  ~CryptoEngine();
+
   Result initialize(std::string_view app_data_dir, std::string_view passphrase,
                     bool production_swap_requested);
 
@@ -24,12 +40,45 @@ public:
 
   [[nodiscard]] std::string derive_vault_key(std::string_view passphrase,
                                              std::string_view salt) const;
+  // Inputs of an off-thread KDF, copied while the caller holds the engine:
+  // the vault or backup file bytes and the hash mode at that moment.
+  struct KdfSnapshot {
+    std::string file_text;
+    std::string vault_salt;  // compatibility vault salt
+    bool production = false;
+  };
+  [[nodiscard]] KdfSnapshot snapshot_vault() const;
+  [[nodiscard]] KdfSnapshot snapshot_backup(std::string_view backup_path) const;
+
+  // Runs the identity-vault KDF for `passphrase` and leaves the key in the
+  // session cache so a following unlock_identity() is cheap.
+  Result prewarm_unlock(std::string_view passphrase) const;
+  // Forms of prewarm_unlock() and verify_identity_backup() that read only
+  // the snapshot and the internally locked KDF cache, so a worker thread can
+  // run them while other calls rewrite the vault.
+  Result prewarm_unlock(const KdfSnapshot& vault, std::string_view passphrase) const;
+  Result verify_identity_backup(const KdfSnapshot& backup, std::string_view password) const;
+  void configure_kdf_cache(KdfCacheConfig config);
+  void wipe_kdf_cache();
+  [[nodiscard]] KdfCacheStats kdf_cache_stats() const;
   [[nodiscard]] std::string hash_bytes(std::string_view payload) const;
   [[nodiscard]] std::string content_id(std::string_view payload) const;
 
   [[nodiscard]] std::string sign(std::string_view payload) const;
+
+  // Buffer-reusing forms of hash_bytes/content_id/sign for hot paths. `out` is
+  // overwritten; its capacity is kept so repeated calls do not allocate.
+  void hash_bytes_into(std::string_view payload, std::string& out) const;
+  void content_id_into(std::string_view payload, std::string& out) const;
+  bool sign_into(std::string_view payload, std::string& out) const;
+  bool sign_many(std::span<const std::string> payloads, std::vector<std::string>& signatures) const;
+
   [[nodiscard]] bool verify(std::string_view payload, std::string_view signature,
                             std::string_view public_key) const;
+  [[nodiscard]] PublicKeyMaterial decode_public_key(std::string_view public_key) const;
+  [[nodiscard]] bool verify_decoded(std::string_view payload, std::string_view signature,
+                                    const PublicKeyMaterial& key) const;
+  [[nodiscard]] std::string cid_for_public_key(std::string_view public_key) const;
 
   Result export_identity_backup(std::string_view backup_path, std::string_view password,
                                 std::string_view salt) const;
@@ -49,6 +98,11 @@ private:
   Result persist_identity_vault(std::string_view passphrase);
   Result unlock_from_vault(std::string_view passphrase);
   Result generate_identity(bool prefer_production_keys);
+  [[nodiscard]] bool production_hash_active() const;
+  void load_signing_key();
+  void wipe_signing_key();
+
+  static constexpr std::size_t kSigningKeyBytes = 64;
 
   std::string app_data_dir_;
   IdentityKeyPair identity_;
@@ -57,6 +111,10 @@ private:
   bool production_mode_active_ = false;
   std::int64_t last_unlocked_unix_ = 0;
   std::int64_t last_locked_unix_ = 0;
+  // Ed25519 secret key decoded once on unlock and mlock'ed until lock.
+  std::array<unsigned char, kSigningKeyBytes> signing_key_{};
+  bool signing_key_loaded_ = false;
+  mutable KdfSessionCache kdf_cache_;
 };
 
 }  // namespace alpha
@@ -0,0 +1,233 @@
+#include "core/crypto/kdf_cache.hpp"
+
+#include <algorithm>
+#include <cstring>
+#include <new>
+#include <random>
+
+#include "core/util/canonical.hpp"
+#include "core/util/hash.hpp"
+
+#ifdef GOT_SOUP_HAVE_SODIUM
+#include <sodium.h>
+#elif !defined(_WIN32)
+#include <sys/mman.h>
+#endif
+
+namespace alpha {
+namespace {
+
+void secure_zero(void* data, std::size_t size) {
+#ifdef GOT_SOUP_HAVE_SODIUM
+  sodium_memzero(data, size);
+#else
+  volatile unsigned char* bytes = static_cast<volatile unsigned char*>(data);
+  for (std::size_t i = 0; i < size; ++i) {
+    bytes[i] = 0;
+  }
+#endif
+}
+
+}  // namespace
+
+struct KdfSessionCache::SlotTable {
+  Slot* slots = nullptr;
+  std::size_t count = 0;
+  bool locked = false;
+};
+
+void KdfSessionCache::SlotTableDeleter::operator()(SlotTable* table) const {
+  if (table == nullptr) {
+    return;
+  }
+  const std::size_t bytes = table->count * sizeof(Slot);
+  secure_zero(table->slots, bytes);
+#ifdef GOT_SOUP_HAVE_SODIUM
+  sodium_free(table->slots);
+#else
+#ifndef _WIN32
+  if (table->locked) {
+    (void)::munlock(table->slots, bytes);
+  }
+#endif
+  ::operator delete(table->slots);
+#endif
+  delete table;
+}
+
+KdfSessionCache::KdfSessionCache(KdfCacheConfig config) : config_(config) {
+#ifdef GOT_SOUP_HAVE_SODIUM
+  randombytes_buf(pepper_.data(), pepper_.size());
+#else
+  std::random_device rd;
+  for (auto& byte : pepper_) {
+    byte = static_cast<unsigned char>(rd() & 0xFFU);
+  }
+#endif
+  std::lock_guard lock(mutex_);
+  allocate_slots_locked();
+}
+
+KdfSessionCache::~KdfSessionCache() {
+  secure_zero(pepper_.data(), pepper_.size());
+}
+
+void KdfSessionCache::configure(KdfCacheConfig config) {
+  std::lock_guard lock(mutex_);
+  config_ = config;
+  allocate_slots_locked();
+}
+
+void KdfSessionCache::allocate_slots_locked() {
+  slots_.reset();
+  if (config_.capacity == 0) {
+    return;
+  }
+
+  auto table = std::unique_ptr<SlotTable, SlotTableDeleter>(new SlotTable{});
+#ifdef GOT_SOUP_HAVE_SODIUM
+  // sodium_allocarray returns guarded, mlock'ed pages.
+  void* raw = sodium_allocarray(config_.capacity, sizeof(Slot));
+  if (raw == nullptr) {
+    return;
+  }
+  table->locked = true;
+#else
+  const std::size_t bytes = config_.capacity * sizeof(Slot);
+  void* raw = ::operator new(bytes);
+#ifndef _WIN32
+  table->locked = ::mlock(raw, bytes) == 0;
+#endif
+#endif
+  table->slots = static_cast<Slot*>(raw);
+  table->count = config_.capacity;
+  for (std::size_t i = 0; i < table->count; ++i) {
+    new (&table->slots[i]) Slot{};
+  }
+  slots_ = std::move(table);
+}
+
+std::array<char, KdfSessionCache::kTagChars> KdfSessionCache::tag_for(std::string_view domain,
+                                                                      std::string_view passphrase,
+                                                                      std::string_view salt) const {
+  std::array<char, kTagChars> tag{};
+#ifdef GOT_SOUP_HAVE_SODIUM
+  std::array<unsigned char, 32> digest{};
+  crypto_generichash_state state;
+  crypto_generichash_init(&state, pepper_.data(), pepper_.size(), digest.size());
+  const auto absorb = [&state](std::string_view part) {
+    const std::uint64_t size = part.size();
+    crypto_generichash_update(&state, reinterpret_cast<const unsigned char*>(&size), sizeof(size));
+    crypto_generichash_update(&state, reinterpret_cast<const unsigned char*>(part.data()), part.size());
+  };
+  absorb(domain);
+  absorb(passphrase);
+  absorb(salt);
+  crypto_generichash_final(&state, digest.data(), digest.size());
+  static constexpr char kHex[] = "0123456789abcdef";
+  for (std::size_t i = 0; i < digest.size(); ++i) {
+    tag[i * 2U] = kHex[(digest[i] >> 4U) & 0x0FU];
+    tag[(i * 2U) + 1U] = kHex[digest[i] & 0x0FU];
+  }
+#else
+  std::string material;
+  material.reserve(pepper_.size() + domain.size() + passphrase.size() + salt.size() + 64U);
+  material.append(reinterpret_cast<const char*>(pepper_.data()), pepper_.size());
+  for (const std::string_view part : {domain, passphrase, salt}) {
+    material.append(std::to_string(part.size()));
+    material.push_back(':');
+    material.append(part);
+  }
+  const std::string digest = util::sha256_like_hex(material);
+  secure_zero(material.data(), material.size());
+  std::copy_n(digest.begin(), std::min(digest.size(), tag.size()), tag.begin());
+#endif
+  return tag;
+}
+
+std::string KdfSessionCache::get_or_derive(std::string_view domain, std::string_view passphrase,
+                                           std::string_view salt, const std::function<std::string()>& derive) {
+  const auto tag = tag_for(domain, passphrase, salt);
+  const std::int64_t now = util::unix_timestamp_now();
+  {
+    std::lock_guard lock(mutex_);
+    if (slots_) {
+      for (std::size_t i = 0; i < slots_->count; ++i) {
+        Slot& slot = slots_->slots[i];
+        if (!slot.used || slot.tag != tag) {
+          continue;
+        }
+        if (slot.expires_unix > now) {
+          ++hits_;
+          return std::string{slot.key.data(), slot.key_size};
+        }
+        secure_zero(&slot, sizeof(Slot));
+      }
+    }
+    ++misses_;
+  }
+
+  std::string key = derive();
+  if (key.empty() || key.size() > kMaxKeyChars) {
+    return key;
+  }
+
+  std::lock_guard lock(mutex_);
+  if (!slots_ || config_.ttl_seconds <= 0) {
+    return key;
+  }
+  // Reuse a free or expired slot, otherwise evict the one closest to expiry.
+  Slot* target = &slots_->slots[0];
+  for (std::size_t i = 0; i < slots_->count; ++i) {
+    Slot& slot = slots_->slots[i];
+    if (!slot.used || slot.expires_unix <= now || slot.tag == tag) {
+      target = &slot;
+      break;
+    }
+    if (slot.expires_unix < target->expires_unix) {
+      target = &slot;
+    }
+  }
+  secure_zero(target, sizeof(Slot));
+  target->tag = tag;
+  std::memcpy(target->key.data(), key.data(), key.size());
+  target->key_size = key.size();
+  target->expires_unix = now + config_.ttl_seconds;
+  target->used = true;
+  return key;
+}
+
+void KdfSessionCache::wipe() {
+  std::lock_guard lock(mutex_);
+  wipe_locked();
+}
+
+void KdfSessionCache::wipe_locked() {
+  if (!slots_) {
+    return;
+  }
+  secure_zero(slots_->slots, slots_->count * sizeof(Slot));
+  for (std::size_t i = 0; i < slots_->count; ++i) {
+    new (&slots_->slots[i]) Slot{};
+  }
+}
+
+KdfCacheStats KdfSessionCache::stats() const {
+  std::lock_guard lock(mutex_);
+  KdfCacheStats out;
+  out.hits = hits_;
+  out.misses = misses_;
+  if (slots_) {
+    out.capacity = slots_->count;
+    out.memory_locked = slots_->locked;
+    const std::int64_t now = util::unix_timestamp_now();
+    for (std::size_t i = 0; i < slots_->count; ++i) {
+      if (slots_->slots[i].used && slots_->slots[i].expires_unix > now) {
+        ++out.entries;
+      }
+    }
+  }
+  return out;
+}
+
+}  // namespace alpha
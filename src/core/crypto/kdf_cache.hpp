@@ -0,0 +1,80 @@
+#pragma once
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <string_view>
+
+namespace alpha {
+
+struct KdfCacheConfig {
+  std::size_t capacity = 8;  // 0 disables caching
+  std::int64_t ttl_seconds = 300;
+};
+
+struct KdfCacheStats {
+  std::size_t entries = 0;
+  std::size_t capacity = 0;
+  std::uint64_t hits = 0;
+  std::uint64_t misses = 0;
+  bool memory_locked = false;
+};
+
+// Session cache for passphrase-derived keys so repeated unlock/backup checks do
+// not re-run Argon2id. Entries are looked up by a peppered digest of
+// (domain, passphrase, salt) -- the passphrase itself is never stored -- and
+// live in a fixed slot table that is mlock'ed and zeroed on wipe/expiry.
+// Thread-safe; the derivation callback runs outside the lock.
+class KdfSessionCache {
+public:
+  explicit KdfSessionCache(KdfCacheConfig config = {});
+  KdfSessionCache(const KdfSessionCache&) = delete;
+  KdfSessionCache& operator=(const KdfSessionCache&) = delete;
+  ~KdfSessionCache();
+
+  // Drops every entry and resizes the slot table.
+  void configure(KdfCacheConfig config);
+
+  // Returns the cached key for (domain, passphrase, salt) or runs `derive` and
+  // remembers a non-empty result.
+  std::string get_or_derive(std::string_view domain, std::string_view passphrase, std::string_view salt,
+                            const std::function<std::string()>& derive);
+  void wipe();
+
+  [[nodiscard]] KdfCacheStats stats() const;
+
+private:
+  static constexpr std::size_t kTagChars = 64;
+  static constexpr std::size_t kMaxKeyChars = 128;
+
+  struct Slot {
+    std::array<char, kTagChars> tag{};
+    std::array<char, kMaxKeyChars> key{};
+    std::size_t key_size = 0;
+    std::int64_t expires_unix = 0;
+    bool used = false;
+  };
+
+  struct SlotTable;
+  struct SlotTableDeleter {
+    void operator()(SlotTable* table) const;
+  };
+
+  [[nodiscard]] std::array<char, kTagChars> tag_for(std::string_view domain, std::string_view passphrase,
+                                                    std::string_view salt) const;
+  void allocate_slots_locked();
+  void wipe_locked();
+
+  mutable std::mutex mutex_;
+  KdfCacheConfig config_;
+  std::unique_ptr<SlotTable, SlotTableDeleter> slots_;
+  std::array<unsigned char, 32> pepper_{};
+  std::uint64_t hits_ = 0;
+  std::uint64_t misses_ = 0;
+};
+
+}  // namespace alpha
@@ -0,0 +1,146 @@
+#include "core/crypto/signature_verifier.hpp"
+
+#include <optional>
+#include <string>
+
+#include "core/util/canonical.hpp"
+
+namespace alpha {
+
+SignatureVerifier::SignatureVerifier(const CryptoEngine& crypto, SignatureVerifierConfig config)
+    : crypto_(crypto), config_(config) {}
+
+SignatureCheck SignatureVerifier::verify(const EventEnvelope& event) {
+  return verify_batch(std::span<const EventEnvelope>{&event, 1}).front();
+}
+
+std::vector<SignatureCheck> SignatureVerifier::verify_batch(std::span<const EventEnvelope> events) {
+  std::vector<SignatureCheck> results(events.size());
+  if (events.empty()) {
+    return results;
+  }
+  ++stats_.batches;
+  if (keys_.size() > config_.key_cache_capacity) {
+    keys_.clear();
+  }
+
+  // Serial pass: cheap structural checks and one hex decode per distinct key.
+  std::vector<const KeyEntry*> entries(events.size(), nullptr);
+  std::vector<std::string> pair_keys(events.size());
+  for (std::size_t i = 0; i < events.size(); ++i) {
+    const EventEnvelope& event = events[i];
+    if (event.signature.empty()) {
+      results[i].reason = "Remote event signature is missing.";
+      continue;
+    }
+    const std::optional<std::string> public_key = util::canonical_field(event.payload, "author_pubkey");
+    if (!public_key.has_value() || public_key->empty()) {
+      results[i].reason = "Remote event is missing its author_pubkey binding.";
+      continue;
+    }
+    const KeyEntry& entry = key_entry(*public_key);
+    if (entry.cid != event.author_cid) {
+      results[i].reason = "Remote event author_pubkey does not match author_cid.";
+      continue;
+    }
+    // The envelope's kind and timestamp are not signed themselves; they
+    // must repeat the signed payload's, or a relayer could restamp them.
+    if (util::canonical_field(event.payload, "kind") != std::to_string(static_cast<int>(event.kind))) {
+      results[i].reason = "Remote event kind does not match its signed payload.";
+      continue;
+    }
+    if (util::canonical_field(event.payload, "unix_ts") != std::to_string(event.unix_ts)) {
+      results[i].reason = "Remote event timestamp does not match its signed payload.";
+      continue;
+    }
+    entries[i] = &entry;
+    pair_keys[i] = event.event_id + "|" + *public_key;
+  }
+
+  // Parallel pass: content id binding, cache probe and detached signature check.
+  const auto check_one = [&](std::size_t i) {
+    if (entries[i] == nullptr) {
+      return;
+    }
+    const EventEnvelope& event = events[i];
+    if (crypto_.content_id(event.payload) != event.event_id) {
+      results[i].reason = "Remote event id does not match its payload.";
+      return;
+    }
+    if (verified_pairs_.contains(pair_keys[i])) {
+      results[i].ok = true;
+      results[i].cache_hit = true;
+      return;
+    }
+    if (!crypto_.verify_decoded(event.payload, event.signature, entries[i]->material)) {
+      results[i].reason = "Remote event signature is invalid.";
+      return;
+    }
+    results[i].ok = true;
+  };
+
+  if (events.size() >= config_.min_parallel_batch) {
+    if (!pool_) {
+      pool_ = std::make_unique<util::ThreadPool>(config_.worker_threads);
+    }
+    pool_->parallel_for(events.size(), check_one);
+  } else {
+    for (std::size_t i = 0; i < events.size(); ++i) {
+      check_one(i);
+    }
+  }
+
+  for (std::size_t i = 0; i < events.size(); ++i) {
+    if (!results[i].ok) {
+      ++stats_.rejected;
+      continue;
+    }
+    ++stats_.verified;
+    if (results[i].cache_hit) {
+      ++stats_.cache_hits;
+    } else {
+      remember_verified(std::move(pair_keys[i]));
+    }
+  }
+  return results;
+}
+
+void SignatureVerifier::clear_cache() {
+  keys_.clear();
+  verified_pairs_.clear();
+  verified_order_.clear();
+}
+
+SignatureVerifierStats SignatureVerifier::stats() const {
+  SignatureVerifierStats out = stats_;
+  out.cached_pairs = verified_pairs_.size();
+  out.cached_keys = keys_.size();
+  return out;
+}
+
+const SignatureVerifier::KeyEntry& SignatureVerifier::key_entry(const std::string& public_key_hex) {
+  if (const auto it = keys_.find(public_key_hex); it != keys_.end()) {
+    return it->second;
+  }
+  KeyEntry entry{
+      .material = crypto_.decode_public_key(public_key_hex),
+      .cid = crypto_.cid_for_public_key(public_key_hex),
+  };
+  return keys_.emplace(public_key_hex, std::move(entry)).first->second;
+}
+
+void SignatureVerifier::remember_verified(std::string pair_key) {
+  if (config_.verified_cache_capacity == 0) {
+    return;
+  }
+  if (!verified_pairs_.insert(pair_key).second) {
+    return;
+  }
+  verified_order_.push_back(std::move(pair_key));
+  while (verified_order_.size() > config_.verified_cache_capacity) {
+    verified_pairs_.erase(verified_order_.front());
+    verified_order_.pop_front();
+  }
+}
+
+}  // namespace alpha
@@ -0,0 +1,75 @@
+#pragma once
+
+#include <cstdint>
+#include <deque>
+#include <memory>
+#include <span>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <unordered_set>
+#include <vector>
+
+#include "core/crypto/crypto.hpp"
+#include "core/model/types.hpp"
+#include "core/util/thread_pool.hpp"
+
+namespace alpha {
+
+struct SignatureVerifierConfig {
+  std::size_t worker_threads = 0;  // 0 = one per hardware thread
+  std::size_t verified_cache_capacity = 65536;
+  std::size_t key_cache_capacity = 4096;
+  std::size_t min_parallel_batch = 8;
+};
+
+struct SignatureCheck {
+  bool ok = false;
+  bool cache_hit = false;
+  std::string reason;
+};
+
+struct SignatureVerifierStats {
+  std::uint64_t batches = 0;
+  std::uint64_t verified = 0;
+  std::uint64_t rejected = 0;
+  std::uint64_t cache_hits = 0;
+  std::size_t cached_pairs = 0;
+  std::size_t cached_keys = 0;
+};
+
+// Verifies remote event signatures in batches. Each event must carry an
+// `author_pubkey` payload field whose CID matches `author_cid`, `kind` and
+// `unix_ts` payload fields equal to the envelope's, and a content id that
+// matches `event_id`; the detached signature is then checked on a worker
+// pool. Verified (event_id, pubkey) pairs are remembered so re-gossiped
+// copies skip the signature check.
+class SignatureVerifier {
+public:
+  explicit SignatureVerifier(const CryptoEngine& crypto, SignatureVerifierConfig config = {});
+
+  std::vector<SignatureCheck> verify_batch(std::span<const EventEnvelope> events);
+  SignatureCheck verify(const EventEnvelope& event);
+  void clear_cache();
+
+  [[nodiscard]] SignatureVerifierStats stats() const;
+
+private:
+  struct KeyEntry {
+    CryptoEngine::PublicKeyMaterial material;
+    std::string cid;
+  };
+
+  const KeyEntry& key_entry(const std::string& public_key_hex);
+  void remember_verified(std::string pair_key);
+
+  const CryptoEngine& crypto_;
+  SignatureVerifierConfig config_;
+  std::unique_ptr<util::ThreadPool> pool_;
+  std::unordered_map<std::string, KeyEntry> keys_;
+  std::unordered_set<std::string> verified_pairs_;
+  std::deque<std::string> verified_order_;
+  SignatureVerifierStats stats_;
+};
+
+}  // namespace alpha
@@ -0,0 +1,517 @@
+#include "core/mining/stratum_server.hpp"
+
+#include <algorithm>
+#include <array>
+#include <cctype>
+#include <chrono>
+#include <optional>
+
+#include "core/rpc/json.hpp"
+#include "core/util/hash.hpp"
+#include "core/util/socket.hpp"
+
+#ifndef _WIN32
+#include <cerrno>
+#include <fcntl.h>
+#include <poll.h>
+#include <sys/socket.h>
+#include <unistd.h>
+#endif
+
+namespace alpha {
+namespace {
+
+constexpr std::string_view kSubscriptionId = "got-soup-stratum-1";
+
+bool is_hex(std::string_view text) {
+  return std::ranges::all_of(text, [](char c) { return std::isxdigit(static_cast<unsigned char>(c)) != 0; });
+}
+
+// Stratum ids are echoed back verbatim when they are scalars; the parser has
+// already validated their text.
+std::string request_id(const JsonValue& request) {
+  const std::optional<JsonValue> id = request.find("id");
+  if (!id.has_value() || id->is_array() || id->is_object()) {
+    return "null";
+  }
+  return std::string{id->raw()};
+}
+
+// Flat scalar params array: strings are decoded, numbers and bools kept as
+// their text.
+std::vector<std::string> request_params(const JsonValue& request) {
+  std::vector<std::string> params;
+  const std::optional<JsonValue> list = request.find("params");
+  if (!list.has_value() || !list->is_array()) {
+    return params;
+  }
+  params.reserve(list->size());
+  for (std::size_t i = 0; i < list->size(); ++i) {
+    const JsonValue item = list->at(i);
+    params.push_back(item.is_string() ? item.as_string().value_or("") : std::string{item.raw()});
+  }
+  return params;
+}
+
+template <typename Fn>
+void append_result(std::string& out, std::string_view id, Fn&& write_result) {
+  JsonWriter writer(out);
+  writer.begin_object().key("id").raw(id).key("result");
+  write_result(writer);
+  writer.key("error").null().end_object();
+  out.push_back('\n');
+}
+
+void append_result(std::string& out, std::string_view id, bool result) {
+  append_result(out, id, [result](JsonWriter& writer) { writer.value(result); });
+}
+
+void append_error(std::string& out, std::string_view id, int code, std::string_view message) {
+  JsonWriter writer(out);
+  writer.begin_object().key("id").raw(id).key("result").null().key("error");
+  writer.begin_array().value(code).value(message).null().end_array().end_object();
+  out.push_back('\n');
+}
+
+}  // namespace
+
+StratumServer::~StratumServer() {
+  stop();
+}
+
+#ifndef _WIN32
+
+Result StratumServer::start(const StratumServerConfig& config, JobSource job_source, SolutionSink solution_sink) {
+  if (running_.load()) {
+    return Result::failure("Stratum server already running.");
+  }
+  if (!job_source || !solution_sink) {
+    return Result::failure("Stratum server requires a job source and a solution sink.");
+  }
+
+  config_ = config;
+  config_.share_difficulty_nibbles = std::max(0, config_.share_difficulty_nibbles);
+  config_.job_refresh_ms = std::max<std::uint32_t>(50, config_.job_refresh_ms);
+  job_source_ = std::move(job_source);
+  solution_sink_ = std::move(solution_sink);
+
+  const Result listen = util::listen_tcp(config_.bind_host, config_.port, 32, listen_fd_);
+  if (!listen.ok) {
+    return Result::failure("Stratum server failed: " + listen.message);
+  }
+  util::set_non_blocking(listen_fd_);
+  bound_port_ = util::local_port(listen_fd_);
+
+  std::array<int, 2> pipe_fds{-1, -1};
+  if (::pipe(pipe_fds.data()) != 0) {
+    util::close_socket(listen_fd_);
+    return Result::failure("Stratum server failed: unable to create wake pipe.");
+  }
+  wake_read_fd_ = pipe_fds[0];
+  wake_write_fd_ = pipe_fds[1];
+  util::set_non_blocking(wake_read_fd_);
+  util::set_non_blocking(wake_write_fd_);
+
+  {
+    std::lock_guard lock(stats_mutex_);
+    stats_ = {};
+    stats_.running = true;
+    stats_.bound_port = bound_port_;
+  }
+  running_.store(true);
+  refresh_requested_.store(true);
+  worker_ = std::thread([this] { run(); });
+  return Result::success("Stratum adapter listening on " + config_.bind_host + ":" + std::to_string(bound_port_));
+}
+
+void StratumServer::stop() {
+  if (!running_.exchange(false)) {
+    return;
+  }
+  wake();
+  if (worker_.joinable()) {
+    worker_.join();
+  }
+  for (auto& client : clients_) {
+    util::close_socket(client.fd);
+  }
+  clients_.clear();
+  jobs_.clear();
+  job_order_.clear();
+  seen_shares_.clear();
+  util::close_socket(listen_fd_);
+  util::close_socket(wake_read_fd_);
+  util::close_socket(wake_write_fd_);
+  std::lock_guard lock(stats_mutex_);
+  stats_.running = false;
+  stats_.connected_clients = 0;
+}
+
+void StratumServer::request_job_refresh() {
+  refresh_requested_.store(true);
+  wake();
+}
+
+void StratumServer::wake() {
+  if (wake_write_fd_ >= 0) {
+    const char byte = 1;
+    (void)::write(wake_write_fd_, &byte, 1);
+  }
+}
+
+void StratumServer::run() {
+  using Clock = std::chrono::steady_clock;
+  auto next_refresh = Clock::now();
+
+  while (running_.load()) {
+    const auto now = Clock::now();
+    if (refresh_requested_.exchange(false) || now >= next_refresh) {
+      refresh_jobs(false);
+      next_refresh = now + std::chrono::milliseconds(config_.job_refresh_ms);
+    }
+
+    std::vector<pollfd> fds;
+    fds.reserve(clients_.size() + 2U);
+    fds.push_back({wake_read_fd_, POLLIN, 0});
+    fds.push_back({listen_fd_, POLLIN, 0});
+    for (const auto& client : clients_) {
+      fds.push_back({client.fd, static_cast<short>(POLLIN | (client.outbox.empty() ? 0 : POLLOUT)), 0});
+    }
+
+    const auto wait = std::chrono::duration_cast<std::chrono::milliseconds>(next_refresh - Clock::now()).count();
+    const int rc = ::poll(fds.data(), fds.size(), static_cast<int>(std::clamp<long long>(wait, 0, 1000)));
+    if (rc < 0 && errno != EINTR) {
+      break;
+    }
+    if (rc <= 0) {
+      continue;
+    }
+
+    if ((fds[0].revents & POLLIN) != 0) {
+      std::array<char, 64> drain{};
+      while (::read(wake_read_fd_, drain.data(), drain.size()) > 0) {
+      }
+    }
+    if ((fds[1].revents & POLLIN) != 0) {
+      accept_clients();
+    }
+
+    // Clients accepted above are not in `fds` yet; only walk the polled ones.
+    std::vector<bool> drop(clients_.size(), false);
+    for (std::size_t i = 2; i < fds.size(); ++i) {
+      Client& client = clients_[i - 2U];
+      const short revents = fds[i].revents;
+      if ((revents & (POLLERR | POLLNVAL)) != 0) {
+        drop[i - 2U] = true;
+        continue;
+      }
+      if ((revents & (POLLIN | POLLHUP)) != 0 && !read_client(client)) {
+        drop[i - 2U] = true;
+        continue;
+      }
+      if (!client.outbox.empty() && !flush_client(client)) {
+        drop[i - 2U] = true;
+      }
+    }
+
+    std::size_t write_pos = 0;
+    for (std::size_t i = 0; i < clients_.size(); ++i) {
+      if (i < drop.size() && drop[i]) {
+        util::close_socket(clients_[i].fd);
+        continue;
+      }
+      if (write_pos != i) {
+        clients_[write_pos] = std::move(clients_[i]);
+      }
+      ++write_pos;
+    }
+    clients_.resize(write_pos);
+    std::lock_guard lock(stats_mutex_);
+    stats_.connected_clients = clients_.size();
+  }
+}
+
+void StratumServer::accept_clients() {
+  while (true) {
+    const int fd = ::accept(listen_fd_, nullptr, nullptr);
+    if (fd < 0) {
+      return;
+    }
+    if (clients_.size() >= config_.max_clients) {
+      ::close(fd);
+      continue;
+    }
+    util::set_non_blocking(fd);
+    util::set_no_delay(fd);
+    Client client;
+    client.fd = fd;
+    client.extranonce1 = util::sha256_like_hex(std::to_string(bound_port_) + ":" +
+                                               std::to_string(next_client_serial_++))
+                             .substr(0, 8);
+    clients_.push_back(std::move(client));
+  }
+}
+
+bool StratumServer::read_client(Client& client) {
+  std::array<char, 4096> buffer{};
+  while (true) {
+    const ssize_t n = ::recv(client.fd, buffer.data(), buffer.size(), 0);
+    if (n == 0) {
+      return false;
+    }
+    if (n < 0) {
+      if (errno == EINTR) {
+        continue;
+      }
+      if (errno == EAGAIN || errno == EWOULDBLOCK) {
+        break;
+      }
+      return false;
+    }
+    client.inbox.append(buffer.data(), static_cast<std::size_t>(n));
+  }
+
+  std::size_t line_start = 0;
+  while (true) {
+    const std::size_t newline = client.inbox.find('\n', line_start);
+    if (newline == std::string::npos) {
+      break;
+    }
+    std::string_view line{client.inbox.data() + line_start, newline - line_start};
+    if (!line.empty() && line.back() == '\r') {
+      line.remove_suffix(1);
+    }
+    if (!line.empty()) {
+      handle_line(client, line);
+    }
+    line_start = newline + 1U;
+  }
+  client.inbox.erase(0, line_start);
+  return client.inbox.size() <= config_.max_line_bytes;
+}
+
+bool StratumServer::flush_client(Client& client) {
+  while (!client.outbox.empty()) {
+#ifdef MSG_NOSIGNAL
+    const ssize_t n = ::send(client.fd, client.outbox.data(), client.outbox.size(), MSG_NOSIGNAL);
+#else
+    const ssize_t n = ::send(client.fd, client.outbox.data(), client.outbox.size(), 0);
+#endif
+    if (n < 0) {
+      if (errno == EINTR) {
+        continue;
+      }
+      return errno == EAGAIN || errno == EWOULDBLOCK;
+    }
+    client.outbox.erase(0, static_cast<std::size_t>(n));
+  }
+  return true;
+}
+
+#else
+
+Result StratumServer::start(const StratumServerConfig&, JobSource, SolutionSink) {
+  return Result::failure("Stratum adapter is not available in this build.");
+}
+
+void StratumServer::stop() {
+  running_.store(false);
+}
+
+void StratumServer::request_job_refresh() {}
+
+void StratumServer::wake() {}
+
+void StratumServer::run() {}
+
+void StratumServer::accept_clients() {}
+
+bool StratumServer::read_client(Client&) {
+  return false;
+}
+
+bool StratumServer::flush_client(Client&) {
+  return false;
+}
+
+#endif
+
+void StratumServer::handle_line(Client& client, std::string_view line) {
+  const std::optional<JsonDocument> request = JsonDocument::parse(line);
+  if (!request.has_value() || !request->root().is_object()) {
+    append_error(client.outbox, "null", 20, "Parse error.");
+    return;
+  }
+  const JsonValue root = request->root();
+  const std::string id = request_id(root);
+  const std::optional<JsonValue> method_value = root.find("method");
+  const std::optional<std::string> method =
+      method_value.has_value() ? method_value->as_string() : std::optional<std::string>{};
+  if (!method.has_value()) {
+    append_error(client.outbox, id, 20, "Missing method.");
+    return;
+  }
+  const std::vector<std::string> params = request_params(root);
+
+  if (*method == "mining.subscribe") {
+    client.subscribed = true;
+    append_result(client.outbox, id, [&client](JsonWriter& writer) {
+      writer.begin_array().begin_array();
+      writer.begin_array().value("mining.set_difficulty").value(kSubscriptionId).end_array();
+      writer.begin_array().value("mining.notify").value(kSubscriptionId).end_array();
+      writer.end_array().value(client.extranonce1).value(kExtranonce2Bytes).end_array();
+    });
+    JsonWriter difficulty(client.outbox);
+    difficulty.begin_object().key("id").null().member("method", "mining.set_difficulty").key("params");
+    difficulty.begin_array().value(config_.share_difficulty_nibbles).end_array().end_object();
+    client.outbox.push_back('\n');
+    if (client.authorized) {
+      queue_notify(client, true);
+    }
+    return;
+  }
+  if (*method == "mining.authorize") {
+    client.worker = params.empty() ? std::string{"anonymous"} : params.front();
+    client.authorized = true;
+    append_result(client.outbox, id, true);
+    if (client.subscribed) {
+      queue_notify(client, true);
+    }
+    return;
+  }
+  if (*method == "mining.submit") {
+    handle_submit(client, id, params);
+    return;
+  }
+  if (*method == "mining.extranonce.subscribe") {
+    append_result(client.outbox, id, false);
+    return;
+  }
+  append_error(client.outbox, id, 20, "Unsupported method: " + *method);
+}
+
+void StratumServer::handle_submit(Client& client, std::string_view id, const std::vector<std::string>& params) {
+  const auto reject = [&](int code, std::string_view message) {
+    append_error(client.outbox, id, code, message);
+    std::lock_guard lock(stats_mutex_);
+    ++stats_.rejected_shares;
+  };
+
+  if (!client.subscribed || !client.authorized) {
+    reject(24, "Unauthorized worker.");
+    return;
+  }
+  if (params.size() < 4U || params[3].empty()) {
+    reject(20, "mining.submit expects [worker, job_id, extranonce2, nonce].");
+    return;
+  }
+  const std::string& extranonce2 = params[2];
+  if (extranonce2.size() != 2U * kExtranonce2Bytes || !is_hex(extranonce2)) {
+    reject(20, "extranonce2 must be " + std::to_string(kExtranonce2Bytes) + " hex-encoded bytes.");
+    return;
+  }
+  const auto job_it = jobs_.find(params[1]);
+  if (job_it == jobs_.end()) {
+    reject(21, "Job not found (stale).");
+    return;
+  }
+  const std::string nonce = share_nonce(client.extranonce1, extranonce2, params[3]);
+  if (!seen_shares_.insert(params[1] + "|" + nonce).second) {
+    reject(22, "Duplicate share.");
+    return;
+  }
+
+  const MiningJob& job = job_it->second;
+  const std::string hash = util::sha256_like_hex(job.pow_material + "|" + nonce);
+  const int share_target = std::min(config_.share_difficulty_nibbles, job.difficulty_nibbles);
+  if (!util::has_leading_zero_nibbles(hash, share_target)) {
+    reject(23, "Low difficulty share.");
+    return;
+  }
+
+  {
+    std::lock_guard lock(stats_mutex_);
+    ++stats_.accepted_shares;
+  }
+  if (!util::has_leading_zero_nibbles(hash, job.difficulty_nibbles)) {
+    append_result(client.outbox, id, true);
+    return;
+  }
+
+  const Result claimed = solution_sink_(job, nonce);
+  {
+    std::lock_guard lock(stats_mutex_);
+    if (claimed.ok) {
+      ++stats_.blocks_found;
+    } else {
+      ++stats_.blocks_rejected;
+    }
+  }
+  if (claimed.ok) {
+    append_result(client.outbox, id, true);
+  } else {
+    append_error(client.outbox, id, 21, claimed.message);
+  }
+  // The claimed block leaves the claimable set; push fresh work immediately.
+  refresh_jobs(true);
+}
+
+std::string StratumServer::share_nonce(std::string_view extranonce1, std::string_view extranonce2,
+                                       std::string_view nonce) {
+  std::string out;
+  out.reserve(extranonce1.size() + extranonce2.size() + nonce.size());
+  out.append(extranonce1).append(extranonce2).append(nonce);
+  return out;
+}
+
+void StratumServer::refresh_jobs(bool force_notify) {
+  std::vector<MiningJob> fresh = job_source_();
+  std::vector<std::string> order;
+  order.reserve(fresh.size());
+  for (const auto& job : fresh) {
+    order.push_back(job.job_id);
+  }
+  if (!force_notify && order == job_order_) {
+    return;
+  }
+
+  jobs_.clear();
+  for (auto& job : fresh) {
+    const std::string job_id = job.job_id;
+    jobs_.emplace(job_id, std::move(job));
+  }
+  job_order_ = std::move(order);
+  std::erase_if(seen_shares_, [this](const std::string& share) {
+    return !jobs_.contains(share.substr(0, share.find('|')));
+  });
+
+  for (auto& client : clients_) {
+    if (client.subscribed && client.authorized) {
+      queue_notify(client, true);
+    }
+  }
+  std::lock_guard lock(stats_mutex_);
+  stats_.active_jobs = jobs_.size();
+}
+
+void StratumServer::queue_notify(Client& client, bool clean_jobs) {
+  bool first = true;
+  for (const auto& job_id : job_order_) {
+    const MiningJob& job = jobs_.at(job_id);
+    JsonWriter out(client.outbox);
+    out.begin_object().key("id").null().member("method", "mining.notify").key("params").begin_array();
+    out.value(job.job_id).value(job.pow_material).value(job.block_index).value(job.difficulty_nibbles);
+    out.value(job.reward_units).value(clean_jobs && first).end_array().end_object();
+    client.outbox.push_back('\n');
+    first = false;
+    std::lock_guard lock(stats_mutex_);
+    ++stats_.notifications_sent;
+  }
+}
+
+StratumServerStats StratumServer::stats() const {
+  std::lock_guard lock(stats_mutex_);
+  return stats_;
+}
+
+}  // namespace alpha
@@ -0,0 +1,115 @@
+#pragma once
+
+#include <atomic>
+#include <cstdint>
+#include <functional>
+#include <mutex>
+#include <string>
+#include <string_view>
+#include <thread>
+#include <unordered_map>
+#include <unordered_set>
+#include <vector>
+
+#include "core/model/types.hpp"
+
+namespace alpha {
+
+struct StratumServerConfig {
+  std::string bind_host = "127.0.0.1";
+  std::uint16_t port = 0;  // 0 binds an ephemeral port (tests, local miners)
+  int share_difficulty_nibbles = 2;
+  std::uint32_t job_refresh_ms = 1000;
+  std::size_t max_clients = 64;
+  std::size_t max_line_bytes = 16U << 10U;
+};
+
+struct StratumServerStats {
+  bool running = false;
+  std::uint16_t bound_port = 0;
+  std::size_t connected_clients = 0;
+  std::size_t active_jobs = 0;
+  std::uint64_t notifications_sent = 0;
+  std::uint64_t accepted_shares = 0;
+  std::uint64_t rejected_shares = 0;
+  std::uint64_t blocks_found = 0;
+  std::uint64_t blocks_rejected = 0;
+};
+
+// Line-delimited JSON-RPC (Stratum v1 flavoured) adapter that lets external
+// miner processes work on the node's claimable reward blocks. Jobs are pulled
+// from `JobSource` and winning shares are handed to `SolutionSink`; both run
+// on the server thread, so callers must serialize access to shared state.
+class StratumServer {
+public:
+  using JobSource = std::function<std::vector<MiningJob>()>;
+  using SolutionSink = std::function<Result(const MiningJob& job, std::string_view nonce)>;
+
+  StratumServer() = default;
+  StratumServer(const StratumServer&) = delete;
+  StratumServer& operator=(const StratumServer&) = delete;
+  ~StratumServer();
+
+  Result start(const StratumServerConfig& config, JobSource job_source, SolutionSink solution_sink);
+  void stop();
+  void request_job_refresh();
+
+  // Bytes of extranonce2 a miner chooses per share, sent as hex.
+  static constexpr std::size_t kExtranonce2Bytes = 8;
+
+  // The nonce a share stands for. Each session gets its own extranonce1, so
+  // miners never search the same space. Shares hash
+  // `pow_material + "|" + share_nonce(...)`, and a block-difficulty share
+  // hands this value to the SolutionSink, so the claim is checked exactly as
+  // an in-process one.
+  [[nodiscard]] static std::string share_nonce(std::string_view extranonce1, std::string_view extranonce2,
+                                               std::string_view nonce);
+
+  [[nodiscard]] bool running() const { return running_.load(); }
+  [[nodiscard]] std::uint16_t bound_port() const { return bound_port_; }
+  [[nodiscard]] StratumServerStats stats() const;
+
+private:
+  struct Client {
+    int fd = -1;
+    std::string extranonce1;
+    std::string worker;
+    std::string inbox;
+    std::string outbox;
+    bool subscribed = false;
+    bool authorized = false;
+  };
+
+  void run();
+  void accept_clients();
+  bool read_client(Client& client);
+  bool flush_client(Client& client);
+  void handle_line(Client& client, std::string_view line);
+  void handle_submit(Client& client, std::string_view id, const std::vector<std::string>& params);
+  void refresh_jobs(bool force_notify);
+  void queue_notify(Client& client, bool clean_jobs);
+  void wake();
+
+  StratumServerConfig config_;
+  JobSource job_source_;
+  SolutionSink solution_sink_;
+
+  std::atomic<bool> running_{false};
+  std::atomic<bool> refresh_requested_{false};
+  std::thread worker_;
+  int listen_fd_ = -1;
+  int wake_read_fd_ = -1;
+  int wake_write_fd_ = -1;
+  std::uint16_t bound_port_ = 0;
+  std::uint64_t next_client_serial_ = 1;
+
+  std::vector<Client> clients_;
+  std::unordered_map<std::string, MiningJob> jobs_;
+  std::vector<std::string> job_order_;
+  std::unordered_set<std::string> seen_shares_;
+
+  mutable std::mutex stats_mutex_;
+  StratumServerStats stats_;
+};
+
+}  // namespace alpha
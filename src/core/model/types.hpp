@@ -278,6 +278,39 @@ struct NodeRuntimeStats {
   std::size_t outbound_queue = 0;
   std::size_t seen_event_count = 0;
   std::uint64_t sync_tick_count = 0;
+  bool listening = false;
+  std::size_t connected_peers = 0;
+  std::uint64_t frames_in = 0;
+  std::uint64_t frames_out = 0;
+  std::uint64_t bytes_in = 0;
+  std::uint64_t bytes_out = 0;
+  std::string transport_status;
+  std::uint64_t inventory_announced = 0;
+  std::uint64_t events_requested = 0;
+  std::uint64_t events_served = 0;
+  std::uint64_t reconcile_messages = 0;
+  bool initial_sync_active = false;
+  std::size_t initial_sync_headers = 0;
+  std::size_t initial_sync_blocks_applied = 0;
+  std::size_t initial_sync_peers = 0;
+  std::size_t seen_filter_bytes = 0;
+  std::size_t seen_filter_window = 0;
+  std::uint64_t seen_filter_store_checks = 0;
+  std::uint64_t seen_filter_false_positives = 0;
+  std::size_t outbound_capacity = 0;
+  std::uint64_t outbound_rejected = 0;
+  bool network_thread = false;
+  std::size_t peer_table_size = 0;
+  std::size_t peers_banned = 0;
+  std::uint64_t peer_explorations = 0;
+  std::uint64_t frames_compressed = 0;
+  std::uint64_t compression_saved_bytes = 0;
+  std::uint64_t compact_blocks_sent = 0;
+  std::uint64_t compact_blocks_received = 0;
+  std::uint64_t compact_blocks_reconstructed = 0;
+  std::uint64_t compact_block_events_fetched = 0;
+  // Frames left queued because received events were not taken fast enough.
+  std::uint64_t frames_deferred = 0;
 };
 
 struct CommunityProfile {
@@ -373,6 +406,16 @@ struct MiningTemplate {
   std::string sample_nonce_hash;
 };
 
+struct MiningJob {
+  std::string job_id;
+  std::uint64_t block_index = 0;
+  std::string block_hash;
+  std::string merkle_root;
+  std::string pow_material;
+  int difficulty_nibbles = 0;
+  std::int64_t reward_units = 0;
+};
+
 struct WalletStatus {
   bool locked = false;
   bool destroyed = false;
@@ -387,6 +430,15 @@ struct WalletStatus {
   std::int64_t backup_last_unix = 0;
   std::int64_t last_unlocked_unix = 0;
   std::int64_t last_locked_unix = 0;
+  std::size_t kdf_cache_entries = 0;
+  bool kdf_cache_memory_locked = false;
+  // Last wallet operation answered before it finished ("async": true), e.g.
+  // "wallet.unlock"; empty when there was none.
+  std::string task;
+  bool task_pending = false;
+  bool task_ok = false;
+  std::string task_message;
+  std::int64_t task_finished_unix = 0;
 };
 
 struct InitConfig {
@@ -403,6 +455,9 @@ struct InitConfig {
   bool production_swap = true;
   std::uint64_t block_interval_seconds = 150;
   std::uint64_t validation_interval_ticks = 10;
+  bool external_mining = false;
+  std::size_t kdf_cache_entries = 8;  // 0 disables the unlock session cache
+  std::int64_t kdf_cache_ttl_seconds = 300;
   std::int64_t block_reward_units = 115;
   std::int64_t minimum_post_value = 0;
   std::string genesis_psz_timestamp;
@@ -435,6 +490,22 @@ struct InitConfig {
   std::uint64_t prune_keep_recent_blocks = 4096;
   std::uint16_t p2p_mainnet_port = 4001;
   std::uint16_t p2p_testnet_port = 14001;
+  // A node with no events bootstraps headers-first from peers holding at
+  // least this many; smaller gaps are left to set reconciliation.
+  std::size_t initial_sync_min_peer_events = 256;
+  // Memory cap and target false-positive rate of the node's seen-id filter.
+  std::size_t seen_filter_max_bytes = 1U << 20U;
+  double seen_filter_false_positive_rate = 0.0001;
+  // Pump the P2P transport on its own thread instead of once per sync tick.
+  bool p2p_network_thread = true;
+  // Offer shared-dictionary frame compression to peers; raw otherwise.
+  bool p2p_compression = true;
+  // Check and verify received events on ingest pipeline threads; off runs
+  // every stage inline on sync_tick().
+  bool ingest_pipeline_threads = true;
+  // Received events the ingest pipeline holds before the node stops taking
+  // more from its peers.
+  std::size_t ingest_queue_capacity = 8192;
   std::string fresh_genesis_release_tag = "fresh-genesis-reset-v3";
 };
 
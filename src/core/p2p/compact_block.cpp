@@ -0,0 +1,136 @@
+#include "core/p2p/compact_block.hpp"
+
+#include <algorithm>
+#include <limits>
+#include <unordered_map>
+#include <utility>
+
+#include "core/util/hash.hpp"
+
+namespace alpha {
+namespace {
+
+constexpr std::uint64_t kShortIdMask = (std::uint64_t{1} << (kShortIdBytes * 8U)) - 1U;
+
+}  // namespace
+
+std::uint64_t compact_block_salt(std::string_view block_hash, std::uint64_t nonce) {
+  return util::mix64(util::seeded_hash64(block_hash, nonce));
+}
+
+std::uint64_t short_event_id(std::string_view event_id, std::uint64_t salt) {
+  return util::seeded_hash64(event_id, salt) & kShortIdMask;
+}
+
+CompactBlock make_compact_block(const Store::BlockRecord& block, std::span<const EventEnvelope* const> events,
+                                std::uint64_t nonce) {
+  CompactBlock out{.header = block, .nonce = nonce};
+  out.header.event_ids.clear();
+  const std::uint64_t salt = compact_block_salt(block.block_hash, nonce);
+  out.short_ids.reserve(block.event_ids.size());
+  for (const auto& id : block.event_ids) {
+    out.short_ids.push_back(short_event_id(id, salt));
+  }
+  std::int64_t lo = std::numeric_limits<std::int64_t>::max();
+  std::int64_t hi = std::numeric_limits<std::int64_t>::min();
+  for (const EventEnvelope* event : events) {
+    if (event != nullptr) {
+      lo = std::min(lo, event->unix_ts);
+      hi = std::max(hi, event->unix_ts);
+    }
+  }
+  if (lo <= hi) {
+    out.min_unix_ts = lo;
+    out.max_unix_ts = hi;
+  }
+  return out;
+}
+
+CompactBlockAssembly::CompactBlockAssembly(CompactBlock block, std::span<const std::string> candidates)
+    : block_(std::move(block)),
+      salt_(compact_block_salt(block_.header.block_hash, block_.nonce)),
+      ids_(block_.short_ids.size()),
+      fetched_(block_.short_ids.size()) {
+  // Short id -> candidate, or an empty string once two candidates share it.
+  std::unordered_map<std::uint64_t, std::string_view> local;
+  local.reserve(candidates.size());
+  for (const auto& id : candidates) {
+    const auto [it, inserted] = local.try_emplace(short_event_id(id, salt_), id);
+    if (!inserted && it->second != id) {
+      it->second = {};
+    }
+  }
+  for (std::size_t position = 0; position < ids_.size(); ++position) {
+    const auto it = local.find(block_.short_ids[position]);
+    if (it != local.end() && !it->second.empty()) {
+      ids_[position] = std::string{it->second};
+      ++matched_;
+    }
+  }
+  filled_ = matched_;
+}
+
+std::vector<std::uint32_t> CompactBlockAssembly::missing() const {
+  std::vector<std::uint32_t> out;
+  for (std::size_t position = 0; position < ids_.size(); ++position) {
+    if (ids_[position].empty() && !fetched_[position].has_value()) {
+      out.push_back(static_cast<std::uint32_t>(position));
+    }
+  }
+  return out;
+}
+
+bool CompactBlockAssembly::accept(EventEnvelope event) {
+  const std::uint64_t short_id = short_event_id(event.event_id, salt_);
+  for (std::size_t position = 0; position < ids_.size(); ++position) {
+    if (block_.short_ids[position] == short_id && ids_[position].empty() && !fetched_[position].has_value()) {
+      fetched_[position] = std::move(event);
+      ++filled_;
+      return true;
+    }
+  }
+  return false;
+}
+
+void CompactBlockAssembly::forget_matches() {
+  for (std::size_t position = 0; position < ids_.size(); ++position) {
+    ids_[position].clear();
+    fetched_[position].reset();
+  }
+  matched_ = 0;
+  filled_ = 0;
+}
+
+bool CompactBlockAssembly::verify(const EventLookup& lookup) const {
+  if (!complete()) {
+    return false;
+  }
+  std::vector<EventEnvelope> events;
+  events.reserve(ids_.size());
+  for (std::size_t position = 0; position < ids_.size(); ++position) {
+    if (fetched_[position].has_value()) {
+      events.push_back(*fetched_[position]);
+      continue;
+    }
+    const EventEnvelope* local = lookup ? lookup(ids_[position]) : nullptr;
+    if (local == nullptr) {
+      return false;
+    }
+    events.push_back(*local);
+  }
+  return Store::block_merkle_root(events) == block_.header.merkle_root &&
+         Store::block_content_hash(events) == block_.header.content_hash;
+}
+
+std::vector<EventEnvelope> CompactBlockAssembly::take_fetched() {
+  std::vector<EventEnvelope> out;
+  for (auto& event : fetched_) {
+    if (event.has_value()) {
+      out.push_back(std::move(*event));
+      event.reset();
+    }
+  }
+  return out;
+}
+
+}  // namespace alpha
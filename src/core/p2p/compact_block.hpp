@@ -0,0 +1,80 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <optional>
+#include <span>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include "core/model/types.hpp"
+#include "core/storage/store.hpp"
+
+namespace alpha {
+
+// Short ids are the low 48 bits of a seeded hash of the event id.
+inline constexpr std::size_t kShortIdBytes = 6;
+
+// A confirmed block announced as its header plus one salted short id per
+// event instead of the full id list. The salt is derived from the block hash
+// and a per-announcement nonce, so a collision crafted against one
+// announcement does not carry over to the next.
+struct CompactBlock {
+  Store::BlockRecord header;  // event_ids stay empty
+  std::uint64_t nonce = 0;
+  // Timestamp span of the block's events; receivers look for matches in the
+  // reconciliation buckets it covers.
+  std::int64_t min_unix_ts = 0;
+  std::int64_t max_unix_ts = 0;
+  std::vector<std::uint64_t> short_ids;
+};
+
+[[nodiscard]] std::uint64_t compact_block_salt(std::string_view block_hash, std::uint64_t nonce);
+[[nodiscard]] std::uint64_t short_event_id(std::string_view event_id, std::uint64_t salt);
+
+// `events` are the block's events in block order; ids without a body are
+// still listed but do not widen the timestamp span.
+CompactBlock make_compact_block(const Store::BlockRecord& block, std::span<const EventEnvelope* const> events,
+                                std::uint64_t nonce);
+
+// Receiver side of one compact block: short ids are matched against local
+// event ids, the rest are fetched from the announcing peer, and the result
+// is checked against the header's merkle root and content hash.
+class CompactBlockAssembly {
+public:
+  using EventLookup = std::function<const EventEnvelope*(std::string_view event_id)>;
+
+  // Short ids matched by two candidates are left missing rather than
+  // guessed.
+  CompactBlockAssembly(CompactBlock block, std::span<const std::string> candidates);
+
+  [[nodiscard]] const Store::BlockRecord& header() const { return block_.header; }
+  [[nodiscard]] std::size_t size() const { return block_.short_ids.size(); }
+  [[nodiscard]] std::size_t matched() const { return matched_; }
+  // Positions still without an id or a fetched body.
+  [[nodiscard]] std::vector<std::uint32_t> missing() const;
+  [[nodiscard]] bool complete() const { return filled_ == block_.short_ids.size(); }
+
+  // Fills the missing position whose short id the event hashes to. Returns
+  // false for events the block does not ask for.
+  bool accept(EventEnvelope event);
+  // Drops every match and fetched body so the whole block is fetched again;
+  // used when a reconstruction fails to verify.
+  void forget_matches();
+  // Rebuilds the block from fetched bodies and `lookup` and compares it
+  // with the header.
+  [[nodiscard]] bool verify(const EventLookup& lookup) const;
+  std::vector<EventEnvelope> take_fetched();
+
+private:
+  CompactBlock block_;
+  std::uint64_t salt_ = 0;
+  std::vector<std::string> ids_;  // empty where unmatched
+  std::vector<std::optional<EventEnvelope>> fetched_;
+  std::size_t matched_ = 0;
+  std::size_t filled_ = 0;
+};
+
+}  // namespace alpha
@@ -0,0 +1,220 @@
+#include "core/p2p/compression.hpp"
+
+#include <algorithm>
+#include <bit>
+#include <cstring>
+#include <vector>
+
+namespace alpha::wire {
+namespace {
+
+constexpr std::size_t kMinMatch = 4;
+constexpr unsigned kMinHashBits = 10;
+constexpr unsigned kMaxHashBits = 15;
+
+void put_varint(std::string& out, std::uint64_t value) {
+  while (value >= 0x80U) {
+    out.push_back(static_cast<char>((value & 0x7FU) | 0x80U));
+    value >>= 7U;
+  }
+  out.push_back(static_cast<char>(value));
+}
+
+std::optional<std::uint64_t> get_varint(std::string_view in, std::size_t& pos) {
+  std::uint64_t value = 0;
+  for (unsigned shift = 0; shift < 64U; shift += 7U) {
+    if (pos >= in.size()) {
+      return std::nullopt;
+    }
+    const auto byte = static_cast<std::uint8_t>(in[pos++]);
+    value |= static_cast<std::uint64_t>(byte & 0x7FU) << shift;
+    if ((byte & 0x80U) == 0) {
+      return value;
+    }
+  }
+  return std::nullopt;
+}
+
+std::uint32_t hash4(const char* at, unsigned bits) {
+  std::uint32_t word = 0;
+  std::memcpy(&word, at, sizeof(word));
+  return (word * 2654435761U) >> (32U - bits);
+}
+
+std::string build_event_dictionary() {
+  // Ordered least common first: matches against the end of the history
+  // encode the shortest distances.
+  constexpr std::string_view kRareKeys[] = {
+      "amount",       "block_hash",    "block_index",   "claim_id",       "current_cid",
+      "display_name", "fee",           "hidden",        "memo",           "merkle_root",
+      "nonce",        "object_id",     "pinned",        "pow_difficulty", "pow_hash",
+      "pow_material", "pow_nonce",     "previous_cid",  "psz_timestamp",  "public_key",
+      "rating",       "reason",        "release_tag",   "reply_id",       "reset_unix",
+      "review_id",    "reward",        "target_cid",    "thumb_id",       "to_address",
+      "to_cid",       "transfer_id",   "witness_root",  "action",         "thread_id",
+      "category",     "markdown",      "recipe_id",     "title",
+  };
+  std::string out;
+  for (const auto key : kRareKeys) {
+    out.append(key);
+    out.append("=\n");
+  }
+  out.append("evt-rcp-thr-rep-rev-xfr-clm-");
+  out.append("chain_id=got-soup-testnet-v3-\nnetwork_id=testnet\n");
+  out.append("chain_id=got-soup-mainnet-v3\nnetwork_id=mainnet\n");
+  out.append("community_id=recipes\ncore_topic=0\n");
+  out.append("kind=0\nmarkdown=");
+  out.append("\nmenu_segment=community-post\npost_value=0\n");
+  out.append("unix_ts=17");
+  out.append("\nauthor_cid=cid-");
+  out.append("\nauthor_pubkey=");
+  return out;
+}
+
+}  // namespace
+
+std::string_view event_dictionary() {
+  static const std::string dictionary = build_event_dictionary();
+  return dictionary;
+}
+
+std::string compress(std::string_view input, std::string_view dictionary) {
+  std::string out;
+  out.reserve(input.size() / 2U + 16U);
+  put_varint(out, input.size());
+
+  std::string window;
+  window.reserve(dictionary.size() + input.size());
+  window.append(dictionary);
+  window.append(input);
+  const char* data = window.data();
+  const std::size_t end = window.size();
+
+  // Most recent position + 1 per 4-byte hash; 0 is empty. Sized to the
+  // window so small frames do not pay for clearing a large table.
+  const unsigned bits = std::clamp<unsigned>(static_cast<unsigned>(std::bit_width(end)), kMinHashBits, kMaxHashBits);
+  std::vector<std::uint32_t> table(std::size_t{1} << bits, 0U);
+  for (std::size_t pos = 0; pos + kMinMatch <= dictionary.size(); ++pos) {
+    table[hash4(data + pos, bits)] = static_cast<std::uint32_t>(pos + 1U);
+  }
+
+  std::size_t anchor = dictionary.size();
+  std::size_t pos = anchor;
+  while (pos + kMinMatch <= end) {
+    const std::uint32_t slot = hash4(data + pos, bits);
+    const std::size_t candidate = table[slot];
+    table[slot] = static_cast<std::uint32_t>(pos + 1U);
+    if (candidate == 0 || std::memcmp(data + candidate - 1U, data + pos, kMinMatch) != 0) {
+      ++pos;
+      continue;
+    }
+    const std::size_t from = candidate - 1U;
+    std::size_t length = kMinMatch;
+    while (pos + length < end && data[from + length] == data[pos + length]) {
+      ++length;
+    }
+
+    put_varint(out, pos - anchor);
+    out.append(data + anchor, pos - anchor);
+    put_varint(out, length);
+    put_varint(out, pos - from);
+
+    const std::size_t match_end = pos + length;
+    for (++pos; pos < match_end && pos + kMinMatch <= end; ++pos) {
+      table[hash4(data + pos, bits)] = static_cast<std::uint32_t>(pos + 1U);
+    }
+    pos = match_end;
+    anchor = pos;
+  }
+  put_varint(out, end - anchor);
+  out.append(data + anchor, end - anchor);
+  put_varint(out, 0);
+  return out;
+}
+
+std::optional<std::string> decompress(std::string_view input, std::string_view dictionary, std::size_t max_output) {
+  std::size_t pos = 0;
+  const std::optional<std::uint64_t> size = get_varint(input, pos);
+  if (!size.has_value() || *size > max_output) {
+    return std::nullopt;
+  }
+  std::string out(*size, '\0');
+  char* const base = out.data();
+  std::size_t written = 0;
+  while (true) {
+    const std::optional<std::uint64_t> literals = get_varint(input, pos);
+    if (!literals.has_value() || *literals > input.size() - pos || *literals > *size - written) {
+      return std::nullopt;
+    }
+    std::memcpy(base + written, input.data() + pos, *literals);
+    written += *literals;
+    pos += *literals;
+
+    const std::optional<std::uint64_t> length = get_varint(input, pos);
+    if (!length.has_value()) {
+      return std::nullopt;
+    }
+    if (*length == 0) {
+      break;
+    }
+    const std::optional<std::uint64_t> distance = get_varint(input, pos);
+    const std::size_t history = dictionary.size() + written;
+    if (*length < kMinMatch || *length > *size - written || !distance.has_value() || *distance == 0 ||
+        *distance > history) {
+      return std::nullopt;
+    }
+    std::size_t remaining = *length;
+    if (*distance > written) {
+      // Starts inside the dictionary and may run on into the output.
+      const std::size_t from = dictionary.size() - (*distance - written);
+      const std::size_t take = std::min(remaining, dictionary.size() - from);
+      std::memcpy(base + written, dictionary.data() + from, take);
+      written += take;
+      remaining -= take;
+    }
+    std::size_t from = written - std::min<std::size_t>(*distance, written);
+    if (*distance >= remaining) {
+      std::memcpy(base + written, base + from, remaining);
+      written += remaining;
+      continue;
+    }
+    // Overlapping match: each byte may be one this match just produced.
+    for (; remaining > 0; --remaining) {
+      base[written++] = base[from++];
+    }
+  }
+  if (pos != input.size() || written != *size) {
+    return std::nullopt;
+  }
+  return out;
+}
+
+std::optional<std::string> encode_compressed(MessageType type, std::string_view body) {
+  if (body.size() < kMinCompressBytes) {
+    return std::nullopt;
+  }
+  std::string out;
+  out.push_back(static_cast<char>(type));
+  out.append(compress(body, event_dictionary()));
+  if (out.size() >= body.size()) {
+    return std::nullopt;
+  }
+  return out;
+}
+
+std::optional<std::pair<MessageType, std::string>> decode_compressed(std::string_view body) {
+  if (body.empty()) {
+    return std::nullopt;
+  }
+  const auto type = static_cast<MessageType>(static_cast<unsigned char>(body.front()));
+  if (type == MessageType::Compressed || type == MessageType::Hello) {
+    return std::nullopt;
+  }
+  std::optional<std::string> inner = decompress(body.substr(1), event_dictionary(), kMaxFrameBytes);
+  if (!inner.has_value()) {
+    return std::nullopt;
+  }
+  return std::pair{type, std::move(*inner)};
+}
+
+}  // namespace alpha::wire
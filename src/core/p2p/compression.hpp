@@ -0,0 +1,39 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <optional>
+#include <string>
+#include <string_view>
+#include <utility>
+
+#include "core/p2p/wire.hpp"
+
+namespace alpha::wire {
+
+// Advertised in Hello. Peers compress frames to each other only when both
+// advertise the same id; 0 means raw frames only.
+inline constexpr std::uint32_t kEventDictionaryId = 1;
+// Smaller bodies rarely shrink enough to pay for the wrapper.
+inline constexpr std::size_t kMinCompressBytes = 128;
+
+// Preset history for the compressor: canonical payload keys in canonical
+// order, the chain/network values every event repeats and the id prefixes.
+// Changing it requires a new kEventDictionaryId.
+std::string_view event_dictionary();
+
+// LZ77 over `dictionary` followed by the input, so the first event of a
+// frame already matches the repeated keys. Stream: varint raw size, then
+// sequences of varint literal length, literals, varint match length
+// (0 ends the stream) and varint distance back into dictionary + output.
+std::string compress(std::string_view input, std::string_view dictionary);
+// Rejects truncated or inconsistent streams and anything that would expand
+// past `max_output` bytes.
+std::optional<std::string> decompress(std::string_view input, std::string_view dictionary, std::size_t max_output);
+
+// Compressed frame body: u8 inner message type, then the compressed inner
+// body. Returns nullopt when compression would not make the frame smaller.
+std::optional<std::string> encode_compressed(MessageType type, std::string_view body);
+std::optional<std::pair<MessageType, std::string>> decode_compressed(std::string_view body);
+
+}  // namespace alpha::wire
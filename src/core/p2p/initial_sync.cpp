@@ -0,0 +1,333 @@
+#include "core/p2p/initial_sync.hpp"
+
+#include <algorithm>
+#include <iterator>
+
+namespace alpha {
+
+void InitialSync::begin(PeerId header_peer, std::string genesis_block_hash) {
+  reset();
+  active_ = true;
+  header_peer_ = header_peer;
+  genesis_block_hash_ = std::move(genesis_block_hash);
+}
+
+void InitialSync::reset() {
+  const InitialSyncConfig config = config_;
+  *this = InitialSync{};
+  config_ = config;
+}
+
+bool InitialSync::complete() const {
+  return active_ && headers_complete_ && next_apply_ == blocks_.size();
+}
+
+std::optional<InitialSync::HeaderFetch> InitialSync::next_header_fetch(std::span<const PeerId> peers,
+                                                                       std::uint64_t now_tick) {
+  if (!active_ || headers_complete_) {
+    return std::nullopt;
+  }
+  if (header_outstanding_ && header_requested_tick_ + config_.request_timeout_ticks > now_tick) {
+    return std::nullopt;
+  }
+  const bool timed_out = header_outstanding_;
+  header_outstanding_ = false;
+  if (timed_out || header_peer_ == 0) {
+    // Block layout differs per node, so another peer's headers would not link
+    // onto these. Once headers have been taken the sync finishes what it has
+    // and reconciliation fills in the rest.
+    if (!headers_.empty()) {
+      headers_complete_ = true;
+      return std::nullopt;
+    }
+    const auto next = std::ranges::find_if(peers, [this](PeerId peer) { return peer != header_peer_; });
+    header_peer_ = next == peers.end() ? 0 : *next;
+    if (header_peer_ == 0) {
+      return std::nullopt;
+    }
+  }
+  header_outstanding_ = true;
+  header_requested_tick_ = now_tick;
+  return HeaderFetch{
+      .peer = header_peer_,
+      .from_index = headers_.size(),
+      .max_count = config_.headers_per_request,
+  };
+}
+
+Result InitialSync::accept_headers(PeerId peer, std::vector<Store::BlockRecord> headers) {
+  if (!active_ || peer != header_peer_ || !header_outstanding_) {
+    return Result::success("Unsolicited headers ignored.");
+  }
+  header_outstanding_ = false;
+  // Servers may trim a reply to fit a frame, so only an empty reply ends it.
+  const bool last_batch = headers.empty();
+
+  for (auto& header : headers) {
+    const std::string failure = [&]() -> std::string {
+      if (header.index != headers_.size()) {
+        return "Initial sync header is out of sequence.";
+      }
+      const std::string& expected_prev = headers_.empty() ? std::string{"genesis"} : headers_.back().block_hash;
+      if (header.prev_hash != expected_prev) {
+        return "Initial sync header does not link to its predecessor.";
+      }
+      // An empty genesis carries the network's hardcoded hash; every other
+      // block hash is recomputed from the header fields.
+      const bool hardcoded_genesis = header.index == 0 && header.event_ids.empty() && !genesis_block_hash_.empty();
+      const std::string expected_hash = hardcoded_genesis ? genesis_block_hash_ : Store::block_header_hash(header);
+      if (header.block_hash != expected_hash) {
+        return "Initial sync header hash mismatch.";
+      }
+      for (const auto& id : header.event_ids) {
+        if (id.empty() || pending_ids_.contains(id)) {
+          return "Initial sync header lists an invalid or duplicate event id.";
+        }
+      }
+      return {};
+    }();
+    if (!failure.empty()) {
+      header_peer_ = 0;
+      add_ranges();
+      return Result::failure(failure);
+    }
+
+    const std::size_t block = blocks_.size();
+    BlockSlot slot;
+    slot.events.resize(header.event_ids.size());
+    slot.verified = header.event_ids.empty();
+    for (std::size_t position = 0; position < header.event_ids.size(); ++position) {
+      pending_ids_.emplace(header.event_ids[position], PendingId{.block = block, .position = position});
+    }
+    blocks_verified_ += slot.verified ? 1U : 0U;
+    blocks_.push_back(std::move(slot));
+    headers_.push_back(std::move(header));
+  }
+
+  headers_complete_ = last_batch;
+  add_ranges();
+  return Result::success("Initial sync headers accepted.");
+}
+
+std::vector<InitialSync::BodyFetch> InitialSync::schedule_bodies(std::span<const PeerId> peers,
+                                                                 std::uint64_t now_tick) {
+  std::vector<BodyFetch> fetches;
+  if (!active_ || peers.empty()) {
+    return fetches;
+  }
+
+  std::unordered_map<PeerId, std::size_t> load;
+  for (const PeerId peer : peers) {
+    load[peer] = 0;
+  }
+  for (const auto& range : ranges_) {
+    if (!range.done && range.peer != 0 && load.contains(range.peer)) {
+      ++load[range.peer];
+    }
+  }
+
+  for (auto& range : ranges_) {
+    if (range.done) {
+      continue;
+    }
+    if (range_finished(range)) {
+      range.done = true;
+      if (load.contains(range.peer)) {
+        --load[range.peer];
+      }
+      continue;
+    }
+    if (range.peer != 0) {
+      const bool connected = load.contains(range.peer);
+      if (connected && range.requested_tick + config_.request_timeout_ticks > now_tick) {
+        continue;
+      }
+      if (connected) {
+        --load[range.peer];
+      }
+      fail_range(range);
+    }
+
+    if (std::ranges::all_of(peers, [&range](PeerId peer) { return range.failed_peers.contains(peer); })) {
+      // Nobody connected can serve these bodies (pruned or withheld). Skip
+      // the blocks; reconciliation picks up whatever is still reachable.
+      for (std::size_t block = range.first_block; block < range.end_block; ++block) {
+        BlockSlot& slot = blocks_[block];
+        if (slot.verified || slot.abandoned) {
+          continue;
+        }
+        slot.abandoned = true;
+        slot.events.clear();
+        ++blocks_abandoned_;
+        for (const auto& id : headers_[block].event_ids) {
+          pending_ids_.erase(id);
+        }
+      }
+      range.done = true;
+      continue;
+    }
+
+    PeerId best = 0;
+    std::size_t best_load = config_.ranges_per_peer;
+    for (const PeerId peer : peers) {
+      if (!range.failed_peers.contains(peer) && load[peer] < best_load) {
+        best = peer;
+        best_load = load[peer];
+      }
+    }
+    if (best == 0) {
+      continue;
+    }
+
+    range.peer = best;
+    range.requested_tick = now_tick;
+    ++load[best];
+    peers_used_.insert(best);
+    BodyFetch fetch{.peer = best, .ids = {}};
+    for (std::size_t block = range.first_block; block < range.end_block; ++block) {
+      const BlockSlot& slot = blocks_[block];
+      for (std::size_t position = 0; position < slot.events.size(); ++position) {
+        if (!slot.events[position].has_value()) {
+          fetch.ids.push_back(headers_[block].event_ids[position]);
+        }
+      }
+    }
+    fetches.push_back(std::move(fetch));
+  }
+  return fetches;
+}
+
+bool InitialSync::expects(std::string_view event_id) const {
+  return active_ && pending_ids_.contains(std::string{event_id});
+}
+
+void InitialSync::accept_event(EventEnvelope event) {
+  const auto it = pending_ids_.find(event.event_id);
+  if (it == pending_ids_.end()) {
+    return;
+  }
+  const PendingId pending = it->second;
+  pending_ids_.erase(it);
+  BlockSlot& slot = blocks_[pending.block];
+  slot.events[pending.position] = std::move(event);
+  if (++slot.received == slot.events.size()) {
+    verify_block(pending.block);
+  }
+}
+
+std::vector<EventEnvelope> InitialSync::take_ready_events() {
+  std::vector<EventEnvelope> out;
+  while (next_apply_ < blocks_.size()) {
+    BlockSlot& slot = blocks_[next_apply_];
+    if (!slot.verified && !slot.abandoned) {
+      break;
+    }
+    for (auto& event : slot.events) {
+      if (event.has_value()) {
+        out.push_back(std::move(*event));
+      }
+    }
+    slot.events.clear();
+    slot.events.shrink_to_fit();
+    ++next_apply_;
+  }
+  return out;
+}
+
+void InitialSync::peer_lost(PeerId peer) {
+  if (header_peer_ == peer) {
+    header_peer_ = 0;
+    header_outstanding_ = false;
+  }
+  for (auto& range : ranges_) {
+    if (!range.done && range.peer == peer) {
+      range.peer = 0;
+      ++ranges_reassigned_;
+    }
+  }
+}
+
+InitialSyncStats InitialSync::stats() const {
+  return {
+      .active = active_,
+      .headers_complete = headers_complete_,
+      .headers = headers_.size(),
+      .blocks_verified = blocks_verified_,
+      .blocks_applied = next_apply_,
+      .blocks_abandoned = blocks_abandoned_,
+      .body_mismatches = body_mismatches_,
+      .ranges_reassigned = ranges_reassigned_,
+      .peers_used = peers_used_.size(),
+  };
+}
+
+void InitialSync::add_ranges() {
+  while (ranged_until_ < blocks_.size()) {
+    if (blocks_[ranged_until_].verified) {
+      ++ranged_until_;
+      continue;
+    }
+    BodyRange range{.first_block = ranged_until_, .end_block = ranged_until_};
+    std::size_t bodies = 0;
+    while (range.end_block < blocks_.size() && bodies < config_.blocks_per_range) {
+      bodies += blocks_[range.end_block].verified ? 0U : 1U;
+      ++range.end_block;
+    }
+    ranged_until_ = range.end_block;
+    ranges_.push_back(std::move(range));
+  }
+}
+
+void InitialSync::verify_block(std::size_t block) {
+  BlockSlot& slot = blocks_[block];
+  std::vector<EventEnvelope> events;
+  events.reserve(slot.events.size());
+  for (const auto& event : slot.events) {
+    events.push_back(*event);
+  }
+  const Store::BlockRecord& header = headers_[block];
+  if (Store::block_merkle_root(events) == header.merkle_root &&
+      Store::block_content_hash(events) == header.content_hash) {
+    slot.verified = true;
+    ++blocks_verified_;
+    return;
+  }
+
+  // Some body in the block does not match the header: drop them all and
+  // fetch the block again from a different peer.
+  ++body_mismatches_;
+  for (std::size_t position = 0; position < slot.events.size(); ++position) {
+    slot.events[position].reset();
+    pending_ids_.emplace(header.event_ids[position], PendingId{.block = block, .position = position});
+  }
+  slot.received = 0;
+  if (BodyRange* range = range_for_block(block); range != nullptr && range->peer != 0) {
+    fail_range(*range);
+  }
+}
+
+void InitialSync::fail_range(BodyRange& range) {
+  range.failed_peers.insert(range.peer);
+  range.peer = 0;
+  ++ranges_reassigned_;
+}
+
+bool InitialSync::range_finished(const BodyRange& range) const {
+  for (std::size_t block = range.first_block; block < range.end_block; ++block) {
+    if (!blocks_[block].verified && !blocks_[block].abandoned) {
+      return false;
+    }
+  }
+  return true;
+}
+
+InitialSync::BodyRange* InitialSync::range_for_block(std::size_t block) {
+  const auto it = std::ranges::upper_bound(ranges_, block, {}, &BodyRange::first_block);
+  if (it == ranges_.begin()) {
+    return nullptr;
+  }
+  BodyRange& range = *std::prev(it);
+  return block < range.end_block ? &range : nullptr;
+}
+
+}  // namespace alpha
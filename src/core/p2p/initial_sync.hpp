@@ -0,0 +1,137 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <optional>
+#include <span>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <unordered_set>
+#include <vector>
+
+#include "core/model/types.hpp"
+#include "core/p2p/tcp_transport.hpp"
+#include "core/storage/store.hpp"
+
+namespace alpha {
+
+struct InitialSyncConfig {
+  // A fresh node only bootstraps headers-first when a peer holds at least
+  // this many events; smaller gaps are cheaper to close by reconciliation.
+  std::size_t min_peer_events = 256;
+  std::uint32_t headers_per_request = 2000;
+  // Consecutive non-empty blocks fetched by one GetData round.
+  std::size_t blocks_per_range = 16;
+  std::size_t ranges_per_peer = 2;
+  std::uint64_t request_timeout_ticks = 20;
+};
+
+struct InitialSyncStats {
+  bool active = false;
+  bool headers_complete = false;
+  std::size_t headers = 0;
+  std::size_t blocks_verified = 0;
+  std::size_t blocks_applied = 0;
+  std::size_t blocks_abandoned = 0;
+  std::uint64_t body_mismatches = 0;
+  std::uint64_t ranges_reassigned = 0;
+  std::size_t peers_used = 0;
+};
+
+// Headers-first bootstrap state for a node joining with an empty event set.
+// Headers are pulled from one peer and checked for linkage and hashes; block
+// bodies are then fetched in ranges spread across every connected peer and
+// released in chain order once each block matches its header's merkle root
+// and content hash. Block layout is per node, so bodies are requested by
+// event id and any peer holding the events can serve a range.
+class InitialSync {
+public:
+  struct HeaderFetch {
+    PeerId peer = 0;
+    std::uint64_t from_index = 0;
+    std::uint32_t max_count = 0;
+  };
+
+  struct BodyFetch {
+    PeerId peer = 0;
+    std::vector<std::string> ids;
+  };
+
+  void configure(InitialSyncConfig config) { config_ = config; }
+  [[nodiscard]] const InitialSyncConfig& config() const { return config_; }
+
+  // `genesis_block_hash` is the local genesis; header 0 must match it.
+  void begin(PeerId header_peer, std::string genesis_block_hash);
+  void reset();
+  // Leaves the counters readable after complete() and stops scheduling.
+  void finish() { active_ = false; }
+  [[nodiscard]] bool active() const { return active_; }
+  // All headers fetched and every block applied or abandoned.
+  [[nodiscard]] bool complete() const;
+
+  // Next GetHeaders to send, if one is due. Picks a new header peer from
+  // `peers` when the previous one went away.
+  std::optional<HeaderFetch> next_header_fetch(std::span<const PeerId> peers, std::uint64_t now_tick);
+  Result accept_headers(PeerId peer, std::vector<Store::BlockRecord> headers);
+
+  // Assigns idle or timed-out body ranges to the least loaded peers.
+  std::vector<BodyFetch> schedule_bodies(std::span<const PeerId> peers, std::uint64_t now_tick);
+  [[nodiscard]] bool expects(std::string_view event_id) const;
+  void accept_event(EventEnvelope event);
+  // Events of verified blocks, in chain order, up to the first gap.
+  std::vector<EventEnvelope> take_ready_events();
+  void peer_lost(PeerId peer);
+
+  [[nodiscard]] InitialSyncStats stats() const;
+
+private:
+  struct BlockSlot {
+    std::vector<std::optional<EventEnvelope>> events;
+    std::size_t received = 0;
+    bool verified = false;
+    bool abandoned = false;
+  };
+
+  struct BodyRange {
+    std::size_t first_block = 0;
+    std::size_t end_block = 0;
+    PeerId peer = 0;
+    std::uint64_t requested_tick = 0;
+    bool done = false;
+    std::unordered_set<PeerId> failed_peers;
+  };
+
+  struct PendingId {
+    std::size_t block = 0;
+    std::size_t position = 0;
+  };
+
+  void add_ranges();
+  void verify_block(std::size_t block);
+  void fail_range(BodyRange& range);
+  [[nodiscard]] bool range_finished(const BodyRange& range) const;
+  [[nodiscard]] BodyRange* range_for_block(std::size_t block);
+
+  InitialSyncConfig config_;
+  bool active_ = false;
+  std::string genesis_block_hash_;
+  PeerId header_peer_ = 0;
+  bool header_outstanding_ = false;
+  std::uint64_t header_requested_tick_ = 0;
+  bool headers_complete_ = false;
+
+  std::vector<Store::BlockRecord> headers_;
+  std::vector<BlockSlot> blocks_;
+  std::vector<BodyRange> ranges_;
+  std::size_t ranged_until_ = 0;
+  std::size_t next_apply_ = 0;
+  std::unordered_map<std::string, PendingId> pending_ids_;
+  std::unordered_set<PeerId> peers_used_;
+  std::size_t blocks_verified_ = 0;
+  std::size_t blocks_abandoned_ = 0;
+  std::uint64_t body_mismatches_ = 0;
+  std::uint64_t ranges_reassigned_ = 0;
+};
+
+}  // namespace alpha
@@ -3,11 +3,65 @@
 #include <algorithm>
 #include <filesystem>
 #include <fstream>
+#include <iterator>
+#include <optional>
+#include <random>
 #include <sstream>
+#include <utility>
 
+#include "core/p2p/compression.hpp"
 #include "core/util/canonical.hpp"
+#include "core/util/hash.hpp"
+#include "core/util/socket.hpp"
 
 namespace alpha {
+namespace {
+
+constexpr std::uint64_t kRedialTicks = 5;
+// Consecutive failures double the redial delay up to this many times.
+constexpr std::uint32_t kMaxRedialBackoffShift = 6;
+constexpr std::size_t kMaxOutboundPeers = 8;
+// Forwarded events are announced to this many of the best peers; the rest
+// catch up through reconciliation. Local events go to every peer.
+constexpr std::size_t kRelayFanout = 8;
+constexpr std::uint64_t kPeerTableSaveTicks = 600;
+constexpr std::int32_t kMalformedFramePenalty = 20;
+constexpr std::int32_t kProtocolViolationPenalty = 10;
+constexpr std::int32_t kBadHeadersPenalty = 50;
+constexpr std::uint64_t kRequestTimeoutTicks = 10;
+constexpr std::size_t kRecentEventCapacity = 256;
+constexpr std::size_t kKnownInventoryCapacity = 16384;
+// Announced blocks remembered for GetBlockEvents, and compact blocks a node
+// rebuilds at once.
+constexpr std::size_t kAnnouncedBlockCapacity = 16;
+constexpr std::size_t kMaxPendingCompactBlocks = 16;
+// Ranges at or below this many local ids are settled by exchanging id lists.
+constexpr std::uint32_t kReconcileIdThreshold = 64;
+constexpr std::size_t kReconcileFanout = 16;
+// Upper bound on how long the network thread sits in poll() before it
+// drains the outbound ring again.
+constexpr int kNetworkPollMs = 10;
+// The network thread stops reading once this many frames wait for the next
+// sync_tick(); TCP flow control then pushes back on the peers.
+constexpr std::size_t kMaxPendingFrames = 4096;
+
+// Alpha test mode only dials literal addresses so a tick never blocks on DNS.
+bool is_numeric_host(std::string_view host) {
+  return !host.empty() &&
+         std::ranges::all_of(host, [](char c) { return (c >= '0' && c <= '9') || c == '.'; });
+}
+
+double elapsed_ms(std::chrono::steady_clock::time_point since) {
+  return std::chrono::duration<double, std::milli>(util::monotonic_now() - since).count();
+}
+
+}  // namespace
+
+P2PNode::P2PNode() : outbound_ring_(std::make_unique<util::MpscRing<OutboundEvent>>(kOutboundRingCapacity)) {}
+
+P2PNode::~P2PNode() {
+  stop_network_thread();
+}
 
 Result P2PNode::start(const std::vector<std::string>& seed_peers, const ProxyEndpoint& endpoint,
                       std::string_view local_cid, bool alpha_test_mode, std::uint16_t p2p_port,
@@ -16,6 +70,7 @@ Result P2PNode::start(const std::vector<std::string>& seed_peers, const ProxyEnd
     return Result::failure("P2P start failed: local CID is empty.");
   }
 
+  const auto lock = lock_state();
   running_ = true;
   alpha_test_mode_ = alpha_test_mode;
   network_name_ = network_name.empty() ? "mainnet" : std::string{network_name};
@@ -27,27 +82,124 @@ Result P2PNode::start(const std::vector<std::string>& seed_peers, const ProxyEnd
   }
 
   for (const auto& peer : seed_peers) {
-    if (!peer.empty()) {
-      peers_.push_back(peer);
-    }
+    (void)peer_table_.add(peer, true);
   }
 
-  std::ranges::sort(peers_);
-  peers_.erase(std::unique(peers_.begin(), peers_.end()), peers_.end());
+  // A busy port is not fatal: the node keeps dialing out without a listener.
+  transport_ = transport_factory_ ? transport_factory_() : std::make_unique<TcpTransport>();
+  TcpTransportConfig transport_config{
+      .bind_host = alpha_test_mode_ ? "127.0.0.1" : "0.0.0.0",
+      .port = p2p_port_,
+  };
+  if (!alpha_test_mode_) {
+    // Outside alpha test mode every outbound connection goes through the
+    // anonymity proxy.
+    transport_config.socks_proxy = endpoint_;
+  }
+  Result transport_result = transport_->start(transport_config);
+  if (!transport_result.ok) {
+    transport_config.listen = false;
+    const Result fallback = transport_->start(transport_config);
+    transport_result.message += fallback.ok ? " (outbound only)" : "";
+    if (!fallback.ok) {
+      transport_.reset();
+    }
+  }
+  if (transport_) {
+    transport_->watch_wake_pipe(&wake_);
+  }
+  transport_status_ = transport_result.message;
+  compact_nonce_seed_ = (static_cast<std::uint64_t>(std::random_device{}()) << 32U) | std::random_device{}();
 
   return Result::success("P2P node started with seed peers.");
 }
 
 void P2PNode::stop() {
+  stop_network_thread();
+  const auto lock = lock_state();
+  if (running_) {
+    save_peer_table();
+  }
   running_ = false;
-  outbound_queue_.clear();
+  while (outbound_ring_->try_pop().has_value()) {
+  }
+  pending_poll_ = {};
+  published_.clear();
+  transport_.reset();
+  links_.clear();
+  dialed_.clear();
+  next_dial_tick_.clear();
+  in_flight_.clear();
+  received_events_.clear();
+  initial_sync_.reset();
+  initial_sync_done_ = false;
+  synced_events_.clear();
+  next_block_announce_.reset();
+  announced_blocks_.clear();
+  pending_compact_.clear();
+}
+
+void P2PNode::reset() {
+  stop();
+  const auto lock = lock_state();
+  peer_table_.clear();
+  peers_dat_path_.clear();
+  self_endpoints_.clear();
+  endpoint_cids_.clear();
+  event_lookup_ = {};
+  chain_lookup_ = {};
+  recent_events_.clear();
+  event_index_.clear();
+  seen_filter_.clear();
+  seen_store_checks_ = 0;
+  seen_false_positives_ = 0;
+  sync_tick_count_ = 0;
+  inventory_announced_ = 0;
+  events_requested_ = 0;
+  events_served_ = 0;
+  reconcile_messages_ = 0;
+  outbound_rejected_ = 0;
+  frames_compressed_ = 0;
+  compression_saved_bytes_ = 0;
+  compact_blocks_sent_ = 0;
+  compact_blocks_received_ = 0;
+  compact_blocks_reconstructed_ = 0;
+  compact_block_events_fetched_ = 0;
+  frames_deferred_ = 0;
+}
+
+void P2PNode::start_network_thread() {
+  const auto lock = lock_state();
+  if (network_thread_.joinable() || !running_ || !transport_) {
+    return;
+  }
+  network_stop_ = false;
+  network_thread_ = std::thread([this] { network_loop(); });
+  network_active_ = true;
+}
+
+void P2PNode::stop_network_thread() {
+  if (!network_thread_.joinable()) {
+    return;
+  }
+  network_stop_ = true;
+  wake_.notify();
+  network_thread_.join();
+  network_active_ = false;
 }
 
 std::vector<std::string> P2PNode::peers() const {
-  return peers_;
+  const auto lock = lock_state();
+  return peer_table_.configured_endpoints();
+}
+
+std::string P2PNode::peers_dat_path() const {
+  const auto lock = lock_state();
+  return peers_dat_path_;
 }
 
 Result P2PNode::load_peers_dat(std::string_view path) {
+  const auto lock = lock_state();
   peers_dat_path_ = std::string{path};
 
   std::ifstream in(std::string{path});
@@ -62,15 +214,18 @@ Result P2PNode::load_peers_dat(std::string_view path) {
       continue;
     }
 
-    peers_.push_back(trimmed);
+    (void)peer_table_.add(trimmed, true);
   }
 
-  std::ranges::sort(peers_);
-  peers_.erase(std::unique(peers_.begin(), peers_.end()), peers_.end());
+  const Result table = peer_table_.load(peer_table_path(path));
+  if (!table.ok) {
+    return table;
+  }
   return Result::success("Loaded peers.dat entries.");
 }
 
 Result P2PNode::save_peers_dat(std::string_view path) const {
+  const auto lock = lock_state();
   if (path.empty()) {
     return Result::failure("save_peers_dat failed: empty path.");
   }
@@ -91,7 +246,7 @@ Result P2PNode::save_peers_dat(std::string_view path) const {
 
   out << "# got-soup peers.dat\n";
   out << "# one peer per line\n";
-  for (const auto& peer : peers_) {
+  for (const auto& peer : peer_table_.configured_endpoints()) {
     out << peer << '\n';
   }
 
@@ -99,10 +254,15 @@ Result P2PNode::save_peers_dat(std::string_view path) const {
     return Result::failure("Failed writing peers.dat file.");
   }
 
+  const Result table = peer_table_.save(peer_table_path(path));
+  if (!table.ok) {
+    return table;
+  }
   return Result::success("Saved peers.dat file.");
 }
 
 Result P2PNode::add_peer(std::string_view peer) {
+  const auto lock = lock_state();
   const std::string trimmed = trim(peer);
   if (trimmed.empty()) {
     return Result::failure("Peer is empty.");
@@ -113,44 +273,322 @@ Result P2PNode::add_peer(std::string_view peer) {
     return Result::failure("127.0.0.1 peers require Alpha Test Mode.");
   }
 
-  peers_.push_back(trimmed);
-  std::ranges::sort(peers_);
-  peers_.erase(std::unique(peers_.begin(), peers_.end()), peers_.end());
+  (void)peer_table_.add(trimmed, true);
   return Result::success("Peer added.");
 }
 
-void P2PNode::queue_local_event(const EventEnvelope& event) {
+std::string P2PNode::peer_table_path(std::string_view peers_dat_path) {
+  return std::string{peers_dat_path} + ".table";
+}
+
+bool P2PNode::queue_local_event(const EventEnvelope& event) {
   if (!running_ || event.event_id.empty()) {
-    return;
+    return false;
   }
-
-  if (seen_event_ids_.insert(event.event_id).second) {
-    outbound_queue_.push_back(event);
+  if (!outbound_ring_->try_push({.event = event, .relayed = false})) {
+    ++outbound_rejected_;
+    return false;
   }
+  if (network_active_) {
+    wake_.notify();
+  }
+  return true;
 }
 
 bool P2PNode::ingest_remote_event(const EventEnvelope& event) {
+  const auto lock = lock_state();
   if (!running_ || event.event_id.empty()) {
     return false;
   }
 
-  return seen_event_ids_.insert(event.event_id).second;
+  // Not marked seen here: a corrupted copy relayed first would otherwise
+  // shadow the valid one. The service marks ids once they are stored.
+  return !already_seen(event.event_id);
+}
+
+void P2PNode::mark_seen(std::span<const std::string> event_ids) {
+  const auto lock = lock_state();
+  for (const std::string& event_id : event_ids) {
+    seen_filter_.insert(event_id);
+  }
+}
+
+void P2PNode::relay_event(const EventEnvelope& event) {
+  if (!running_ || event.event_id.empty()) {
+    return;
+  }
+  if (!outbound_ring_->try_push({.event = event, .relayed = true})) {
+    ++outbound_rejected_;
+    return;
+  }
+  if (network_active_) {
+    wake_.notify();
+  }
+}
+
+void P2PNode::set_event_lookup(EventLookup lookup) {
+  const auto lock = lock_state();
+  event_lookup_ = std::move(lookup);
+}
+
+void P2PNode::index_events(std::span<const EventEnvelope> events) {
+  const auto lock = lock_state();
+  event_index_.insert_all(events);
+  for (const EventEnvelope& event : events) {
+    seen_filter_.insert(event.event_id);
+  }
+}
+
+void P2PNode::set_chain_lookup(ChainLookup lookup) {
+  const auto lock = lock_state();
+  chain_lookup_ = std::move(lookup);
+}
+
+void P2PNode::configure_initial_sync(InitialSyncConfig config) {
+  const auto lock = lock_state();
+  initial_sync_.configure(config);
+}
+
+void P2PNode::configure_seen_filter(RollingBloomConfig config) {
+  const auto lock = lock_state();
+  seen_filter_ = RollingBloomFilter(config);
+}
+
+void P2PNode::set_compression(bool enabled) {
+  const auto lock = lock_state();
+  compression_enabled_ = enabled;
+}
+
+void P2PNode::set_transport_factory(TransportFactory factory) {
+  const auto lock = lock_state();
+  transport_factory_ = std::move(factory);
+}
+
+void P2PNode::announce_confirmed_blocks(std::span<const Store::BlockRecord> chain) {
+  const auto lock = lock_state();
+  if (!running_ || !transport_ || chain.empty()) {
+    return;
+  }
+  if (initial_sync_.active()) {
+    // Synced history is not news to anyone; start counting once it is done.
+    next_block_announce_.reset();
+    return;
+  }
+  if (!next_block_announce_.has_value()) {
+    const auto last_confirmed = std::ranges::find_if(chain.rbegin(), chain.rend(), &Store::BlockRecord::confirmed);
+    next_block_announce_ = last_confirmed == chain.rend() ? chain.front().index : last_confirmed->index + 1U;
+    return;
+  }
+
+  auto it = std::ranges::lower_bound(chain, *next_block_announce_, {}, &Store::BlockRecord::index);
+  for (; it != chain.end() && it->confirmed; ++it) {
+    next_block_announce_ = it->index + 1U;
+    if (it->event_ids.empty()) {
+      continue;
+    }
+    std::vector<const EventEnvelope*> events;
+    events.reserve(it->event_ids.size());
+    for (const auto& id : it->event_ids) {
+      events.push_back(find_event(id));
+    }
+    const CompactBlock compact = make_compact_block(*it, events, util::mix64(compact_nonce_seed_ ^ it->index));
+    const std::string body = wire::encode_compact_block(compact);
+    for (auto& [peer, link] : links_) {
+      if (link.handshaken) {
+        ++compact_blocks_sent_;
+        send_frame(peer, wire::MessageType::CompactBlock, body);
+      }
+    }
+    announced_blocks_.push_back(*it);
+    while (announced_blocks_.size() > kAnnouncedBlockCapacity) {
+      announced_blocks_.pop_front();
+    }
+  }
 }
 
 std::vector<EventEnvelope> P2PNode::sync_tick() {
+  const auto lock = lock_state();
   if (!running_) {
     return {};
   }
 
   ++sync_tick_count_;
 
-  // Stub transport: return local outbound events as if publish/flush occurred.
-  std::vector<EventEnvelope> published = outbound_queue_;
-  outbound_queue_.clear();
-  return published;
+  if (transport_) {
+    dial_missing_peers();
+    if (!network_active_ && pending_poll_.frames.size() < kMaxPendingFrames) {
+      poll_transport(0);
+    }
+    handle_poll(std::exchange(pending_poll_, {}));
+  }
+  std::erase_if(in_flight_, [this](const auto& entry) {
+    return entry.second.requested_tick + kRequestTimeoutTicks <= sync_tick_count_;
+  });
+  // Unfinished blocks are left to reconciliation.
+  std::erase_if(pending_compact_, [this](const auto& entry) {
+    return entry.second.requested_tick + kRequestTimeoutTicks <= sync_tick_count_;
+  });
+  drive_initial_sync();
+  if (sync_tick_count_ % kPeerTableSaveTicks == 0) {
+    save_peer_table();
+  }
+
+  drain_outbound();
+  flush_inventory();
+  return std::exchange(published_, {});
+}
+
+std::unique_lock<std::mutex> P2PNode::lock_state() const {
+  ++lock_waiters_;
+  if (network_active_) {
+    wake_.notify();
+  }
+  std::unique_lock<std::mutex> lock(mutex_);
+  --lock_waiters_;
+  return lock;
+}
+
+void P2PNode::network_loop() {
+  while (!network_stop_) {
+    // Hand the lock over to callers woken out of their wait.
+    while (lock_waiters_ > 0 && !network_stop_) {
+      std::this_thread::yield();
+    }
+    std::unique_lock<std::mutex> lock(mutex_);
+    if (network_stop_ || !transport_) {
+      break;
+    }
+    drain_outbound();
+    flush_inventory();
+    if (pending_poll_.frames.size() < kMaxPendingFrames) {
+      poll_transport(kNetworkPollMs);
+      continue;
+    }
+    lock.unlock();
+    std::this_thread::sleep_for(std::chrono::milliseconds(kNetworkPollMs));
+  }
+}
+
+void P2PNode::poll_transport(int timeout_ms) {
+  TransportPollResult polled = transport_->poll(timeout_ms);
+  std::ranges::move(polled.connected, std::back_inserter(pending_poll_.connected));
+  std::ranges::move(polled.frames, std::back_inserter(pending_poll_.frames));
+  std::ranges::move(polled.disconnected, std::back_inserter(pending_poll_.disconnected));
+}
+
+void P2PNode::drain_outbound() {
+  std::optional<std::vector<PeerId>> relay_targets;
+  while (std::optional<OutboundEvent> next = outbound_ring_->try_pop()) {
+    EventEnvelope& event = next->event;
+    if (!next->relayed) {
+      // Local events are already in the store, so a filter positive is only
+      // trusted when the id was just published.
+      if (seen_filter_.contains(event.event_id) &&
+          std::ranges::any_of(recent_events_, [&event](const EventEnvelope& other) {
+            return other.event_id == event.event_id;
+          })) {
+        continue;
+      }
+      seen_filter_.insert(event.event_id);
+    }
+    event_index_.insert(event.event_id, event.unix_ts);
+    remember_recent(event);
+    if (next->relayed) {
+      if (!relay_targets.has_value()) {
+        relay_targets = ranked_peers();
+        relay_targets->resize(std::min(relay_targets->size(), kRelayFanout));
+      }
+      for (const PeerId peer : *relay_targets) {
+        announce(links_.at(peer), event.event_id);
+      }
+    } else {
+      for (auto& [peer, link] : links_) {
+        if (link.handshaken) {
+          announce(link, event.event_id);
+        }
+      }
+    }
+    if (published_.size() < kOutboundRingCapacity) {
+      published_.push_back(std::move(event));
+    }
+  }
+}
+
+void P2PNode::handle_poll(TransportPollResult polled) {
+  for (const PeerId peer : polled.connected) {
+    const auto [it, inserted] = links_.try_emplace(peer);
+    if (inserted) {
+      it->second.opened_at = util::monotonic_now();
+    }
+    send_hello(peer);
+  }
+  std::size_t handled = 0;
+  for (; handled < polled.frames.size() && received_events_.size() < kMaxReceivedBacklog; ++handled) {
+    handle_frame(polled.frames[handled]);
+  }
+  if (handled < polled.frames.size()) {
+    // The owner is behind on ingest. Keep the rest, and the disconnects
+    // that may follow them, for a later tick; the network thread stops
+    // reading once enough frames pile up.
+    frames_deferred_ += polled.frames.size() - handled;
+    polled.frames.erase(polled.frames.begin(), polled.frames.begin() + static_cast<std::ptrdiff_t>(handled));
+    polled.connected.clear();
+    pending_poll_ = std::move(polled);
+    return;
+  }
+  for (const PeerId peer : polled.disconnected) {
+    const auto it = links_.find(peer);
+    if (it == links_.end()) {
+      continue;
+    }
+    if (!it->second.endpoint.empty()) {
+      const std::string& endpoint = it->second.endpoint;
+      if (!it->second.handshaken) {
+        peer_table_.record_failure(endpoint, util::unix_timestamp_now());
+      }
+      dialed_.erase(endpoint);
+      const PeerRecord* record = peer_table_.find(endpoint);
+      const std::uint32_t failures = record == nullptr ? 0U : record->failures;
+      next_dial_tick_[endpoint] = sync_tick_count_ + (kRedialTicks << std::min(failures, kMaxRedialBackoffShift));
+    }
+    links_.erase(it);
+    // Outstanding requests to a vanished peer may be retried elsewhere.
+    std::erase_if(in_flight_, [peer](const auto& entry) { return entry.second.peer == peer; });
+    std::erase_if(pending_compact_, [peer](const auto& entry) { return entry.second.peer == peer; });
+    initial_sync_.peer_lost(peer);
+  }
+}
+
+std::vector<EventEnvelope> P2PNode::take_received_events(std::size_t max_count) {
+  const auto lock = lock_state();
+  if (max_count >= received_events_.size()) {
+    return std::exchange(received_events_, {});
+  }
+  const auto split = received_events_.begin() + static_cast<std::ptrdiff_t>(max_count);
+  std::vector<EventEnvelope> out(std::make_move_iterator(received_events_.begin()), std::make_move_iterator(split));
+  received_events_.erase(received_events_.begin(), split);
+  return out;
+}
+
+std::vector<EventEnvelope> P2PNode::take_synced_events() {
+  const auto lock = lock_state();
+  std::vector<EventEnvelope> out = std::move(synced_events_);
+  synced_events_.clear();
+  return out;
+}
+
+InitialSyncStats P2PNode::initial_sync_stats() const {
+  const auto lock = lock_state();
+  return initial_sync_.stats();
 }
 
 NodeRuntimeStats P2PNode::runtime_status() const {
+  const auto lock = lock_state();
+  const TcpTransportStats transport = transport_ ? transport_->stats() : TcpTransportStats{};
+  const auto connected = std::ranges::count_if(links_, [](const auto& entry) { return entry.second.handshaken; });
+  const InitialSyncStats initial_sync = initial_sync_.stats();
+  const RollingBloomStats seen = seen_filter_.stats();
+  const PeerTableStats peers = peer_table_.stats(util::unix_timestamp_now());
   return {
       .running = running_,
       .alpha_test_mode = alpha_test_mode_,
@@ -158,11 +596,737 @@ NodeRuntimeStats P2PNode::runtime_status() const {
       .bind_host = alpha_test_mode_ ? "127.0.0.1" : "0.0.0.0",
       .bind_port = p2p_port_,
       .proxy_port = endpoint_.port,
-      .peer_count = peers_.size(),
-      .outbound_queue = outbound_queue_.size(),
-      .seen_event_count = seen_event_ids_.size(),
+      .peer_count = peers.configured,
+      .outbound_queue = outbound_ring_->size(),
+      .seen_event_count = seen.entries,
       .sync_tick_count = sync_tick_count_,
+      .listening = transport.listening,
+      .connected_peers = static_cast<std::size_t>(connected),
+      .frames_in = transport.frames_in,
+      .frames_out = transport.frames_out,
+      .bytes_in = transport.bytes_in,
+      .bytes_out = transport.bytes_out,
+      .transport_status = transport_status_,
+      .inventory_announced = inventory_announced_,
+      .events_requested = events_requested_,
+      .events_served = events_served_,
+      .reconcile_messages = reconcile_messages_,
+      .initial_sync_active = initial_sync.active,
+      .initial_sync_headers = initial_sync.headers,
+      .initial_sync_blocks_applied = initial_sync.blocks_applied,
+      .initial_sync_peers = initial_sync.peers_used,
+      .seen_filter_bytes = seen.bytes,
+      .seen_filter_window = seen.window,
+      .seen_filter_store_checks = seen_store_checks_,
+      .seen_filter_false_positives = seen_false_positives_,
+      .outbound_capacity = outbound_ring_->capacity(),
+      .outbound_rejected = outbound_rejected_,
+      .network_thread = network_active_,
+      .peer_table_size = peers.entries,
+      .peers_banned = peers.banned,
+      .peer_explorations = peers.explorations,
+      .frames_compressed = frames_compressed_,
+      .compression_saved_bytes = compression_saved_bytes_,
+      .compact_blocks_sent = compact_blocks_sent_,
+      .compact_blocks_received = compact_blocks_received_,
+      .compact_blocks_reconstructed = compact_blocks_reconstructed_,
+      .compact_block_events_fetched = compact_block_events_fetched_,
+      .frames_deferred = frames_deferred_,
+  };
+}
+
+void P2PNode::dial_missing_peers() {
+  if (dialed_.size() >= kMaxOutboundPeers) {
+    return;
+  }
+  const std::int64_t now = util::unix_timestamp_now();
+  const auto dialable = [this](const PeerRecord& record) {
+    const std::string& peer = record.endpoint;
+    if (dialed_.contains(peer) || self_endpoints_.contains(peer)) {
+      return false;
+    }
+    if (const auto it = next_dial_tick_.find(peer); it != next_dial_tick_.end() && it->second > sync_tick_count_) {
+      return false;
+    }
+    // Already linked to this node, through either side's connection.
+    if (const auto it = endpoint_cids_.find(peer); it != endpoint_cids_.end() && cid_connected(it->second)) {
+      return false;
+    }
+    std::string host;
+    std::uint16_t port = 0;
+    // The proxy resolves names itself; direct test-mode dials do not.
+    return util::split_host_port(peer, host, port) && (!alpha_test_mode_ || is_numeric_host(host));
+  };
+  for (const auto& peer : peer_table_.select(kMaxOutboundPeers - dialed_.size(), now, dialable)) {
+    peer_table_.record_attempt(peer, now);
+    PeerId id = 0;
+    if (!transport_->dial(peer, id).ok) {
+      peer_table_.record_failure(peer, now);
+      const std::uint32_t failures = peer_table_.find(peer)->failures;
+      next_dial_tick_[peer] = sync_tick_count_ + (kRedialTicks << std::min(failures, kMaxRedialBackoffShift));
+      continue;
+    }
+    dialed_[peer] = id;
+    PeerLink& link = links_[id];
+    link.endpoint = peer;
+    link.address = peer;
+    link.opened_at = util::monotonic_now();
+  }
+}
+
+void P2PNode::penalize(PeerId peer, std::int32_t points) {
+  if (const auto it = links_.find(peer); it != links_.end() && !it->second.address.empty()) {
+    (void)peer_table_.record_misbehavior(it->second.address, points, util::unix_timestamp_now());
+  }
+  transport_->disconnect(peer);
+}
+
+std::vector<PeerId> P2PNode::ranked_peers() const {
+  const std::int64_t now = util::unix_timestamp_now();
+  std::vector<std::pair<double, PeerId>> scored;
+  for (const auto& [peer, link] : links_) {
+    if (link.handshaken) {
+      scored.emplace_back(peer_table_.score(link.address, now), peer);
+    }
+  }
+  std::ranges::sort(scored, [](const auto& a, const auto& b) {
+    return a.first != b.first ? a.first > b.first : a.second < b.second;
+  });
+  std::vector<PeerId> out;
+  out.reserve(scored.size());
+  for (const auto& [score, peer] : scored) {
+    out.push_back(peer);
+  }
+  return out;
+}
+
+void P2PNode::save_peer_table() const {
+  if (!peers_dat_path_.empty()) {
+    (void)peer_table_.save(peer_table_path(peers_dat_path_));
+  }
+}
+
+void P2PNode::handle_frame(const TransportFrame& frame) {
+  const auto it = links_.find(frame.peer);
+  if (it == links_.end()) {
+    return;
+  }
+  PeerLink& link = it->second;
+  if (frame.type != wire::MessageType::Hello && !link.handshaken) {
+    penalize(frame.peer, kProtocolViolationPenalty);
+    return;
+  }
+  if (frame.type == wire::MessageType::Compressed) {
+    if (!link.compressed) {
+      penalize(frame.peer, kProtocolViolationPenalty);
+      return;
+    }
+    std::optional<std::pair<wire::MessageType, std::string>> inner = wire::decode_compressed(frame.body);
+    if (!inner.has_value()) {
+      penalize(frame.peer, kMalformedFramePenalty);
+      return;
+    }
+    handle_frame({.peer = frame.peer, .type = inner->first, .body = std::move(inner->second)});
+    return;
+  }
+
+  switch (frame.type) {
+    case wire::MessageType::Hello:
+      handle_hello(frame.peer, link, frame.body);
+      return;
+    case wire::MessageType::Inventory:
+      handle_inventory(frame.peer, link, frame.body);
+      return;
+    case wire::MessageType::GetData:
+      handle_getdata(frame.peer, link, frame.body);
+      return;
+    case wire::MessageType::Events:
+      handle_events(frame.peer, link, frame.body);
+      return;
+    case wire::MessageType::RangeSummary:
+      handle_range_summary(frame.peer, link, frame.body);
+      return;
+    case wire::MessageType::RangeIds:
+      handle_range_ids(frame.peer, link, frame.body);
+      return;
+    case wire::MessageType::GetHeaders:
+      handle_get_headers(frame.peer, frame.body);
+      return;
+    case wire::MessageType::Headers:
+      handle_headers(frame.peer, frame.body);
+      return;
+    case wire::MessageType::CompactBlock:
+      handle_compact_block(frame.peer, frame.body);
+      return;
+    case wire::MessageType::GetBlockEvents:
+      handle_get_block_events(frame.peer, link, frame.body);
+      return;
+    case wire::MessageType::BlockEvents:
+      handle_block_events(frame.peer, link, frame.body);
+      return;
+    case wire::MessageType::Compressed:
+      break;
+  }
+  penalize(frame.peer, kProtocolViolationPenalty);
+}
+
+void P2PNode::handle_hello(PeerId peer, PeerLink& link, std::string_view body) {
+  const std::optional<wire::Hello> hello = wire::decode_hello(body);
+  if (!hello.has_value() || hello->protocol_version != wire::kProtocolVersion ||
+      hello->network != network_name_ || hello->cid == local_cid_) {
+    if (hello.has_value() && hello->cid == local_cid_ && !link.endpoint.empty()) {
+      self_endpoints_.insert(link.endpoint);
+    }
+    transport_->disconnect(peer);
+    return;
+  }
+  if (link.handshaken) {
+    return;
+  }
+  const std::int64_t now = util::unix_timestamp_now();
+  if (link.endpoint.empty() && hello->listen_port != 0) {
+    // Inbound peers advertise their listener; it joins the table as a
+    // learned peer that later dial rounds may explore.
+    std::string host;
+    std::uint16_t port = 0;
+    if (util::split_host_port(transport_->peer_endpoint(peer), host, port)) {
+      link.address = host + ":" + std::to_string(hello->listen_port);
+      (void)peer_table_.add(link.address, false);
+    }
+  }
+  if (!link.address.empty() && peer_table_.banned(link.address, now)) {
+    transport_->disconnect(peer);
+    return;
+  }
+  if (!link.address.empty()) {
+    endpoint_cids_[link.address] = hello->cid;
+  }
+
+  // Two nodes dialing each other end up with two links. Both sides keep the
+  // one opened by the smaller CID so the choice agrees without coordination.
+  const bool local_smaller = local_cid_ < hello->cid;
+  const auto preferred = [local_smaller](const PeerLink& candidate) {
+    return !candidate.endpoint.empty() == local_smaller;
+  };
+  for (auto& [other_peer, other] : links_) {
+    if (other_peer == peer || !other.handshaken || other.cid != hello->cid) {
+      continue;
+    }
+    if (preferred(link) && !preferred(other)) {
+      other.handshaken = false;
+      transport_->disconnect(other_peer);
+      continue;
+    }
+    transport_->disconnect(peer);
+    return;
+  }
+
+  link.cid = hello->cid;
+  link.handshaken = true;
+  // Peers without the dictionary (or with compression off) get raw frames.
+  link.compressed = compression_enabled_ && hello->dictionary_id == wire::kEventDictionaryId;
+  link.remote_event_count = hello->event_count;
+  if (!link.address.empty()) {
+    peer_table_.record_connected(link.address, now);
+    // Connect plus hello exchange: a coarse first latency sample.
+    peer_table_.record_rtt(link.address, elapsed_ms(link.opened_at));
+  }
+  maybe_begin_initial_sync(peer, link);
+
+  // The dialing side opens reconciliation with a digest of its whole set;
+  // anything either side missed while apart is found top-down from there.
+  // A bootstrapping node reconciles once its initial sync is done instead.
+  if (!link.endpoint.empty() && !initial_sync_.active()) {
+    send_range_summary(peer);
+  }
+}
+
+void P2PNode::handle_inventory(PeerId peer, PeerLink& link, std::string_view body) {
+  const std::optional<std::vector<std::string>> ids = wire::decode_ids(body);
+  if (!ids.has_value()) {
+    penalize(peer, kMalformedFramePenalty);
+    return;
+  }
+  std::vector<std::string> wanted;
+  for (const auto& id : *ids) {
+    if (link.known.size() >= kKnownInventoryCapacity) {
+      link.known.clear();
+    }
+    link.known.insert(id);
+    // Anything announced during initial sync is caught by the reconciliation
+    // that follows it.
+    if (!initial_sync_.active() && wants_event(id)) {
+      wanted.push_back(id);
+    }
+  }
+  request_events(peer, std::move(wanted));
+}
+
+void P2PNode::handle_getdata(PeerId peer, PeerLink& link, std::string_view body) {
+  const std::optional<std::vector<std::string>> ids = wire::decode_ids(body);
+  if (!ids.has_value()) {
+    penalize(peer, kMalformedFramePenalty);
+    return;
+  }
+  std::vector<EventEnvelope> batch;
+  std::size_t batch_bytes = 0;
+  const auto flush = [&] {
+    if (!batch.empty()) {
+      events_served_ += batch.size();
+      send_frame(peer, wire::MessageType::Events, wire::encode_events(batch));
+      batch.clear();
+      batch_bytes = 0;
+    }
+  };
+  for (const auto& id : *ids) {
+    const EventEnvelope* event = find_event(id);
+    if (event == nullptr) {
+      continue;
+    }
+    const std::size_t size = event->event_id.size() + event->author_cid.size() + event->payload.size() +
+                             event->signature.size() + 28U;
+    if (batch_bytes + size > wire::kMaxEventBatchBytes) {
+      flush();
+    }
+    link.known.insert(id);
+    batch.push_back(*event);
+    batch_bytes += size;
+  }
+  flush();
+}
+
+void P2PNode::handle_events(PeerId peer, PeerLink& link, std::string_view body) {
+  std::optional<std::vector<EventEnvelope>> events = wire::decode_events(body);
+  if (!events.has_value()) {
+    penalize(peer, kMalformedFramePenalty);
+    return;
+  }
+  bool sampled = false;
+  for (auto& event : *events) {
+    link.known.insert(event.event_id);
+    if (initial_sync_.expects(event.event_id)) {
+      initial_sync_.accept_event(std::move(event));
+      continue;
+    }
+    // Only bodies we asked this peer for are accepted; the rest is noise.
+    const auto it = in_flight_.find(event.event_id);
+    if (it == in_flight_.end() || it->second.peer != peer) {
+      continue;
+    }
+    if (!sampled && !link.address.empty()) {
+      // One GetData round trip per reply frame feeds the peer's latency and
+      // throughput averages.
+      const double ms = elapsed_ms(it->second.requested_at);
+      peer_table_.record_rtt(link.address, ms);
+      peer_table_.record_throughput(link.address, body.size() + wire::kFrameHeaderBytes, ms / 1000.0);
+      sampled = true;
+    }
+    in_flight_.erase(it);
+    received_events_.push_back(std::move(event));
+  }
+}
+
+void P2PNode::handle_range_summary(PeerId peer, PeerLink& link, std::string_view body) {
+  const std::optional<std::vector<DigestRange>> ranges = wire::decode_range_summary(body);
+  if (!ranges.has_value()) {
+    penalize(peer, kMalformedFramePenalty);
+    return;
+  }
+  if (initial_sync_.active()) {
+    return;
+  }
+  std::vector<DigestRange> narrower;
+  std::vector<wire::RangeIds> listed;
+  for (const DigestRange& range : *ranges) {
+    const RangeDigest mine = event_index_.digest(range.lo, range.hi);
+    if (mine == range.digest) {
+      continue;
+    }
+    if (range.digest.count == 0) {
+      // The peer holds nothing here; announcing is cheaper than recursing.
+      for (const auto& id : event_index_.ids(range.lo, range.hi)) {
+        announce(link, id);
+      }
+      continue;
+    }
+    if (mine.count > kReconcileIdThreshold) {
+      std::vector<DigestRange> parts = event_index_.split(range.lo, range.hi, kReconcileFanout);
+      if (parts.size() > 1U) {
+        narrower.insert(narrower.end(), parts.begin(), parts.end());
+        continue;
+      }
+    }
+    listed.push_back({.lo = range.lo, .hi = range.hi, .ids = event_index_.ids(range.lo, range.hi)});
+  }
+
+  for (std::size_t offset = 0; offset < narrower.size(); offset += wire::kMaxReconcileRanges) {
+    const std::size_t end = std::min(narrower.size(), offset + wire::kMaxReconcileRanges);
+    const std::vector<DigestRange> chunk(narrower.begin() + static_cast<std::ptrdiff_t>(offset),
+                                         narrower.begin() + static_cast<std::ptrdiff_t>(end));
+    ++reconcile_messages_;
+    send_frame(peer, wire::MessageType::RangeSummary, wire::encode_range_summary(chunk));
+  }
+  for (std::size_t offset = 0; offset < listed.size(); offset += wire::kMaxReconcileRanges) {
+    const std::size_t end = std::min(listed.size(), offset + wire::kMaxReconcileRanges);
+    const std::vector<wire::RangeIds> chunk(std::make_move_iterator(listed.begin() + static_cast<std::ptrdiff_t>(offset)),
+                                            std::make_move_iterator(listed.begin() + static_cast<std::ptrdiff_t>(end)));
+    ++reconcile_messages_;
+    send_frame(peer, wire::MessageType::RangeIds, wire::encode_range_ids(chunk));
+  }
+}
+
+void P2PNode::handle_range_ids(PeerId peer, PeerLink& link, std::string_view body) {
+  const std::optional<std::vector<wire::RangeIds>> ranges = wire::decode_range_ids(body);
+  if (!ranges.has_value()) {
+    penalize(peer, kMalformedFramePenalty);
+    return;
+  }
+  if (initial_sync_.active()) {
+    return;
+  }
+  std::vector<std::string> wanted;
+  for (const wire::RangeIds& range : *ranges) {
+    const std::unordered_set<std::string> theirs(range.ids.begin(), range.ids.end());
+    const std::vector<std::string> mine_list = event_index_.ids(range.lo, range.hi);
+    const std::unordered_set<std::string> mine(mine_list.begin(), mine_list.end());
+    for (const auto& id : mine_list) {
+      if (!theirs.contains(id)) {
+        announce(link, id);
+      }
+    }
+    for (const auto& id : range.ids) {
+      link.known.insert(id);
+      if (!mine.contains(id) && wants_event(id)) {
+        wanted.push_back(id);
+      }
+    }
+  }
+  request_events(peer, std::move(wanted));
+}
+
+void P2PNode::handle_get_headers(PeerId peer, std::string_view body) {
+  const std::optional<wire::HeaderRequest> request = wire::decode_header_request(body);
+  if (!request.has_value()) {
+    penalize(peer, kMalformedFramePenalty);
+    return;
+  }
+  std::vector<Store::BlockRecord> headers;
+  if (chain_lookup_) {
+    headers = chain_lookup_(request->from_index, std::min(request->max_count, wire::kMaxHeadersPerMessage));
+  }
+  std::string encoded = wire::encode_headers(headers);
+  // Blocks carry their id lists, so trim until the reply fits one frame.
+  while (encoded.size() + wire::kFrameHeaderBytes > wire::kMaxFrameBytes && headers.size() > 1U) {
+    headers.resize(headers.size() / 2U);
+    encoded = wire::encode_headers(headers);
+  }
+  send_frame(peer, wire::MessageType::Headers, encoded);
+}
+
+void P2PNode::handle_headers(PeerId peer, std::string_view body) {
+  std::optional<std::vector<Store::BlockRecord>> headers = wire::decode_headers(body);
+  if (!headers.has_value() || !initial_sync_.accept_headers(peer, std::move(*headers)).ok) {
+    penalize(peer, kBadHeadersPenalty);
+  }
+}
+
+void P2PNode::handle_compact_block(PeerId peer, std::string_view body) {
+  std::optional<CompactBlock> block = wire::decode_compact_block(body);
+  if (!block.has_value()) {
+    penalize(peer, kMalformedFramePenalty);
+    return;
+  }
+  ++compact_blocks_received_;
+  const std::string block_hash = block->header.block_hash;
+  if (initial_sync_.active() || pending_compact_.contains(block_hash) ||
+      pending_compact_.size() >= kMaxPendingCompactBlocks) {
+    return;
+  }
+  if (chain_lookup_) {
+    // Same block locally: every event is already here.
+    const std::vector<Store::BlockRecord> local = chain_lookup_(block->header.index, 1);
+    if (!local.empty() && local.front().block_hash == block_hash) {
+      ++compact_blocks_reconstructed_;
+      return;
+    }
+  }
+  const std::vector<std::string> candidates = compact_candidates(*block);
+  CompactBlockAssembly assembly(std::move(*block), candidates);
+  pending_compact_.emplace(block_hash, PendingCompactBlock{
+                                           .peer = peer,
+                                           .assembly = std::move(assembly),
+                                           .requested_tick = sync_tick_count_,
+                                       });
+  settle_compact_block(block_hash);
+}
+
+void P2PNode::handle_get_block_events(PeerId peer, PeerLink& link, std::string_view body) {
+  const std::optional<wire::BlockEventRequest> request = wire::decode_block_event_request(body);
+  if (!request.has_value()) {
+    penalize(peer, kMalformedFramePenalty);
+    return;
+  }
+  const auto block = std::ranges::find(announced_blocks_, request->block_hash, &Store::BlockRecord::block_hash);
+  if (block == announced_blocks_.end()) {
+    return;
+  }
+  std::vector<EventEnvelope> batch;
+  std::size_t batch_bytes = 0;
+  const auto flush = [&] {
+    if (!batch.empty()) {
+      events_served_ += batch.size();
+      send_frame(peer, wire::MessageType::BlockEvents, wire::encode_block_events(request->block_hash, batch));
+      batch.clear();
+      batch_bytes = 0;
+    }
   };
+  for (const std::uint32_t position : request->positions) {
+    if (position >= block->event_ids.size()) {
+      penalize(peer, kProtocolViolationPenalty);
+      return;
+    }
+    const EventEnvelope* event = find_event(block->event_ids[position]);
+    if (event == nullptr) {
+      continue;
+    }
+    const std::size_t size = event->event_id.size() + event->author_cid.size() + event->payload.size() +
+                             event->signature.size() + 28U;
+    if (batch_bytes + size > wire::kMaxEventBatchBytes) {
+      flush();
+    }
+    link.known.insert(event->event_id);
+    batch.push_back(*event);
+    batch_bytes += size;
+  }
+  flush();
+}
+
+void P2PNode::handle_block_events(PeerId peer, PeerLink& link, std::string_view body) {
+  std::optional<wire::BlockEvents> reply = wire::decode_block_events(body);
+  if (!reply.has_value()) {
+    penalize(peer, kMalformedFramePenalty);
+    return;
+  }
+  const auto it = pending_compact_.find(reply->block_hash);
+  if (it == pending_compact_.end() || it->second.peer != peer) {
+    return;
+  }
+  for (auto& event : reply->events) {
+    link.known.insert(event.event_id);
+    if (it->second.assembly.accept(std::move(event))) {
+      ++compact_block_events_fetched_;
+    }
+  }
+  settle_compact_block(reply->block_hash);
+}
+
+void P2PNode::settle_compact_block(const std::string& block_hash) {
+  const auto it = pending_compact_.find(block_hash);
+  PendingCompactBlock& pending = it->second;
+  if (!pending.assembly.complete()) {
+    const std::vector<std::uint32_t> missing = pending.assembly.missing();
+    const wire::BlockEventRequest request{.block_hash = block_hash, .positions = missing};
+    pending.requested_tick = sync_tick_count_;
+    events_requested_ += missing.size();
+    send_frame(pending.peer, wire::MessageType::GetBlockEvents, wire::encode_block_event_request(request));
+    return;
+  }
+  if (!pending.assembly.verify([this](std::string_view id) { return find_event(std::string{id}); })) {
+    if (pending.refetched) {
+      // The peer's own bodies do not add up to its header.
+      const PeerId peer = pending.peer;
+      pending_compact_.erase(it);
+      penalize(peer, kBadHeadersPenalty);
+      return;
+    }
+    // A short id collided with an unrelated local event: fetch the block
+    // whole.
+    pending.refetched = true;
+    pending.assembly.forget_matches();
+    settle_compact_block(block_hash);
+    return;
+  }
+  ++compact_blocks_reconstructed_;
+  for (auto& event : pending.assembly.take_fetched()) {
+    if (!already_seen(event.event_id)) {
+      received_events_.push_back(std::move(event));
+    }
+  }
+  pending_compact_.erase(it);
+}
+
+std::vector<std::string> P2PNode::compact_candidates(const CompactBlock& block) const {
+  std::vector<std::string> out;
+  if (block.min_unix_ts <= block.max_unix_ts) {
+    out = event_index_.ids(EventSetIndex::bucket_for(block.min_unix_ts),
+                           EventSetIndex::bucket_for(block.max_unix_ts) + 1);
+  }
+  // Events relayed moments ago may still be on their way into the store.
+  for (const auto& event : recent_events_) {
+    out.push_back(event.event_id);
+  }
+  return out;
+}
+
+void P2PNode::maybe_begin_initial_sync(PeerId peer, const PeerLink& link) {
+  if (initial_sync_done_ || initial_sync_.active() || !chain_lookup_ || event_index_.size() != 0 ||
+      link.remote_event_count < initial_sync_.config().min_peer_events) {
+    return;
+  }
+  const std::vector<Store::BlockRecord> genesis = chain_lookup_(0, 1);
+  const bool empty_genesis = !genesis.empty() && genesis.front().event_ids.empty();
+  initial_sync_.begin(peer, empty_genesis ? genesis.front().block_hash : std::string{});
+}
+
+void P2PNode::drive_initial_sync() {
+  if (!initial_sync_.active() || !transport_) {
+    return;
+  }
+  // Best peers first: ranges and the header chain go to them before slower
+  // ones.
+  const std::vector<PeerId> peers = ranked_peers();
+
+  if (const auto fetch = initial_sync_.next_header_fetch(peers, sync_tick_count_); fetch.has_value()) {
+    const wire::HeaderRequest request{.from_index = fetch->from_index, .max_count = fetch->max_count};
+    send_frame(fetch->peer, wire::MessageType::GetHeaders, wire::encode_header_request(request));
+  }
+  for (const auto& fetch : initial_sync_.schedule_bodies(peers, sync_tick_count_)) {
+    events_requested_ += fetch.ids.size();
+    send_getdata(fetch.peer, fetch.ids);
+  }
+
+  std::vector<EventEnvelope> ready = initial_sync_.take_ready_events();
+  event_index_.insert_all(ready);
+  std::ranges::move(ready, std::back_inserter(synced_events_));
+
+  if (initial_sync_.complete()) {
+    initial_sync_.finish();
+    initial_sync_done_ = true;
+    for (const PeerId peer : peers) {
+      send_range_summary(peer);
+    }
+  }
+}
+
+void P2PNode::send_range_summary(PeerId peer) {
+  const std::vector<DigestRange> top{{
+      .lo = EventSetIndex::kMinBucket,
+      .hi = EventSetIndex::kMaxBucket,
+      .digest = event_index_.digest(EventSetIndex::kMinBucket, EventSetIndex::kMaxBucket),
+  }};
+  ++reconcile_messages_;
+  send_frame(peer, wire::MessageType::RangeSummary, wire::encode_range_summary(top));
+}
+
+void P2PNode::request_events(PeerId peer, std::vector<std::string> ids) {
+  const auto now = util::monotonic_now();
+  for (const auto& id : ids) {
+    in_flight_[id] = {.peer = peer, .requested_tick = sync_tick_count_, .requested_at = now};
+  }
+  events_requested_ += ids.size();
+  send_getdata(peer, ids);
+}
+
+void P2PNode::send_getdata(PeerId peer, const std::vector<std::string>& ids) {
+  for (std::size_t offset = 0; offset < ids.size(); offset += wire::kMaxInventoryIds) {
+    const std::size_t end = std::min(ids.size(), offset + wire::kMaxInventoryIds);
+    const std::vector<std::string> chunk(ids.begin() + static_cast<std::ptrdiff_t>(offset),
+                                         ids.begin() + static_cast<std::ptrdiff_t>(end));
+    send_frame(peer, wire::MessageType::GetData, wire::encode_ids(chunk));
+  }
+}
+
+void P2PNode::send_hello(PeerId peer) {
+  const wire::Hello hello{
+      .network = network_name_,
+      .cid = local_cid_,
+      .listen_port = transport_->bound_port(),
+      .event_count = event_index_.size(),
+      .dictionary_id = compression_enabled_ ? wire::kEventDictionaryId : 0U,
+  };
+  transport_->send(peer, wire::MessageType::Hello, wire::encode_hello(hello));
+}
+
+void P2PNode::send_frame(PeerId peer, wire::MessageType type, std::string_view body) {
+  if (const auto it = links_.find(peer); it != links_.end() && it->second.compressed) {
+    if (const std::optional<std::string> packed = wire::encode_compressed(type, body); packed.has_value()) {
+      ++frames_compressed_;
+      compression_saved_bytes_ += body.size() - packed->size();
+      transport_->send(peer, wire::MessageType::Compressed, *packed);
+      return;
+    }
+  }
+  transport_->send(peer, type, body);
+}
+
+void P2PNode::announce(PeerLink& link, const std::string& event_id) {
+  if (link.known.size() >= kKnownInventoryCapacity) {
+    link.known.clear();
+  }
+  if (link.known.insert(event_id).second) {
+    link.pending_inventory.push_back(event_id);
+  }
+}
+
+void P2PNode::flush_inventory() {
+  if (!transport_) {
+    return;
+  }
+  for (auto& [peer, link] : links_) {
+    auto& pending = link.pending_inventory;
+    for (std::size_t offset = 0; offset < pending.size(); offset += wire::kMaxInventoryIds) {
+      const std::size_t end = std::min(pending.size(), offset + wire::kMaxInventoryIds);
+      const std::vector<std::string> chunk(pending.begin() + static_cast<std::ptrdiff_t>(offset),
+                                           pending.begin() + static_cast<std::ptrdiff_t>(end));
+      inventory_announced_ += chunk.size();
+      send_frame(peer, wire::MessageType::Inventory, wire::encode_ids(chunk));
+    }
+    pending.clear();
+  }
+}
+
+void P2PNode::remember_recent(const EventEnvelope& event) {
+  recent_events_.push_back(event);
+  while (recent_events_.size() > kRecentEventCapacity) {
+    recent_events_.pop_front();
+  }
+}
+
+bool P2PNode::already_seen(const std::string& event_id) {
+  if (!seen_filter_.contains(event_id)) {
+    return false;
+  }
+  if (!event_lookup_) {
+    return true;
+  }
+  // Only stored ids are inserted, so a positive the store cannot confirm is
+  // a false positive and the id is still wanted.
+  ++seen_store_checks_;
+  if (event_lookup_(event_id) != nullptr) {
+    return true;
+  }
+  ++seen_false_positives_;
+  return false;
+}
+
+bool P2PNode::wants_event(const std::string& event_id) {
+  return !in_flight_.contains(event_id) && !already_seen(event_id);
+}
+
+const EventEnvelope* P2PNode::find_event(const std::string& event_id) const {
+  if (event_lookup_) {
+    if (const EventEnvelope* stored = event_lookup_(event_id); stored != nullptr) {
+      return stored;
+    }
+  }
+  const auto it = std::ranges::find(recent_events_, event_id, &EventEnvelope::event_id);
+  return it == recent_events_.end() ? nullptr : &*it;
+}
+
+bool P2PNode::cid_connected(std::string_view cid) const {
+  return std::ranges::any_of(links_, [cid](const auto& entry) {
+    return entry.second.handshaken && entry.second.cid == cid;
+  });
 }
 
 std::string P2PNode::trim(std::string_view text) {
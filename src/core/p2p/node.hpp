@@ -1,52 +1,283 @@
 #pragma once
 
+#include <atomic>
+#include <chrono>
+#include <deque>
+#include <optional>
+#include <functional>
+#include <limits>
+#include <memory>
+#include <mutex>
+#include <span>
 #include <string>
 #include <string_view>
+#include <thread>
+#include <unordered_map>
 #include <unordered_set>
 #include <vector>
 
 #include "core/model/types.hpp"
+#include "core/p2p/compact_block.hpp"
+#include "core/p2p/initial_sync.hpp"
+#include "core/p2p/peer_table.hpp"
+#include "core/p2p/reconcile.hpp"
+#include "core/p2p/rolling_bloom.hpp"
+#include "core/p2p/tcp_transport.hpp"
 #include "core/transport/anonymity_provider.hpp"
+#include "core/util/mpsc_ring.hpp"
 
 namespace alpha {
 
+// All methods may be called from any thread. queue_local_event() is
+// lock-free and never waits on the network; everything else takes the node
+// lock, which the network thread (when running) holds only while pumping.
 class P2PNode {
 public:
+  using EventLookup = std::function<const EventEnvelope*(std::string_view event_id)>;
+  // Returns up to `max_count` local blocks starting at `from_index`.
+  using ChainLookup = std::function<std::vector<Store::BlockRecord>(std::uint64_t from_index, std::size_t max_count)>;
+  using TransportFactory = std::function<std::unique_ptr<IPeerTransport>()>;
+
+  static constexpr std::size_t kOutboundRingCapacity = 4096;
+  static constexpr std::size_t kMaxReceivedBacklog = 8192;
+
+  P2PNode();
+  P2PNode(const P2PNode&) = delete;
+  P2PNode& operator=(const P2PNode&) = delete;
+  ~P2PNode();
+
   Result start(const std::vector<std::string>& seed_peers, const ProxyEndpoint& endpoint,
                std::string_view local_cid, bool alpha_test_mode, std::uint16_t p2p_port,
                std::string_view network_name);
   void stop();
+  // Stops the node and forgets peers and seen ids; configuration is kept.
+  void reset();
+
+  // Runs the transport on a dedicated thread that drains the outbound ring
+  // and moves bytes continuously, so publishing does not wait for the next
+  // sync_tick(). Frames are still handled on the sync_tick() caller, which
+  // owns the store the handlers read from.
+  // Called by the owner of the node, not from producer threads.
+  void start_network_thread();
+  void stop_network_thread();
 
   [[nodiscard]] bool running() const { return running_; }
+  [[nodiscard]] bool network_thread_running() const { return network_active_; }
+  // Configured peers (seeds, peers.dat and add_peer); learned ones live only
+  // in the peer table.
   [[nodiscard]] std::vector<std::string> peers() const;
 
+  // Also loads and saves the peer table kept next to peers.dat.
   Result load_peers_dat(std::string_view path);
   Result save_peers_dat(std::string_view path) const;
   Result add_peer(std::string_view peer);
+  [[nodiscard]] static std::string peer_table_path(std::string_view peers_dat_path);
 
-  void queue_local_event(const EventEnvelope& event);
+  // Returns false when the outbound ring is full. The event is then left to
+  // reach peers through reconciliation instead of an announce.
+  bool queue_local_event(const EventEnvelope& event);
+  // True when `event` is not known to be stored yet and should go on to
+  // verification. Does not mark it seen; see mark_seen().
   bool ingest_remote_event(const EventEnvelope& event);
+  // Remembers ids the store accepted, so later announcements of them are
+  // not fetched again.
+  void mark_seen(std::span<const std::string> event_ids);
+  // Queues an already-seen remote event for forwarding to connected peers.
+  void relay_event(const EventEnvelope& event);
+  // Backing store for gossip: ids it knows are never requested, and GetData
+  // is answered from it before falling back to recently published events.
+  void set_event_lookup(EventLookup lookup);
+  // Seeds the reconciliation index and the seen filter with events already
+  // held in the store.
+  void index_events(std::span<const EventEnvelope> events);
+  // Local chain served to peers that bootstrap headers-first. Its genesis is
+  // also what a fresh node checks peers' header chains against.
+  void set_chain_lookup(ChainLookup lookup);
+  void configure_initial_sync(InitialSyncConfig config);
+  // Resizes the seen-id filter; ids remembered so far are dropped.
+  void configure_seen_filter(RollingBloomConfig config);
+  // Whether to offer the shared-dictionary frame compression in Hello; takes
+  // effect for links opened afterwards.
+  void set_compression(bool enabled);
+  // Transport created by each start(); TCP when unset. Lets a simulation run
+  // nodes over in-process links.
+  void set_transport_factory(TransportFactory factory);
+  // Announces blocks of `chain` confirmed since the previous call as compact
+  // blocks to every connected peer. The first call after start() only notes
+  // where the confirmed prefix ends.
+  void announce_confirmed_blocks(std::span<const Store::BlockRecord> chain);
+
+  // Dials missing peers, handles frames read since the last tick (pumping the
+  // transport once when no network thread runs) and announces whatever is
+  // left in the outbound ring. Returns the events published since the last
+  // tick.
   std::vector<EventEnvelope> sync_tick();
+  // Events decoded from peers, oldest first and at most `max_count`; the
+  // caller verifies and ingests them. While more than
+  // kMaxReceivedBacklog wait here, sync_tick() stops handling frames and
+  // the transport stops reading, so peers are slowed down by TCP.
+  std::vector<EventEnvelope> take_received_events(std::size_t max_count = std::numeric_limits<std::size_t>::max());
+  // Bodies of blocks verified against the header chain during initial sync,
+  // in chain order. They predate this node and bypass the past-drift window.
+  std::vector<EventEnvelope> take_synced_events();
+  [[nodiscard]] InitialSyncStats initial_sync_stats() const;
 
   [[nodiscard]] NodeRuntimeStats runtime_status() const;
-  [[nodiscard]] std::string peers_dat_path() const { return peers_dat_path_; }
+  [[nodiscard]] std::string peers_dat_path() const;
 
 private:
+  struct PeerLink {
+    std::string endpoint;  // set for links we dialed
+    // Peer table key: the dialed endpoint, or the listener an inbound peer
+    // advertised in its hello.
+    std::string address;
+    std::chrono::steady_clock::time_point opened_at{};
+    std::string cid;
+    bool handshaken = false;
+    bool compressed = false;  // both hellos named the same dictionary
+    // Ids this peer announced or was sent; never announced back to it.
+    std::unordered_set<std::string> known;
+    std::vector<std::string> pending_inventory;
+    std::uint64_t remote_event_count = 0;
+  };
+
+  struct OutboundEvent {
+    EventEnvelope event;
+    bool relayed = false;  // remote event being forwarded; skips local dedupe
+  };
+
+  struct PendingCompactBlock {
+    PeerId peer = 0;
+    CompactBlockAssembly assembly;
+    std::uint64_t requested_tick = 0;
+    bool refetched = false;  // local matches already dropped once
+  };
+
+  struct InFlightRequest {
+    PeerId peer = 0;
+    std::uint64_t requested_tick = 0;
+    std::chrono::steady_clock::time_point requested_at{};
+  };
+
   static std::string trim(std::string_view text);
   static bool is_comment_or_empty(std::string_view line);
 
-  bool running_ = false;
+  // Takes the node lock; wakes the network thread first so it lets go of
+  // the lock promptly.
+  [[nodiscard]] std::unique_lock<std::mutex> lock_state() const;
+  void network_loop();
+  // Polls the transport and stashes the result for the next sync_tick().
+  void poll_transport(int timeout_ms);
+  void handle_poll(TransportPollResult polled);
+  void drain_outbound();
+  void dial_missing_peers();
+  // Records misbehavior against the peer's table entry and drops the link.
+  void penalize(PeerId peer, std::int32_t points);
+  // Handshaken peers, best scored first.
+  [[nodiscard]] std::vector<PeerId> ranked_peers() const;
+  void save_peer_table() const;
+  void handle_frame(const TransportFrame& frame);
+  void handle_hello(PeerId peer, PeerLink& link, std::string_view body);
+  void handle_inventory(PeerId peer, PeerLink& link, std::string_view body);
+  void handle_getdata(PeerId peer, PeerLink& link, std::string_view body);
+  void handle_events(PeerId peer, PeerLink& link, std::string_view body);
+  void handle_range_summary(PeerId peer, PeerLink& link, std::string_view body);
+  void handle_range_ids(PeerId peer, PeerLink& link, std::string_view body);
+  void handle_get_headers(PeerId peer, std::string_view body);
+  void handle_headers(PeerId peer, std::string_view body);
+  void handle_compact_block(PeerId peer, std::string_view body);
+  void handle_get_block_events(PeerId peer, PeerLink& link, std::string_view body);
+  void handle_block_events(PeerId peer, PeerLink& link, std::string_view body);
+  // Verifies a fully filled compact block, handing fetched events to the
+  // caller, or asks for the rest of it.
+  void settle_compact_block(const std::string& block_hash);
+  // Local event ids a compact block's short ids are matched against.
+  [[nodiscard]] std::vector<std::string> compact_candidates(const CompactBlock& block) const;
+  void maybe_begin_initial_sync(PeerId peer, const PeerLink& link);
+  void drive_initial_sync();
+  void send_range_summary(PeerId peer);
+  void request_events(PeerId peer, std::vector<std::string> ids);
+  void send_getdata(PeerId peer, const std::vector<std::string>& ids);
+  void send_hello(PeerId peer);
+  // Sends compressed when the link negotiated it and the frame shrinks.
+  void send_frame(PeerId peer, wire::MessageType type, std::string_view body);
+  void announce(PeerLink& link, const std::string& event_id);
+  void flush_inventory();
+  void remember_recent(const EventEnvelope& event);
+  [[nodiscard]] bool already_seen(const std::string& event_id);
+  [[nodiscard]] bool wants_event(const std::string& event_id);
+  [[nodiscard]] const EventEnvelope* find_event(const std::string& event_id) const;
+  [[nodiscard]] bool cid_connected(std::string_view cid) const;
+
+  mutable std::mutex mutex_;
+  mutable std::atomic<std::size_t> lock_waiters_{0};
+  std::thread network_thread_;
+  std::atomic<bool> network_active_{false};
+  std::atomic<bool> network_stop_{false};
+  util::WakePipe wake_;
+  TransportPollResult pending_poll_;
+  std::unique_ptr<util::MpscRing<OutboundEvent>> outbound_ring_;
+  std::atomic<std::uint64_t> outbound_rejected_{0};
+  // Events drained from the ring since the last sync_tick(), capped at the
+  // ring capacity.
+  std::vector<EventEnvelope> published_;
+
+  std::atomic<bool> running_{false};
   bool alpha_test_mode_ = false;
   std::string network_name_ = "mainnet";
   std::uint16_t p2p_port_ = 0;
   std::string local_cid_;
   ProxyEndpoint endpoint_;
-  std::vector<std::string> peers_;
+  PeerTable peer_table_;
   std::string peers_dat_path_;
 
-  std::unordered_set<std::string> seen_event_ids_;
-  std::vector<EventEnvelope> outbound_queue_;
+  // Bounded memory of stored ids: local events, indexed history and remote
+  // events the service marked after appending them. Positives are confirmed
+  // against the store; misses cost nothing.
+  RollingBloomFilter seen_filter_;
+  std::uint64_t seen_store_checks_ = 0;
+  std::uint64_t seen_false_positives_ = 0;
   std::uint64_t sync_tick_count_ = 0;
+
+  // Created by start() and dropped by stop(), so a stopped node holds no
+  // sockets.
+  std::unique_ptr<IPeerTransport> transport_;
+  TransportFactory transport_factory_;
+  std::string transport_status_;
+  std::unordered_map<PeerId, PeerLink> links_;
+  std::unordered_map<std::string, PeerId> dialed_;
+  std::unordered_map<std::string, std::uint64_t> next_dial_tick_;
+  std::unordered_set<std::string> self_endpoints_;
+  std::unordered_map<std::string, std::string> endpoint_cids_;
+  EventLookup event_lookup_;
+  // Recently published events announced to peers as they handshake, so events
+  // created before a connection came up still reach it.
+  std::deque<EventEnvelope> recent_events_;
+  std::unordered_map<std::string, InFlightRequest> in_flight_;
+  EventSetIndex event_index_;
+  std::vector<EventEnvelope> received_events_;
+  std::uint64_t inventory_announced_ = 0;
+  std::uint64_t events_requested_ = 0;
+  std::uint64_t events_served_ = 0;
+  std::uint64_t reconcile_messages_ = 0;
+  bool compression_enabled_ = true;
+  std::uint64_t frames_compressed_ = 0;
+  std::uint64_t compression_saved_bytes_ = 0;
+  ChainLookup chain_lookup_;
+  InitialSync initial_sync_;
+  bool initial_sync_done_ = false;
+  std::vector<EventEnvelope> synced_events_;
+  // Next block index to announce; unset until the first call after start().
+  std::optional<std::uint64_t> next_block_announce_;
+  std::uint64_t compact_nonce_seed_ = 0;
+  // Recently announced blocks, kept to answer GetBlockEvents.
+  std::deque<Store::BlockRecord> announced_blocks_;
+  std::unordered_map<std::string, PendingCompactBlock> pending_compact_;
+  std::uint64_t compact_blocks_sent_ = 0;
+  std::uint64_t compact_blocks_received_ = 0;
+  std::uint64_t compact_blocks_reconstructed_ = 0;
+  std::uint64_t compact_block_events_fetched_ = 0;
+  std::uint64_t frames_deferred_ = 0;
 };
 
 }  // namespace alpha
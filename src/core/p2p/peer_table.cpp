@@ -0,0 +1,264 @@
+#include "core/p2p/peer_table.hpp"
+
+#include <algorithm>
+#include <cmath>
+#include <filesystem>
+#include <fstream>
+#include <limits>
+#include <sstream>
+
+namespace alpha {
+namespace {
+
+// Weight of a new sample in the moving averages.
+constexpr double kSampleWeight = 0.25;
+// Assumed for peers without a measurement: slow enough that any measured
+// healthy peer wins, fast enough that untried peers are still picked.
+constexpr double kUnmeasuredRttMs = 1000.0;
+constexpr std::string_view kTableHeader = "# got-soup peer table v1";
+
+double blend(double average, double sample) {
+  return average <= 0.0 ? sample : average + kSampleWeight * (sample - average);
+}
+
+}  // namespace
+
+bool PeerTable::add(std::string_view endpoint, bool configured) {
+  if (endpoint.empty()) {
+    return false;
+  }
+  if (PeerRecord* record = find_mutable(endpoint); record != nullptr) {
+    record->configured = record->configured || configured;
+    return false;
+  }
+  records_.emplace(std::string{endpoint}, PeerRecord{.endpoint = std::string{endpoint}, .configured = configured});
+  if (!configured) {
+    evict_learned(endpoint);
+  }
+  return true;
+}
+
+void PeerTable::clear() {
+  records_.clear();
+  selections_ = 0;
+  explorations_ = 0;
+}
+
+bool PeerTable::contains(std::string_view endpoint) const {
+  return records_.contains(endpoint);
+}
+
+const PeerRecord* PeerTable::find(std::string_view endpoint) const {
+  const auto it = records_.find(endpoint);
+  return it == records_.end() ? nullptr : &it->second;
+}
+
+std::vector<std::string> PeerTable::configured_endpoints() const {
+  std::vector<std::string> out;
+  for (const auto& [endpoint, record] : records_) {
+    if (record.configured) {
+      out.push_back(endpoint);
+    }
+  }
+  return out;
+}
+
+void PeerTable::record_attempt(std::string_view endpoint, std::int64_t now_unix) {
+  if (PeerRecord* record = find_mutable(endpoint); record != nullptr) {
+    record->last_attempt_unix = now_unix;
+  }
+}
+
+void PeerTable::record_connected(std::string_view endpoint, std::int64_t now_unix) {
+  if (PeerRecord* record = find_mutable(endpoint); record != nullptr) {
+    ++record->successes;
+    record->failures = 0;
+    record->last_seen_unix = now_unix;
+  }
+}
+
+void PeerTable::record_failure(std::string_view endpoint, std::int64_t now_unix) {
+  if (PeerRecord* record = find_mutable(endpoint); record != nullptr) {
+    ++record->failures;
+    record->last_attempt_unix = std::max(record->last_attempt_unix, now_unix);
+  }
+}
+
+void PeerTable::record_rtt(std::string_view endpoint, double rtt_ms) {
+  if (PeerRecord* record = find_mutable(endpoint); record != nullptr && rtt_ms >= 0.0) {
+    record->rtt_ms = blend(record->rtt_ms, std::max(rtt_ms, 0.01));
+  }
+}
+
+void PeerTable::record_throughput(std::string_view endpoint, std::size_t bytes, double seconds) {
+  if (PeerRecord* record = find_mutable(endpoint); record != nullptr && bytes > 0U) {
+    // Sub-millisecond replies say more about the clock than the link.
+    record->bytes_per_sec = blend(record->bytes_per_sec, static_cast<double>(bytes) / std::max(seconds, 0.001));
+  }
+}
+
+bool PeerTable::record_misbehavior(std::string_view endpoint, std::int32_t points, std::int64_t now_unix) {
+  PeerRecord* record = find_mutable(endpoint);
+  if (record == nullptr) {
+    return false;
+  }
+  record->misbehavior += points;
+  if (record->misbehavior < config_.ban_threshold) {
+    return false;
+  }
+  record->banned_until_unix = now_unix + config_.ban_seconds;
+  record->misbehavior = 0;
+  return true;
+}
+
+bool PeerTable::banned(std::string_view endpoint, std::int64_t now_unix) const {
+  const PeerRecord* record = find(endpoint);
+  return record != nullptr && record->banned_until_unix > now_unix;
+}
+
+double PeerTable::score(std::string_view endpoint, std::int64_t now_unix) const {
+  const PeerRecord* record = find(endpoint);
+  return record == nullptr ? score(PeerRecord{}, now_unix) : score(*record, now_unix);
+}
+
+std::vector<std::string> PeerTable::select(std::size_t count, std::int64_t now_unix,
+                                           const std::function<bool(const PeerRecord&)>& eligible) {
+  std::vector<const PeerRecord*> candidates;
+  for (const auto& [endpoint, record] : records_) {
+    if (record.banned_until_unix <= now_unix && (!eligible || eligible(record))) {
+      candidates.push_back(&record);
+    }
+  }
+  std::vector<std::string> out;
+  if (count == 0 || candidates.empty()) {
+    return out;
+  }
+
+  std::ranges::stable_sort(candidates, [this, now_unix](const PeerRecord* a, const PeerRecord* b) {
+    return score(*a, now_unix) > score(*b, now_unix);
+  });
+  const std::size_t take = std::min(count, candidates.size());
+  for (std::size_t i = 0; i < take; ++i) {
+    out.push_back(candidates[i]->endpoint);
+  }
+
+  ++selections_;
+  if (take < candidates.size() && config_.explore_every != 0 && selections_ % config_.explore_every == 0) {
+    // The left-out peer tried longest ago (never, for fresh ones) takes the
+    // last slot.
+    const auto explore = std::ranges::min_element(
+        candidates.begin() + static_cast<std::ptrdiff_t>(take), candidates.end(),
+        [](const PeerRecord* a, const PeerRecord* b) { return a->last_attempt_unix < b->last_attempt_unix; });
+    out.back() = (*explore)->endpoint;
+    ++explorations_;
+  }
+  return out;
+}
+
+Result PeerTable::load(std::string_view path) {
+  std::ifstream in{std::string{path}};
+  if (!in) {
+    return Result::success("Peer table not found yet; it will be created after first save.");
+  }
+  std::string line;
+  while (std::getline(in, line)) {
+    if (line.empty() || line.front() == '#') {
+      continue;
+    }
+    std::istringstream fields(line);
+    PeerRecord loaded;
+    if (!(fields >> loaded.endpoint >> loaded.rtt_ms >> loaded.bytes_per_sec >> loaded.successes >>
+          loaded.failures >> loaded.last_seen_unix >> loaded.last_attempt_unix >> loaded.misbehavior >>
+          loaded.banned_until_unix)) {
+      continue;
+    }
+    (void)add(loaded.endpoint, false);
+    PeerRecord* record = find_mutable(loaded.endpoint);
+    if (record == nullptr) {
+      continue;
+    }
+    loaded.configured = record->configured;
+    *record = std::move(loaded);
+  }
+  return Result::success("Loaded peer table.");
+}
+
+Result PeerTable::save(std::string_view path) const {
+  if (path.empty()) {
+    return Result::failure("Peer table save failed: empty path.");
+  }
+  const std::filesystem::path file_path{std::string{path}};
+  std::error_code ec;
+  if (file_path.has_parent_path()) {
+    std::filesystem::create_directories(file_path.parent_path(), ec);
+    if (ec) {
+      return Result::failure("Unable to create peer table directory: " + ec.message());
+    }
+  }
+  std::ofstream out(file_path, std::ios::out | std::ios::trunc);
+  if (!out) {
+    return Result::failure("Unable to write peer table file.");
+  }
+  out << kTableHeader << '\n';
+  out << "# endpoint rtt_ms bytes_per_sec successes failures last_seen last_attempt misbehavior banned_until\n";
+  for (const auto& [endpoint, record] : records_) {
+    out << endpoint << ' ' << record.rtt_ms << ' ' << record.bytes_per_sec << ' ' << record.successes << ' '
+        << record.failures << ' ' << record.last_seen_unix << ' ' << record.last_attempt_unix << ' '
+        << record.misbehavior << ' ' << record.banned_until_unix << '\n';
+  }
+  if (!out.good()) {
+    return Result::failure("Failed writing peer table file.");
+  }
+  return Result::success("Saved peer table.");
+}
+
+PeerTableStats PeerTable::stats(std::int64_t now_unix) const {
+  PeerTableStats out{.entries = records_.size(), .explorations = explorations_};
+  for (const auto& [endpoint, record] : records_) {
+    out.configured += record.configured ? 1U : 0U;
+    out.banned += record.banned_until_unix > now_unix ? 1U : 0U;
+  }
+  return out;
+}
+
+PeerRecord* PeerTable::find_mutable(std::string_view endpoint) {
+  const auto it = records_.find(endpoint);
+  return it == records_.end() ? nullptr : &it->second;
+}
+
+double PeerTable::score(const PeerRecord& record, std::int64_t now_unix) const {
+  if (record.banned_until_unix > now_unix) {
+    return -std::numeric_limits<double>::infinity();
+  }
+  const double rtt = record.rtt_ms > 0.0 ? record.rtt_ms : kUnmeasuredRttMs;
+  // Latency dominates for gossip; throughput (log KiB/s) separates peers
+  // with similar latency during bulk sync.
+  double value = 1000.0 / (50.0 + rtt) + std::log2(1.0 + record.bytes_per_sec / 1024.0);
+  value /= 1.0 + static_cast<double>(record.failures);
+  return value - static_cast<double>(record.misbehavior) / 10.0;
+}
+
+void PeerTable::evict_learned(std::string_view keep) {
+  std::size_t learned = 0;
+  for (const auto& [endpoint, record] : records_) {
+    learned += record.configured ? 0U : 1U;
+  }
+  while (learned > config_.max_learned) {
+    // Drop the learned peer with the most consecutive failures, oldest first.
+    auto worst = records_.end();
+    for (auto it = records_.begin(); it != records_.end(); ++it) {
+      if (it->second.configured || it->first == keep) {
+        continue;
+      }
+      if (worst == records_.end() || it->second.failures > worst->second.failures ||
+          (it->second.failures == worst->second.failures &&
+           it->second.last_seen_unix < worst->second.last_seen_unix)) {
+        worst = it;
+      }
+    }
+    records_.erase(worst);
+    --learned;
+  }
+}
+
+}  // namespace alpha
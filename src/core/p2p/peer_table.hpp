@@ -0,0 +1,99 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <map>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include "core/model/types.hpp"
+
+namespace alpha {
+
+struct PeerRecord {
+  std::string endpoint;
+  // Listed in peers.dat, a seed or added by hand; learned peers are only
+  // kept in the table file.
+  bool configured = false;
+  double rtt_ms = 0.0;  // moving average, 0 until measured
+  double bytes_per_sec = 0.0;
+  std::uint32_t successes = 0;
+  std::uint32_t failures = 0;  // consecutive, reset by a successful handshake
+  std::int64_t last_seen_unix = 0;
+  std::int64_t last_attempt_unix = 0;
+  std::int32_t misbehavior = 0;
+  std::int64_t banned_until_unix = 0;
+};
+
+struct PeerTableConfig {
+  std::size_t max_learned = 1024;
+  std::int32_t ban_threshold = 100;
+  std::int64_t ban_seconds = 24 * 60 * 60;
+  // Every Nth selection gives one slot to the least recently tried peer so
+  // untested peers get a chance to beat the incumbents.
+  std::uint64_t explore_every = 4;
+};
+
+struct PeerTableStats {
+  std::size_t entries = 0;
+  std::size_t configured = 0;
+  std::size_t banned = 0;
+  std::uint64_t explorations = 0;
+};
+
+// Known peers keyed by endpoint with the quality data used to rank them:
+// round-trip time and throughput as moving averages, consecutive failures
+// and a misbehavior score that bans the peer once it crosses the threshold.
+// The table is saved next to peers.dat, which keeps its one-endpoint-per-line
+// format.
+class PeerTable {
+public:
+  explicit PeerTable(PeerTableConfig config = {}) : config_(config) {}
+
+  // Returns true when the endpoint is new. Adding a learned peer never
+  // downgrades a configured one.
+  bool add(std::string_view endpoint, bool configured);
+  void clear();
+  [[nodiscard]] bool contains(std::string_view endpoint) const;
+  [[nodiscard]] const PeerRecord* find(std::string_view endpoint) const;
+  [[nodiscard]] std::size_t size() const { return records_.size(); }
+  [[nodiscard]] std::vector<std::string> configured_endpoints() const;
+
+  void record_attempt(std::string_view endpoint, std::int64_t now_unix);
+  void record_connected(std::string_view endpoint, std::int64_t now_unix);
+  void record_failure(std::string_view endpoint, std::int64_t now_unix);
+  void record_rtt(std::string_view endpoint, double rtt_ms);
+  void record_throughput(std::string_view endpoint, std::size_t bytes, double seconds);
+  // Returns true when the peer is banned as a result.
+  bool record_misbehavior(std::string_view endpoint, std::int32_t points, std::int64_t now_unix);
+  [[nodiscard]] bool banned(std::string_view endpoint, std::int64_t now_unix) const;
+
+  // Higher is better; banned peers score lowest. Unknown endpoints get the
+  // score of an untested peer.
+  [[nodiscard]] double score(std::string_view endpoint, std::int64_t now_unix) const;
+  // Up to `count` eligible, unbanned peers, best first, with one slot given
+  // to exploration every `explore_every` calls.
+  std::vector<std::string> select(std::size_t count, std::int64_t now_unix,
+                                  const std::function<bool(const PeerRecord&)>& eligible);
+
+  // Missing files load as an empty table.
+  Result load(std::string_view path);
+  Result save(std::string_view path) const;
+
+  [[nodiscard]] PeerTableStats stats(std::int64_t now_unix) const;
+
+private:
+  PeerRecord* find_mutable(std::string_view endpoint);
+  [[nodiscard]] double score(const PeerRecord& record, std::int64_t now_unix) const;
+  // Trims learned peers to the cap, never dropping `keep`.
+  void evict_learned(std::string_view keep);
+
+  PeerTableConfig config_;
+  std::map<std::string, PeerRecord, std::less<>> records_;
+  std::uint64_t selections_ = 0;
+  std::uint64_t explorations_ = 0;
+};
+
+}  // namespace alpha
@@ -0,0 +1,93 @@
+#include "core/p2p/reconcile.hpp"
+
+#include <algorithm>
+
+#include "core/util/hash.hpp"
+
+namespace alpha {
+namespace {
+
+void add_id(RangeDigest& digest, std::string_view event_id) {
+  digest.sum_a += util::seeded_hash64(event_id, 0);
+  digest.sum_b += util::seeded_hash64(event_id, 0x5bd1e9955bd1e995ULL);
+  ++digest.count;
+}
+
+void add_digest(RangeDigest& into, const RangeDigest& other) {
+  into.sum_a += other.sum_a;
+  into.sum_b += other.sum_b;
+  into.count += other.count;
+}
+
+}  // namespace
+
+std::int64_t EventSetIndex::bucket_for(std::int64_t unix_ts) {
+  return std::clamp(unix_ts / kBucketSeconds, kMinBucket, kMaxBucket - 1);
+}
+
+bool EventSetIndex::insert(std::string_view event_id, std::int64_t unix_ts) {
+  if (event_id.empty()) {
+    return false;
+  }
+  Bucket& bucket = buckets_[bucket_for(unix_ts)];
+  if (std::ranges::find(bucket.ids, event_id) != bucket.ids.end()) {
+    return false;
+  }
+  bucket.ids.emplace_back(event_id);
+  add_id(bucket.digest, event_id);
+  ++size_;
+  return true;
+}
+
+void EventSetIndex::insert_all(std::span<const EventEnvelope> events) {
+  for (const auto& event : events) {
+    (void)insert(event.event_id, event.unix_ts);
+  }
+}
+
+void EventSetIndex::clear() {
+  buckets_.clear();
+  size_ = 0;
+}
+
+RangeDigest EventSetIndex::digest(std::int64_t lo, std::int64_t hi) const {
+  RangeDigest out;
+  for (auto it = buckets_.lower_bound(lo); it != buckets_.end() && it->first < hi; ++it) {
+    add_digest(out, it->second.digest);
+  }
+  return out;
+}
+
+std::vector<std::string> EventSetIndex::ids(std::int64_t lo, std::int64_t hi) const {
+  std::vector<std::string> out;
+  for (auto it = buckets_.lower_bound(lo); it != buckets_.end() && it->first < hi; ++it) {
+    out.insert(out.end(), it->second.ids.begin(), it->second.ids.end());
+  }
+  return out;
+}
+
+std::vector<DigestRange> EventSetIndex::split(std::int64_t lo, std::int64_t hi, std::size_t fanout) const {
+  const RangeDigest whole = digest(lo, hi);
+  if (fanout < 2U || whole.count == 0 || hi - lo < 2) {
+    return {{.lo = lo, .hi = hi, .digest = whole}};
+  }
+
+  // Cut after the bucket where the running count crosses each quantile, so
+  // dense recent history and sparse old history split equally well.
+  std::vector<DigestRange> out;
+  const std::uint64_t share = (static_cast<std::uint64_t>(whole.count) + fanout - 1U) / fanout;
+  DigestRange current{.lo = lo, .hi = hi};
+  for (auto it = buckets_.lower_bound(lo); it != buckets_.end() && it->first < hi; ++it) {
+    add_digest(current.digest, it->second.digest);
+    const std::int64_t cut = it->first + 1;
+    if (current.digest.count >= share && cut < hi && out.size() + 1U < fanout) {
+      current.hi = cut;
+      out.push_back(current);
+      current = {.lo = cut, .hi = hi};
+    }
+  }
+  out.push_back(current);
+  return out;
+}
+
+}  // namespace alpha
@@ -0,0 +1,67 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <map>
+#include <span>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include "core/model/types.hpp"
+
+namespace alpha {
+
+// Order-independent digest of a set of event ids: two 64-bit sums of
+// differently seeded id hashes plus the element count. Sums make the digest
+// incremental and let range digests be added up bucket by bucket.
+struct RangeDigest {
+  std::uint64_t sum_a = 0;
+  std::uint64_t sum_b = 0;
+  std::uint32_t count = 0;
+
+  bool operator==(const RangeDigest&) const = default;
+};
+
+// Half-open range [lo, hi) of time buckets with the sender's digest.
+struct DigestRange {
+  std::int64_t lo = 0;
+  std::int64_t hi = 0;
+  RangeDigest digest;
+};
+
+// Event ids bucketed by timestamp for range-based set reconciliation. Block
+// indexes are assigned on arrival and differ between nodes, so buckets are
+// keyed on the event's own unix_ts instead; every node agrees on them.
+// Ranges are compared top-down and only mismatching ranges are split, so a
+// reconnect costs bandwidth proportional to the difference, not the history.
+class EventSetIndex {
+public:
+  static constexpr std::int64_t kBucketSeconds = 150;
+  static constexpr std::int64_t kMinBucket = 0;
+  static constexpr std::int64_t kMaxBucket = std::int64_t{1} << 40;
+
+  [[nodiscard]] static std::int64_t bucket_for(std::int64_t unix_ts);
+
+  bool insert(std::string_view event_id, std::int64_t unix_ts);
+  void insert_all(std::span<const EventEnvelope> events);
+  void clear();
+
+  [[nodiscard]] RangeDigest digest(std::int64_t lo, std::int64_t hi) const;
+  [[nodiscard]] std::vector<std::string> ids(std::int64_t lo, std::int64_t hi) const;
+  // Partitions [lo, hi) into up to `fanout` ranges holding roughly equal
+  // shares of the local ids. Returns a single range when it cannot split.
+  [[nodiscard]] std::vector<DigestRange> split(std::int64_t lo, std::int64_t hi, std::size_t fanout) const;
+  [[nodiscard]] std::size_t size() const { return size_; }
+
+private:
+  struct Bucket {
+    RangeDigest digest;
+    std::vector<std::string> ids;
+  };
+
+  std::map<std::int64_t, Bucket> buckets_;
+  std::size_t size_ = 0;
+};
+
+}  // namespace alpha
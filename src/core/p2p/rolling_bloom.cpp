@@ -0,0 +1,91 @@
+#include "core/p2p/rolling_bloom.hpp"
+
+#include <algorithm>
+#include <cmath>
+#include <numbers>
+#include <random>
+
+#include "core/util/hash.hpp"
+
+namespace alpha {
+
+RollingBloomFilter::RollingBloomFilter(RollingBloomConfig config) : config_(config) {
+  // Per generation: m bits at rate p/2 hold n = m * ln(2)^2 / -ln(p/2) keys
+  // with k = -log2(p/2) hash functions.
+  const double rate = std::clamp(config_.false_positive_rate, 1e-9, 0.5) / 2.0;
+  const std::size_t words = std::max<std::size_t>(1U, config_.max_bytes / (2U * sizeof(std::uint64_t)));
+  bits_ = static_cast<std::uint64_t>(words) * 64U;
+  const double ln2 = std::numbers::ln2;
+  window_ = std::max<std::size_t>(1U, static_cast<std::size_t>(static_cast<double>(bits_) * ln2 * ln2 / -std::log(rate)));
+  hash_functions_ = std::clamp(static_cast<std::uint32_t>(std::lround(-std::log2(rate))), 1U, 32U);
+  for (auto& generation : generations_) {
+    generation.words.assign(words, 0);
+  }
+  seed_ = (static_cast<std::uint64_t>(std::random_device{}()) << 32U) | std::random_device{}();
+}
+
+template <typename Fn>
+void RollingBloomFilter::for_each_bit(std::string_view key, Fn&& fn) const {
+  // Double hashing: bit_i = h1 + i * h2 over one seeded 64-bit hash. `fn`
+  // returns false to stop early.
+  const std::uint64_t h1 = util::seeded_hash64(key, seed_);
+  const std::uint64_t h2 = util::mix64(h1 ^ seed_) | 1U;
+  for (std::uint32_t i = 0; i < hash_functions_; ++i) {
+    if (!fn((h1 + i * h2) % bits_)) {
+      return;
+    }
+  }
+}
+
+void RollingBloomFilter::insert(std::string_view key) {
+  Generation* current = &generations_[current_];
+  if (current->entries >= window_) {
+    current_ ^= 1U;
+    current = &generations_[current_];
+    std::ranges::fill(current->words, 0);
+    current->entries = 0;
+    ++rotations_;
+  }
+  for_each_bit(key, [current](std::uint64_t bit) {
+    current->words[bit >> 6U] |= 1ULL << (bit & 63U);
+    return true;
+  });
+  ++current->entries;
+}
+
+bool RollingBloomFilter::contains(std::string_view key) const {
+  for (const auto& generation : generations_) {
+    if (generation.entries == 0) {
+      continue;
+    }
+    bool all_set = true;
+    for_each_bit(key, [&](std::uint64_t bit) {
+      all_set = (generation.words[bit >> 6U] & (1ULL << (bit & 63U))) != 0;
+      return all_set;
+    });
+    if (all_set) {
+      return true;
+    }
+  }
+  return false;
+}
+
+void RollingBloomFilter::clear() {
+  for (auto& generation : generations_) {
+    std::ranges::fill(generation.words, 0);
+    generation.entries = 0;
+  }
+  current_ = 0;
+}
+
+RollingBloomStats RollingBloomFilter::stats() const {
+  return {
+      .bytes = (generations_[0].words.size() + generations_[1].words.size()) * sizeof(std::uint64_t),
+      .window = window_,
+      .entries = generations_[0].entries + generations_[1].entries,
+      .hash_functions = hash_functions_,
+      .rotations = rotations_,
+  };
+}
+
+}  // namespace alpha
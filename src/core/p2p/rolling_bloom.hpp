@@ -0,0 +1,62 @@
+#pragma once
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <string_view>
+#include <vector>
+
+namespace alpha {
+
+struct RollingBloomConfig {
+  std::size_t max_bytes = 1U << 20U;
+  // Target rate for the whole filter; each generation gets half of it.
+  double false_positive_rate = 0.0001;
+};
+
+struct RollingBloomStats {
+  std::size_t bytes = 0;
+  // Insertions the filter is guaranteed to remember; up to twice as many
+  // are held while the older generation is still live.
+  std::size_t window = 0;
+  std::size_t entries = 0;
+  std::uint32_t hash_functions = 0;
+  std::uint64_t rotations = 0;
+};
+
+// Fixed-memory "probably seen" set over the most recent insertions. Two
+// Bloom generations alternate: inserts go to the current one, and once it
+// holds `window` keys the older one is wiped and becomes current. Lookups
+// check both, so a key is remembered for at least `window` insertions.
+// Hashes are salted per instance so peers cannot aim ids at our bits.
+class RollingBloomFilter {
+public:
+  explicit RollingBloomFilter(RollingBloomConfig config = {});
+
+  void insert(std::string_view key);
+  [[nodiscard]] bool contains(std::string_view key) const;
+  void clear();
+
+  [[nodiscard]] const RollingBloomConfig& config() const { return config_; }
+  [[nodiscard]] RollingBloomStats stats() const;
+
+private:
+  struct Generation {
+    std::vector<std::uint64_t> words;
+    std::size_t entries = 0;
+  };
+
+  template <typename Fn>
+  void for_each_bit(std::string_view key, Fn&& fn) const;
+
+  RollingBloomConfig config_;
+  std::array<Generation, 2> generations_;
+  std::size_t current_ = 0;
+  std::uint64_t bits_ = 0;
+  std::size_t window_ = 0;
+  std::uint32_t hash_functions_ = 1;
+  std::uint64_t seed_ = 0;
+  std::uint64_t rotations_ = 0;
+};
+
+}  // namespace alpha
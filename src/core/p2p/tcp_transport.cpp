@@ -0,0 +1,582 @@
+#include "core/p2p/tcp_transport.hpp"
+
+#include <algorithm>
+#include <array>
+
+#include "core/util/poller.hpp"
+#include "core/util/socket.hpp"
+
+#ifndef _WIN32
+#include <cerrno>
+#include <sys/socket.h>
+#include <unistd.h>
+#endif
+
+namespace alpha {
+
+#ifndef _WIN32
+
+namespace {
+
+// Poller tokens reserved for the listening socket and the wake pipe; peer
+// ids start at 1.
+constexpr PeerId kListenToken = 0;
+constexpr PeerId kWakeToken = ~PeerId{0};
+constexpr std::string_view kProxyEndpointLabel = "socks-proxy";
+// Isolation username; the password carries the destination.
+constexpr std::string_view kSocksUsername = "got-soup";
+constexpr std::uint32_t kMaxWarmBackoffShift = 6;
+
+std::uint32_t read_be32(const char* data) {
+  std::uint32_t value = 0;
+  for (int i = 0; i < 4; ++i) {
+    value = (value << 8U) | static_cast<unsigned char>(data[i]);
+  }
+  return value;
+}
+
+}  // namespace
+
+TcpTransport::TcpTransport() = default;
+
+TcpTransport::~TcpTransport() {
+  stop();
+}
+
+Result TcpTransport::start(const TcpTransportConfig& config) {
+  if (running_) {
+    return Result::failure("P2P transport already running.");
+  }
+  config_ = config;
+  poller_ = std::make_unique<util::Poller>();
+  if (!poller_->valid()) {
+    poller_.reset();
+    return Result::failure("P2P transport failed: unable to create poller.");
+  }
+  stats_ = {};
+
+  if (config_.listen) {
+    const Result listened = util::listen_tcp(config_.bind_host, config_.port, 64, listen_fd_);
+    if (!listened.ok) {
+      poller_.reset();
+      return Result::failure("P2P transport failed: " + listened.message);
+    }
+    util::set_non_blocking(listen_fd_);
+    bound_port_ = util::local_port(listen_fd_);
+    poller_->add(listen_fd_, kListenToken, false);
+    stats_.listening = true;
+    stats_.bound_port = bound_port_;
+  }
+
+  running_ = true;
+  return Result::success("P2P transport listening on " + config_.bind_host + ":" + std::to_string(bound_port_));
+}
+
+void TcpTransport::stop() {
+  for (auto& [peer, connection] : connections_) {
+    util::close_socket(connection.fd);
+  }
+  connections_.clear();
+  pending_disconnects_.clear();
+  warm_pool_.clear();
+  proxy_failures_ = 0;
+  next_warm_attempt_ = {};
+  util::close_socket(listen_fd_);
+  poller_.reset();
+  wake_ = nullptr;
+  running_ = false;
+  bound_port_ = 0;
+  stats_.listening = false;
+  stats_.bound_port = 0;
+}
+
+Result TcpTransport::dial(std::string_view endpoint, PeerId& out_peer) {
+  out_peer = 0;
+  if (!running_) {
+    return Result::failure("P2P transport is not running.");
+  }
+  if (connections_.size() >= config_.max_connections) {
+    return Result::failure("P2P transport connection limit reached.");
+  }
+  std::string host;
+  std::uint16_t port = 0;
+  if (!util::split_host_port(endpoint, host, port)) {
+    return Result::failure("Invalid peer endpoint: " + std::string{endpoint});
+  }
+  if (config_.socks_proxy.has_value()) {
+    return dial_proxied(endpoint, host, port, out_peer);
+  }
+  int fd = util::kInvalidSocket;
+  const Result connected = util::connect_tcp(host, port, true, fd);
+  if (!connected.ok) {
+    ++stats_.dial_failures;
+    return connected;
+  }
+  util::set_no_delay(fd);
+  out_peer = add_connection(fd, std::string{endpoint}, true, true);
+  if (out_peer == 0) {
+    util::close_socket(fd);
+    ++stats_.dial_failures;
+    return Result::failure("P2P transport failed to register connection.");
+  }
+  return Result::success("Dialing " + std::string{endpoint});
+}
+
+bool TcpTransport::send(PeerId peer, wire::MessageType type, std::string_view body) {
+  const auto it = connections_.find(peer);
+  if (it == connections_.end()) {
+    return false;
+  }
+  Connection& connection = it->second;
+  if (connection.outbox.size() - connection.outbox_offset + body.size() > config_.max_write_buffer_bytes) {
+    close_peer(peer, nullptr);
+    return false;
+  }
+  wire::append_frame(connection.outbox, type, body);
+  ++stats_.frames_out;
+  if (connection.connecting) {
+    return true;
+  }
+  if (!flush_peer(peer, connection)) {
+    close_peer(peer, nullptr);
+    return false;
+  }
+  return true;
+}
+
+void TcpTransport::disconnect(PeerId peer) {
+  close_peer(peer, nullptr);
+}
+
+TransportPollResult TcpTransport::poll(int timeout_ms) {
+  TransportPollResult out;
+  out.disconnected = std::move(pending_disconnects_);
+  pending_disconnects_.clear();
+  if (!running_) {
+    return out;
+  }
+  top_up_warm_pool();
+
+  for (const util::PollEvent& event : poller_->wait(timeout_ms)) {
+    if (event.token == kListenToken) {
+      accept_peers(out);
+      continue;
+    }
+    if (event.token == kWakeToken) {
+      wake_->drain();
+      continue;
+    }
+    const auto it = connections_.find(event.token);
+    if (it == connections_.end()) {
+      continue;
+    }
+    const PeerId peer = it->first;
+    Connection& connection = it->second;
+
+    if (connection.connecting) {
+      int error = 0;
+      socklen_t len = sizeof(error);
+      if (::getsockopt(connection.fd, SOL_SOCKET, SO_ERROR, &error, &len) != 0) {
+        error = errno;
+      }
+      if (error != 0 || event.failed) {
+        stats_.dial_failures += connection.warm ? 0U : 1U;
+        close_peer(peer, &out);
+        continue;
+      }
+      if (!event.writable && !event.readable) {
+        continue;
+      }
+      connection.connecting = false;
+      if (!connection.socks) {
+        out.connected.push_back(peer);
+      }
+    }
+
+    if (event.failed || ((event.readable) && !read_peer(peer, connection, out))) {
+      close_peer(peer, &out);
+      continue;
+    }
+    if (!flush_peer(peer, connection)) {
+      close_peer(peer, &out);
+    }
+  }
+  return out;
+}
+
+void TcpTransport::watch_wake_pipe(const util::WakePipe* wake) {
+  if (!running_ || wake_ != nullptr || wake == nullptr || wake->read_fd() < 0) {
+    return;
+  }
+  if (poller_->add(wake->read_fd(), kWakeToken, false)) {
+    wake_ = wake;
+  }
+}
+
+std::string TcpTransport::peer_endpoint(PeerId peer) const {
+  const auto it = connections_.find(peer);
+  return it == connections_.end() ? std::string{} : it->second.endpoint;
+}
+
+std::vector<PeerId> TcpTransport::peer_ids() const {
+  std::vector<PeerId> out;
+  out.reserve(connections_.size());
+  for (const auto& [peer, connection] : connections_) {
+    if (!connection.connecting && !connection.socks) {
+      out.push_back(peer);
+    }
+  }
+  return out;
+}
+
+TcpTransportStats TcpTransport::stats() const {
+  TcpTransportStats out = stats_;
+  out.connections = connections_.size();
+  out.socks_warm = warm_pool_.size();
+  return out;
+}
+
+PeerId TcpTransport::add_connection(int fd, std::string endpoint, bool outbound, bool connecting) {
+  const PeerId peer = next_peer_id_++;
+  if (!poller_->add(fd, peer, connecting)) {
+    return 0;
+  }
+  connections_.emplace(peer, Connection{
+                                 .fd = fd,
+                                 .endpoint = std::move(endpoint),
+                                 .outbound = outbound,
+                                 .connecting = connecting,
+                                 .want_write = connecting,
+                             });
+  return peer;
+}
+
+Result TcpTransport::dial_proxied(std::string_view endpoint, const std::string& host, std::uint16_t port,
+                                  PeerId& out_peer) {
+  Socks5Request target{.host = host, .port = port};
+  if (config_.socks_isolate_peers) {
+    target.username = std::string{kSocksUsername};
+    target.password = std::string{endpoint};
+  }
+  PeerId peer = take_warm_connection();
+  if (peer != 0) {
+    ++stats_.socks_warm_hits;
+  } else {
+    peer = open_proxy_connection();
+  }
+  if (peer == 0) {
+    ++stats_.dial_failures;
+    return Result::failure("Unable to reach SOCKS5 proxy for " + std::string{endpoint});
+  }
+  Connection& connection = connections_.at(peer);
+  const std::string request = connection.socks->request(target);
+  if (request.empty()) {
+    connection.warm = false;
+    close_peer(peer, nullptr);
+    ++stats_.dial_failures;
+    return Result::failure("Peer endpoint does not fit a SOCKS5 request: " + std::string{endpoint});
+  }
+  connection.endpoint = std::string{endpoint};
+  connection.outbox.append(request);
+  if (!connection.connecting && !flush_peer(peer, connection)) {
+    close_peer(peer, nullptr);
+    ++stats_.dial_failures;
+    return Result::failure("SOCKS5 proxy connection lost while dialing " + std::string{endpoint});
+  }
+  out_peer = peer;
+  return Result::success("Dialing " + std::string{endpoint} + " through SOCKS5 proxy");
+}
+
+PeerId TcpTransport::open_proxy_connection() {
+  int fd = util::kInvalidSocket;
+  if (!util::connect_tcp(config_.socks_proxy->host, config_.socks_proxy->port, true, fd).ok) {
+    return 0;
+  }
+  util::set_no_delay(fd);
+  const PeerId peer = add_connection(fd, std::string{kProxyEndpointLabel}, true, true);
+  if (peer == 0) {
+    util::close_socket(fd);
+    return 0;
+  }
+  Connection& connection = connections_.at(peer);
+  connection.socks = std::make_unique<Socks5Handshake>(config_.socks_isolate_peers);
+  connection.outbox = connection.socks->greeting();
+  return peer;
+}
+
+PeerId TcpTransport::take_warm_connection() {
+  // Greeted connections first: they skip straight to the request.
+  const auto greeted = std::ranges::find_if(warm_pool_, [this](PeerId peer) {
+    return connections_.at(peer).socks->greeted();
+  });
+  const auto pick = greeted != warm_pool_.end() ? greeted : warm_pool_.begin();
+  if (pick == warm_pool_.end()) {
+    return 0;
+  }
+  const PeerId peer = *pick;
+  warm_pool_.erase(pick);
+  connections_.at(peer).warm = false;
+  return peer;
+}
+
+void TcpTransport::top_up_warm_pool() {
+  if (!config_.socks_proxy.has_value() || warm_pool_.size() >= config_.socks_warm_connections ||
+      std::chrono::steady_clock::now() < next_warm_attempt_) {
+    return;
+  }
+  while (warm_pool_.size() < config_.socks_warm_connections &&
+         connections_.size() < config_.max_connections) {
+    const PeerId peer = open_proxy_connection();
+    if (peer == 0) {
+      proxy_failures_ = std::min(proxy_failures_ + 1U, kMaxWarmBackoffShift);
+      next_warm_attempt_ = std::chrono::steady_clock::now() + (std::chrono::seconds{1} * (1U << proxy_failures_));
+      return;
+    }
+    connections_.at(peer).warm = true;
+    warm_pool_.push_back(peer);
+  }
+}
+
+bool TcpTransport::advance_socks(PeerId peer, Connection& connection, TransportPollResult& out) {
+  const std::size_t used =
+      connection.socks->feed(std::string_view{connection.inbox}.substr(connection.inbox_offset));
+  connection.inbox_offset += used;
+  if (connection.socks->failed()) {
+    ++stats_.socks_failures;
+    return false;
+  }
+  if (connection.socks->greeted()) {
+    proxy_failures_ = 0;
+  }
+  if (connection.warm && connection.inbox_offset < connection.inbox.size()) {
+    // Nothing but the method reply is expected before a request goes out.
+    ++stats_.socks_failures;
+    return false;
+  }
+  if (connection.socks->done()) {
+    connection.socks.reset();
+    ++stats_.socks_handshakes;
+    out.connected.push_back(peer);
+  }
+  return true;
+}
+
+void TcpTransport::accept_peers(TransportPollResult& out) {
+  while (true) {
+    sockaddr_storage addr{};
+    socklen_t len = sizeof(addr);
+    int fd = ::accept(listen_fd_, reinterpret_cast<sockaddr*>(&addr), &len);
+    if (fd < 0) {
+      return;
+    }
+    if (connections_.size() >= config_.max_connections || !util::set_non_blocking(fd)) {
+      util::close_socket(fd);
+      continue;
+    }
+    util::set_no_delay(fd);
+    const PeerId peer = add_connection(fd, "inbound", false, false);
+    if (peer == 0) {
+      util::close_socket(fd);
+      continue;
+    }
+    out.connected.push_back(peer);
+  }
+}
+
+bool TcpTransport::read_peer(PeerId peer, Connection& connection, TransportPollResult& out) {
+  std::array<char, 16384> buffer{};
+  while (true) {
+    const ssize_t n = ::recv(connection.fd, buffer.data(), buffer.size(), 0);
+    if (n == 0) {
+      // A proxy refusing a CONNECT replies and hangs up in one go.
+      if (connection.socks && advance_socks(peer, connection, out) && connection.socks) {
+        ++stats_.socks_failures;
+      }
+      return false;
+    }
+    if (n < 0) {
+      if (errno == EINTR) {
+        continue;
+      }
+      if (errno == EAGAIN || errno == EWOULDBLOCK) {
+        break;
+      }
+      return false;
+    }
+    connection.inbox.append(buffer.data(), static_cast<std::size_t>(n));
+    stats_.bytes_in += static_cast<std::uint64_t>(n);
+  }
+
+  if (connection.socks && !advance_socks(peer, connection, out)) {
+    return false;
+  }
+  while (!connection.socks && connection.inbox.size() - connection.inbox_offset >= wire::kFrameHeaderBytes) {
+    const char* head = connection.inbox.data() + connection.inbox_offset;
+    const std::uint32_t length = read_be32(head);
+    if (length == 0 || length > config_.max_frame_bytes) {
+      return false;
+    }
+    if (connection.inbox.size() - connection.inbox_offset < 4U + length) {
+      break;
+    }
+    out.frames.push_back({
+        .peer = peer,
+        .type = static_cast<wire::MessageType>(static_cast<unsigned char>(head[4])),
+        .body = std::string{head + wire::kFrameHeaderBytes, length - 1U},
+    });
+    ++stats_.frames_in;
+    connection.inbox_offset += 4U + length;
+  }
+
+  // Compact once the consumed prefix dominates so the buffer does not creep.
+  if (connection.inbox_offset == connection.inbox.size()) {
+    connection.inbox.clear();
+    connection.inbox_offset = 0;
+  } else if (connection.inbox_offset > connection.inbox.size() / 2U) {
+    connection.inbox.erase(0, connection.inbox_offset);
+    connection.inbox_offset = 0;
+  }
+  return true;
+}
+
+bool TcpTransport::flush_peer(PeerId peer, Connection& connection) {
+  while (connection.outbox_offset < connection.outbox.size()) {
+#ifdef MSG_NOSIGNAL
+    const ssize_t n = ::send(connection.fd, connection.outbox.data() + connection.outbox_offset,
+                             connection.outbox.size() - connection.outbox_offset, MSG_NOSIGNAL);
+#else
+    const ssize_t n = ::send(connection.fd, connection.outbox.data() + connection.outbox_offset,
+                             connection.outbox.size() - connection.outbox_offset, 0);
+#endif
+    if (n < 0) {
+      if (errno == EINTR) {
+        continue;
+      }
+      if (errno == EAGAIN || errno == EWOULDBLOCK) {
+        break;
+      }
+      return false;
+    }
+    connection.outbox_offset += static_cast<std::size_t>(n);
+    stats_.bytes_out += static_cast<std::uint64_t>(n);
+  }
+
+  const bool pending = connection.outbox_offset < connection.outbox.size();
+  if (!pending) {
+    connection.outbox.clear();
+    connection.outbox_offset = 0;
+  } else if (connection.outbox_offset > connection.outbox.size() / 2U) {
+    connection.outbox.erase(0, connection.outbox_offset);
+    connection.outbox_offset = 0;
+  }
+  if (pending != connection.want_write) {
+    connection.want_write = pending;
+    return poller_->modify(connection.fd, peer, pending);
+  }
+  return true;
+}
+
+void TcpTransport::close_peer(PeerId peer, TransportPollResult* out) {
+  const auto it = connections_.find(peer);
+  if (it == connections_.end()) {
+    return;
+  }
+  const bool warm = it->second.warm;
+  poller_->remove(it->second.fd);
+  util::close_socket(it->second.fd);
+  connections_.erase(it);
+  if (warm) {
+    // Never handed out, so the owner does not know this id.
+    std::erase(warm_pool_, peer);
+    proxy_failures_ = std::min(proxy_failures_ + 1U, kMaxWarmBackoffShift);
+    next_warm_attempt_ = std::chrono::steady_clock::now() + (std::chrono::seconds{1} * (1U << proxy_failures_));
+    return;
+  }
+  if (out != nullptr) {
+    out->disconnected.push_back(peer);
+  } else {
+    pending_disconnects_.push_back(peer);
+  }
+}
+
+#else
+
+TcpTransport::TcpTransport() = default;
+
+TcpTransport::~TcpTransport() = default;
+
+Result TcpTransport::start(const TcpTransportConfig&) {
+  return Result::failure("P2P transport is not available in this build.");
+}
+
+void TcpTransport::stop() {
+  running_ = false;
+}
+
+Result TcpTransport::dial(std::string_view, PeerId& out_peer) {
+  out_peer = 0;
+  return Result::failure("P2P transport is not available in this build.");
+}
+
+bool TcpTransport::send(PeerId, wire::MessageType, std::string_view) {
+  return false;
+}
+
+void TcpTransport::disconnect(PeerId) {}
+
+TransportPollResult TcpTransport::poll(int) {
+  return {};
+}
+
+void TcpTransport::watch_wake_pipe(const util::WakePipe*) {}
+
+std::string TcpTransport::peer_endpoint(PeerId) const {
+  return {};
+}
+
+std::vector<PeerId> TcpTransport::peer_ids() const {
+  return {};
+}
+
+TcpTransportStats TcpTransport::stats() const {
+  return stats_;
+}
+
+PeerId TcpTransport::add_connection(int, std::string, bool, bool) {
+  return 0;
+}
+
+Result TcpTransport::dial_proxied(std::string_view, const std::string&, std::uint16_t, PeerId& out_peer) {
+  out_peer = 0;
+  return Result::failure("P2P transport is not available in this build.");
+}
+
+PeerId TcpTransport::open_proxy_connection() {
+  return 0;
+}
+
+PeerId TcpTransport::take_warm_connection() {
+  return 0;
+}
+
+void TcpTransport::top_up_warm_pool() {}
+
+bool TcpTransport::advance_socks(PeerId, Connection&, TransportPollResult&) {
+  return false;
+}
+
+void TcpTransport::accept_peers(TransportPollResult&) {}
+
+bool TcpTransport::read_peer(PeerId, Connection&, TransportPollResult&) {
+  return false;
+}
+
+bool TcpTransport::flush_peer(PeerId, Connection&) {
+  return false;
+}
+
+void TcpTransport::close_peer(PeerId, TransportPollResult*) {}
+
+#endif
+
+}  // namespace alpha
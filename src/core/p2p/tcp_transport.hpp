@@ -0,0 +1,170 @@
+#pragma once
+
+#include <cstddef>
+#include <chrono>
+#include <cstdint>
+#include <memory>
+#include <optional>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <vector>
+
+#include "core/model/types.hpp"
+#include "core/p2p/wire.hpp"
+#include "core/transport/anonymity_provider.hpp"
+#include "core/transport/socks5.hpp"
+#include "core/util/poller.hpp"
+#include "core/util/socket.hpp"
+
+namespace alpha {
+
+using PeerId = std::uint64_t;
+
+struct TcpTransportConfig {
+  std::string bind_host = "0.0.0.0";
+  std::uint16_t port = 0;  // 0 binds an ephemeral port
+  bool listen = true;
+  std::size_t max_connections = 64;
+  std::size_t max_frame_bytes = wire::kMaxFrameBytes;
+  std::size_t max_write_buffer_bytes = 32U << 20U;
+  // Outbound connections go through this SOCKS5 proxy when set.
+  std::optional<ProxyEndpoint> socks_proxy;
+  // Credentials derived from the destination, so Tor puts every peer on its
+  // own circuit and keeps reusing it for that peer.
+  bool socks_isolate_peers = true;
+  // Proxy connections kept open with the method already negotiated, so a
+  // dial only waits for the CONNECT reply.
+  std::size_t socks_warm_connections = 2;
+};
+
+struct TransportFrame {
+  PeerId peer = 0;
+  wire::MessageType type = wire::MessageType::Hello;
+  std::string body;
+};
+
+struct TransportPollResult {
+  std::vector<TransportFrame> frames;
+  std::vector<PeerId> connected;
+  std::vector<PeerId> disconnected;
+};
+
+struct TcpTransportStats {
+  bool listening = false;
+  std::uint16_t bound_port = 0;
+  std::size_t connections = 0;
+  std::uint64_t frames_in = 0;
+  std::uint64_t frames_out = 0;
+  std::uint64_t bytes_in = 0;
+  std::uint64_t bytes_out = 0;
+  std::uint64_t dial_failures = 0;
+  std::uint64_t socks_handshakes = 0;
+  std::uint64_t socks_failures = 0;
+  std::uint64_t socks_warm_hits = 0;
+  std::size_t socks_warm = 0;
+};
+
+// Framed peer links as P2PNode sees them. TcpTransport is the real one; the
+// network simulator substitutes in-process links with modelled delays.
+class IPeerTransport {
+public:
+  virtual ~IPeerTransport() = default;
+
+  virtual Result start(const TcpTransportConfig& config) = 0;
+  virtual void stop() = 0;
+
+  virtual Result dial(std::string_view endpoint, PeerId& out_peer) = 0;
+  virtual bool send(PeerId peer, wire::MessageType type, std::string_view body) = 0;
+  virtual void disconnect(PeerId peer) = 0;
+  virtual TransportPollResult poll(int timeout_ms) = 0;
+  virtual void watch_wake_pipe(const util::WakePipe* wake) = 0;
+
+  [[nodiscard]] virtual bool running() const = 0;
+  [[nodiscard]] virtual std::uint16_t bound_port() const = 0;
+  [[nodiscard]] virtual std::string peer_endpoint(PeerId peer) const = 0;
+  [[nodiscard]] virtual TcpTransportStats stats() const = 0;
+};
+
+// Non-blocking, single-threaded framed TCP transport. The owner drives it by
+// calling poll(); epoll is used on Linux and poll(2) on other POSIX hosts.
+// Connections carry length-prefixed wire frames with per-connection read and
+// write buffers; a peer that sends an oversized frame or lets its write
+// buffer grow past the limit is disconnected. With a SOCKS5 proxy configured,
+// dials tunnel through it: the greeting, request and any frames sent before
+// the tunnel opens go out back to back, and the peer is reported connected
+// once the proxy confirms the CONNECT.
+class TcpTransport final : public IPeerTransport {
+public:
+  TcpTransport();
+  TcpTransport(const TcpTransport&) = delete;
+  TcpTransport& operator=(const TcpTransport&) = delete;
+  ~TcpTransport() override;
+
+  Result start(const TcpTransportConfig& config) override;
+  void stop() override;
+
+  // Starts a non-blocking connect; the peer shows up in `connected` (or
+  // `disconnected` on failure) from a later poll(). Frames may be sent to
+  // the peer right away; they are queued until the connection is up.
+  Result dial(std::string_view endpoint, PeerId& out_peer) override;
+  bool send(PeerId peer, wire::MessageType type, std::string_view body) override;
+  void disconnect(PeerId peer) override;
+  TransportPollResult poll(int timeout_ms) override;
+  // Also watches `wake` so another thread can cut a blocking poll() short.
+  // The pipe must outlive the transport.
+  void watch_wake_pipe(const util::WakePipe* wake) override;
+
+  [[nodiscard]] bool running() const override { return running_; }
+  [[nodiscard]] std::uint16_t bound_port() const override { return bound_port_; }
+  [[nodiscard]] std::string peer_endpoint(PeerId peer) const override;
+  [[nodiscard]] std::vector<PeerId> peer_ids() const;
+  [[nodiscard]] TcpTransportStats stats() const override;
+
+private:
+  struct Connection {
+    int fd = -1;
+    std::string endpoint;
+    bool outbound = false;
+    bool connecting = false;
+    bool want_write = false;
+    std::string inbox;
+    std::size_t inbox_offset = 0;
+    std::string outbox;
+    std::size_t outbox_offset = 0;
+    // Set until the proxy confirms the tunnel.
+    std::unique_ptr<Socks5Handshake> socks;
+    bool warm = false;  // pooled proxy connection not yet given to a dial
+  };
+
+  PeerId add_connection(int fd, std::string endpoint, bool outbound, bool connecting);
+  Result dial_proxied(std::string_view endpoint, const std::string& host, std::uint16_t port, PeerId& out_peer);
+  // Connects to the proxy and queues the greeting; 0 on failure.
+  PeerId open_proxy_connection();
+  PeerId take_warm_connection();
+  void top_up_warm_pool();
+  // Runs the proxy handshake on buffered input; false once it failed.
+  bool advance_socks(PeerId peer, Connection& connection, TransportPollResult& out);
+  void accept_peers(TransportPollResult& out);
+  bool read_peer(PeerId peer, Connection& connection, TransportPollResult& out);
+  bool flush_peer(PeerId peer, Connection& connection);
+  void close_peer(PeerId peer, TransportPollResult* out);
+
+  TcpTransportConfig config_;
+  std::unique_ptr<util::Poller> poller_;
+  bool running_ = false;
+  int listen_fd_ = -1;
+  const util::WakePipe* wake_ = nullptr;
+  std::uint16_t bound_port_ = 0;
+  PeerId next_peer_id_ = 1;
+  std::unordered_map<PeerId, Connection> connections_;
+  std::vector<PeerId> pending_disconnects_;
+  std::vector<PeerId> warm_pool_;
+  // Consecutive warm connections lost before the proxy answered; refills
+  // back off exponentially while the proxy is unreachable.
+  std::uint32_t proxy_failures_ = 0;
+  std::chrono::steady_clock::time_point next_warm_attempt_{};
+  TcpTransportStats stats_;
+};
+
+}  // namespace alpha
@@ -0,0 +1,455 @@
+#include "core/p2p/wire.hpp"
+
+namespace alpha::wire {
+namespace {
+
+// Every block field except the event id list.
+void write_header_fields(Writer& writer, const Store::BlockRecord& header) {
+  writer.u64(header.index);
+  writer.i64(header.opened_unix);
+  writer.u8(static_cast<std::uint8_t>((header.reserved ? 1U : 0U) | (header.confirmed ? 2U : 0U) |
+                                      (header.backfilled ? 4U : 0U)));
+  writer.bytes(header.psz_timestamp);
+  writer.bytes(header.prev_hash);
+  writer.bytes(header.merkle_root);
+  writer.bytes(header.content_hash);
+  writer.bytes(header.block_hash);
+}
+
+void read_header_fields(Reader& reader, Store::BlockRecord& header) {
+  header.index = reader.u64();
+  header.opened_unix = reader.i64();
+  const std::uint8_t flags = reader.u8();
+  header.reserved = (flags & 1U) != 0;
+  header.confirmed = (flags & 2U) != 0;
+  header.backfilled = (flags & 4U) != 0;
+  header.psz_timestamp = reader.bytes();
+  header.prev_hash = reader.bytes();
+  header.merkle_root = reader.bytes();
+  header.content_hash = reader.bytes();
+  header.block_hash = reader.bytes();
+}
+
+}  // namespace
+
+void Writer::u8(std::uint8_t value) {
+  out_.push_back(static_cast<char>(value));
+}
+
+void Writer::u16(std::uint16_t value) {
+  u8(static_cast<std::uint8_t>(value >> 8U));
+  u8(static_cast<std::uint8_t>(value));
+}
+
+void Writer::u32(std::uint32_t value) {
+  for (int shift = 24; shift >= 0; shift -= 8) {
+    u8(static_cast<std::uint8_t>(value >> static_cast<unsigned>(shift)));
+  }
+}
+
+void Writer::u64(std::uint64_t value) {
+  for (int shift = 56; shift >= 0; shift -= 8) {
+    u8(static_cast<std::uint8_t>(value >> static_cast<unsigned>(shift)));
+  }
+}
+
+void Writer::bytes(std::string_view value) {
+  u32(static_cast<std::uint32_t>(value.size()));
+  out_.append(value);
+}
+
+bool Reader::take(std::size_t count) {
+  if (!ok_ || in_.size() - pos_ < count) {
+    ok_ = false;
+    return false;
+  }
+  return true;
+}
+
+std::uint8_t Reader::u8() {
+  if (!take(1)) {
+    return 0;
+  }
+  return static_cast<std::uint8_t>(in_[pos_++]);
+}
+
+std::uint16_t Reader::u16() {
+  const std::uint16_t hi = u8();
+  const std::uint16_t lo = u8();
+  return static_cast<std::uint16_t>((hi << 8U) | lo);
+}
+
+std::uint32_t Reader::u32() {
+  std::uint32_t value = 0;
+  for (int i = 0; i < 4; ++i) {
+    value = (value << 8U) | u8();
+  }
+  return value;
+}
+
+std::uint64_t Reader::u64() {
+  std::uint64_t value = 0;
+  for (int i = 0; i < 8; ++i) {
+    value = (value << 8U) | u8();
+  }
+  return value;
+}
+
+std::string Reader::bytes() {
+  const std::uint32_t size = u32();
+  if (!take(size)) {
+    return {};
+  }
+  std::string out{in_.substr(pos_, size)};
+  pos_ += size;
+  return out;
+}
+
+void append_frame(std::string& out, MessageType type, std::string_view body) {
+  Writer writer(out);
+  writer.u32(static_cast<std::uint32_t>(body.size() + 1U));
+  writer.u8(static_cast<std::uint8_t>(type));
+  out.append(body);
+}
+
+std::string encode_hello(const Hello& hello) {
+  std::string out;
+  Writer writer(out);
+  writer.u32(hello.protocol_version);
+  writer.bytes(hello.network);
+  writer.bytes(hello.cid);
+  writer.u16(hello.listen_port);
+  writer.u64(hello.event_count);
+  writer.u32(hello.dictionary_id);
+  return out;
+}
+
+std::optional<Hello> decode_hello(std::string_view body) {
+  Reader reader(body);
+  Hello hello;
+  hello.protocol_version = reader.u32();
+  hello.network = reader.bytes();
+  hello.cid = reader.bytes();
+  hello.listen_port = reader.u16();
+  hello.event_count = reader.u64();
+  hello.dictionary_id = reader.u32();
+  if (!reader.done()) {
+    return std::nullopt;
+  }
+  return hello;
+}
+
+std::string encode_ids(const std::vector<std::string>& ids) {
+  std::string out;
+  Writer writer(out);
+  writer.u32(static_cast<std::uint32_t>(ids.size()));
+  for (const auto& id : ids) {
+    writer.bytes(id);
+  }
+  return out;
+}
+
+std::optional<std::vector<std::string>> decode_ids(std::string_view body) {
+  Reader reader(body);
+  const std::uint32_t count = reader.u32();
+  if (!reader.ok() || count > kMaxInventoryIds) {
+    return std::nullopt;
+  }
+  std::vector<std::string> ids;
+  ids.reserve(count);
+  for (std::uint32_t i = 0; i < count; ++i) {
+    std::string id = reader.bytes();
+    if (!reader.ok() || id.empty()) {
+      return std::nullopt;
+    }
+    ids.push_back(std::move(id));
+  }
+  if (!reader.done()) {
+    return std::nullopt;
+  }
+  return ids;
+}
+
+std::string encode_range_summary(const std::vector<DigestRange>& ranges) {
+  std::string out;
+  Writer writer(out);
+  writer.u32(static_cast<std::uint32_t>(ranges.size()));
+  for (const auto& range : ranges) {
+    writer.i64(range.lo);
+    writer.i64(range.hi);
+    writer.u64(range.digest.sum_a);
+    writer.u64(range.digest.sum_b);
+    writer.u32(range.digest.count);
+  }
+  return out;
+}
+
+std::optional<std::vector<DigestRange>> decode_range_summary(std::string_view body) {
+  Reader reader(body);
+  const std::uint32_t count = reader.u32();
+  if (!reader.ok() || count > kMaxReconcileRanges) {
+    return std::nullopt;
+  }
+  std::vector<DigestRange> ranges(count);
+  for (auto& range : ranges) {
+    range.lo = reader.i64();
+    range.hi = reader.i64();
+    range.digest.sum_a = reader.u64();
+    range.digest.sum_b = reader.u64();
+    range.digest.count = reader.u32();
+    if (range.lo >= range.hi) {
+      return std::nullopt;
+    }
+  }
+  if (!reader.done()) {
+    return std::nullopt;
+  }
+  return ranges;
+}
+
+std::string encode_range_ids(const std::vector<RangeIds>& ranges) {
+  std::string out;
+  Writer writer(out);
+  writer.u32(static_cast<std::uint32_t>(ranges.size()));
+  for (const auto& range : ranges) {
+    writer.i64(range.lo);
+    writer.i64(range.hi);
+    writer.u32(static_cast<std::uint32_t>(range.ids.size()));
+    for (const auto& id : range.ids) {
+      writer.bytes(id);
+    }
+  }
+  return out;
+}
+
+std::optional<std::vector<RangeIds>> decode_range_ids(std::string_view body) {
+  Reader reader(body);
+  const std::uint32_t count = reader.u32();
+  if (!reader.ok() || count > kMaxReconcileRanges) {
+    return std::nullopt;
+  }
+  std::vector<RangeIds> ranges(count);
+  for (auto& range : ranges) {
+    range.lo = reader.i64();
+    range.hi = reader.i64();
+    const std::uint32_t id_count = reader.u32();
+    // Each id costs at least its 4-byte length prefix.
+    if (!reader.ok() || range.lo >= range.hi || id_count > reader.remaining() / 4U) {
+      return std::nullopt;
+    }
+    range.ids.reserve(id_count);
+    for (std::uint32_t i = 0; i < id_count; ++i) {
+      range.ids.push_back(reader.bytes());
+    }
+  }
+  if (!reader.done()) {
+    return std::nullopt;
+  }
+  return ranges;
+}
+
+std::string encode_header_request(const HeaderRequest& request) {
+  std::string out;
+  Writer writer(out);
+  writer.u64(request.from_index);
+  writer.u32(request.max_count);
+  return out;
+}
+
+std::optional<HeaderRequest> decode_header_request(std::string_view body) {
+  Reader reader(body);
+  HeaderRequest request;
+  request.from_index = reader.u64();
+  request.max_count = reader.u32();
+  if (!reader.done()) {
+    return std::nullopt;
+  }
+  return request;
+}
+
+std::string encode_headers(std::span<const Store::BlockRecord> headers) {
+  std::string out;
+  Writer writer(out);
+  writer.u32(static_cast<std::uint32_t>(headers.size()));
+  for (const auto& header : headers) {
+    write_header_fields(writer, header);
+    writer.u32(static_cast<std::uint32_t>(header.event_ids.size()));
+    for (const auto& id : header.event_ids) {
+      writer.bytes(id);
+    }
+  }
+  return out;
+}
+
+std::optional<std::vector<Store::BlockRecord>> decode_headers(std::string_view body) {
+  Reader reader(body);
+  const std::uint32_t count = reader.u32();
+  if (!reader.ok() || count > kMaxHeadersPerMessage) {
+    return std::nullopt;
+  }
+  std::vector<Store::BlockRecord> headers(count);
+  for (auto& header : headers) {
+    read_header_fields(reader, header);
+    const std::uint32_t id_count = reader.u32();
+    if (!reader.ok() || id_count > reader.remaining() / 4U) {
+      return std::nullopt;
+    }
+    header.event_ids.reserve(id_count);
+    for (std::uint32_t i = 0; i < id_count; ++i) {
+      header.event_ids.push_back(reader.bytes());
+    }
+  }
+  if (!reader.done()) {
+    return std::nullopt;
+  }
+  return headers;
+}
+
+void write_event(Writer& writer, const EventEnvelope& event) {
+  writer.bytes(event.event_id);
+  writer.u32(static_cast<std::uint32_t>(event.kind));
+  writer.bytes(event.author_cid);
+  writer.i64(event.unix_ts);
+  writer.bytes(event.payload);
+  writer.bytes(event.signature);
+}
+
+std::optional<EventEnvelope> read_event(Reader& reader) {
+  EventEnvelope event;
+  event.event_id = reader.bytes();
+  const std::uint32_t kind = reader.u32();
+  event.author_cid = reader.bytes();
+  event.unix_ts = reader.i64();
+  event.payload = reader.bytes();
+  event.signature = reader.bytes();
+  if (!reader.ok() || kind > static_cast<std::uint32_t>(EventKind::PolicyUpdated)) {
+    return std::nullopt;
+  }
+  event.kind = static_cast<EventKind>(kind);
+  return event;
+}
+
+std::string encode_events(const std::vector<EventEnvelope>& events) {
+  std::string out;
+  Writer writer(out);
+  writer.u32(static_cast<std::uint32_t>(events.size()));
+  for (const auto& event : events) {
+    write_event(writer, event);
+  }
+  return out;
+}
+
+std::optional<std::vector<EventEnvelope>> decode_events(std::string_view body) {
+  Reader reader(body);
+  const std::uint32_t count = reader.u32();
+  std::vector<EventEnvelope> events;
+  // Every event needs at least its fixed-width fields; reject absurd counts early.
+  if (!reader.ok() || count > reader.remaining() / 28U) {
+    return std::nullopt;
+  }
+  events.reserve(count);
+  for (std::uint32_t i = 0; i < count; ++i) {
+    auto event = read_event(reader);
+    if (!event.has_value()) {
+      return std::nullopt;
+    }
+    events.push_back(std::move(*event));
+  }
+  if (!reader.done()) {
+    return std::nullopt;
+  }
+  return events;
+}
+
+std::string encode_compact_block(const CompactBlock& block) {
+  std::string out;
+  Writer writer(out);
+  write_header_fields(writer, block.header);
+  writer.u64(block.nonce);
+  writer.i64(block.min_unix_ts);
+  writer.i64(block.max_unix_ts);
+  writer.u32(static_cast<std::uint32_t>(block.short_ids.size()));
+  for (const std::uint64_t short_id : block.short_ids) {
+    for (int shift = static_cast<int>(kShortIdBytes - 1U) * 8; shift >= 0; shift -= 8) {
+      writer.u8(static_cast<std::uint8_t>(short_id >> static_cast<unsigned>(shift)));
+    }
+  }
+  return out;
+}
+
+std::optional<CompactBlock> decode_compact_block(std::string_view body) {
+  Reader reader(body);
+  CompactBlock block;
+  read_header_fields(reader, block.header);
+  block.nonce = reader.u64();
+  block.min_unix_ts = reader.i64();
+  block.max_unix_ts = reader.i64();
+  const std::uint32_t count = reader.u32();
+  if (!reader.ok() || count != reader.remaining() / kShortIdBytes || block.header.block_hash.empty()) {
+    return std::nullopt;
+  }
+  block.short_ids.reserve(count);
+  for (std::uint32_t i = 0; i < count; ++i) {
+    std::uint64_t short_id = 0;
+    for (std::size_t byte = 0; byte < kShortIdBytes; ++byte) {
+      short_id = (short_id << 8U) | reader.u8();
+    }
+    block.short_ids.push_back(short_id);
+  }
+  if (!reader.done()) {
+    return std::nullopt;
+  }
+  return block;
+}
+
+std::string encode_block_event_request(const BlockEventRequest& request) {
+  std::string out;
+  Writer writer(out);
+  writer.bytes(request.block_hash);
+  writer.u32(static_cast<std::uint32_t>(request.positions.size()));
+  for (const std::uint32_t position : request.positions) {
+    writer.u32(position);
+  }
+  return out;
+}
+
+std::optional<BlockEventRequest> decode_block_event_request(std::string_view body) {
+  Reader reader(body);
+  BlockEventRequest request{.block_hash = reader.bytes()};
+  const std::uint32_t count = reader.u32();
+  if (!reader.ok() || count != reader.remaining() / 4U) {
+    return std::nullopt;
+  }
+  request.positions.reserve(count);
+  for (std::uint32_t i = 0; i < count; ++i) {
+    request.positions.push_back(reader.u32());
+  }
+  if (!reader.done()) {
+    return std::nullopt;
+  }
+  return request;
+}
+
+std::string encode_block_events(std::string_view block_hash, const std::vector<EventEnvelope>& events) {
+  std::string out;
+  Writer writer(out);
+  writer.bytes(block_hash);
+  out.append(encode_events(events));
+  return out;
+}
+
+std::optional<BlockEvents> decode_block_events(std::string_view body) {
+  Reader reader(body);
+  BlockEvents out{.block_hash = reader.bytes()};
+  if (!reader.ok()) {
+    return std::nullopt;
+  }
+  std::optional<std::vector<EventEnvelope>> events = decode_events(body.substr(body.size() - reader.remaining()));
+  if (!events.has_value()) {
+    return std::nullopt;
+  }
+  out.events = std::move(*events);
+  return out;
+}
+
+}  // namespace alpha::wire
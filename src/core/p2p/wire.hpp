@@ -0,0 +1,159 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <optional>
+#include <span>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include "core/model/types.hpp"
+#include "core/p2p/compact_block.hpp"
+#include "core/p2p/reconcile.hpp"
+#include "core/storage/store.hpp"
+
+namespace alpha::wire {
+
+// Frame layout: u32 big-endian length of (type + body), u8 message type, body.
+inline constexpr std::size_t kFrameHeaderBytes = 5;
+inline constexpr std::size_t kMaxFrameBytes = 8U * 1024U * 1024U;
+inline constexpr std::uint32_t kProtocolVersion = 5;
+// Per-message caps so a single announce or request stays well under a frame.
+inline constexpr std::size_t kMaxInventoryIds = 1000;
+inline constexpr std::size_t kMaxEventBatchBytes = 1U * 1024U * 1024U;
+inline constexpr std::size_t kMaxReconcileRanges = 256;
+inline constexpr std::uint32_t kMaxHeadersPerMessage = 2000;
+
+// Events propagate announce-first: peers send Inventory (event ids), the
+// receiver answers GetData for ids it lacks, and bodies come back in Events.
+// On connect, RangeSummary/RangeIds reconcile the two event sets top-down.
+// A fresh node bootstraps headers-first with GetHeaders/Headers and then
+// fetches block bodies through GetData from every connected peer. Confirmed
+// blocks are announced as CompactBlock (header plus short ids); receivers ask
+// for the events they cannot match with GetBlockEvents and get them back in
+// BlockEvents. Once both hellos advertise the same dictionary, any later
+// frame may be wrapped in Compressed (see compression.hpp).
+enum class MessageType : std::uint8_t {
+  Hello = 1,
+  Inventory = 2,
+  GetData = 3,
+  Events = 4,
+  RangeSummary = 5,
+  RangeIds = 6,
+  GetHeaders = 7,
+  Headers = 8,
+  Compressed = 9,
+  CompactBlock = 10,
+  GetBlockEvents = 11,
+  BlockEvents = 12,
+};
+
+// Appends big-endian integers and u32-length-prefixed byte strings.
+class Writer {
+public:
+  explicit Writer(std::string& out) : out_(out) {}
+
+  void u8(std::uint8_t value);
+  void u16(std::uint16_t value);
+  void u32(std::uint32_t value);
+  void u64(std::uint64_t value);
+  void i64(std::int64_t value) { u64(static_cast<std::uint64_t>(value)); }
+  void bytes(std::string_view value);
+
+private:
+  std::string& out_;
+};
+
+// Bounds-checked reader; any short read latches `ok() == false`.
+class Reader {
+public:
+  explicit Reader(std::string_view in) : in_(in) {}
+
+  std::uint8_t u8();
+  std::uint16_t u16();
+  std::uint32_t u32();
+  std::uint64_t u64();
+  std::int64_t i64() { return static_cast<std::int64_t>(u64()); }
+  std::string bytes();
+
+  [[nodiscard]] bool ok() const { return ok_; }
+  [[nodiscard]] bool done() const { return ok_ && pos_ == in_.size(); }
+  [[nodiscard]] std::size_t remaining() const { return in_.size() - pos_; }
+
+private:
+  bool take(std::size_t count);
+
+  std::string_view in_;
+  std::size_t pos_ = 0;
+  bool ok_ = true;
+};
+
+struct RangeIds {
+  std::int64_t lo = 0;
+  std::int64_t hi = 0;
+  std::vector<std::string> ids;
+};
+
+struct Hello {
+  std::uint32_t protocol_version = kProtocolVersion;
+  std::string network;
+  std::string cid;
+  std::uint16_t listen_port = 0;
+  std::uint64_t event_count = 0;
+  std::uint32_t dictionary_id = 0;  // 0: raw frames only
+};
+
+struct HeaderRequest {
+  std::uint64_t from_index = 0;
+  std::uint32_t max_count = kMaxHeadersPerMessage;
+};
+
+// Positions into a compact block's short id list.
+struct BlockEventRequest {
+  std::string block_hash;
+  std::vector<std::uint32_t> positions;
+};
+
+struct BlockEvents {
+  std::string block_hash;
+  std::vector<EventEnvelope> events;
+};
+
+void append_frame(std::string& out, MessageType type, std::string_view body);
+
+std::string encode_hello(const Hello& hello);
+std::optional<Hello> decode_hello(std::string_view body);
+
+// Inventory and GetData share one body layout: u32 count, then ids.
+std::string encode_ids(const std::vector<std::string>& ids);
+std::optional<std::vector<std::string>> decode_ids(std::string_view body);
+
+std::string encode_range_summary(const std::vector<DigestRange>& ranges);
+std::optional<std::vector<DigestRange>> decode_range_summary(std::string_view body);
+std::string encode_range_ids(const std::vector<RangeIds>& ranges);
+std::optional<std::vector<RangeIds>> decode_range_ids(std::string_view body);
+
+std::string encode_header_request(const HeaderRequest& request);
+std::optional<HeaderRequest> decode_header_request(std::string_view body);
+// Headers carry the block's event ids so bodies can be fetched by id from
+// any peer and checked against the header's merkle root.
+std::string encode_headers(std::span<const Store::BlockRecord> headers);
+std::optional<std::vector<Store::BlockRecord>> decode_headers(std::string_view body);
+
+// Header fields as in Headers, then u64 nonce, i64 min/max event timestamp,
+// u32 count and a 6-byte big-endian short id per event.
+std::string encode_compact_block(const CompactBlock& block);
+std::optional<CompactBlock> decode_compact_block(std::string_view body);
+std::string encode_block_event_request(const BlockEventRequest& request);
+std::optional<BlockEventRequest> decode_block_event_request(std::string_view body);
+// Block hash, then the Events body layout.
+std::string encode_block_events(std::string_view block_hash, const std::vector<EventEnvelope>& events);
+std::optional<BlockEvents> decode_block_events(std::string_view body);
+
+void write_event(Writer& writer, const EventEnvelope& event);
+std::optional<EventEnvelope> read_event(Reader& reader);
+std::string encode_events(const std::vector<EventEnvelope>& events);
+std::optional<std::vector<EventEnvelope>> decode_events(std::string_view body);
+
+}  // namespace alpha::wire
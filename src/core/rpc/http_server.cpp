@@ -0,0 +1,811 @@
+#include "core/rpc/http_server.hpp"
+
+#include <algorithm>
+#include <array>
+#include <cctype>
+#include <charconv>
+#include <exception>
+
+#ifndef _WIN32
+#include <cerrno>
+#include <sys/socket.h>
+#include <unistd.h>
+#endif
+
+namespace alpha {
+namespace {
+
+std::string lower_copy(std::string_view text) {
+  std::string out{text};
+  std::ranges::transform(out, out.begin(), [](unsigned char c) { return static_cast<char>(std::tolower(c)); });
+  return out;
+}
+
+std::string_view trim_view(std::string_view text) {
+  while (!text.empty() && (text.front() == ' ' || text.front() == '\t')) {
+    text.remove_prefix(1);
+  }
+  while (!text.empty() && (text.back() == ' ' || text.back() == '\t')) {
+    text.remove_suffix(1);
+  }
+  return text;
+}
+
+// True when the comma-separated, lower-cased header value lists `token`.
+bool has_token(std::string_view value, std::string_view token) {
+  while (!value.empty()) {
+    const std::size_t comma = value.find(',');
+    if (trim_view(value.substr(0, comma)) == token) {
+      return true;
+    }
+    if (comma == std::string_view::npos) {
+      break;
+    }
+    value.remove_prefix(comma + 1U);
+  }
+  return false;
+}
+
+}  // namespace
+
+std::optional<std::string_view> HttpRequest::header(std::string_view lower_name) const {
+  for (const auto& [name, value] : headers) {
+    if (name == lower_name) {
+      return value;
+    }
+  }
+  return std::nullopt;
+}
+
+HttpRequestParser::HttpRequestParser(std::size_t max_header_bytes, std::size_t max_body_bytes)
+    : max_header_bytes_(max_header_bytes), max_body_bytes_(max_body_bytes) {}
+
+HttpRequestParser::State HttpRequestParser::parse(std::string& buffer, HttpRequest& out) {
+  if (error_status_ != 0) {
+    return State::Error;
+  }
+  if (head_bytes_ == 0) {
+    // Step back over a terminator split across two reads.
+    const std::size_t from = scan_offset_ > 3U ? scan_offset_ - 3U : 0U;
+    const std::size_t end = buffer.find("\r\n\r\n", from);
+    if (end == std::string::npos) {
+      if (buffer.size() > max_header_bytes_) {
+        return fail(431);
+      }
+      scan_offset_ = buffer.size();
+      return State::NeedMore;
+    }
+    if (end + 4U > max_header_bytes_) {
+      return fail(431);
+    }
+    head_ = {};
+    if (!parse_head(std::string_view{buffer}.substr(0, end), head_)) {
+      return State::Error;
+    }
+    head_bytes_ = end + 4U;
+  }
+  if (buffer.size() - head_bytes_ < content_length_) {
+    return State::NeedMore;
+  }
+
+  out = std::move(head_);
+  out.body.assign(buffer, head_bytes_, content_length_);
+  buffer.erase(0, head_bytes_ + content_length_);
+  head_ = {};
+  head_bytes_ = 0;
+  scan_offset_ = 0;
+  content_length_ = 0;
+  return State::Complete;
+}
+
+HttpRequestParser::State HttpRequestParser::fail(int status) {
+  error_status_ = status;
+  return State::Error;
+}
+
+bool HttpRequestParser::parse_head(std::string_view head, HttpRequest& out) {
+  std::size_t line_end = head.find("\r\n");
+  const std::string_view request_line = head.substr(0, line_end);
+  const std::size_t first_space = request_line.find(' ');
+  const std::size_t second_space =
+      first_space == std::string_view::npos ? std::string_view::npos : request_line.find(' ', first_space + 1U);
+  if (second_space == std::string_view::npos || first_space == 0 || second_space == first_space + 1U) {
+    (void)fail(400);
+    return false;
+  }
+  out.method = request_line.substr(0, first_space);
+  out.target = request_line.substr(first_space + 1U, second_space - first_space - 1U);
+  out.version = request_line.substr(second_space + 1U);
+  if (out.version != "HTTP/1.1" && out.version != "HTTP/1.0") {
+    (void)fail(400);
+    return false;
+  }
+
+  std::optional<std::size_t> content_length;
+  std::string connection;
+  while (line_end != std::string_view::npos) {
+    const std::size_t start = line_end + 2U;
+    line_end = head.find("\r\n", start);
+    const std::string_view line = head.substr(start, line_end == std::string_view::npos ? head.size() - start
+                                                                                        : line_end - start);
+    const std::size_t colon = line.find(':');
+    if (colon == std::string_view::npos || colon == 0) {
+      (void)fail(400);
+      return false;
+    }
+    std::string name = lower_copy(line.substr(0, colon));
+    const std::string_view value = trim_view(line.substr(colon + 1U));
+    if (name == "content-length") {
+      std::size_t length = 0;
+      const auto parsed = std::from_chars(value.data(), value.data() + value.size(), length);
+      if (parsed.ec != std::errc{} || parsed.ptr != value.data() + value.size() ||
+          (content_length.has_value() && *content_length != length)) {
+        (void)fail(400);
+        return false;
+      }
+      content_length = length;
+    } else if (name == "transfer-encoding") {
+      (void)fail(501);
+      return false;
+    } else if (name == "connection") {
+      connection = lower_copy(value);
+    }
+    out.headers.emplace_back(std::move(name), std::string{value});
+  }
+
+  if (content_length.value_or(0) > max_body_bytes_) {
+    (void)fail(413);
+    return false;
+  }
+  content_length_ = content_length.value_or(0);
+  out.keep_alive = out.version == "HTTP/1.1" ? !has_token(connection, "close") : has_token(connection, "keep-alive");
+  return true;
+}
+
+std::string_view http_status_text(int status) {
+  switch (status) {
+    case 200:
+      return "OK";
+    case 204:
+      return "No Content";
+    case 400:
+      return "Bad Request";
+    case 401:
+      return "Unauthorized";
+    case 404:
+      return "Not Found";
+    case 405:
+      return "Method Not Allowed";
+    case 408:
+      return "Request Timeout";
+    case 413:
+      return "Content Too Large";
+    case 431:
+      return "Request Header Fields Too Large";
+    case 500:
+      return "Internal Server Error";
+    case 501:
+      return "Not Implemented";
+    case 503:
+      return "Service Unavailable";
+    default:
+      return "Unknown";
+  }
+}
+
+void append_http_head(std::string& out, const HttpResponse& response, bool keep_alive) {
+  out += "HTTP/1.1 ";
+  out += std::to_string(response.status);
+  out += ' ';
+  out += http_status_text(response.status);
+  if (response.stream) {
+    out += "\r\nContent-Type: ";
+    out += response.content_type;
+    out += "\r\nTransfer-Encoding: chunked";
+  } else if (response.status != 204) {
+    // 204 carries neither a body nor headers describing one.
+    out += "\r\nContent-Type: ";
+    out += response.content_type;
+    out += "\r\nContent-Length: ";
+    out += std::to_string(response.body.size());
+  }
+  out += keep_alive ? "\r\nConnection: keep-alive\r\n\r\n" : "\r\nConnection: close\r\n\r\n";
+}
+
+void append_rpc_frame(std::string& out, std::string_view payload) {
+  const auto length = static_cast<std::uint32_t>(payload.size());
+  for (int shift = 24; shift >= 0; shift -= 8) {
+    out.push_back(static_cast<char>((length >> static_cast<unsigned>(shift)) & 0xFFU));
+  }
+  out.append(payload);
+}
+
+std::optional<std::size_t> rpc_frame_length(std::string_view buffer) {
+  if (buffer.size() < kRpcFrameHeaderBytes) {
+    return std::nullopt;
+  }
+  std::size_t length = 0;
+  for (std::size_t i = 0; i < kRpcFrameHeaderBytes; ++i) {
+    length = (length << 8U) | static_cast<unsigned char>(buffer[i]);
+  }
+  return length;
+}
+
+std::string serialize_http_response(const HttpResponse& response, bool keep_alive) {
+  std::string out;
+  out.reserve(128U + response.content_type.size() + response.body.size());
+  append_http_head(out, response, keep_alive);
+  if (!response.stream) {
+    out += response.body;
+  }
+  return out;
+}
+
+#ifndef _WIN32
+
+namespace {
+
+// Poller tokens reserved for the listener and the wake pipe; connection ids
+// start at 1.
+constexpr std::uint64_t kListenToken = 0;
+constexpr std::uint64_t kWakeToken = ~std::uint64_t{0};
+constexpr std::uint64_t kUnixListenToken = kWakeToken - 1U;
+// The first byte of a frame is the top byte of its length.
+constexpr std::size_t kMaxFrameBytes = (std::size_t{1} << 24U) - 1U;
+// Longest the loop sleeps, so deadlines are checked with no socket ready.
+constexpr int kSweepIntervalMs = 100;
+// A streamed body is pulled until this much is waiting to be sent.
+constexpr std::size_t kStreamLowWater = 64U << 10U;
+// Chunk sizes are written at a fixed width and patched once known.
+constexpr std::size_t kChunkSizeDigits = 8;
+constexpr std::size_t kStreamWindowsPerFlush = 16;
+
+HttpResponse error_response(int status) {
+  return {
+      .status = status,
+      .body = "{\"error\":\"" + std::string{http_status_text(status)} + "\"}",
+  };
+}
+
+}  // namespace
+
+HttpServer::~HttpServer() {
+  stop();
+}
+
+Result HttpServer::start(const HttpServerConfig& config, Handler handler) {
+  if (running_) {
+    return Result::failure("HTTP server already running.");
+  }
+  config_ = config;
+  handler_ = std::move(handler);
+  poller_ = std::make_unique<util::Poller>();
+  wake_ = std::make_unique<util::WakePipe>();
+  if (!poller_->valid() || wake_->read_fd() == util::kInvalidSocket) {
+    poller_.reset();
+    wake_.reset();
+    return Result::failure("HTTP server failed: unable to create poller.");
+  }
+  const Result listened = util::listen_tcp(config_.bind_host, config_.port, config_.backlog, listen_fd_);
+  if (!listened.ok) {
+    poller_.reset();
+    wake_.reset();
+    return Result::failure("HTTP server failed: " + listened.message);
+  }
+  util::set_non_blocking(listen_fd_);
+  bound_port_ = util::local_port(listen_fd_);
+  poller_->add(listen_fd_, kListenToken, false);
+  if (!config_.unix_socket_path.empty()) {
+    const Result unix_listened = util::listen_unix(config_.unix_socket_path, config_.backlog, unix_listen_fd_);
+    if (!unix_listened.ok) {
+      util::close_socket(listen_fd_);
+      poller_.reset();
+      wake_.reset();
+      return Result::failure("HTTP server failed: " + unix_listened.message);
+    }
+    util::set_non_blocking(unix_listen_fd_);
+    poller_->add(unix_listen_fd_, kUnixListenToken, false);
+  }
+  poller_->add(wake_->read_fd(), kWakeToken, false);
+  workers_ = std::make_unique<util::ThreadPool>(std::max<std::size_t>(config_.worker_threads, 1U));
+  {
+    const std::lock_guard lock(stats_mutex_);
+    stats_ = {.running = true, .bound_port = bound_port_};
+  }
+
+  streams_woken_ = false;
+  running_ = true;
+  thread_ = std::thread([this] { run(); });
+  return Result::success("HTTP server listening on " + config_.bind_host + ":" + std::to_string(bound_port_) +
+                         (config_.unix_socket_path.empty() ? "" : " and " + config_.unix_socket_path));
+}
+
+void HttpServer::stop() {
+  if (!running_.exchange(false)) {
+    return;
+  }
+  wake_->notify();
+  if (thread_.joinable()) {
+    thread_.join();
+  }
+  // Handlers still running finish first; their responses are dropped.
+  workers_.reset();
+  {
+    const std::lock_guard lock(completions_mutex_);
+    completions_.clear();
+  }
+  for (auto& [id, connection] : connections_) {
+    util::close_socket(connection.fd);
+  }
+  connections_.clear();
+  util::close_socket(listen_fd_);
+  if (unix_listen_fd_ != util::kInvalidSocket) {
+    util::close_socket(unix_listen_fd_);
+    ::unlink(config_.unix_socket_path.c_str());
+  }
+  // wake_ stays open until the next start() so a late wake_streams() still
+  // has a pipe to write to.
+  poller_.reset();
+  const std::lock_guard lock(stats_mutex_);
+  stats_.running = false;
+  stats_.open_connections = 0;
+  stats_.handlers_in_flight = 0;
+  stats_.parked_streams = 0;
+}
+
+HttpServerStats HttpServer::stats() const {
+  const std::lock_guard lock(stats_mutex_);
+  return stats_;
+}
+
+void HttpServer::wake_streams() {
+  if (running_ && !streams_woken_.exchange(true)) {
+    wake_->notify();
+  }
+}
+
+void HttpServer::run() {
+  while (running_) {
+    for (const util::PollEvent& event : poller_->wait(kSweepIntervalMs)) {
+      if (event.token == kListenToken || event.token == kUnixListenToken) {
+        const bool local = event.token == kUnixListenToken;
+        accept_connections(local ? unix_listen_fd_ : listen_fd_, local);
+        continue;
+      }
+      if (event.token == kWakeToken) {
+        wake_->drain();
+        if (streams_woken_.exchange(false)) {
+          resume_parked_streams();
+        }
+        continue;
+      }
+      auto it = connections_.find(event.token);
+      if (it == connections_.end()) {
+        continue;
+      }
+      if (event.failed) {
+        close_connection(event.token);
+        continue;
+      }
+      if (event.writable && !flush_connection(event.token, it->second)) {
+        continue;
+      }
+      if (event.readable) {
+        (void)read_connection(event.token, it->second);
+      }
+    }
+    apply_completions();
+    expire_connections();
+  }
+}
+
+void HttpServer::accept_connections(int listen_fd, bool local) {
+  while (true) {
+    int fd = ::accept(listen_fd, nullptr, nullptr);
+    if (fd < 0) {
+      return;
+    }
+    if (connections_.size() >= config_.max_connections || !util::set_non_blocking(fd)) {
+      util::close_socket(fd);
+      const std::lock_guard lock(stats_mutex_);
+      ++stats_.connections_rejected;
+      continue;
+    }
+    if (!local) {
+      util::set_no_delay(fd);
+    }
+    const ConnectionId id = next_connection_id_++;
+    Connection& connection = connections_.try_emplace(id, config_).first->second;
+    connection.fd = fd;
+    connection.local = local;
+    connection.framing = local ? Framing::Sniff : Framing::Http;
+    connection.deadline = Clock::now() + std::chrono::milliseconds(config_.idle_timeout_ms);
+    if (!poller_->add(fd, id, false)) {
+      close_connection(id);
+      continue;
+    }
+    const std::lock_guard lock(stats_mutex_);
+    ++stats_.connections_accepted;
+    stats_.local_connections += local ? 1U : 0U;
+    stats_.open_connections = connections_.size();
+  }
+}
+
+bool HttpServer::read_connection(ConnectionId id, Connection& connection) {
+  const std::size_t limit = config_.max_header_bytes + config_.max_body_bytes;
+  std::array<char, 16384> buffer{};
+  while (connection.inbox.size() <= limit) {
+    const ssize_t n = ::recv(connection.fd, buffer.data(), buffer.size(), 0);
+    if (n == 0) {
+      close_connection(id);
+      return false;
+    }
+    if (n < 0) {
+      if (errno == EINTR) {
+        continue;
+      }
+      if (errno == EAGAIN || errno == EWOULDBLOCK) {
+        break;
+      }
+      close_connection(id);
+      return false;
+    }
+    connection.inbox.append(buffer.data(), static_cast<std::size_t>(n));
+  }
+  if (connection.busy && connection.inbox.size() > limit) {
+    // Pipelining past every limit while a handler runs.
+    close_connection(id);
+    return false;
+  }
+  return advance(id, connection);
+}
+
+bool HttpServer::advance(ConnectionId id, Connection& connection) {
+  if (connection.busy || connection.stream || connection.close_after_write) {
+    return true;
+  }
+  bool open = true;
+  std::optional<HttpRequest> next = next_request(id, connection, open);
+  if (!next.has_value()) {
+    return open;
+  }
+  HttpRequest request = std::move(*next);
+  const bool framed = connection.framing == Framing::LengthPrefixed;
+
+  connection.busy = true;
+  connection.deadline = Clock::time_point::max();
+  ++connection.requests;
+  {
+    const std::lock_guard lock(stats_mutex_);
+    ++stats_.requests;
+    stats_.keep_alive_reuses += connection.requests > 1U ? 1U : 0U;
+    stats_.framed_requests += framed ? 1U : 0U;
+    ++stats_.handlers_in_flight;
+  }
+  const bool keep_alive = request.keep_alive;
+  const bool chunked = !framed && request.version == "HTTP/1.1";
+  workers_->submit([this, id, keep_alive, chunked, request = std::move(request)] {
+    HttpResponse response;
+    try {
+      response = handler_(request);
+    } catch (const std::exception&) {
+      response = error_response(500);
+    }
+    {
+      const std::lock_guard lock(completions_mutex_);
+      completions_.push_back(
+          {.connection = id, .response = std::move(response), .keep_alive = keep_alive, .chunked = chunked});
+    }
+    wake_->notify();
+  });
+  return true;
+}
+
+std::optional<HttpRequest> HttpServer::next_request(ConnectionId id, Connection& connection, bool& open) {
+  const auto need_more = [&]() -> std::optional<HttpRequest> {
+    if (!connection.inbox.empty() && connection.outbox.empty()) {
+      connection.deadline = std::min(connection.deadline,
+                                     Clock::now() + std::chrono::milliseconds(config_.request_timeout_ms));
+    }
+    return std::nullopt;
+  };
+  const auto reject = [&](int status) -> std::optional<HttpRequest> {
+    {
+      const std::lock_guard lock(stats_mutex_);
+      ++stats_.bad_requests;
+    }
+    open = queue_response(id, connection, error_response(status), false);
+    return std::nullopt;
+  };
+
+  if (connection.framing == Framing::Sniff) {
+    if (connection.inbox.empty()) {
+      return std::nullopt;
+    }
+    connection.framing = connection.inbox.front() == '\0' ? Framing::LengthPrefixed : Framing::Http;
+  }
+
+  HttpRequest request;
+  if (connection.framing == Framing::LengthPrefixed) {
+    const std::optional<std::size_t> length = rpc_frame_length(connection.inbox);
+    if (!length.has_value()) {
+      return need_more();
+    }
+    if (*length > std::min(config_.max_body_bytes, kMaxFrameBytes)) {
+      return reject(413);
+    }
+    if (connection.inbox.size() < kRpcFrameHeaderBytes + *length) {
+      return need_more();
+    }
+    request.method = "POST";
+    request.target = "/";
+    request.body.assign(connection.inbox, kRpcFrameHeaderBytes, *length);
+    connection.inbox.erase(0, kRpcFrameHeaderBytes + *length);
+  } else {
+    const HttpRequestParser::State state = connection.parser.parse(connection.inbox, request);
+    if (state == HttpRequestParser::State::NeedMore) {
+      return need_more();
+    }
+    if (state == HttpRequestParser::State::Error) {
+      return reject(connection.parser.error_status());
+    }
+  }
+  request.local = connection.local;
+  return request;
+}
+
+bool HttpServer::queue_response(ConnectionId id, Connection& connection, HttpResponse response, bool keep_alive,
+                                bool chunked) {
+  if (response.stream && !chunked) {
+    // HTTP/1.0 and frames have no chunked encoding, so the body is
+    // collected first.
+    const HttpBodyStream stream = std::move(response.stream);
+    response.stream = nullptr;
+    try {
+      std::size_t before = 0;
+      do {
+        before = response.body.size();
+      } while (stream(response.body) && response.body.size() != before);
+    } catch (const std::exception&) {
+      response = error_response(500);
+    }
+  }
+  if (connection.framing == Framing::LengthPrefixed) {
+    // The stream was collected above: a frame's length comes first.
+    append_rpc_frame(connection.outbox, response.body);
+  } else {
+    append_http_head(connection.outbox, response, keep_alive);
+    if (response.stream) {
+      connection.stream = std::move(response.stream);
+      const std::lock_guard lock(stats_mutex_);
+      ++stats_.streamed_responses;
+    } else {
+      connection.outbox += response.body;
+    }
+  }
+  connection.close_after_write = !keep_alive;
+  connection.deadline = Clock::now() + std::chrono::milliseconds(config_.request_timeout_ms);
+  return flush_connection(id, connection);
+}
+
+bool HttpServer::send_outbox(ConnectionId id, Connection& connection) {
+  while (connection.outbox_offset < connection.outbox.size()) {
+#ifdef MSG_NOSIGNAL
+    const ssize_t n = ::send(connection.fd, connection.outbox.data() + connection.outbox_offset,
+                             connection.outbox.size() - connection.outbox_offset, MSG_NOSIGNAL);
+#else
+    const ssize_t n = ::send(connection.fd, connection.outbox.data() + connection.outbox_offset,
+                             connection.outbox.size() - connection.outbox_offset, 0);
+#endif
+    if (n < 0) {
+      if (errno == EINTR) {
+        continue;
+      }
+      if (errno == EAGAIN || errno == EWOULDBLOCK) {
+        break;
+      }
+      close_connection(id);
+      return false;
+    }
+    connection.outbox_offset += static_cast<std::size_t>(n);
+    // The write deadline covers stalls, not the length of a large body.
+    connection.deadline = Clock::now() + std::chrono::milliseconds(config_.request_timeout_ms);
+  }
+  return true;
+}
+
+bool HttpServer::pump_stream(ConnectionId id, Connection& connection) {
+  // Sent bytes go first so the buffer stays about one window wide.
+  connection.outbox.erase(0, connection.outbox_offset);
+  connection.outbox_offset = 0;
+  while (connection.stream && connection.outbox.size() < kStreamLowWater) {
+    const std::size_t size_at = connection.outbox.size();
+    connection.outbox.append(kChunkSizeDigits, '0');
+    connection.outbox += "\r\n";
+    const std::size_t piece_at = connection.outbox.size();
+    bool more = false;
+    try {
+      more = connection.stream(connection.outbox);
+    } catch (const std::exception&) {
+      // The head is already out; cutting the body short is all that is left.
+      close_connection(id);
+      return false;
+    }
+    const std::size_t piece = connection.outbox.size() - piece_at;
+    if (piece == 0) {
+      connection.outbox.resize(size_at);
+      if (more) {
+        set_parked(connection, true);
+        break;
+      }
+    } else {
+      static constexpr char kHex[] = "0123456789abcdef";
+      for (std::size_t i = 0; i < kChunkSizeDigits; ++i) {
+        connection.outbox[size_at + kChunkSizeDigits - 1U - i] = kHex[(piece >> (4U * i)) & 0x0FU];
+      }
+      connection.outbox += "\r\n";
+    }
+    if (!more) {
+      connection.outbox += "0\r\n\r\n";
+      connection.stream = nullptr;
+    }
+  }
+  return true;
+}
+
+bool HttpServer::flush_connection(ConnectionId id, Connection& connection) {
+  // A fast reader could keep one stream pumping for its whole body; after a
+  // few windows the loop moves on and comes back on the next writable event.
+  for (std::size_t windows = 0;; ++windows) {
+    if (!send_outbox(id, connection)) {
+      return false;
+    }
+    if (!connection.stream || connection.stream_parked || windows == kStreamWindowsPerFlush ||
+        connection.outbox.size() - connection.outbox_offset >= kStreamLowWater) {
+      break;
+    }
+    if (!pump_stream(id, connection)) {
+      return false;
+    }
+  }
+
+  const bool pending = connection.outbox_offset < connection.outbox.size() ||
+                       (connection.stream && !connection.stream_parked);
+  if (pending != connection.want_write) {
+    connection.want_write = pending;
+    if (!poller_->modify(connection.fd, id, pending)) {
+      close_connection(id);
+      return false;
+    }
+  }
+  if (pending) {
+    return true;
+  }
+  connection.outbox.clear();
+  connection.outbox_offset = 0;
+  if (connection.stream) {
+    // Parked with everything sent: the client is the one waiting.
+    connection.deadline = Clock::time_point::max();
+    return true;
+  }
+  if (connection.close_after_write) {
+    close_connection(id);
+    return false;
+  }
+  if (!connection.busy) {
+    connection.deadline = Clock::now() + std::chrono::milliseconds(config_.idle_timeout_ms);
+  }
+  // Requests pipelined behind the one just answered.
+  return advance(id, connection);
+}
+
+void HttpServer::set_parked(Connection& connection, bool parked) {
+  if (connection.stream_parked == parked) {
+    return;
+  }
+  connection.stream_parked = parked;
+  const std::lock_guard lock(stats_mutex_);
+  if (parked) {
+    ++stats_.parked_streams;
+  } else {
+    --stats_.parked_streams;
+  }
+}
+
+void HttpServer::resume_parked_streams() {
+  // Flushing can close connections, so the ids are collected first.
+  std::vector<ConnectionId> parked;
+  for (const auto& [id, connection] : connections_) {
+    if (connection.stream_parked) {
+      parked.push_back(id);
+    }
+  }
+  for (const ConnectionId id : parked) {
+    const auto it = connections_.find(id);
+    if (it == connections_.end()) {
+      continue;
+    }
+    set_parked(it->second, false);
+    (void)flush_connection(id, it->second);
+  }
+}
+
+void HttpServer::close_connection(ConnectionId id) {
+  const auto it = connections_.find(id);
+  if (it == connections_.end()) {
+    return;
+  }
+  set_parked(it->second, false);
+  poller_->remove(it->second.fd);
+  util::close_socket(it->second.fd);
+  connections_.erase(it);
+  const std::lock_guard lock(stats_mutex_);
+  stats_.open_connections = connections_.size();
+}
+
+void HttpServer::apply_completions() {
+  std::vector<Completion> ready;
+  {
+    const std::lock_guard lock(completions_mutex_);
+    ready.swap(completions_);
+  }
+  if (ready.empty()) {
+    return;
+  }
+  {
+    const std::lock_guard lock(stats_mutex_);
+    stats_.handlers_in_flight -= ready.size();
+  }
+  for (Completion& completion : ready) {
+    const auto it = connections_.find(completion.connection);
+    if (it == connections_.end()) {
+      continue;
+    }
+    it->second.busy = false;
+    (void)queue_response(completion.connection, it->second, std::move(completion.response), completion.keep_alive,
+                         completion.chunked);
+  }
+}
+
+void HttpServer::expire_connections() {
+  // Deadlines are seconds long, so one pass per sweep interval is enough and
+  // a busy loop does not walk every parked connection after each event.
+  const Clock::time_point now = Clock::now();
+  if (now < next_sweep_) {
+    return;
+  }
+  next_sweep_ = now + std::chrono::milliseconds(kSweepIntervalMs);
+  std::vector<ConnectionId> expired;
+  for (const auto& [id, connection] : connections_) {
+    if (connection.deadline <= now) {
+      expired.push_back(id);
+    }
+  }
+  for (const ConnectionId id : expired) {
+    close_connection(id);
+  }
+  if (!expired.empty()) {
+    const std::lock_guard lock(stats_mutex_);
+    stats_.timeouts += expired.size();
+  }
+}
+
+#else
+
+HttpServer::~HttpServer() = default;
+
+Result HttpServer::start(const HttpServerConfig&, Handler) {
+  return Result::failure("HTTP server is not available in this build.");
+}
+
+void HttpServer::stop() {}
+
+void HttpServer::wake_streams() {}
+
+HttpServerStats HttpServer::stats() const {
+  return {};
+}
+
+#endif
+
+}  // namespace alpha
@@ -0,0 +1,255 @@
+#pragma once
+
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <optional>
+#include <string>
+#include <string_view>
+#include <thread>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+#include "core/model/types.hpp"
+#include "core/util/poller.hpp"
+#include "core/util/socket.hpp"
+#include "core/util/thread_pool.hpp"
+
+namespace alpha {
+
+struct HttpServerConfig {
+  std::string bind_host = "127.0.0.1";
+  std::uint16_t port = 0;  // 0 binds an ephemeral port (tests)
+  int backlog = 512;
+  std::size_t worker_threads = 4;
+  std::size_t max_connections = 4096;
+  std::size_t max_header_bytes = 16U << 10U;
+  std::size_t max_body_bytes = 8U << 20U;
+  // From the first byte of a request to its last, and for each stalled
+  // response write.
+  std::uint32_t request_timeout_ms = 10000;
+  // Keep-alive connections with no request in progress.
+  std::uint32_t idle_timeout_ms = 60000;
+  // Also accept connections on this AF_UNIX socket (mode 0600) when set.
+  // Its clients may speak HTTP or length-prefixed frames; see
+  // append_rpc_frame.
+  std::string unix_socket_path;
+};
+
+struct HttpServerStats {
+  bool running = false;
+  std::uint16_t bound_port = 0;
+  std::size_t open_connections = 0;
+  std::size_t handlers_in_flight = 0;
+  std::uint64_t connections_accepted = 0;
+  std::uint64_t connections_rejected = 0;  // over max_connections
+  std::uint64_t requests = 0;
+  std::uint64_t keep_alive_reuses = 0;  // requests after a connection's first
+  std::uint64_t bad_requests = 0;
+  std::uint64_t timeouts = 0;
+  std::uint64_t streamed_responses = 0;
+  std::uint64_t local_connections = 0;  // accepted on the unix socket
+  std::uint64_t framed_requests = 0;
+  std::size_t parked_streams = 0;  // streams waiting for wake_streams()
+};
+
+struct HttpRequest {
+  std::string method;
+  std::string target;
+  std::string version;
+  std::vector<std::pair<std::string, std::string>> headers;  // names lower-cased
+  std::string body;
+  bool keep_alive = true;
+  // Arrived on the unix socket, so the peer already passed its file
+  // permissions. Framed requests have method POST and target "/".
+  bool local = false;
+
+  [[nodiscard]] std::optional<std::string_view> header(std::string_view lower_name) const;
+};
+
+// Appends the next piece of a streamed body to `out` and returns false once
+// the body is complete. Called on the server thread whenever the
+// connection's send buffer runs low, so each call should produce a bounded
+// slice (tens of KiB) from state it owns and must not block. Returning true
+// with nothing appended parks the stream: the connection then costs no
+// polling and no timeout until HttpServer::wake_streams() calls it again,
+// which is how long-lived event streams wait. A body collected up front
+// (HTTP/1.0, frames) ends at the first empty piece instead.
+using HttpBodyStream = std::function<bool(std::string& out)>;
+
+struct HttpResponse {
+  int status = 200;
+  std::string content_type = "application/json";
+  std::string body;
+  // When set, replaces `body` and is sent with chunked transfer encoding as
+  // it is produced (or collected first for HTTP/1.0 clients).
+  HttpBodyStream stream;
+};
+
+// Incremental HTTP/1.x request parser. Bytes are appended to a connection
+// buffer between calls; the header terminator search resumes where the
+// last call stopped, so a request trickling in is scanned once. Bodies need
+// Content-Length; chunked uploads are refused.
+class HttpRequestParser {
+public:
+  enum class State {
+    NeedMore,
+    Complete,
+    Error,
+  };
+
+  HttpRequestParser(std::size_t max_header_bytes, std::size_t max_body_bytes);
+
+  // On Complete the request's bytes are removed from the front of `buffer`
+  // and any pipelined bytes behind it stay for the next call.
+  State parse(std::string& buffer, HttpRequest& out);
+  // 400, 413, 431 or 501 after Error.
+  [[nodiscard]] int error_status() const { return error_status_; }
+
+private:
+  State fail(int status);
+  bool parse_head(std::string_view head, HttpRequest& out);
+
+  std::size_t max_header_bytes_;
+  std::size_t max_body_bytes_;
+  std::size_t scan_offset_ = 0;
+  std::size_t head_bytes_ = 0;  // through the blank line, 0 until found
+  std::size_t content_length_ = 0;
+  HttpRequest head_;
+  int error_status_ = 0;
+};
+
+// Length-prefixed framing for unix socket clients: a 4-byte big-endian
+// payload length, then the payload. Requests and responses are framed alike
+// and carry the JSON-RPC text alone, with no status line or headers; a 204
+// is an empty frame. A connection is framed when its first byte is 0, which
+// no HTTP request starts with, so frames are limited to 16 MiB and to
+// max_body_bytes.
+inline constexpr std::size_t kRpcFrameHeaderBytes = 4;
+void append_rpc_frame(std::string& out, std::string_view payload);
+// Payload length of the frame at the front of `buffer`, or nullopt until its
+// header has arrived.
+[[nodiscard]] std::optional<std::size_t> rpc_frame_length(std::string_view buffer);
+
+[[nodiscard]] std::string_view http_status_text(int status);
+[[nodiscard]] std::string serialize_http_response(const HttpResponse& response, bool keep_alive);
+// Status line and headers only; a streamed response is declared chunked.
+void append_http_head(std::string& out, const HttpResponse& response, bool keep_alive);
+
+// HTTP/1.1 server for the daemon's JSON-RPC surface. One thread owns the
+// sockets (epoll on Linux) and parses requests as bytes arrive; complete
+// requests run on a worker pool so a slow handler never holds up other
+// connections. Connections are kept alive between requests, pipelined
+// requests are answered in order, and idle or stalled connections are
+// closed on their deadlines. Streamed bodies are pulled a slice at a time
+// into the connection's send buffer, which is reused across responses, so
+// a large result never sits in memory as one string. The handler runs on worker threads, so it
+// must serialize access to shared state itself. With unix_socket_path set,
+// the same loop also serves a unix socket whose requests are marked local
+// and may use length-prefixed frames instead of HTTP.
+class HttpServer {
+public:
+  using Handler = std::function<HttpResponse(const HttpRequest&)>;
+
+  HttpServer() = default;
+  HttpServer(const HttpServer&) = delete;
+  HttpServer& operator=(const HttpServer&) = delete;
+  ~HttpServer();
+
+  Result start(const HttpServerConfig& config, Handler handler);
+  void stop();
+
+  [[nodiscard]] bool running() const { return running_.load(); }
+  [[nodiscard]] std::uint16_t bound_port() const { return bound_port_; }
+  [[nodiscard]] HttpServerStats stats() const;
+  // Calls every parked stream again on the server thread. Safe from any
+  // thread, before start() and after stop() included; wakes that arrive
+  // before the loop gets to them are coalesced into one pass.
+  void wake_streams();
+
+private:
+  using ConnectionId = std::uint64_t;
+  using Clock = std::chrono::steady_clock;
+
+  enum class Framing : std::uint8_t {
+    Sniff,  // unix socket connection before its first byte
+    Http,
+    LengthPrefixed,
+  };
+
+  struct Connection {
+    explicit Connection(const HttpServerConfig& config)
+        : parser(config.max_header_bytes, config.max_body_bytes) {}
+
+    int fd = util::kInvalidSocket;
+    bool local = false;
+    Framing framing = Framing::Http;
+    std::string inbox;
+    std::string outbox;
+    std::size_t outbox_offset = 0;
+    HttpRequestParser parser;
+    bool busy = false;  // a handler owns the current request
+    bool close_after_write = false;
+    HttpBodyStream stream;  // set while a chunked body is being produced
+    bool stream_parked = false;
+    bool want_write = false;
+    std::uint64_t requests = 0;
+    Clock::time_point deadline;
+  };
+
+  struct Completion {
+    ConnectionId connection = 0;
+    HttpResponse response;
+    bool keep_alive = false;
+    bool chunked = false;  // the client speaks HTTP/1.1
+  };
+
+  void run();
+  void accept_connections(int listen_fd, bool local);
+  // Each returns false once the connection has been closed.
+  bool read_connection(ConnectionId id, Connection& connection);
+  bool advance(ConnectionId id, Connection& connection);
+  // Cuts the next request off the inbox; nullopt when it is incomplete or
+  // the connection was answered with an error.
+  std::optional<HttpRequest> next_request(ConnectionId id, Connection& connection, bool& open);
+  bool queue_response(ConnectionId id, Connection& connection, HttpResponse response, bool keep_alive,
+                      bool chunked = true);
+  bool flush_connection(ConnectionId id, Connection& connection);
+  bool send_outbox(ConnectionId id, Connection& connection);
+  // Tops the send buffer up from the connection's stream; false when the
+  // stream failed and the connection was closed.
+  bool pump_stream(ConnectionId id, Connection& connection);
+  void set_parked(Connection& connection, bool parked);
+  void resume_parked_streams();
+  void close_connection(ConnectionId id);
+  void apply_completions();
+  void expire_connections();
+
+  HttpServerConfig config_;
+  Handler handler_;
+  std::atomic<bool> running_{false};
+  std::atomic<bool> streams_woken_{false};
+  std::thread thread_;
+  std::unique_ptr<util::Poller> poller_;
+  std::unique_ptr<util::WakePipe> wake_;
+  std::unique_ptr<util::ThreadPool> workers_;
+  int listen_fd_ = util::kInvalidSocket;
+  int unix_listen_fd_ = util::kInvalidSocket;
+  std::uint16_t bound_port_ = 0;
+  ConnectionId next_connection_id_ = 1;
+  Clock::time_point next_sweep_;
+  std::unordered_map<ConnectionId, Connection> connections_;
+
+  std::mutex completions_mutex_;
+  std::vector<Completion> completions_;
+
+  mutable std::mutex stats_mutex_;
+  HttpServerStats stats_;
+};
+
+}  // namespace alpha
@@ -0,0 +1,541 @@
+#include "core/rpc/json.hpp"
+
+#include <charconv>
+#include <cmath>
+#include <limits>
+#include <utility>
+
+namespace alpha {
+namespace {
+
+bool is_space(char c) {
+  return c == ' ' || c == '\t' || c == '\n' || c == '\r';
+}
+
+bool is_digit(char c) {
+  return c >= '0' && c <= '9';
+}
+
+std::optional<std::uint32_t> hex4(std::string_view text, std::size_t at) {
+  if (at + 4U > text.size()) {
+    return std::nullopt;
+  }
+  std::uint32_t value = 0;
+  for (std::size_t i = at; i < at + 4U; ++i) {
+    const char c = text[i];
+    value <<= 4U;
+    if (c >= '0' && c <= '9') {
+      value |= static_cast<std::uint32_t>(c - '0');
+    } else if (c >= 'a' && c <= 'f') {
+      value |= static_cast<std::uint32_t>(c - 'a' + 10);
+    } else if (c >= 'A' && c <= 'F') {
+      value |= static_cast<std::uint32_t>(c - 'A' + 10);
+    } else {
+      return std::nullopt;
+    }
+  }
+  return value;
+}
+
+void append_utf8(std::string& out, std::uint32_t code_point) {
+  if (code_point < 0x80U) {
+    out.push_back(static_cast<char>(code_point));
+  } else if (code_point < 0x800U) {
+    out.push_back(static_cast<char>(0xC0U | (code_point >> 6U)));
+    out.push_back(static_cast<char>(0x80U | (code_point & 0x3FU)));
+  } else if (code_point < 0x10000U) {
+    out.push_back(static_cast<char>(0xE0U | (code_point >> 12U)));
+    out.push_back(static_cast<char>(0x80U | ((code_point >> 6U) & 0x3FU)));
+    out.push_back(static_cast<char>(0x80U | (code_point & 0x3FU)));
+  } else {
+    out.push_back(static_cast<char>(0xF0U | (code_point >> 18U)));
+    out.push_back(static_cast<char>(0x80U | ((code_point >> 12U) & 0x3FU)));
+    out.push_back(static_cast<char>(0x80U | ((code_point >> 6U) & 0x3FU)));
+    out.push_back(static_cast<char>(0x80U | (code_point & 0x3FU)));
+  }
+}
+
+}  // namespace
+
+void append_json_string(std::string& out, std::string_view value) {
+  static constexpr char kHex[] = "0123456789abcdef";
+  out.reserve(out.size() + value.size() + 2U);
+  out.push_back('"');
+  std::size_t run = 0;
+  for (std::size_t i = 0; i < value.size(); ++i) {
+    const auto c = static_cast<unsigned char>(value[i]);
+    if (c >= 0x20U && c != '"' && c != '\\') {
+      continue;
+    }
+    out.append(value.substr(run, i - run));
+    run = i + 1U;
+    switch (c) {
+      case '"': out += "\\\""; break;
+      case '\\': out += "\\\\"; break;
+      case '\n': out += "\\n"; break;
+      case '\r': out += "\\r"; break;
+      case '\t': out += "\\t"; break;
+      case '\b': out += "\\b"; break;
+      case '\f': out += "\\f"; break;
+      default:
+        out += "\\u00";
+        out.push_back(kHex[c >> 4U]);
+        out.push_back(kHex[c & 0x0FU]);
+        break;
+    }
+  }
+  out.append(value.substr(run));
+  out.push_back('"');
+}
+
+JsonWriter& JsonWriter::key(std::string_view name) {
+  separate();
+  append_json_string(out_, name);
+  out_.push_back(':');
+  after_key_ = true;
+  return *this;
+}
+
+JsonWriter& JsonWriter::value(std::string_view text) {
+  separate();
+  append_json_string(out_, text);
+  return *this;
+}
+
+JsonWriter& JsonWriter::value(bool flag) {
+  separate();
+  out_ += flag ? "true" : "false";
+  return *this;
+}
+
+JsonWriter& JsonWriter::value(double number) {
+  if (!std::isfinite(number)) {
+    return null();
+  }
+  separate();
+  char digits[32];
+  const auto [end, ec] = std::to_chars(digits, digits + sizeof(digits), number);
+  out_.append(digits, end);
+  return *this;
+}
+
+JsonWriter& JsonWriter::null() {
+  separate();
+  out_ += "null";
+  return *this;
+}
+
+JsonWriter& JsonWriter::raw(std::string_view json) {
+  separate();
+  out_ += json;
+  return *this;
+}
+
+JsonWriter& JsonWriter::open(char bracket) {
+  separate();
+  out_.push_back(bracket);
+  ++depth_;
+  if (depth_ <= 64U) {
+    filled_ &= ~(std::uint64_t{1} << (depth_ - 1U));
+  }
+  return *this;
+}
+
+JsonWriter& JsonWriter::close(char bracket) {
+  out_.push_back(bracket);
+  depth_ -= depth_ > 0 ? 1U : 0U;
+  return *this;
+}
+
+void JsonWriter::separate() {
+  if (after_key_) {
+    after_key_ = false;
+    return;
+  }
+  if (depth_ == 0 || depth_ > 64U) {
+    return;
+  }
+  const std::uint64_t bit = std::uint64_t{1} << (depth_ - 1U);
+  if ((filled_ & bit) != 0U) {
+    out_.push_back(',');
+  }
+  filled_ |= bit;
+}
+
+std::optional<std::string> json_unescape(std::string_view contents) {
+  std::string out;
+  out.reserve(contents.size());
+  for (std::size_t i = 0; i < contents.size(); ++i) {
+    const char c = contents[i];
+    if (c != '\\') {
+      out.push_back(c);
+      continue;
+    }
+    if (++i >= contents.size()) {
+      return std::nullopt;
+    }
+    switch (contents[i]) {
+      case '"': out.push_back('"'); break;
+      case '\\': out.push_back('\\'); break;
+      case '/': out.push_back('/'); break;
+      case 'b': out.push_back('\b'); break;
+      case 'f': out.push_back('\f'); break;
+      case 'n': out.push_back('\n'); break;
+      case 'r': out.push_back('\r'); break;
+      case 't': out.push_back('\t'); break;
+      case 'u': {
+        std::optional<std::uint32_t> unit = hex4(contents, i + 1U);
+        if (!unit.has_value()) {
+          return std::nullopt;
+        }
+        i += 4U;
+        std::uint32_t code_point = *unit;
+        if (code_point >= 0xDC00U && code_point <= 0xDFFFU) {
+          return std::nullopt;
+        }
+        if (code_point >= 0xD800U && code_point <= 0xDBFFU) {
+          if (i + 2U >= contents.size() || contents[i + 1U] != '\\' || contents[i + 2U] != 'u') {
+            return std::nullopt;
+          }
+          const std::optional<std::uint32_t> low = hex4(contents, i + 3U);
+          if (!low.has_value() || *low < 0xDC00U || *low > 0xDFFFU) {
+            return std::nullopt;
+          }
+          i += 6U;
+          code_point = 0x10000U + ((code_point - 0xD800U) << 10U) + (*low - 0xDC00U);
+        }
+        append_utf8(out, code_point);
+        break;
+      }
+      default:
+        return std::nullopt;
+    }
+  }
+  return out;
+}
+
+// Recursive descent over the text, appending nodes as values close.
+class JsonParser {
+public:
+  JsonParser(std::string_view text, JsonDocument& document) : text_(text), document_(document) {}
+
+  bool run() {
+    skip_space();
+    if (!parse_value(0)) {
+      return false;
+    }
+    skip_space();
+    return pos_ == text_.size() || fail("trailing characters after JSON value");
+  }
+
+  [[nodiscard]] std::string error() const { return error_ + " at offset " + std::to_string(pos_); }
+
+private:
+  bool fail(std::string message) {
+    if (error_.empty()) {
+      error_ = std::move(message);
+    }
+    return false;
+  }
+
+  void skip_space() {
+    while (pos_ < text_.size() && is_space(text_[pos_])) {
+      ++pos_;
+    }
+  }
+
+  std::uint32_t add_node(JsonType type, std::size_t start) {
+    document_.nodes_.push_back({.type = type, .raw = text_.substr(start, pos_ - start)});
+    return static_cast<std::uint32_t>(document_.nodes_.size() - 1U);
+  }
+
+  // The root takes slot 0 whatever its type, so it is reserved up front and
+  // filled in when it closes.
+  std::uint32_t reserve_node() {
+    document_.nodes_.emplace_back();
+    return static_cast<std::uint32_t>(document_.nodes_.size() - 1U);
+  }
+
+  bool parse_value(std::size_t depth) {
+    if (pos_ >= text_.size()) {
+      return fail("unexpected end of input");
+    }
+    const std::uint32_t slot = reserve_node();
+    const std::size_t start = pos_;
+    JsonDocument::Node node;
+    switch (text_[pos_]) {
+      case '{':
+      case '[':
+        if (depth >= JsonDocument::kMaxDepth) {
+          return fail("nesting too deep");
+        }
+        if (!parse_container(depth, node)) {
+          return false;
+        }
+        break;
+      case '"':
+        node.type = JsonType::String;
+        if (!scan_string(node.escaped)) {
+          return false;
+        }
+        break;
+      case 't':
+      case 'f':
+      case 'n': {
+        const std::string_view word = text_[pos_] == 't' ? "true" : text_[pos_] == 'f' ? "false" : "null";
+        if (text_.substr(pos_, word.size()) != word) {
+          return fail("invalid literal");
+        }
+        pos_ += word.size();
+        node.type = word == "null" ? JsonType::Null : JsonType::Bool;
+        break;
+      }
+      default:
+        node.type = JsonType::Number;
+        if (!scan_number()) {
+          return false;
+        }
+        break;
+    }
+    node.raw = text_.substr(start, pos_ - start);
+    document_.nodes_[slot] = node;
+    last_value_ = slot;
+    return true;
+  }
+
+  bool parse_container(std::size_t depth, JsonDocument::Node& node) {
+    const bool object = text_[pos_] == '{';
+    const char close = object ? '}' : ']';
+    node.type = object ? JsonType::Object : JsonType::Array;
+    ++pos_;
+    const std::size_t base = pending_.size();
+    skip_space();
+    if (pos_ < text_.size() && text_[pos_] == close) {
+      ++pos_;
+      node.first = static_cast<std::uint32_t>(document_.children_.size());
+      return true;
+    }
+    while (true) {
+      std::uint32_t key = 0;
+      if (object) {
+        skip_space();
+        if (pos_ >= text_.size() || text_[pos_] != '"') {
+          return fail("expected member name");
+        }
+        const std::size_t key_start = pos_;
+        bool escaped = false;
+        if (!scan_string(escaped)) {
+          return false;
+        }
+        key = add_node(JsonType::String, key_start);
+        document_.nodes_[key].escaped = escaped;
+        skip_space();
+        if (pos_ >= text_.size() || text_[pos_] != ':') {
+          return fail("expected ':' after member name");
+        }
+        ++pos_;
+      }
+      skip_space();
+      if (!parse_value(depth + 1U)) {
+        return false;
+      }
+      document_.nodes_[last_value_].key = key;
+      pending_.push_back(last_value_);
+      skip_space();
+      if (pos_ >= text_.size()) {
+        return fail("unterminated container");
+      }
+      if (text_[pos_] == ',') {
+        ++pos_;
+        continue;
+      }
+      if (text_[pos_] == close) {
+        ++pos_;
+        break;
+      }
+      return fail(object ? "expected ',' or '}'" : "expected ',' or ']'");
+    }
+    // Children of nested containers were flushed when those closed, so this
+    // container's direct children are the tail of pending_.
+    node.first = static_cast<std::uint32_t>(document_.children_.size());
+    node.count = static_cast<std::uint32_t>(pending_.size() - base);
+    document_.children_.insert(document_.children_.end(), pending_.begin() + static_cast<std::ptrdiff_t>(base),
+                               pending_.end());
+    pending_.resize(base);
+    return true;
+  }
+
+  bool scan_string(bool& escaped) {
+    ++pos_;
+    escaped = false;
+    while (pos_ < text_.size()) {
+      const char c = text_[pos_];
+      if (c == '"') {
+        ++pos_;
+        return true;
+      }
+      if (static_cast<unsigned char>(c) < 0x20U) {
+        return fail("control character in string");
+      }
+      if (c == '\\') {
+        escaped = true;
+        const char next = pos_ + 1U < text_.size() ? text_[pos_ + 1U] : '\0';
+        if (next == 'u') {
+          if (!hex4(text_, pos_ + 2U).has_value()) {
+            return fail("invalid \\u escape");
+          }
+          pos_ += 6U;
+          continue;
+        }
+        if (std::string_view{"\"\\/bfnrt"}.find(next) == std::string_view::npos) {
+          return fail("invalid escape");
+        }
+        pos_ += 2U;
+        continue;
+      }
+      ++pos_;
+    }
+    return fail("unterminated string");
+  }
+
+  bool scan_number() {
+    const std::size_t start = pos_;
+    if (pos_ < text_.size() && text_[pos_] == '-') {
+      ++pos_;
+    }
+    if (pos_ >= text_.size() || !is_digit(text_[pos_])) {
+      return fail("invalid value");
+    }
+    if (text_[pos_] == '0') {
+      ++pos_;
+    } else {
+      while (pos_ < text_.size() && is_digit(text_[pos_])) {
+        ++pos_;
+      }
+    }
+    if (pos_ < text_.size() && text_[pos_] == '.') {
+      ++pos_;
+      if (pos_ >= text_.size() || !is_digit(text_[pos_])) {
+        return fail("invalid number");
+      }
+      while (pos_ < text_.size() && is_digit(text_[pos_])) {
+        ++pos_;
+      }
+    }
+    if (pos_ < text_.size() && (text_[pos_] == 'e' || text_[pos_] == 'E')) {
+      ++pos_;
+      if (pos_ < text_.size() && (text_[pos_] == '+' || text_[pos_] == '-')) {
+        ++pos_;
+      }
+      if (pos_ >= text_.size() || !is_digit(text_[pos_])) {
+        return fail("invalid number");
+      }
+      while (pos_ < text_.size() && is_digit(text_[pos_])) {
+        ++pos_;
+      }
+    }
+    return pos_ > start;
+  }
+
+  std::string_view text_;
+  JsonDocument& document_;
+  std::size_t pos_ = 0;
+  std::uint32_t last_value_ = 0;
+  std::vector<std::uint32_t> pending_;
+  std::string error_;
+};
+
+std::optional<JsonDocument> JsonDocument::parse(std::string_view text, std::string* error) {
+  if (text.size() >= std::numeric_limits<std::uint32_t>::max()) {
+    if (error != nullptr) {
+      *error = "document too large";
+    }
+    return std::nullopt;
+  }
+  JsonDocument document;
+  document.nodes_.reserve(text.size() / 8U + 1U);
+  JsonParser parser(text, document);
+  if (!parser.run()) {
+    if (error != nullptr) {
+      *error = parser.error();
+    }
+    return std::nullopt;
+  }
+  return document;
+}
+
+JsonType JsonValue::type() const {
+  return document_->nodes_[node_].type;
+}
+
+std::string_view JsonValue::raw() const {
+  return document_->nodes_[node_].raw;
+}
+
+std::optional<std::string> JsonValue::as_string() const {
+  const JsonDocument::Node& node = document_->nodes_[node_];
+  if (node.type != JsonType::String) {
+    return std::nullopt;
+  }
+  const std::string_view contents = node.raw.substr(1, node.raw.size() - 2U);
+  if (!node.escaped) {
+    return std::string{contents};
+  }
+  return json_unescape(contents);
+}
+
+std::optional<std::string_view> JsonValue::as_string_view() const {
+  const JsonDocument::Node& node = document_->nodes_[node_];
+  if (node.type != JsonType::String || node.escaped) {
+    return std::nullopt;
+  }
+  return node.raw.substr(1, node.raw.size() - 2U);
+}
+
+std::optional<long long> JsonValue::as_int() const {
+  const JsonDocument::Node& node = document_->nodes_[node_];
+  if (node.type != JsonType::Number) {
+    return std::nullopt;
+  }
+  long long value = 0;
+  const auto [end, ec] = std::from_chars(node.raw.data(), node.raw.data() + node.raw.size(), value);
+  if (ec != std::errc{} || end != node.raw.data() + node.raw.size()) {
+    return std::nullopt;
+  }
+  return value;
+}
+
+std::optional<bool> JsonValue::as_bool() const {
+  const JsonDocument::Node& node = document_->nodes_[node_];
+  if (node.type != JsonType::Bool) {
+    return std::nullopt;
+  }
+  return node.raw == "true";
+}
+
+std::size_t JsonValue::size() const {
+  return document_->nodes_[node_].count;
+}
+
+JsonValue JsonValue::at(std::size_t index) const {
+  const JsonDocument::Node& node = document_->nodes_[node_];
+  return {document_, document_->children_[node.first + index]};
+}
+
+std::optional<JsonValue> JsonValue::find(std::string_view key) const {
+  const JsonDocument::Node& node = document_->nodes_[node_];
+  if (node.type != JsonType::Object) {
+    return std::nullopt;
+  }
+  for (std::size_t i = node.count; i-- > 0;) {
+    const std::uint32_t child = document_->children_[node.first + i];
+    const JsonDocument::Node& name = document_->nodes_[document_->nodes_[child].key];
+    const std::string_view contents = name.raw.substr(1, name.raw.size() - 2U);
+    if (!name.escaped ? contents == key : json_unescape(contents) == key) {
+      return JsonValue{document_, child};
+    }
+  }
+  return std::nullopt;
+}
+
+}  // namespace alpha
@@ -0,0 +1,153 @@
+#pragma once
+
+#include <charconv>
+#include <concepts>
+#include <cstddef>
+#include <cstdint>
+#include <optional>
+#include <string>
+#include <string_view>
+#include <vector>
+
+namespace alpha {
+
+enum class JsonType : std::uint8_t {
+  Null,
+  Bool,
+  Number,
+  String,
+  Array,
+  Object,
+};
+
+class JsonDocument;
+
+// Handle to one value inside a JsonDocument. Cheap to copy; valid while the
+// document and the text it parsed are alive.
+class JsonValue {
+public:
+  [[nodiscard]] JsonType type() const;
+  [[nodiscard]] bool is_null() const { return type() == JsonType::Null; }
+  [[nodiscard]] bool is_string() const { return type() == JsonType::String; }
+  [[nodiscard]] bool is_array() const { return type() == JsonType::Array; }
+  [[nodiscard]] bool is_object() const { return type() == JsonType::Object; }
+
+  // The value's source text: strings keep their quotes, containers span
+  // their brackets. Suitable for echoing a value back verbatim.
+  [[nodiscard]] std::string_view raw() const;
+
+  // Decoded string contents, escapes and \uXXXX included.
+  [[nodiscard]] std::optional<std::string> as_string() const;
+  // Borrowed string contents when the string has no escapes, which is the
+  // common case and costs no allocation.
+  [[nodiscard]] std::optional<std::string_view> as_string_view() const;
+  // Integers only; fractions and exponents do not convert.
+  [[nodiscard]] std::optional<long long> as_int() const;
+  [[nodiscard]] std::optional<bool> as_bool() const;
+
+  // Elements of an array or members of an object.
+  [[nodiscard]] std::size_t size() const;
+  [[nodiscard]] JsonValue at(std::size_t index) const;
+  // Object member by key; the last one wins when a key repeats.
+  [[nodiscard]] std::optional<JsonValue> find(std::string_view key) const;
+
+private:
+  friend class JsonDocument;
+  JsonValue(const JsonDocument* document, std::uint32_t node) : document_(document), node_(node) {}
+
+  const JsonDocument* document_;
+  std::uint32_t node_;
+};
+
+// Single-pass JSON parser. Tokens are recorded as views into the source
+// text instead of being copied, and a container keeps the indices of its
+// children, so member lookups never rescan the input. Strings are only
+// decoded when asked for. Rejects anything RFC 8259 does not allow.
+class JsonDocument {
+public:
+  static constexpr std::size_t kMaxDepth = 64;
+
+  // `text` must outlive the document.
+  [[nodiscard]] static std::optional<JsonDocument> parse(std::string_view text, std::string* error = nullptr);
+
+  [[nodiscard]] JsonValue root() const { return {this, 0}; }
+
+private:
+  friend class JsonValue;
+  friend class JsonParser;
+
+  struct Node {
+    JsonType type = JsonType::Null;
+    bool escaped = false;        // strings: contents contain backslashes
+    std::uint32_t key = 0;       // object members: node index of the key string
+    std::uint32_t first = 0;     // containers: offset into children_
+    std::uint32_t count = 0;     // containers: element or member count
+    std::string_view raw;
+  };
+
+  std::vector<Node> nodes_;
+  // Child node indices, each container's contiguous. Object members are
+  // value nodes; their key is in Node::key.
+  std::vector<std::uint32_t> children_;
+};
+
+// Appends `value` as a quoted JSON string. Quotes, backslashes and control
+// characters are escaped; other bytes pass through as UTF-8.
+void append_json_string(std::string& out, std::string_view value);
+
+// Appends JSON straight into a caller's buffer, tracking where commas go so
+// builders only name keys and values. Nothing is buffered inside the writer:
+// a response built with it is the response body, and a streamed body can
+// hand it the connection's send buffer. Nesting is limited to 64 levels.
+class JsonWriter {
+public:
+  explicit JsonWriter(std::string& out) : out_(out) {}
+
+  JsonWriter& begin_object() { return open('{'); }
+  JsonWriter& end_object() { return close('}'); }
+  JsonWriter& begin_array() { return open('['); }
+  JsonWriter& end_array() { return close(']'); }
+  JsonWriter& key(std::string_view name);
+
+  JsonWriter& value(std::string_view text);
+  JsonWriter& value(const char* text) { return value(std::string_view{text}); }
+  JsonWriter& value(const std::string& text) { return value(std::string_view{text}); }
+  JsonWriter& value(bool flag);
+  JsonWriter& value(double number);  // non-finite values become null
+  template <std::integral T>
+  JsonWriter& value(T number) {
+    separate();
+    char digits[24];
+    const auto [end, ec] = std::to_chars(digits, digits + sizeof(digits), number);
+    out_.append(digits, end);
+    return *this;
+  }
+  JsonWriter& null();
+  // A value that is already JSON, such as an echoed request id.
+  JsonWriter& raw(std::string_view json);
+
+  template <typename T>
+  JsonWriter& member(std::string_view name, const T& item) {
+    key(name);
+    return value(item);
+  }
+
+  [[nodiscard]] std::string& buffer() { return out_; }
+
+private:
+  JsonWriter& open(char bracket);
+  JsonWriter& close(char bracket);
+  void separate();
+
+  std::string& out_;
+  // One bit per open container: set once it has an element.
+  std::uint64_t filled_ = 0;
+  std::size_t depth_ = 0;
+  bool after_key_ = false;
+};
+
+// Decodes the contents of a JSON string literal (without its quotes) into
+// UTF-8. Returns nullopt on a malformed escape or lone surrogate.
+[[nodiscard]] std::optional<std::string> json_unescape(std::string_view contents);
+
+}  // namespace alpha
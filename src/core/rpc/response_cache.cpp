@@ -0,0 +1,71 @@
+#include "core/rpc/response_cache.hpp"
+
+#include <algorithm>
+
+namespace alpha {
+
+ResponseCache::ResponseCache(ResponseCacheConfig config) : config_(config) {
+  config_.max_entries = std::max<std::size_t>(config_.max_entries, 1U);
+}
+
+ResponseCache::Body ResponseCache::find(std::string_view key, std::uint64_t generation) {
+  const std::lock_guard lock(mutex_);
+  const auto it = index_.find(key);
+  if (it == index_.end()) {
+    ++stats_.misses;
+    return nullptr;
+  }
+  if (it->second->generation != generation) {
+    ++stats_.misses;
+    ++stats_.stale;
+    erase(it->second);
+    return nullptr;
+  }
+  ++stats_.hits;
+  lru_.splice(lru_.begin(), lru_, it->second);
+  return lru_.front().body;
+}
+
+void ResponseCache::insert(std::string key, std::uint64_t generation, Body body) {
+  if (!body) {
+    return;
+  }
+  const std::lock_guard lock(mutex_);
+  if (const auto it = index_.find(key); it != index_.end()) {
+    erase(it->second);
+  }
+  if (body->size() > config_.max_entry_bytes) {
+    ++stats_.oversized;
+    return;
+  }
+  stats_.bytes += body->size();
+  lru_.push_front({.key = std::move(key), .generation = generation, .body = std::move(body)});
+  index_.emplace(lru_.front().key, lru_.begin());
+  while (lru_.size() > config_.max_entries || stats_.bytes > config_.max_bytes) {
+    erase(std::prev(lru_.end()));
+    ++stats_.evictions;
+  }
+  stats_.entries = lru_.size();
+}
+
+void ResponseCache::clear() {
+  const std::lock_guard lock(mutex_);
+  index_.clear();
+  lru_.clear();
+  stats_.entries = 0;
+  stats_.bytes = 0;
+}
+
+ResponseCacheStats ResponseCache::stats() const {
+  const std::lock_guard lock(mutex_);
+  return stats_;
+}
+
+void ResponseCache::erase(std::list<Entry>::iterator entry) {
+  stats_.bytes -= entry->body->size();
+  index_.erase(entry->key);
+  lru_.erase(entry);
+  stats_.entries = lru_.size();
+}
+
+}  // namespace alpha
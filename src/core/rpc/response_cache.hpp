@@ -0,0 +1,70 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <list>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+
+namespace alpha {
+
+struct ResponseCacheConfig {
+  std::size_t max_entries = 512;
+  std::size_t max_bytes = 32U << 20U;
+  // Larger results are answered but not kept.
+  std::size_t max_entry_bytes = 4U << 20U;
+};
+
+struct ResponseCacheStats {
+  std::uint64_t hits = 0;
+  std::uint64_t misses = 0;
+  std::uint64_t stale = 0;  // misses that found an entry from an older generation
+  std::uint64_t evictions = 0;
+  std::uint64_t oversized = 0;
+  std::size_t entries = 0;
+  std::size_t bytes = 0;
+};
+
+// LRU cache of serialized read-only RPC results. Each entry remembers the
+// state generation it was computed at, and a lookup at any other generation
+// drops it, so a (key, generation) pair is never answered from older state
+// and nothing has to be invalidated explicitly when the state moves on.
+// Results are shared immutable strings: a hit hands out a reference, and
+// an entry evicted while a response is still streaming from it stays alive
+// until that response is done. Safe to use from any thread.
+class ResponseCache {
+public:
+  using Body = std::shared_ptr<const std::string>;
+
+  explicit ResponseCache(ResponseCacheConfig config = {});
+  ResponseCache(const ResponseCache&) = delete;
+  ResponseCache& operator=(const ResponseCache&) = delete;
+
+  // The result cached under `key` at `generation`, or null.
+  [[nodiscard]] Body find(std::string_view key, std::uint64_t generation);
+  // Replaces any entry under `key`, then evicts from the cold end until the
+  // cache is back within its bounds.
+  void insert(std::string key, std::uint64_t generation, Body body);
+  void clear();
+  [[nodiscard]] ResponseCacheStats stats() const;
+
+private:
+  struct Entry {
+    std::string key;
+    std::uint64_t generation = 0;
+    Body body;
+  };
+
+  void erase(std::list<Entry>::iterator entry);
+
+  ResponseCacheConfig config_;
+  mutable std::mutex mutex_;
+  std::list<Entry> lru_;  // most recently used first; nodes never move
+  std::unordered_map<std::string_view, std::list<Entry>::iterator> index_;  // keys view into lru_
+  ResponseCacheStats stats_;
+};
+
+}  // namespace alpha
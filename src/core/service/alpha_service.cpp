@@ -18,10 +18,15 @@
 #include "core/model/app_meta.hpp"
 #include "core/util/canonical.hpp"
 #include "core/util/hash.hpp"
+#include "core/util/metrics.hpp"
 
 namespace alpha {
 namespace {
 
+// Verified remote events applied per tick; each batch rebuilds blocks and
+// views once.
+constexpr std::size_t kMaxIngestApplyBatch = 4096;
+
 bool looks_like_path(std::string_view value) {
   return value.find('/') != std::string_view::npos || value.find('\\') != std::string_view::npos ||
          value.ends_with(".dat");
@@ -465,6 +470,7 @@ void seed_default_assets(std::string_view app_data_dir) {
 }  // namespace
 
 Result AlphaService::init(const InitConfig& config) {
+  note_state_change();
   config_ = config;
   if (config_.p2p_mainnet_port == 0) {
     config_.p2p_mainnet_port = 4001;
@@ -498,6 +504,21 @@ Result AlphaService::init(const InitConfig& config) {
     return release_reset;
   }
 
+  crypto_.configure_kdf_cache({
+      .capacity = config_.kdf_cache_entries,
+      .ttl_seconds = config_.kdf_cache_ttl_seconds,
+  });
+  p2p_node_.configure_initial_sync({.min_peer_events = config_.initial_sync_min_peer_events});
+  p2p_node_.set_compression(config_.p2p_compression);
+  p2p_node_.configure_seen_filter({
+      .max_bytes = config_.seen_filter_max_bytes,
+      .false_positive_rate = config_.seen_filter_false_positive_rate,
+  });
+  ingest_pipeline_ = std::make_unique<IngestPipeline>(signature_verifier_, config_.validation_limits,
+                                                      IngestPipelineConfig{
+                                                          .capacity = config_.ingest_queue_capacity,
+                                                          .threaded = config_.ingest_pipeline_threads,
+                                                      });
   const Result crypto_init =
       crypto_.initialize(config_.app_data_dir, config_.passphrase, config_.production_swap);
   if (!crypto_init.ok) {
@@ -761,6 +782,7 @@ Result AlphaService::apply_release_reset_if_needed() {
 }
 
 Result AlphaService::create_recipe(const RecipeDraft& draft) {
+  note_state_change();
   if (const Result unlocked = ensure_wallet_ready_for_mutation("create_recipe"); !unlocked.ok) {
     return unlocked;
   }
@@ -811,6 +833,7 @@ Result AlphaService::create_recipe(const RecipeDraft& draft) {
 }
 
 Result AlphaService::create_thread(const ThreadDraft& draft) {
+  note_state_change();
   if (const Result unlocked = ensure_wallet_ready_for_mutation("create_thread"); !unlocked.ok) {
     return unlocked;
   }
@@ -846,6 +869,7 @@ Result AlphaService::create_thread(const ThreadDraft& draft) {
 }
 
 Result AlphaService::create_reply(const ReplyDraft& draft) {
+  note_state_change();
   if (const Result unlocked = ensure_wallet_ready_for_mutation("create_reply"); !unlocked.ok) {
     return unlocked;
   }
@@ -880,6 +904,7 @@ Result AlphaService::create_reply(const ReplyDraft& draft) {
 }
 
 Result AlphaService::add_review(const ReviewDraft& draft) {
+  note_state_change();
   if (const Result unlocked = ensure_wallet_ready_for_mutation("add_review"); !unlocked.ok) {
     return unlocked;
   }
@@ -914,6 +939,7 @@ Result AlphaService::add_review(const ReviewDraft& draft) {
 }
 
 Result AlphaService::add_thumb_up(std::string_view recipe_id) {
+  note_state_change();
   if (const Result unlocked = ensure_wallet_ready_for_mutation("add_thumb_up"); !unlocked.ok) {
     return unlocked;
   }
@@ -945,6 +971,7 @@ Result AlphaService::add_thumb_up(std::string_view recipe_id) {
 }
 
 Result AlphaService::transfer_rewards(const RewardTransferDraft& draft) {
+  note_state_change();
   if (const Result unlocked = ensure_wallet_ready_for_mutation("transfer_rewards"); !unlocked.ok) {
     return unlocked;
   }
@@ -993,6 +1020,7 @@ Result AlphaService::transfer_rewards(const RewardTransferDraft& draft) {
 }
 
 Result AlphaService::transfer_rewards_to_address(const RewardTransferAddressDraft& draft) {
+  note_state_change();
   if (const Result unlocked = ensure_wallet_ready_for_mutation("transfer_rewards_to_address"); !unlocked.ok) {
     return unlocked;
   }
@@ -1104,12 +1132,12 @@ std::vector<RewardTransactionSummary> AlphaService::reward_transactions() const
 }
 
 std::vector<EventEnvelope> AlphaService::sync_tick() {
-  const Result block_check = store_.routine_block_check(util::unix_timestamp_now());
+  const Result block_check = check_blocks();
   if (!block_check.ok) {
     return {};
   }
 
-  const Result claim_result = try_claim_confirmed_block_rewards();
+  const Result claim_result = claim_block_rewards();
   if (!claim_result.ok) {
     return {};
   }
@@ -1122,23 +1150,137 @@ std::vector<EventEnvelope> AlphaService::sync_tick() {
     }
     ticks_since_last_validation_ = 0;
   }
+  return network_tick();
+}
+
+Result AlphaService::check_blocks() {
+  return store_.routine_block_check(util::unix_timestamp_now());
+}
+
+Result AlphaService::claim_block_rewards() {
+  return try_claim_confirmed_block_rewards();
+}
+
+std::vector<EventEnvelope> AlphaService::network_tick() {
+  network_ticks_.fetch_add(1, std::memory_order_release);
+  p2p_node_.announce_confirmed_blocks(store_.all_blocks());
+  std::vector<EventEnvelope> published = p2p_node_.sync_tick();
+  const std::vector<EventEnvelope> synced = p2p_node_.take_synced_events();
+  if (!synced.empty()) {
+    (void)ingest_remote_events(synced, true);
+  }
+  // Live events go through the ingest pipeline. Whatever it has no room for
+  // stays with the node, which then stops reading from its peers.
+  if (!ingest_pipeline_) {
+    return published;
+  }
+  std::vector<EventEnvelope> received = p2p_node_.take_received_events(ingest_pipeline_->room());
+  std::erase_if(received, [this](const EventEnvelope& event) { return !p2p_node_.ingest_remote_event(event); });
+  (void)ingest_pipeline_->submit(received);
+  const IngestBatch ingested = ingest_pipeline_->drain(kMaxIngestApplyBatch);
+  for (const IngestRejection& rejection : ingested.rejected) {
+    store_.record_invalid_event(rejection.event_id, rejection.reason);
+  }
+  (void)append_verified_events(ingested.events, false);
+  return published;
+}
 
-  return p2p_node_.sync_tick();
+void AlphaService::set_change_listener(std::function<void(const StoreChange&)> listener) {
+  store_.set_change_listener(std::move(listener));
+}
+
+Result AlphaService::save_peers() {
+  return p2p_node_.save_peers_dat(peers_dat_path_);
+}
+
+Result AlphaService::write_snapshot() {
+  return store_.write_snapshot();
 }
 
 Result AlphaService::ingest_remote_event(const EventEnvelope& event) {
-  if (!p2p_node_.ingest_remote_event(event)) {
-    return Result::success("Duplicate or ignored remote event.");
+  return ingest_remote_events({event}).front();
+}
+
+std::vector<Result> AlphaService::ingest_remote_events(const std::vector<EventEnvelope>& events,
+                                                       bool historical) {
+  std::vector<Result> results(events.size(), Result::success("Duplicate or ignored remote event."));
+  std::vector<EventEnvelope> fresh;
+  std::vector<std::size_t> fresh_positions;
+  fresh.reserve(events.size());
+  for (std::size_t i = 0; i < events.size(); ++i) {
+    if (p2p_node_.ingest_remote_event(events[i])) {
+      fresh.push_back(events[i]);
+      fresh_positions.push_back(i);
+    }
+  }
+
+  const std::vector<SignatureCheck> checks = ingest_pipeline_ ? ingest_pipeline_->verify_now(fresh)
+                                                             : signature_verifier_.verify_batch(fresh);
+  std::vector<EventEnvelope> verified;
+  std::vector<std::size_t> verified_positions;
+  verified.reserve(fresh.size());
+  for (std::size_t i = 0; i < fresh.size(); ++i) {
+    if (!checks[i].ok) {
+      store_.record_invalid_event(fresh[i].event_id, checks[i].reason);
+      results[fresh_positions[i]] = Result::failure(checks[i].reason);
+      continue;
+    }
+    verified.push_back(std::move(fresh[i]));
+    verified_positions.push_back(fresh_positions[i]);
   }
 
-  if (event.signature.empty()) {
-    return Result::failure("Remote event signature is missing.");
+  const std::vector<Result> appended = append_verified_events(verified, historical);
+  for (std::size_t i = 0; i < verified.size(); ++i) {
+    results[verified_positions[i]] = appended[i];
+  }
+  return results;
+}
+
+std::vector<Result> AlphaService::append_verified_events(std::span<const EventEnvelope> verified, bool historical) {
+  if (verified.empty()) {
+    return {};
+  }
+  // One batch append rebuilds blocks and views once for the whole delivery.
+  std::vector<Result> appended = store_.append_events(verified, historical);
+  // Only stored events count as seen, so a forged or rejected copy never
+  // shadows a valid one another peer relays.
+  std::vector<std::string> stored_ids;
+  for (std::size_t i = 0; i < verified.size(); ++i) {
+    if (appended[i].ok) {
+      stored_ids.push_back(verified[i].event_id);
+    }
   }
+  p2p_node_.mark_seen(stored_ids);
+  if (historical) {
+    // Synced history is already indexed by the node and is not relayed.
+    return appended;
+  }
+  for (std::size_t i = 0; i < verified.size(); ++i) {
+    if (appended[i].ok) {
+      p2p_node_.relay_event(verified[i]);
+    }
+  }
+  return appended;
+}
+
+SignatureVerifierStats AlphaService::signature_verifier_stats() const {
+  return ingest_pipeline_ ? ingest_pipeline_->verifier_stats() : signature_verifier_.stats();
+}
+
+IngestPipelineStats AlphaService::ingest_pipeline_stats() const {
+  return ingest_pipeline_ ? ingest_pipeline_->stats() : IngestPipelineStats{};
+}
+
+bool AlphaService::has_event(std::string_view event_id) const {
+  return store_.find_event(event_id) != nullptr;
+}
 
-  return store_.append_event(event);
+void AlphaService::set_p2p_transport_factory(P2PNode::TransportFactory factory) {
+  p2p_node_.set_transport_factory(std::move(factory));
 }
 
 Result AlphaService::set_transport_enabled(AnonymityMode mode, bool enabled) {
+  note_state_change();
   if (mode == AnonymityMode::Tor) {
     tor_enabled_ = enabled;
   } else {
@@ -1169,6 +1311,7 @@ Result AlphaService::set_transport_enabled(AnonymityMode mode, bool enabled) {
 }
 
 Result AlphaService::set_active_transport(AnonymityMode mode) {
+  note_state_change();
   if (mode == AnonymityMode::Tor && !tor_enabled_) {
     return Result::failure("Cannot activate Tor: Tor toggle is OFF.");
   }
@@ -1186,6 +1329,7 @@ Result AlphaService::set_active_transport(AnonymityMode mode) {
 }
 
 Result AlphaService::set_alpha_test_mode(bool enabled) {
+  note_state_change();
   alpha_test_mode_ = enabled;
 
   tor_provider_->set_alpha_test_mode(enabled);
@@ -1213,6 +1357,7 @@ Result AlphaService::set_alpha_test_mode(bool enabled) {
 }
 
 Result AlphaService::add_peer(std::string_view peer) {
+  note_state_change();
   const Result add_result = p2p_node_.add_peer(peer);
   if (!add_result.ok) {
     return add_result;
@@ -1222,6 +1367,7 @@ Result AlphaService::add_peer(std::string_view peer) {
 }
 
 Result AlphaService::reload_peers_dat() {
+  note_state_change();
   const Result load_result = p2p_node_.load_peers_dat(peers_dat_path_);
   if (!load_result.ok) {
     return load_result;
@@ -1236,6 +1382,7 @@ Result AlphaService::reload_peers_dat() {
 }
 
 Result AlphaService::set_profile_display_name(std::string_view display_name) {
+  note_state_change();
   if (const Result unlocked = ensure_wallet_ready_for_mutation("set_profile_display_name"); !unlocked.ok) {
     return unlocked;
   }
@@ -1282,6 +1429,7 @@ Result AlphaService::set_profile_display_name(std::string_view display_name) {
 Result AlphaService::set_immortal_name_with_cipher(std::string_view display_name,
                                                    std::string_view cipher_password,
                                                    std::string_view cipher_salt) {
+  note_state_change();
   if (const Result unlocked = ensure_wallet_ready_for_mutation("set_immortal_name_with_cipher"); !unlocked.ok) {
     return unlocked;
   }
@@ -1309,6 +1457,7 @@ Result AlphaService::set_immortal_name_with_cipher(std::string_view display_name
 }
 
 Result AlphaService::set_duplicate_name_policy(bool reject_duplicates) {
+  note_state_change();
   if (const Result unlocked = ensure_wallet_ready_for_mutation("set_duplicate_name_policy"); !unlocked.ok) {
     return unlocked;
   }
@@ -1331,6 +1480,7 @@ Result AlphaService::set_duplicate_name_policy(bool reject_duplicates) {
 }
 
 Result AlphaService::set_profile_cipher_password(std::string_view password, std::string_view salt) {
+  note_state_change();
   if (const Result unlocked = ensure_wallet_ready_for_mutation("set_profile_cipher_password"); !unlocked.ok) {
     return unlocked;
   }
@@ -1354,6 +1504,7 @@ Result AlphaService::set_profile_cipher_password(std::string_view password, std:
 }
 
 Result AlphaService::update_key_to_peers() {
+  note_state_change();
   if (const Result unlocked = ensure_wallet_ready_for_mutation("update_key_to_peers"); !unlocked.ok) {
     return unlocked;
   }
@@ -1365,6 +1516,7 @@ Result AlphaService::update_key_to_peers() {
 }
 
 Result AlphaService::add_moderator(std::string_view cid) {
+  note_state_change();
   if (const Result unlocked = ensure_wallet_ready_for_mutation("add_moderator"); !unlocked.ok) {
     return unlocked;
   }
@@ -1384,6 +1536,7 @@ Result AlphaService::add_moderator(std::string_view cid) {
 }
 
 Result AlphaService::remove_moderator(std::string_view cid) {
+  note_state_change();
   if (const Result unlocked = ensure_wallet_ready_for_mutation("remove_moderator"); !unlocked.ok) {
     return unlocked;
   }
@@ -1403,6 +1556,7 @@ Result AlphaService::remove_moderator(std::string_view cid) {
 }
 
 Result AlphaService::flag_content(std::string_view object_id, std::string_view reason) {
+  note_state_change();
   if (const Result unlocked = ensure_wallet_ready_for_mutation("flag_content"); !unlocked.ok) {
     return unlocked;
   }
@@ -1419,6 +1573,7 @@ Result AlphaService::flag_content(std::string_view object_id, std::string_view r
 }
 
 Result AlphaService::set_content_hidden(std::string_view object_id, bool hidden, std::string_view reason) {
+  note_state_change();
   if (const Result unlocked = ensure_wallet_ready_for_mutation("set_content_hidden"); !unlocked.ok) {
     return unlocked;
   }
@@ -1440,6 +1595,7 @@ Result AlphaService::set_content_hidden(std::string_view object_id, bool hidden,
 }
 
 Result AlphaService::downvote_and_purge_content(std::string_view object_id, std::string_view reason) {
+  note_state_change();
   if (const Result auth = ensure_local_moderator("downvote_and_purge_content"); !auth.ok) {
     return auth;
   }
@@ -1459,6 +1615,7 @@ Result AlphaService::downvote_and_purge_content(std::string_view object_id, std:
 }
 
 Result AlphaService::pin_core_topic(std::string_view recipe_id, bool pinned) {
+  note_state_change();
   if (const Result unlocked = ensure_wallet_ready_for_mutation("pin_core_topic"); !unlocked.ok) {
     return unlocked;
   }
@@ -1478,6 +1635,7 @@ Result AlphaService::pin_core_topic(std::string_view recipe_id, bool pinned) {
 
 Result AlphaService::export_key_backup(std::string_view backup_path, std::string_view password,
                                        std::string_view salt) {
+  note_state_change();
   if (const Result unlocked = ensure_wallet_unlocked("export_key_backup"); !unlocked.ok) {
     return unlocked;
   }
@@ -1495,6 +1653,7 @@ Result AlphaService::export_key_backup(std::string_view backup_path, std::string
 }
 
 Result AlphaService::verify_key_backup(std::string_view backup_path, std::string_view password) {
+  note_state_change();
   const std::string resolved =
       resolve_data_path(backup_path.empty() ? last_key_backup_path_ : std::string{backup_path},
                         "backup/identity-backup.dat");
@@ -1514,6 +1673,7 @@ Result AlphaService::verify_key_backup(std::string_view backup_path, std::string
 }
 
 Result AlphaService::import_key_backup(std::string_view backup_path, std::string_view password) {
+  note_state_change();
   const std::string resolved = resolve_data_path(backup_path, "backup/identity-backup.dat");
   if (const Result preflight = verify_backup_preflight(resolved, password); !preflight.ok) {
     return preflight;
@@ -1554,6 +1714,7 @@ Result AlphaService::import_key_backup(std::string_view backup_path, std::string
 }
 
 Result AlphaService::lock_wallet() {
+  note_state_change();
   const Result lock = crypto_.lock_identity();
   if (!lock.ok) {
     return lock;
@@ -1566,6 +1727,7 @@ Result AlphaService::lock_wallet() {
 }
 
 Result AlphaService::unlock_wallet(std::string_view passphrase) {
+  note_state_change();
   const Result unlock = crypto_.unlock_identity(passphrase);
   if (!unlock.ok) {
     wallet_recovery_required_ = true;
@@ -1579,8 +1741,52 @@ Result AlphaService::unlock_wallet(std::string_view passphrase) {
   return restart_network();
 }
 
+void AlphaService::prepare_unlock_async(std::string passphrase, std::function<void(Result)> on_ready) {
+  if (!kdf_worker_) {
+    kdf_worker_ = std::make_unique<util::ThreadPool>(1);
+  }
+  kdf_worker_->submit([this, vault = crypto_.snapshot_vault(), passphrase = std::move(passphrase),
+                       on_ready = std::move(on_ready)] {
+    const Result derived = crypto_.prewarm_unlock(vault, passphrase);
+    if (on_ready) {
+      on_ready(derived);
+    }
+  });
+}
+
+void AlphaService::prepare_backup_async(std::string backup_path, std::string password,
+                                        std::function<void(Result)> on_ready) {
+  if (!kdf_worker_) {
+    kdf_worker_ = std::make_unique<util::ThreadPool>(1);
+  }
+  const std::string resolved =
+      resolve_data_path(backup_path.empty() ? last_key_backup_path_ : backup_path, "backup/identity-backup.dat");
+  kdf_worker_->submit([this, backup = crypto_.snapshot_backup(resolved), password = std::move(password),
+                       on_ready = std::move(on_ready)] {
+    const Result derived = crypto_.verify_identity_backup(backup, password);
+    if (on_ready) {
+      on_ready(derived);
+    }
+  });
+}
+
+void AlphaService::begin_wallet_task(std::string_view operation) {
+  note_state_change();
+  wallet_task_ = std::string{operation};
+  wallet_task_pending_ = true;
+  wallet_task_result_ = {};
+}
+
+void AlphaService::finish_wallet_task(const Result& result) {
+  note_state_change();
+  wallet_task_pending_ = false;
+  wallet_task_result_ = result;
+  wallet_task_finished_unix_ = util::unix_timestamp_now();
+}
+
 Result AlphaService::recover_wallet(std::string_view backup_path, std::string_view backup_password,
                                     std::string_view new_local_passphrase) {
+  note_state_change();
   const std::string local_pass = util::trim_copy(new_local_passphrase);
   if (local_pass.empty()) {
     return Result::failure("Wallet recovery failed: new local passphrase is required.");
@@ -1612,6 +1818,7 @@ Result AlphaService::recover_wallet(std::string_view backup_path, std::string_vi
 }
 
 Result AlphaService::prepare_genesis_reset() {
+  note_state_change();
   const Result marker = create_fresh_genesis_marker(false);
   if (!marker.ok) {
     return marker;
@@ -1631,6 +1838,7 @@ Result AlphaService::prepare_genesis_reset() {
 }
 
 Result AlphaService::nuke_key(std::string_view confirmation_phrase) {
+  note_state_change();
   const std::string confirm = util::trim_copy(confirmation_phrase);
   if (confirm != "NUKE-KEY" && confirm != "NUKE") {
     return Result::failure("Nuke key requires confirmation text: NUKE-KEY");
@@ -1679,6 +1887,7 @@ Result AlphaService::run_backtest_validation() {
 Result AlphaService::use_community_profile(std::string_view community_or_path,
                                            std::string_view display_name,
                                            std::string_view description) {
+  note_state_change();
   const Result community_result =
       load_or_create_community_profile(community_or_path, display_name, description);
   if (!community_result.ok) {
@@ -1785,7 +1994,7 @@ Result AlphaService::use_community_profile(std::string_view community_or_path,
                                       "peers-" + current_community_.community_id + "." + network_suffix + ".dat");
 
   // Reset peer state when switching communities, then load external peers file.
-  p2p_node_ = P2PNode{};
+  p2p_node_.reset();
 
   const Result load_peers = p2p_node_.load_peers_dat(peers_dat_path_);
   if (!load_peers.ok) {
@@ -1942,6 +2151,7 @@ NodeStatusReport AlphaService::node_status() const {
   report.chain_policy = config_.chain_policy;
   report.validation_limits = config_.validation_limits;
   report.genesis = active_genesis_spec();
+  const KdfCacheStats kdf_stats = crypto_.kdf_cache_stats();
   report.wallet = {
       .locked = wallet_locked(),
       .destroyed = wallet_destroyed_,
@@ -1956,6 +2166,13 @@ NodeStatusReport AlphaService::node_status() const {
       .backup_last_unix = backup_last_unix_,
       .last_unlocked_unix = wallet_last_unlocked_unix_,
       .last_locked_unix = wallet_last_locked_unix_,
+      .kdf_cache_entries = kdf_stats.entries,
+      .kdf_cache_memory_locked = kdf_stats.memory_locked,
+      .task = wallet_task_,
+      .task_pending = wallet_task_pending_,
+      .task_ok = wallet_task_result_.ok,
+      .task_message = wallet_task_result_.message,
+      .task_finished_unix = wallet_task_finished_unix_,
   };
   report.peers_dat_path = peers_dat_path_;
   report.peers = p2p_node_.peers();
@@ -2018,7 +2235,7 @@ MiningTemplate AlphaService::mining_template() const {
   block_input << tpl.next_block_index << "|" << tpl.next_open_unix << "|" << 1 << "|" << 0 << "|" << 0 << "|"
               << tpl.prev_hash << "|" << tpl.merkle_root << "|" << tpl.content_hash << "|";
   tpl.anticipated_block_hash = util::sha256_like_hex(block_input.str());
-  tpl.difficulty_nibbles = testnet ? 3 : 4;
+  tpl.difficulty_nibbles = pow_difficulty_nibbles();
   tpl.pow_material = tpl.community_id + "|" + tpl.miner_cid + "|" + std::to_string(tpl.next_block_index) + "|" +
                      tpl.anticipated_block_hash + "|" + tpl.merkle_root;
   tpl.sample_nonce_hash = util::sha256_like_hex(tpl.pow_material + "|0");
@@ -2468,6 +2685,9 @@ Result AlphaService::try_claim_confirmed_block_rewards() {
   if (wallet_locked()) {
     return Result::success("Wallet locked; reward claims paused.");
   }
+  if (config_.external_mining) {
+    return Result::success("External mining enabled; reward claims are submitted by miners.");
+  }
   const std::string local_cid = crypto_.identity().cid.value;
   if (local_cid.empty()) {
     return Result::failure("Reward claim failed: local CID is empty.");
@@ -2478,8 +2698,7 @@ Result AlphaService::try_claim_confirmed_block_rewards() {
     return Result::success("No claimable confirmed blocks.");
   }
 
-  const bool testnet = should_use_testnet(alpha_test_mode_, active_mode_);
-  const int difficulty_nibbles = testnet ? 3 : 4;
+  const int difficulty_nibbles = pow_difficulty_nibbles();
   bool claimed_any = false;
   for (const auto& block : claimable_blocks) {
     const std::int64_t reward_units = store_.next_claim_reward(block.index);
@@ -2487,51 +2706,37 @@ Result AlphaService::try_claim_confirmed_block_rewards() {
       continue;
     }
 
-    const std::string pow_material =
-        current_community_.community_id + "|" + local_cid + "|" + std::to_string(block.index) + "|" +
-        block.block_hash + "|" + block.merkle_root;
+    const std::string pow_material = pow_material_for_block(block);
     std::uint64_t pow_nonce = 0;
     std::string pow_hash;
     constexpr std::uint64_t kMaxPowAttempts = 2500000;
-    for (std::uint64_t attempt = 0; attempt < kMaxPowAttempts; ++attempt) {
-      const std::string candidate = util::sha256_like_hex(pow_material + "|" + std::to_string(attempt));
-      if (util::has_leading_zero_nibbles(candidate, difficulty_nibbles)) {
-        pow_nonce = attempt;
-        pow_hash = candidate;
-        break;
+    static util::LatencyHistogram& search_latency = util::metrics().histogram(
+        "gotsoup_pow_search_duration_seconds", "Time spent searching for one block reward nonce.");
+    static util::Counter& attempts_total =
+        util::metrics().counter("gotsoup_pow_attempts_total", "Nonces tried by the in-process miner.");
+    std::uint64_t attempts = 0;
+    {
+      const util::ScopedTimer timer(search_latency);
+      for (std::uint64_t attempt = 0; attempt < kMaxPowAttempts; ++attempt) {
+        ++attempts;
+        const std::string candidate = util::sha256_like_hex(pow_material + "|" + std::to_string(attempt));
+        if (util::has_leading_zero_nibbles(candidate, difficulty_nibbles)) {
+          pow_nonce = attempt;
+          pow_hash = candidate;
+          break;
+        }
       }
     }
+    attempts_total.add(attempts);
     if (pow_hash.empty()) {
       continue;
     }
 
-    const std::string claim_id =
-        "clm-" + crypto_.hash_bytes(current_community_.community_id + local_cid + std::to_string(block.index) +
-                                    block.block_hash)
-                     .substr(0, 16);
-    const std::string witness_root =
-        util::sha256_like_hex(local_cid + "|" + std::to_string(block.index) + "|" +
-                              std::to_string(reward_units) + "|" + pow_hash);
-
-    EventEnvelope claim = make_event(
-        EventKind::BlockRewardClaimed,
-        {{"claim_id", claim_id},
-         {"block_index", std::to_string(block.index)},
-         {"reward", std::to_string(reward_units)},
-         {"pow_difficulty", std::to_string(difficulty_nibbles)},
-         {"pow_nonce", std::to_string(pow_nonce)},
-         {"pow_material", pow_material},
-         {"pow_hash", pow_hash},
-         {"witness_root", witness_root},
-         {"block_hash", block.block_hash},
-         {"merkle_root", block.merkle_root},
-         {"psz_timestamp", block.psz_timestamp}});
-
-    const Result append = store_.append_event(claim);
+    const Result append =
+        append_block_reward_claim(block, reward_units, difficulty_nibbles, std::to_string(pow_nonce), pow_hash);
     if (!append.ok) {
       return append;
     }
-    p2p_node_.queue_local_event(claim);
     claimed_any = true;
   }
 
@@ -2542,6 +2747,127 @@ Result AlphaService::try_claim_confirmed_block_rewards() {
   return run_backtest_validation();
 }
 
+std::vector<MiningJob> AlphaService::mining_jobs() const {
+  std::vector<MiningJob> jobs;
+  if (wallet_locked()) {
+    return jobs;
+  }
+  const std::string local_cid = crypto_.identity().cid.value;
+  if (local_cid.empty()) {
+    return jobs;
+  }
+
+  const int difficulty_nibbles = pow_difficulty_nibbles();
+  for (const auto& block : store_.claimable_confirmed_blocks(local_cid)) {
+    const std::int64_t reward_units = store_.next_claim_reward(block.index);
+    if (reward_units <= 0) {
+      continue;
+    }
+    MiningJob job;
+    job.block_index = block.index;
+    job.block_hash = block.block_hash;
+    job.merkle_root = block.merkle_root;
+    job.pow_material = pow_material_for_block(block);
+    job.difficulty_nibbles = difficulty_nibbles;
+    job.reward_units = reward_units;
+    job.job_id = util::sha256_like_hex(job.pow_material).substr(0, 16);
+    jobs.push_back(std::move(job));
+  }
+  return jobs;
+}
+
+Result AlphaService::submit_mining_solution(std::uint64_t block_index, std::string_view nonce) {
+  if (const Result unlocked = ensure_wallet_unlocked("submit_mining_solution"); !unlocked.ok) {
+    return unlocked;
+  }
+  const std::string nonce_text = util::trim_copy(nonce);
+  if (nonce_text.empty()) {
+    return Result::failure("Mining solution rejected: nonce is required.");
+  }
+
+  const std::string local_cid = crypto_.identity().cid.value;
+  const auto claimable_blocks = store_.claimable_confirmed_blocks(local_cid);
+  const auto block_it = std::ranges::find_if(claimable_blocks, [block_index](const Store::BlockRecord& block) {
+    return block.index == block_index;
+  });
+  if (block_it == claimable_blocks.end()) {
+    return Result::failure("Mining solution rejected: block is not claimable (stale job).");
+  }
+
+  const std::int64_t reward_units = store_.next_claim_reward(block_index);
+  if (reward_units <= 0) {
+    return Result::failure("Mining solution rejected: block has no remaining reward.");
+  }
+
+  const int difficulty_nibbles = pow_difficulty_nibbles();
+  const std::string pow_hash = util::sha256_like_hex(pow_material_for_block(*block_it) + "|" + nonce_text);
+  const bool meets_target = util::has_leading_zero_nibbles(pow_hash, difficulty_nibbles);
+  static util::Counter& accepted = util::metrics().counter(
+      "gotsoup_pow_submissions_total", "Externally mined solutions checked.", {.key = "result", .value = "accepted"});
+  static util::Counter& rejected = util::metrics().counter(
+      "gotsoup_pow_submissions_total", "Externally mined solutions checked.", {.key = "result", .value = "rejected"});
+  (meets_target ? accepted : rejected).add();
+  if (!meets_target) {
+    return Result::failure("Mining solution rejected: hash does not meet block difficulty.");
+  }
+
+  const Result append = append_block_reward_claim(*block_it, reward_units, difficulty_nibbles, nonce_text, pow_hash);
+  if (!append.ok) {
+    return append;
+  }
+  const Result validation = run_backtest_validation();
+  if (!validation.ok) {
+    return validation;
+  }
+  return Result::success("Mining solution accepted; block reward claimed.", pow_hash);
+}
+
+int AlphaService::pow_difficulty_nibbles() const {
+  return should_use_testnet(alpha_test_mode_, active_mode_) ? 3 : 4;
+}
+
+std::string AlphaService::pow_material_for_block(const Store::BlockRecord& block) const {
+  return current_community_.community_id + "|" + crypto_.identity().cid.value + "|" + std::to_string(block.index) +
+         "|" + block.block_hash + "|" + block.merkle_root;
+}
+
+Result AlphaService::append_block_reward_claim(const Store::BlockRecord& block, std::int64_t reward_units,
+                                               int difficulty_nibbles, std::string_view pow_nonce,
+                                               std::string_view pow_hash) {
+  const std::string local_cid = crypto_.identity().cid.value;
+  const std::string claim_id =
+      "clm-" + crypto_.hash_bytes(current_community_.community_id + local_cid + std::to_string(block.index) +
+                                  block.block_hash)
+                   .substr(0, 16);
+  const std::string witness_root =
+      util::sha256_like_hex(local_cid + "|" + std::to_string(block.index) + "|" + std::to_string(reward_units) +
+                            "|" + std::string{pow_hash});
+
+  EventEnvelope claim = make_event(
+      EventKind::BlockRewardClaimed,
+      {{"claim_id", claim_id},
+       {"block_index", std::to_string(block.index)},
+       {"reward", std::to_string(reward_units)},
+       {"pow_difficulty", std::to_string(difficulty_nibbles)},
+       {"pow_nonce", std::string{pow_nonce}},
+       {"pow_material", pow_material_for_block(block)},
+       {"pow_hash", std::string{pow_hash}},
+       {"witness_root", witness_root},
+       {"block_hash", block.block_hash},
+       {"merkle_root", block.merkle_root},
+       {"psz_timestamp", block.psz_timestamp}});
+
+  const Result append = store_.append_event(claim);
+  if (!append.ok) {
+    return append;
+  }
+  if (!p2p_node_.queue_local_event(claim) && p2p_node_.running()) {
+    return Result::success("Block reward claim appended; outbound queue full, left to reconciliation.",
+                           claim.event_id);
+  }
+  return Result::success("Block reward claim appended.", claim.event_id);
+}
+
 Result AlphaService::validate_and_apply_post_cost(std::int64_t requested_units,
                                                   std::int64_t& out_applied_units) const {
   if (requested_units < 0) {
@@ -2618,7 +2944,9 @@ Result AlphaService::append_locally_and_queue(const EventEnvelope& event) {
     return validation;
   }
 
-  p2p_node_.queue_local_event(event);
+  if (!p2p_node_.queue_local_event(event) && p2p_node_.running()) {
+    return Result::success("Event appended; outbound queue full, left to reconciliation.", event.event_id);
+  }
   return Result::success("Event appended and queued for sync.", event.event_id);
 }
 
@@ -2629,27 +2957,34 @@ EventEnvelope AlphaService::make_event(EventKind kind,
   last_local_event_unix_ts_ = event_unix_ts;
   const auto genesis = active_genesis_spec();
   payload_fields.emplace_back("author_cid", crypto_.identity().cid.value);
+  payload_fields.emplace_back("author_pubkey", crypto_.identity().public_key);
   payload_fields.emplace_back("community_id", current_community_.community_id);
   payload_fields.emplace_back("chain_id", genesis.chain_id);
   payload_fields.emplace_back("network_id", genesis.network_id);
   payload_fields.emplace_back("kind", std::to_string(static_cast<int>(kind)));
   payload_fields.emplace_back("unix_ts", std::to_string(event_unix_ts));
 
-  const std::string payload = util::canonical_join(std::move(payload_fields));
-  const std::string event_id = crypto_.content_id(payload);
-
-  return {
-      .event_id = event_id,
+  EventEnvelope event{
+      .event_id = {},
       .kind = kind,
       .author_cid = crypto_.identity().cid.value,
       .unix_ts = event_unix_ts,
-      .payload = payload,
-      .signature = crypto_.sign(payload),
+      .payload = util::canonical_join(std::move(payload_fields)),
+      .signature = {},
   };
+  crypto_.content_id_into(event.payload, event.event_id);
+  (void)crypto_.sign_into(event.payload, event.signature);
+  return event;
 }
 
 Result AlphaService::restart_network() {
   p2p_node_.stop();
+  // Identity or crypto mode may have changed; decoded keys are mode specific.
+  if (ingest_pipeline_) {
+    ingest_pipeline_->clear_verifier_cache();
+  } else {
+    signature_verifier_.clear_cache();
+  }
 
   if (!tor_enabled_ && !i2p_enabled_) {
     return Result::success("No active anonymity providers; P2P node remains offline.");
@@ -2679,8 +3014,23 @@ Result AlphaService::restart_network() {
     seeds.push_back("127.0.0.1:" + std::to_string(p2p_port));
   }
 
-  return p2p_node_.start(seeds, endpoint, crypto_.identity().cid.value, alpha_test_mode_, p2p_port,
-                         network_name);
+  p2p_node_.set_event_lookup([this](std::string_view event_id) { return store_.find_event(event_id); });
+  p2p_node_.set_chain_lookup([this](std::uint64_t from_index, std::size_t max_count) {
+    const std::vector<Store::BlockRecord>& blocks = store_.all_blocks();
+    const std::size_t begin = std::min<std::size_t>(from_index, blocks.size());
+    const std::size_t end = begin + std::min(max_count, blocks.size() - begin);
+    return std::vector<Store::BlockRecord>(blocks.begin() + static_cast<std::ptrdiff_t>(begin),
+                                           blocks.begin() + static_cast<std::ptrdiff_t>(end));
+  });
+  const Result started = p2p_node_.start(seeds, endpoint, crypto_.identity().cid.value, alpha_test_mode_,
+                                         p2p_port, network_name);
+  if (started.ok) {
+    p2p_node_.index_events(store_.all_events());
+    if (config_.p2p_network_thread) {
+      p2p_node_.start_network_thread();
+    }
+  }
+  return started;
 }
 
 Result AlphaService::ensure_provider_state(AnonymityMode mode, bool enabled) {
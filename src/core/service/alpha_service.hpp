@@ -1,18 +1,24 @@
 #pragma once
 
+#include <atomic>
+#include <functional>
 #include <memory>
 #include <optional>
+#include <span>
 #include <string>
 #include <string_view>
 #include <unordered_map>
 #include <vector>
 
 #include "core/crypto/crypto.hpp"
+#include "core/crypto/signature_verifier.hpp"
 #include "core/model/types.hpp"
 #include "core/p2p/node.hpp"
 #include "core/reference_engine.hpp"
+#include "core/service/ingest_pipeline.hpp"
 #include "core/storage/store.hpp"
 #include "core/transport/anonymity_provider.hpp"
+#include "core/util/thread_pool.hpp"
 
 namespace alpha {
 
@@ -66,7 +72,37 @@ public:
   std::vector<RewardTransactionSummary> reward_transactions() const;
 
   std::vector<EventEnvelope> sync_tick();
+  // The steps of sync_tick plus periodic persistence, for callers that run
+  // them on their own schedules (got-soupd's maintenance thread).
+  Result check_blocks();
+  Result claim_block_rewards();
+  std::vector<EventEnvelope> network_tick();
+  Result save_peers();
+  Result write_snapshot();
   Result ingest_remote_event(const EventEnvelope& event);
+  // `historical` events were verified against a peer's header chain during
+  // initial sync; they skip the past-drift window and are not relayed.
+  std::vector<Result> ingest_remote_events(const std::vector<EventEnvelope>& events, bool historical = false);
+  [[nodiscard]] SignatureVerifierStats signature_verifier_stats() const;
+  [[nodiscard]] IngestPipelineStats ingest_pipeline_stats() const;
+  [[nodiscard]] bool has_event(std::string_view event_id) const;
+  // Call before init(); the network simulator runs services over in-process
+  // links this way.
+  void set_p2p_transport_factory(P2PNode::TransportFactory factory);
+  // See Store::set_change_listener.
+  void set_change_listener(std::function<void(const StoreChange&)> listener);
+  // Cache keys for the read-only queries, readable from any thread without
+  // the lock that serializes the service. state_generation() advances with
+  // the store's generation and with every call that changes settings,
+  // wallet, transport, peers or community; status_generation() also
+  // advances each network tick, since node_status() reports live peer
+  // counters.
+  [[nodiscard]] std::uint64_t state_generation() const {
+    return store_.generation() + state_changes_.load(std::memory_order_acquire);
+  }
+  [[nodiscard]] std::uint64_t status_generation() const {
+    return state_generation() + network_ticks_.load(std::memory_order_acquire);
+  }
 
   Result set_transport_enabled(AnonymityMode mode, bool enabled);
   Result set_active_transport(AnonymityMode mode);
@@ -92,6 +128,17 @@ public:
   Result import_key_backup(std::string_view backup_path, std::string_view password);
   Result lock_wallet();
   Result unlock_wallet(std::string_view passphrase);
+  // Run the passphrase KDF on a background worker and invoke `on_ready` there
+  // once the key is cached; the caller then performs the (now cheap)
+  // unlock_wallet / verify_key_backup under its own synchronization. The
+  // vault or backup is read here, under the caller's lock; the worker only
+  // sees that copy.
+  void prepare_unlock_async(std::string passphrase, std::function<void(Result)> on_ready);
+  void prepare_backup_async(std::string backup_path, std::string password, std::function<void(Result)> on_ready);
+  // Bookkeeping for callers that answer before the work is done, reported in
+  // WalletStatus so clients can poll for the outcome.
+  void begin_wallet_task(std::string_view operation);
+  void finish_wallet_task(const Result& result);
   Result recover_wallet(std::string_view backup_path, std::string_view backup_password,
                         std::string_view new_local_passphrase);
   Result prepare_genesis_reset();
@@ -108,6 +155,8 @@ public:
   [[nodiscard]] std::vector<RewardBalanceSummary> reward_balances() const;
   [[nodiscard]] ReceiveAddressInfo receive_info() const;
   [[nodiscard]] MiningTemplate mining_template() const;
+  [[nodiscard]] std::vector<MiningJob> mining_jobs() const;
+  Result submit_mining_solution(std::uint64_t block_index, std::string_view nonce);
   [[nodiscard]] std::string hashspec_console() const;
   [[nodiscard]] std::string soup_address() const;
   [[nodiscard]] std::string public_key() const;
@@ -129,9 +178,16 @@ public:
 
 private:
   Result append_locally_and_queue(const EventEnvelope& event);
+  // Appends signature-checked remote events in one batch and relays the
+  // live ones that were accepted.
+  std::vector<Result> append_verified_events(std::span<const EventEnvelope> verified, bool historical);
   EventEnvelope make_event(EventKind kind,
                            std::vector<std::pair<std::string, std::string>> payload_fields);
   Result try_claim_confirmed_block_rewards();
+  Result append_block_reward_claim(const Store::BlockRecord& block, std::int64_t reward_units,
+                                   int difficulty_nibbles, std::string_view pow_nonce, std::string_view pow_hash);
+  [[nodiscard]] int pow_difficulty_nibbles() const;
+  [[nodiscard]] std::string pow_material_for_block(const Store::BlockRecord& block) const;
   Result validate_and_apply_post_cost(std::int64_t requested_units, std::int64_t& out_applied_units) const;
   std::optional<std::string> resolve_display_name_to_cid(std::string_view display_name) const;
   std::optional<std::string> resolve_address_to_cid(std::string_view address) const;
@@ -180,6 +236,10 @@ private:
   std::string local_display_name_;
   bool wallet_destroyed_ = false;
   bool wallet_recovery_required_ = false;
+  std::string wallet_task_;
+  bool wallet_task_pending_ = false;
+  Result wallet_task_result_;
+  std::int64_t wallet_task_finished_unix_ = 0;
   bool wallet_backup_exists_ = false;
   bool wallet_backup_verified_ = false;
   bool wallet_backup_required_ = true;
@@ -190,6 +250,10 @@ private:
   std::int64_t wallet_last_locked_unix_ = 0;
   std::int64_t wallet_identity_changed_unix_ = 0;
   std::int64_t last_local_event_unix_ts_ = 0;
+  void note_state_change() { state_changes_.fetch_add(1, std::memory_order_release); }
+
+  std::atomic<std::uint64_t> state_changes_{0};
+  std::atomic<std::uint64_t> network_ticks_{0};
   std::uint64_t validation_interval_ticks_ = 10;
   std::uint64_t ticks_since_last_validation_ = 0;
   std::string startup_recovery_summary_;
@@ -197,12 +261,17 @@ private:
   std::string fresh_genesis_marker_path_;
 
   CryptoEngine crypto_;
+  SignatureVerifier signature_verifier_{crypto_};
   Store store_;
   std::unique_ptr<IAnonymityProvider> tor_provider_;
   std::unique_ptr<IAnonymityProvider> i2p_provider_;
   P2PNode p2p_node_;
   refpad::ReferenceEngine reference_engine_;
   CommunityProfile current_community_;
+  // Holds a reference to signature_verifier_, so it is declared after it.
+  std::unique_ptr<IngestPipeline> ingest_pipeline_;
+  // Declared last so pending KDF jobs finish before crypto_ is destroyed.
+  std::unique_ptr<util::ThreadPool> kdf_worker_;
 };
 
 }  // namespace alpha
@@ -0,0 +1,89 @@
+#include "core/service/change_feed.hpp"
+
+#include <algorithm>
+#include <array>
+
+namespace alpha {
+namespace {
+
+constexpr std::array<std::string_view, 4> kTopicNames = {"event", "block", "balance", "moderation"};
+
+std::string_view trim_spaces(std::string_view text) {
+  while (!text.empty() && text.front() == ' ') {
+    text.remove_prefix(1);
+  }
+  while (!text.empty() && text.back() == ' ') {
+    text.remove_suffix(1);
+  }
+  return text;
+}
+
+}  // namespace
+
+std::string_view change_topic_name(StoreChange::Kind kind) {
+  return kTopicNames[static_cast<std::size_t>(kind)];
+}
+
+std::optional<std::uint32_t> parse_change_topics(std::string_view names) {
+  std::uint32_t mask = 0;
+  while (!names.empty()) {
+    const std::size_t comma = names.find(',');
+    const std::string_view name = trim_spaces(names.substr(0, comma));
+    if (!name.empty()) {
+      const auto found = std::ranges::find(kTopicNames, name);
+      if (found == kTopicNames.end()) {
+        return std::nullopt;
+      }
+      mask |= std::uint32_t{1} << static_cast<unsigned>(found - kTopicNames.begin());
+    }
+    if (comma == std::string_view::npos) {
+      break;
+    }
+    names.remove_prefix(comma + 1U);
+  }
+  return mask == 0 ? kAllChangeTopics : mask;
+}
+
+ChangeFeed::ChangeFeed(std::size_t capacity) : capacity_(std::max<std::size_t>(capacity, 1U)) {}
+
+void ChangeFeed::publish(const StoreChange& change) {
+  const std::lock_guard lock(mutex_);
+  ring_.push_back({.seq = ++last_seq_, .change = change});
+  if (ring_.size() > capacity_) {
+    ring_.pop_front();
+  }
+  if (hook_) {
+    hook_();
+  }
+}
+
+ChangeBatch ChangeFeed::read_after(std::uint64_t after, std::uint32_t topics, std::size_t max) const {
+  const std::lock_guard lock(mutex_);
+  ChangeBatch batch{.cursor = std::min(after, last_seq_)};
+  if (ring_.empty() || after >= last_seq_) {
+    return batch;
+  }
+  const std::uint64_t first = ring_.front().seq;
+  batch.missed = after + 1U < first;
+  std::size_t index = batch.missed ? 0U : static_cast<std::size_t>(after + 1U - first);
+  for (; index < ring_.size() && batch.notices.size() < max; ++index) {
+    const ChangeNotice& notice = ring_[index];
+    batch.cursor = notice.seq;
+    if ((topics & change_topic_bit(notice.change.kind)) != 0U) {
+      batch.notices.push_back(notice);
+    }
+  }
+  return batch;
+}
+
+std::uint64_t ChangeFeed::last_seq() const {
+  const std::lock_guard lock(mutex_);
+  return last_seq_;
+}
+
+void ChangeFeed::set_publish_hook(std::function<void()> hook) {
+  const std::lock_guard lock(mutex_);
+  hook_ = std::move(hook);
+}
+
+}  // namespace alpha
@@ -0,0 +1,72 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <deque>
+#include <functional>
+#include <mutex>
+#include <optional>
+#include <string_view>
+#include <vector>
+
+#include "core/storage/store.hpp"
+
+namespace alpha {
+
+// Topic bits for ChangeFeed::read_after, one per StoreChange::Kind.
+[[nodiscard]] constexpr std::uint32_t change_topic_bit(StoreChange::Kind kind) {
+  return std::uint32_t{1} << static_cast<unsigned>(kind);
+}
+inline constexpr std::uint32_t kAllChangeTopics = 0x0FU;
+
+// "event", "block", "balance" or "moderation".
+[[nodiscard]] std::string_view change_topic_name(StoreChange::Kind kind);
+// Comma-separated topic names to a mask; nullopt on an unknown name. An
+// empty list selects every topic.
+[[nodiscard]] std::optional<std::uint32_t> parse_change_topics(std::string_view names);
+
+struct ChangeNotice {
+  std::uint64_t seq = 0;  // from 1, increasing by one per published change
+  StoreChange change;
+};
+
+struct ChangeBatch {
+  std::vector<ChangeNotice> notices;
+  // Resume point for the next read: the last notice examined, matching the
+  // topics or not.
+  std::uint64_t cursor = 0;
+  // Changes after the requested cursor had already left the ring.
+  bool missed = false;
+};
+
+// Bounded history of store changes for push subscribers. The store's
+// listener publishes into it on the mutating thread; subscribers keep their
+// own cursor and read whatever is newer, so an idle subscriber holds no
+// state here and a slow one loses the oldest changes (and is told so)
+// instead of growing a queue.
+class ChangeFeed {
+public:
+  explicit ChangeFeed(std::size_t capacity = 4096);
+  ChangeFeed(const ChangeFeed&) = delete;
+  ChangeFeed& operator=(const ChangeFeed&) = delete;
+
+  void publish(const StoreChange& change);
+  // At most `max` notices with seq > `after` in the `topics` mask, oldest
+  // first.
+  [[nodiscard]] ChangeBatch read_after(std::uint64_t after, std::uint32_t topics, std::size_t max) const;
+  [[nodiscard]] std::uint64_t last_seq() const;
+
+  // Called after each publish, under the feed's lock so that clearing the
+  // hook waits out a call in progress; it must be quick and must not read
+  // the feed. got-soupd wakes its parked event streams from here.
+  void set_publish_hook(std::function<void()> hook);
+
+private:
+  mutable std::mutex mutex_;
+  std::size_t capacity_;
+  std::deque<ChangeNotice> ring_;
+  std::uint64_t last_seq_ = 0;
+  std::function<void()> hook_;
+};
+
+}  // namespace alpha
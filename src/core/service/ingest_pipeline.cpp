@@ -0,0 +1,251 @@
+#include "core/service/ingest_pipeline.hpp"
+
+#include <algorithm>
+#include <iterator>
+#include <optional>
+#include <utility>
+
+#include "core/util/canonical.hpp"
+
+namespace alpha {
+namespace {
+
+// The store's own append checks minus anything that needs its state, so
+// malformed events are dropped before they cost a signature check.
+std::optional<std::string> limits_violation(const EventEnvelope& event, const ValidationLimits& limits,
+                                            std::int64_t now_unix) {
+  if (event.event_id.empty() || event.payload.empty() || event.signature.empty()) {
+    return "remote event rejected: missing id, payload or signature.";
+  }
+  if (event.payload.size() > limits.max_event_bytes) {
+    return "remote event rejected: payload exceeds max_event_bytes.";
+  }
+  if (event.unix_ts > now_unix + limits.max_future_drift_seconds) {
+    return "remote event rejected: timestamp exceeds future drift limit.";
+  }
+  if (event.unix_ts < now_unix - limits.max_past_drift_seconds) {
+    return "remote event rejected: timestamp exceeds past drift limit.";
+  }
+  return std::nullopt;
+}
+
+std::vector<EventEnvelope> take_front(std::deque<EventEnvelope>& queue, std::size_t max_count) {
+  const auto count = static_cast<std::ptrdiff_t>(std::min(max_count, queue.size()));
+  std::vector<EventEnvelope> out(std::make_move_iterator(queue.begin()),
+                                 std::make_move_iterator(queue.begin() + count));
+  queue.erase(queue.begin(), queue.begin() + count);
+  return out;
+}
+
+}  // namespace
+
+IngestPipeline::IngestPipeline(SignatureVerifier& verifier, ValidationLimits limits, IngestPipelineConfig config)
+    : verifier_(verifier), limits_(limits), config_(config) {
+  config_.stage_batch = std::max<std::size_t>(config_.stage_batch, 1U);
+  if (config_.threaded) {
+    limits_thread_ = std::thread([this] { limits_loop(); });
+    verify_thread_ = std::thread([this] { verify_loop(); });
+  }
+}
+
+IngestPipeline::~IngestPipeline() {
+  {
+    const std::lock_guard lock(mutex_);
+    stopping_ = true;
+  }
+  work_cv_.notify_all();
+  if (limits_thread_.joinable()) {
+    limits_thread_.join();
+  }
+  if (verify_thread_.joinable()) {
+    verify_thread_.join();
+  }
+}
+
+std::size_t IngestPipeline::room() const {
+  const std::lock_guard lock(mutex_);
+  return config_.capacity > in_flight_ ? config_.capacity - in_flight_ : 0U;
+}
+
+std::size_t IngestPipeline::submit(std::vector<EventEnvelope>& events) {
+  std::size_t admitted = 0;
+  std::size_t consumed = 0;
+  {
+    const std::lock_guard lock(mutex_);
+    for (; consumed < events.size() && in_flight_ < config_.capacity; ++consumed) {
+      EventEnvelope& event = events[consumed];
+      if (!queued_ids_.insert(event.event_id).second) {
+        ++stats_.duplicates;
+        continue;
+      }
+      intake_.push_back(std::move(event));
+      ++in_flight_;
+      ++admitted;
+    }
+    stats_.admitted += admitted;
+  }
+  events.erase(events.begin(), events.begin() + static_cast<std::ptrdiff_t>(consumed));
+  if (admitted > 0) {
+    work_cv_.notify_all();
+  }
+  return admitted;
+}
+
+IngestBatch IngestPipeline::drain(std::size_t max_events) {
+  if (!config_.threaded) {
+    bool progressed = true;
+    while (progressed) {
+      progressed = run_limits_stage();
+      progressed = run_verify_stage() || progressed;
+    }
+  }
+  IngestBatch out;
+  const std::lock_guard lock(mutex_);
+  std::ranges::sort(ready_, [](const EventEnvelope& a, const EventEnvelope& b) {
+    return a.unix_ts != b.unix_ts ? a.unix_ts < b.unix_ts : a.event_id < b.event_id;
+  });
+  const auto count = static_cast<std::ptrdiff_t>(std::min(max_events, ready_.size()));
+  out.events.assign(std::make_move_iterator(ready_.begin()), std::make_move_iterator(ready_.begin() + count));
+  ready_.erase(ready_.begin(), ready_.begin() + count);
+  for (const EventEnvelope& event : out.events) {
+    queued_ids_.erase(event.event_id);
+  }
+  out.rejected = std::exchange(rejected_, {});
+  in_flight_ -= out.events.size() + out.rejected.size();
+  stats_.drained += out.events.size();
+  stats_.batches += out.events.empty() ? 0U : 1U;
+  return out;
+}
+
+void IngestPipeline::wait_idle() {
+  if (!config_.threaded) {
+    return;
+  }
+  std::unique_lock lock(mutex_);
+  idle_cv_.wait(lock, [this] { return intake_.empty() && checked_.empty() && busy_stages_ == 0; });
+}
+
+std::vector<SignatureCheck> IngestPipeline::verify_now(std::span<const EventEnvelope> events) {
+  const std::lock_guard lock(verifier_mutex_);
+  return verifier_.verify_batch(events);
+}
+
+SignatureVerifierStats IngestPipeline::verifier_stats() const {
+  const std::lock_guard lock(verifier_mutex_);
+  return verifier_.stats();
+}
+
+void IngestPipeline::clear_verifier_cache() {
+  const std::lock_guard lock(verifier_mutex_);
+  verifier_.clear_cache();
+}
+
+IngestPipelineStats IngestPipeline::stats() const {
+  const std::lock_guard lock(mutex_);
+  IngestPipelineStats out = stats_;
+  out.in_flight = in_flight_;
+  return out;
+}
+
+void IngestPipeline::limits_loop() {
+  while (true) {
+    {
+      std::unique_lock lock(mutex_);
+      work_cv_.wait(lock, [this] { return stopping_ || !intake_.empty(); });
+      if (stopping_) {
+        return;
+      }
+    }
+    (void)run_limits_stage();
+  }
+}
+
+void IngestPipeline::verify_loop() {
+  while (true) {
+    {
+      std::unique_lock lock(mutex_);
+      work_cv_.wait(lock, [this] { return stopping_ || !checked_.empty(); });
+      if (stopping_) {
+        return;
+      }
+    }
+    (void)run_verify_stage();
+  }
+}
+
+bool IngestPipeline::run_limits_stage() {
+  std::vector<EventEnvelope> batch;
+  {
+    const std::lock_guard lock(mutex_);
+    if (intake_.empty()) {
+      return false;
+    }
+    batch = take_front(intake_, config_.stage_batch);
+    ++busy_stages_;
+  }
+
+  const std::int64_t now = util::unix_timestamp_now();
+  std::vector<EventEnvelope> passed;
+  std::vector<IngestRejection> failed;
+  passed.reserve(batch.size());
+  for (auto& event : batch) {
+    if (std::optional<std::string> reason = limits_violation(event, limits_, now)) {
+      failed.push_back({.event_id = std::move(event.event_id), .reason = std::move(*reason)});
+      continue;
+    }
+    passed.push_back(std::move(event));
+  }
+
+  {
+    const std::lock_guard lock(mutex_);
+    std::ranges::move(passed, std::back_inserter(checked_));
+    for (const IngestRejection& rejection : failed) {
+      queued_ids_.erase(rejection.event_id);
+    }
+    std::ranges::move(failed, std::back_inserter(rejected_));
+    stats_.rejected_limits += failed.size();
+    --busy_stages_;
+  }
+  work_cv_.notify_all();
+  idle_cv_.notify_all();
+  return true;
+}
+
+bool IngestPipeline::run_verify_stage() {
+  std::vector<EventEnvelope> batch;
+  {
+    const std::lock_guard lock(mutex_);
+    if (checked_.empty()) {
+      return false;
+    }
+    batch = take_front(checked_, config_.stage_batch);
+    ++busy_stages_;
+  }
+
+  const std::vector<SignatureCheck> checks = verify_now(batch);
+  std::vector<EventEnvelope> verified;
+  std::vector<IngestRejection> failed;
+  verified.reserve(batch.size());
+  for (std::size_t i = 0; i < batch.size(); ++i) {
+    if (!checks[i].ok) {
+      failed.push_back({.event_id = std::move(batch[i].event_id), .reason = checks[i].reason});
+      continue;
+    }
+    verified.push_back(std::move(batch[i]));
+  }
+
+  {
+    const std::lock_guard lock(mutex_);
+    std::ranges::move(verified, std::back_inserter(ready_));
+    for (const IngestRejection& rejection : failed) {
+      queued_ids_.erase(rejection.event_id);
+    }
+    std::ranges::move(failed, std::back_inserter(rejected_));
+    stats_.rejected_signature += failed.size();
+    --busy_stages_;
+  }
+  idle_cv_.notify_all();
+  return true;
+}
+
+}  // namespace alpha
@@ -0,0 +1,111 @@
+#pragma once
+
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <deque>
+#include <mutex>
+#include <span>
+#include <string>
+#include <thread>
+#include <unordered_set>
+#include <vector>
+
+#include "core/crypto/signature_verifier.hpp"
+#include "core/model/types.hpp"
+
+namespace alpha {
+
+struct IngestPipelineConfig {
+  // Events admitted and not yet drained; submit() takes no more.
+  std::size_t capacity = 8192;
+  // Most events a stage takes in one pass.
+  std::size_t stage_batch = 1024;
+  // Run each stage on its own thread; otherwise drain() runs them inline.
+  bool threaded = true;
+};
+
+struct IngestPipelineStats {
+  std::uint64_t admitted = 0;
+  std::uint64_t duplicates = 0;  // dropped at submit: same id already queued
+  std::uint64_t rejected_limits = 0;
+  std::uint64_t rejected_signature = 0;
+  std::uint64_t drained = 0;
+  std::uint64_t batches = 0;  // drains that returned events
+  std::size_t in_flight = 0;
+};
+
+struct IngestRejection {
+  std::string event_id;
+  std::string reason;
+};
+
+struct IngestBatch {
+  std::vector<EventEnvelope> events;  // verified, oldest first
+  std::vector<IngestRejection> rejected;
+};
+
+// Staged intake for remote events. Admitted events pass a stateless limits
+// check (fields, size, clock drift) and then signature verification, each
+// stage on its own thread and taking whatever queued up behind it as one
+// batch. Verified events wait for the owner to drain them, sorted by
+// timestamp, and apply them to the store on its own thread. The pipeline is
+// bounded: submit() only takes what fits and leaves the rest with the
+// caller, so a slow store pushes back on the network.
+class IngestPipeline {
+public:
+  IngestPipeline(SignatureVerifier& verifier, ValidationLimits limits, IngestPipelineConfig config = {});
+  IngestPipeline(const IngestPipeline&) = delete;
+  IngestPipeline& operator=(const IngestPipeline&) = delete;
+  ~IngestPipeline();
+
+  [[nodiscard]] std::size_t room() const;
+  // Moves events off the front of `events` while there is room and returns
+  // how many were admitted. An event whose id is already somewhere in the
+  // pipeline is taken off too but dropped, so it is verified once.
+  std::size_t submit(std::vector<EventEnvelope>& events);
+  // Up to `max_events` verified events plus every rejection so far.
+  IngestBatch drain(std::size_t max_events);
+  // Blocks until everything admitted is ready to drain.
+  void wait_idle();
+
+  // The verifier is shared with the synchronous ingest path; these are
+  // serialized with the verify stage.
+  std::vector<SignatureCheck> verify_now(std::span<const EventEnvelope> events);
+  [[nodiscard]] SignatureVerifierStats verifier_stats() const;
+  void clear_verifier_cache();
+
+  [[nodiscard]] IngestPipelineStats stats() const;
+
+private:
+  void limits_loop();
+  void verify_loop();
+  // One pass of each stage over up to a batch of queued events; returns
+  // false when the stage had nothing to do. Called with mutex_ unlocked.
+  bool run_limits_stage();
+  bool run_verify_stage();
+
+  SignatureVerifier& verifier_;
+  ValidationLimits limits_;
+  IngestPipelineConfig config_;
+
+  mutable std::mutex mutex_;
+  std::condition_variable work_cv_;
+  std::condition_variable idle_cv_;
+  bool stopping_ = false;
+  std::deque<EventEnvelope> intake_;
+  std::deque<EventEnvelope> checked_;
+  std::vector<EventEnvelope> ready_;
+  std::vector<IngestRejection> rejected_;
+  // Ids in intake_, checked_ and ready_.
+  std::unordered_set<std::string> queued_ids_;
+  std::size_t in_flight_ = 0;
+  std::size_t busy_stages_ = 0;
+  IngestPipelineStats stats_;
+
+  mutable std::mutex verifier_mutex_;
+  std::thread limits_thread_;
+  std::thread verify_thread_;
+};
+
+}  // namespace alpha
@@ -0,0 +1,147 @@
+#include "core/service/maintenance_scheduler.hpp"
+
+#include <algorithm>
+#include <exception>
+#include <utility>
+
+#include "core/util/canonical.hpp"
+
+namespace alpha {
+
+MaintenanceScheduler::MaintenanceScheduler(std::uint64_t seed)
+    : rng_(seed != 0 ? seed : (static_cast<std::uint64_t>(std::random_device{}()) << 32U) | std::random_device{}()) {}
+
+MaintenanceScheduler::~MaintenanceScheduler() {
+  stop();
+}
+
+Result MaintenanceScheduler::add_job(MaintenanceJob job) {
+  const std::lock_guard lock(mutex_);
+  if (running_) {
+    return Result::failure("Maintenance jobs must be added before start.");
+  }
+  if (job.name.empty() || !job.run || job.interval.count() <= 0) {
+    return Result::failure("Maintenance job needs a name, a positive interval and a body.");
+  }
+  const bool duplicate =
+      std::ranges::any_of(entries_, [&](const Entry& entry) { return entry.job.name == job.name; });
+  if (duplicate) {
+    return Result::failure("Duplicate maintenance job: " + job.name);
+  }
+  job.jitter = std::clamp(job.jitter, 0.0, 0.9);
+  job.retry = std::max(job.retry, std::chrono::milliseconds(1));
+  Entry entry{.job = std::move(job), .stats = {}, .due = {}};
+  entry.stats.name = entry.job.name;
+  entry.stats.interval_ms = entry.job.interval.count();
+  entries_.push_back(std::move(entry));
+  return Result::success("Maintenance job added.");
+}
+
+Result MaintenanceScheduler::start() {
+  const std::lock_guard lock(mutex_);
+  if (running_) {
+    return Result::failure("Maintenance scheduler already running.");
+  }
+  const Clock::time_point now = Clock::now();
+  for (Entry& entry : entries_) {
+    entry.due = entry.job.run_at_start ? now : next_due(entry.job, now);
+  }
+  running_ = true;
+  stopping_ = false;
+  thread_ = std::thread([this] { run(); });
+  return Result::success("Maintenance scheduler started.");
+}
+
+void MaintenanceScheduler::stop() {
+  {
+    const std::lock_guard lock(mutex_);
+    if (!running_) {
+      return;
+    }
+    stopping_ = true;
+  }
+  cv_.notify_all();
+  if (thread_.joinable()) {
+    thread_.join();
+  }
+  const std::lock_guard lock(mutex_);
+  running_ = false;
+}
+
+bool MaintenanceScheduler::running() const {
+  const std::lock_guard lock(mutex_);
+  return running_ && !stopping_;
+}
+
+std::vector<MaintenanceJobStats> MaintenanceScheduler::stats() const {
+  const std::lock_guard lock(mutex_);
+  const Clock::time_point now = Clock::now();
+  std::vector<MaintenanceJobStats> out;
+  out.reserve(entries_.size());
+  for (const Entry& entry : entries_) {
+    MaintenanceJobStats stats = entry.stats;
+    stats.next_due_ms = running_ ? std::chrono::duration_cast<std::chrono::milliseconds>(entry.due - now).count() : 0;
+    out.push_back(std::move(stats));
+  }
+  return out;
+}
+
+MaintenanceScheduler::Clock::time_point MaintenanceScheduler::next_due(const MaintenanceJob& job,
+                                                                       Clock::time_point from) {
+  std::uniform_real_distribution<double> spread(1.0 - job.jitter, 1.0 + job.jitter);
+  const auto wait = std::chrono::duration_cast<Clock::duration>(
+      std::chrono::duration<double, std::milli>(static_cast<double>(job.interval.count()) * spread(rng_)));
+  return from + wait;
+}
+
+void MaintenanceScheduler::run() {
+  std::unique_lock lock(mutex_);
+  while (!stopping_) {
+    if (entries_.empty()) {
+      cv_.wait(lock, [this] { return stopping_; });
+      break;
+    }
+    const auto earliest =
+        std::ranges::min_element(entries_, [](const Entry& a, const Entry& b) { return a.due < b.due; });
+    const Clock::time_point due = earliest->due;
+    if (Clock::now() < due) {
+      cv_.wait_until(lock, due, [this] { return stopping_; });
+      continue;
+    }
+
+    // Entries never move once running, so the job can be called unlocked.
+    const std::size_t index = static_cast<std::size_t>(earliest - entries_.begin());
+    const std::function<std::optional<Result>()>& body = entries_[index].job.run;
+    lock.unlock();
+    const Clock::time_point started = Clock::now();
+    std::optional<Result> result;
+    try {
+      result = body();
+    } catch (const std::exception& e) {
+      result = Result::failure(std::string("Maintenance job threw: ") + e.what());
+    }
+    const Clock::time_point finished = Clock::now();
+    lock.lock();
+
+    Entry& entry = entries_[index];
+    if (!result.has_value()) {
+      ++entry.stats.deferrals;
+      entry.due = finished + entry.job.retry;
+      continue;
+    }
+    const auto elapsed_us =
+        static_cast<std::uint64_t>(std::chrono::duration_cast<std::chrono::microseconds>(finished - started).count());
+    ++entry.stats.runs;
+    entry.stats.failures += result->ok ? 0U : 1U;
+    entry.stats.last_duration_us = elapsed_us;
+    entry.stats.max_duration_us = std::max(entry.stats.max_duration_us, elapsed_us);
+    entry.stats.total_duration_us += elapsed_us;
+    entry.stats.last_run_unix = util::unix_timestamp_now();
+    entry.stats.last_message = std::move(result->message);
+    // Timers restart from the end of the run, so a slow job is not
+    // immediately due again.
+    entry.due = next_due(entry.job, finished);
+  }
+}
+
+}  // namespace alpha
@@ -0,0 +1,90 @@
+#pragma once
+
+#include <chrono>
+#include <condition_variable>
+#include <cstdint>
+#include <functional>
+#include <mutex>
+#include <optional>
+#include <random>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "core/model/types.hpp"
+
+namespace alpha {
+
+struct MaintenanceJob {
+  std::string name;
+  std::chrono::milliseconds interval{1000};
+  // Each wait is interval * (1 +/- jitter), so jobs with equal intervals
+  // drift apart instead of firing together.
+  double jitter = 0.1;
+  // Wait before retrying a job that deferred itself.
+  std::chrono::milliseconds retry{100};
+  // Run once as soon as the scheduler starts instead of after one interval.
+  bool run_at_start = false;
+  // nullopt means the job could not run now (a lock it needs was busy) and
+  // wants to be retried shortly; it is not counted as a run.
+  std::function<std::optional<Result>()> run;
+};
+
+struct MaintenanceJobStats {
+  std::string name;
+  std::int64_t interval_ms = 0;
+  std::uint64_t runs = 0;
+  std::uint64_t failures = 0;
+  std::uint64_t deferrals = 0;
+  std::uint64_t last_duration_us = 0;
+  std::uint64_t max_duration_us = 0;
+  std::uint64_t total_duration_us = 0;
+  std::int64_t last_run_unix = 0;  // 0 until the first run
+  std::int64_t next_due_ms = 0;    // from now, negative when overdue
+  std::string last_message;
+};
+
+// Runs periodic jobs on one background thread, each on its own timer. The
+// thread sleeps until the earliest due job and runs due jobs one at a time,
+// so a job never overlaps itself. Jobs are expected to take whatever locks
+// they need without blocking and defer when they cannot, which keeps the
+// scheduler from stalling anyone else.
+class MaintenanceScheduler {
+public:
+  // seed 0 draws one from std::random_device.
+  explicit MaintenanceScheduler(std::uint64_t seed = 0);
+  MaintenanceScheduler(const MaintenanceScheduler&) = delete;
+  MaintenanceScheduler& operator=(const MaintenanceScheduler&) = delete;
+  ~MaintenanceScheduler();
+
+  // Jobs are added before start().
+  Result add_job(MaintenanceJob job);
+  Result start();
+  // Waits for a job in progress to return.
+  void stop();
+
+  [[nodiscard]] bool running() const;
+  [[nodiscard]] std::vector<MaintenanceJobStats> stats() const;
+
+private:
+  using Clock = std::chrono::steady_clock;
+
+  struct Entry {
+    MaintenanceJob job;
+    MaintenanceJobStats stats;
+    Clock::time_point due;
+  };
+
+  void run();
+  Clock::time_point next_due(const MaintenanceJob& job, Clock::time_point from);
+
+  mutable std::mutex mutex_;
+  std::condition_variable cv_;
+  std::vector<Entry> entries_;
+  std::mt19937_64 rng_;
+  bool running_ = false;
+  bool stopping_ = false;
+  std::thread thread_;
+};
+
+}  // namespace alpha
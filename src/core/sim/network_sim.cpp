@@ -0,0 +1,607 @@
+#include "core/sim/network_sim.hpp"
+
+#include <algorithm>
+#include <filesystem>
+#include <utility>
+
+#include "core/util/canonical.hpp"
+#include "core/util/socket.hpp"
+
+namespace alpha::sim {
+
+class VirtualTransport final : public IPeerTransport {
+public:
+  explicit VirtualTransport(VirtualNetwork& network) : network_(network), slot_(network.attach(this)) {}
+  VirtualTransport(const VirtualTransport&) = delete;
+  VirtualTransport& operator=(const VirtualTransport&) = delete;
+  ~VirtualTransport() override {
+    stop();
+    network_.detach(slot_);
+  }
+
+  Result start(const TcpTransportConfig& config) override {
+    stop();
+    config_ = config;
+    if (config.listen) {
+      std::uint16_t port = config.port;
+      const Result listening = network_.listen(slot_, port);
+      if (!listening.ok) {
+        return listening;
+      }
+      bound_port_ = port;
+      stats_.listening = true;
+    }
+    running_ = true;
+    return Result::success("Virtual transport started.");
+  }
+
+  void stop() override {
+    for (auto& [peer, connection] : connections_) {
+      if (connection.remote_peer != 0) {
+        close_remote(connection);
+      }
+    }
+    connections_.clear();
+    if (stats_.listening) {
+      network_.unlisten(slot_);
+    }
+    inbox_ = {};
+    running_ = false;
+    bound_port_ = 0;
+    stats_.listening = false;
+  }
+
+  Result dial(std::string_view endpoint, PeerId& out_peer) override {
+    out_peer = 0;
+    std::string host;
+    std::uint16_t port = 0;
+    if (!running_ || !util::split_host_port(endpoint, host, port)) {
+      return Result::failure("Virtual dial failed: bad endpoint.");
+    }
+    const PeerId peer = next_peer_id_++;
+    connections_[peer] = Connection{.endpoint = std::string{endpoint}, .connecting = true};
+    network_.schedule({
+        .at_ms = network_.now_ms_ + network_.propagation_delay(),
+        .kind = VirtualNetwork::DeliveryKind::Accept,
+        .from_slot = slot_,
+        .from_peer = peer,
+        .port = port,
+    });
+    out_peer = peer;
+    return Result::success("Virtual dial started.");
+  }
+
+  bool send(PeerId peer, wire::MessageType type, std::string_view body) override {
+    const auto it = connections_.find(peer);
+    if (it == connections_.end() || body.size() > config_.max_frame_bytes) {
+      return false;
+    }
+    ++stats_.frames_out;
+    stats_.bytes_out += wire::kFrameHeaderBytes + body.size();
+    Connection& connection = it->second;
+    if (connection.connecting) {
+      connection.queued.emplace_back(type, std::string{body});
+      return true;
+    }
+    transmit(connection, type, std::string{body});
+    return true;
+  }
+
+  void disconnect(PeerId peer) override {
+    const auto it = connections_.find(peer);
+    if (it == connections_.end()) {
+      return;
+    }
+    // A dial still connecting is closed by the accept it gets back.
+    if (it->second.remote_peer != 0) {
+      close_remote(it->second);
+    }
+    connections_.erase(it);
+    inbox_.disconnected.push_back(peer);
+  }
+
+  TransportPollResult poll(int) override {
+    stats_.connections = connections_.size();
+    return std::exchange(inbox_, {});
+  }
+
+  void watch_wake_pipe(const util::WakePipe*) override {}
+
+  [[nodiscard]] bool running() const override { return running_; }
+  [[nodiscard]] std::uint16_t bound_port() const override { return bound_port_; }
+  [[nodiscard]] std::string peer_endpoint(PeerId peer) const override {
+    const auto it = connections_.find(peer);
+    return it == connections_.end() ? std::string{} : it->second.endpoint;
+  }
+  [[nodiscard]] TcpTransportStats stats() const override {
+    TcpTransportStats out = stats_;
+    out.bound_port = bound_port_;
+    out.connections = connections_.size();
+    return out;
+  }
+
+private:
+  friend class VirtualNetwork;
+
+  struct Connection {
+    std::string endpoint;
+    bool connecting = false;
+    std::size_t remote_slot = 0;
+    PeerId remote_peer = 0;  // 0 until the dial is accepted
+    std::int64_t busy_until_ms = 0;
+    std::int64_t last_arrival_ms = 0;
+    std::vector<std::pair<wire::MessageType, std::string>> queued;
+  };
+
+  void transmit(Connection& connection, wire::MessageType type, std::string body) {
+    std::int64_t at = network_.frame_arrival(wire::kFrameHeaderBytes + body.size(), connection.busy_until_ms);
+    // TCP delivers in order, so jitter never lets a frame overtake another.
+    at = std::max(at, connection.last_arrival_ms);
+    connection.last_arrival_ms = at;
+    network_.schedule({
+        .at_ms = at,
+        .kind = VirtualNetwork::DeliveryKind::Frame,
+        .to_slot = connection.remote_slot,
+        .to_peer = connection.remote_peer,
+        .type = type,
+        .body = std::move(body),
+    });
+  }
+
+  void close_remote(const Connection& connection) {
+    network_.schedule({
+        .at_ms = std::max(network_.now_ms_ + network_.propagation_delay(), connection.last_arrival_ms),
+        .kind = VirtualNetwork::DeliveryKind::Close,
+        .to_slot = connection.remote_slot,
+        .to_peer = connection.remote_peer,
+    });
+  }
+
+  PeerId accept(std::size_t remote_slot, PeerId remote_peer, std::uint16_t remote_port) {
+    const PeerId peer = next_peer_id_++;
+    connections_[peer] = Connection{
+        .endpoint = "127.0.0.1:" + std::to_string(remote_port),
+        .remote_slot = remote_slot,
+        .remote_peer = remote_peer,
+    };
+    inbox_.connected.push_back(peer);
+    return peer;
+  }
+
+  // The dialed side answered; false when the dial was abandoned meanwhile.
+  bool established(PeerId peer, std::size_t remote_slot, PeerId remote_peer) {
+    const auto it = connections_.find(peer);
+    if (it == connections_.end()) {
+      return false;
+    }
+    Connection& connection = it->second;
+    connection.connecting = false;
+    connection.remote_slot = remote_slot;
+    connection.remote_peer = remote_peer;
+    inbox_.connected.push_back(peer);
+    for (auto& [type, body] : std::exchange(connection.queued, {})) {
+      transmit(connection, type, std::move(body));
+    }
+    return true;
+  }
+
+  void dropped(PeerId peer, bool refused) {
+    if (connections_.erase(peer) > 0) {
+      inbox_.disconnected.push_back(peer);
+      stats_.dial_failures += refused ? 1U : 0U;
+    }
+  }
+
+  void received(PeerId peer, wire::MessageType type, std::string body) {
+    if (!connections_.contains(peer)) {
+      return;
+    }
+    ++stats_.frames_in;
+    stats_.bytes_in += wire::kFrameHeaderBytes + body.size();
+    inbox_.frames.push_back({.peer = peer, .type = type, .body = std::move(body)});
+  }
+
+  VirtualNetwork& network_;
+  std::size_t slot_ = 0;
+  TcpTransportConfig config_;
+  bool running_ = false;
+  std::uint16_t bound_port_ = 0;
+  PeerId next_peer_id_ = 1;
+  std::unordered_map<PeerId, Connection> connections_;
+  TransportPollResult inbox_;
+  TcpTransportStats stats_;
+};
+
+VirtualNetwork::VirtualNetwork(std::uint64_t seed, LinkProfile link) : link_(link), rng_(seed) {}
+
+VirtualNetwork::~VirtualNetwork() = default;
+
+std::unique_ptr<IPeerTransport> VirtualNetwork::make_transport() {
+  return std::make_unique<VirtualTransport>(*this);
+}
+
+void VirtualNetwork::advance_to(std::int64_t unix_ms) {
+  while (!queue_.empty() && queue_.front().at_ms <= unix_ms) {
+    std::ranges::pop_heap(queue_, Later{});
+    Delivery delivery = std::move(queue_.back());
+    queue_.pop_back();
+    now_ms_ = std::max(now_ms_, delivery.at_ms);
+    apply(std::move(delivery));
+  }
+  now_ms_ = std::max(now_ms_, unix_ms);
+}
+
+void VirtualNetwork::partition(std::span<const std::uint16_t> ports) {
+  partitioned_.clear();
+  for (const std::uint16_t port : ports) {
+    if (const auto it = listeners_.find(port); it != listeners_.end()) {
+      partitioned_.insert(it->second);
+    }
+  }
+  for (std::size_t slot = 0; slot < slots_.size(); ++slot) {
+    VirtualTransport* transport = slots_[slot];
+    if (transport == nullptr) {
+      continue;
+    }
+    std::vector<PeerId> cut;
+    for (const auto& [peer, connection] : transport->connections_) {
+      if (connection.remote_peer != 0 && crosses_partition(slot, connection.remote_slot)) {
+        cut.push_back(peer);
+      }
+    }
+    std::ranges::sort(cut);
+    for (const PeerId peer : cut) {
+      const auto it = transport->connections_.find(peer);
+      if (it == transport->connections_.end()) {
+        continue;
+      }
+      const auto [remote_slot, remote_peer] = std::pair{it->second.remote_slot, it->second.remote_peer};
+      transport->dropped(peer, false);
+      if (slots_[remote_slot] != nullptr) {
+        slots_[remote_slot]->dropped(remote_peer, false);
+      }
+      ++stats_.links_cut;
+    }
+  }
+}
+
+void VirtualNetwork::heal() {
+  partitioned_.clear();
+}
+
+std::size_t VirtualNetwork::attach(VirtualTransport* transport) {
+  slots_.push_back(transport);
+  return slots_.size() - 1U;
+}
+
+void VirtualNetwork::detach(std::size_t slot) {
+  slots_[slot] = nullptr;
+  partitioned_.erase(slot);
+}
+
+Result VirtualNetwork::listen(std::size_t slot, std::uint16_t& port) {
+  if (port == 0) {
+    port = ephemeral_port();
+  }
+  if (!listeners_.try_emplace(port, slot).second) {
+    return Result::failure("Virtual listener port " + std::to_string(port) + " is already in use.");
+  }
+  return Result::success("Virtual listener bound.");
+}
+
+void VirtualNetwork::unlisten(std::size_t slot) {
+  std::erase_if(listeners_, [slot](const auto& entry) { return entry.second == slot; });
+}
+
+std::uint16_t VirtualNetwork::ephemeral_port() {
+  while (listeners_.contains(next_ephemeral_port_)) {
+    ++next_ephemeral_port_;
+  }
+  return next_ephemeral_port_++;
+}
+
+void VirtualNetwork::schedule(Delivery delivery) {
+  delivery.sequence = next_sequence_++;
+  queue_.push_back(std::move(delivery));
+  std::ranges::push_heap(queue_, Later{});
+}
+
+std::int64_t VirtualNetwork::frame_arrival(std::size_t bytes, std::int64_t& busy_until_ms) {
+  const std::int64_t begin = std::max(now_ms_, busy_until_ms);
+  std::int64_t serialize_ms = 0;
+  if (link_.bandwidth_bytes_per_second > 0) {
+    serialize_ms = static_cast<std::int64_t>((bytes * 1000U + link_.bandwidth_bytes_per_second - 1U) /
+                                             link_.bandwidth_bytes_per_second);
+  }
+  busy_until_ms = begin + serialize_ms;
+  std::int64_t arrival = busy_until_ms + propagation_delay();
+  if (link_.loss_rate > 0.0 && std::bernoulli_distribution{link_.loss_rate}(rng_)) {
+    arrival += link_.retransmit_ms;
+    ++stats_.frames_retransmitted;
+  }
+  return arrival;
+}
+
+std::int64_t VirtualNetwork::propagation_delay() {
+  if (link_.jitter_ms <= 0) {
+    return link_.latency_ms;
+  }
+  return link_.latency_ms + std::uniform_int_distribution<std::int64_t>{0, link_.jitter_ms}(rng_);
+}
+
+bool VirtualNetwork::crosses_partition(std::size_t a_slot, std::size_t b_slot) const {
+  return partitioned_.contains(a_slot) != partitioned_.contains(b_slot);
+}
+
+void VirtualNetwork::apply(Delivery delivery) {
+  VirtualTransport* target = delivery.to_slot < slots_.size() ? slots_[delivery.to_slot] : nullptr;
+  switch (delivery.kind) {
+    case DeliveryKind::Accept: {
+      const auto listener = listeners_.find(delivery.port);
+      VirtualTransport* dialer = slots_[delivery.from_slot];
+      if (dialer == nullptr) {
+        return;
+      }
+      if (listener == listeners_.end() || crosses_partition(delivery.from_slot, listener->second)) {
+        ++stats_.dials_refused;
+        schedule({
+            .at_ms = now_ms_ + propagation_delay(),
+            .kind = DeliveryKind::Refused,
+            .to_slot = delivery.from_slot,
+            .to_peer = delivery.from_peer,
+        });
+        return;
+      }
+      const std::size_t listener_slot = listener->second;
+      const PeerId accepted = slots_[listener_slot]->accept(delivery.from_slot, delivery.from_peer, ephemeral_port());
+      schedule({
+          .at_ms = now_ms_ + propagation_delay(),
+          .kind = DeliveryKind::Established,
+          .to_slot = delivery.from_slot,
+          .to_peer = delivery.from_peer,
+          .from_slot = listener_slot,
+          .from_peer = accepted,
+      });
+      return;
+    }
+    case DeliveryKind::Established:
+      if (target != nullptr && !crosses_partition(delivery.to_slot, delivery.from_slot) &&
+          target->established(delivery.to_peer, delivery.from_slot, delivery.from_peer)) {
+        return;
+      }
+      if (target != nullptr) {
+        target->dropped(delivery.to_peer, true);
+      }
+      schedule({
+          .at_ms = now_ms_ + propagation_delay(),
+          .kind = DeliveryKind::Close,
+          .to_slot = delivery.from_slot,
+          .to_peer = delivery.from_peer,
+      });
+      return;
+    case DeliveryKind::Refused:
+      if (target != nullptr) {
+        target->dropped(delivery.to_peer, true);
+      }
+      return;
+    case DeliveryKind::Frame:
+      if (target != nullptr) {
+        ++stats_.frames_delivered;
+        stats_.bytes_delivered += wire::kFrameHeaderBytes + delivery.body.size();
+        target->received(delivery.to_peer, delivery.type, std::move(delivery.body));
+      }
+      return;
+    case DeliveryKind::Close:
+      if (target != nullptr) {
+        target->dropped(delivery.to_peer, false);
+      }
+      return;
+  }
+}
+
+Simulation::Simulation(SimulationConfig config)
+    : config_(std::move(config)), network_(config_.seed, config_.link), rng_(config_.seed ^ 0x9E3779B97F4A7C15ULL) {
+  if (config_.data_dir.empty()) {
+    config_.data_dir =
+        (std::filesystem::temp_directory_path() / ("got-soup-sim-" + std::to_string(config_.seed))).string();
+  }
+}
+
+Simulation::~Simulation() {
+  nodes_.clear();
+  util::set_virtual_clock(std::nullopt);
+}
+
+Result Simulation::start() {
+  if (!nodes_.empty() || config_.nodes == 0) {
+    return Result::failure("Simulation already started or has no nodes.");
+  }
+  util::set_virtual_clock(config_.start_unix_ms);
+  network_.advance_to(config_.start_unix_ms);
+
+  for (std::size_t i = 0; i < config_.nodes; ++i) {
+    std::vector<std::size_t> others;
+    for (std::size_t j = 0; j < config_.nodes; ++j) {
+      if (j != i) {
+        others.push_back(j);
+      }
+    }
+    std::vector<std::string> seeds;
+    for (std::size_t k = 0; k < config_.seeds_per_node && !others.empty(); ++k) {
+      const std::size_t pick = std::uniform_int_distribution<std::size_t>{0, others.size() - 1U}(rng_);
+      seeds.push_back("127.0.0.1:" + std::to_string(config_.base_port + others[pick]));
+      others.erase(others.begin() + static_cast<std::ptrdiff_t>(pick));
+    }
+
+    // Each run starts from empty stores.
+    const std::filesystem::path dir = std::filesystem::path{config_.data_dir} / ("node-" + std::to_string(i));
+    std::error_code ec;
+    std::filesystem::remove_all(dir, ec);
+
+    auto service = std::make_unique<AlphaService>();
+    service->set_p2p_transport_factory([this] { return network_.make_transport(); });
+    const Result init = service->init({
+        .app_data_dir = dir.string(),
+        .passphrase = "simulation-passphrase",
+        .mode = AnonymityMode::Tor,
+        .seed_peers_testnet = seeds,
+        .alpha_test_mode = true,
+        .community_profile_path = "recipes",
+        .production_swap = true,
+        .block_interval_seconds = config_.block_interval_seconds,
+        .external_mining = true,
+        .p2p_testnet_port = static_cast<std::uint16_t>(config_.base_port + i),
+        .p2p_network_thread = false,
+        .p2p_compression = config_.compression,
+        .ingest_pipeline_threads = false,
+    });
+    if (!init.ok) {
+      return Result::failure("Simulation node " + std::to_string(i) + " failed to start: " + init.message);
+    }
+    // Posting requires a verified key backup.
+    const std::string backup = (dir / "backup" / "identity.dat").string();
+    const Result exported = service->export_key_backup(backup, "simulation-backup", "simulation-salt");
+    const Result verified = exported.ok ? service->verify_key_backup(backup, "simulation-backup") : exported;
+    if (!verified.ok) {
+      return Result::failure("Simulation node " + std::to_string(i) + " has no usable backup: " + verified.message);
+    }
+    nodes_.push_back(std::move(service));
+  }
+  return Result::success("Simulation started with " + std::to_string(nodes_.size()) + " nodes.");
+}
+
+Result Simulation::publish(std::size_t node, std::string_view title) {
+  if (node >= nodes_.size()) {
+    return Result::failure("Simulation node index out of range.");
+  }
+  ++published_;
+  return nodes_[node]->create_recipe({
+      .category = "Simulation",
+      .title = std::string{title},
+      .markdown = "Simulated post " + std::to_string(published_) + ".",
+  });
+}
+
+void Simulation::step() {
+  const std::int64_t now = network_.now_ms() + config_.tick_ms;
+  util::set_virtual_clock(now);
+  network_.advance_to(now);
+  for (std::size_t i = 0; i < nodes_.size(); ++i) {
+    for (const EventEnvelope& event : nodes_[i]->sync_tick()) {
+      TrackedEvent tracked{
+          .origin = i,
+          .announced_ms = now,
+          .held_ms = std::vector<std::int64_t>(nodes_.size(), -1),
+          .outstanding = nodes_.size() - 1U,
+      };
+      tracked.held_ms[i] = now;
+      // Relays of an event already tracked keep its origin.
+      if (tracked_.try_emplace(event.event_id, std::move(tracked)).second) {
+        outstanding_.push_back(event.event_id);
+      }
+    }
+  }
+  record_receipts();
+}
+
+void Simulation::run_for(std::int64_t duration_ms) {
+  const std::int64_t until = network_.now_ms() + duration_ms;
+  while (network_.now_ms() < until) {
+    step();
+  }
+}
+
+Result Simulation::run_load(double events_per_second, std::int64_t duration_ms) {
+  if (events_per_second <= 0.0 || nodes_.empty()) {
+    return Result::failure("Simulation load needs a positive rate and started nodes.");
+  }
+  std::exponential_distribution<double> gap_ms{events_per_second / 1000.0};
+  std::uniform_int_distribution<std::size_t> pick{0, nodes_.size() - 1U};
+  const std::int64_t begin = network_.now_ms();
+  const std::int64_t until = begin + duration_ms;
+  double next = static_cast<double>(begin) + gap_ms(rng_);
+  while (network_.now_ms() < until) {
+    step();
+    const double now = static_cast<double>(network_.now_ms());
+    for (; next <= now && next < static_cast<double>(until); next += gap_ms(rng_)) {
+      const Result posted = publish(pick(rng_), "sim-" + std::to_string(published_));
+      if (!posted.ok) {
+        return posted;
+      }
+    }
+  }
+  return Result::success("Simulation load finished.");
+}
+
+std::optional<std::int64_t> Simulation::run_until_converged(std::int64_t limit_ms) {
+  const std::int64_t begin = network_.now_ms();
+  while (!converged()) {
+    if (network_.now_ms() - begin >= limit_ms) {
+      return std::nullopt;
+    }
+    step();
+  }
+  return network_.now_ms() - begin;
+}
+
+bool Simulation::converged() const {
+  if (nodes_.empty()) {
+    return true;
+  }
+  const std::string first = nodes_.front()->node_status().db.consensus_hash;
+  return std::ranges::all_of(nodes_, [&first](const std::unique_ptr<AlphaService>& node) {
+    return node->node_status().db.consensus_hash == first;
+  });
+}
+
+PropagationReport Simulation::report() const {
+  PropagationReport out;
+  std::vector<std::int64_t> latencies;
+  for (const auto& [id, tracked] : tracked_) {
+    ++out.events;
+    for (std::size_t j = 0; j < tracked.held_ms.size(); ++j) {
+      if (j == tracked.origin) {
+        continue;
+      }
+      if (tracked.held_ms[j] < 0) {
+        ++out.missing_receipts;
+        continue;
+      }
+      latencies.push_back(tracked.held_ms[j] - tracked.announced_ms);
+    }
+  }
+  out.receipts = latencies.size();
+  out.bytes = network_.stats().bytes_delivered;
+  out.frames = network_.stats().frames_delivered;
+  if (!nodes_.empty()) {
+    const std::string first = nodes_.front()->node_status().db.timeline_hash;
+    out.timeline_mismatches = static_cast<std::size_t>(std::ranges::count_if(
+        nodes_, [&first](const auto& node) { return node->node_status().db.timeline_hash != first; }));
+  }
+  if (latencies.empty()) {
+    return out;
+  }
+  std::ranges::sort(latencies);
+  const auto percentile = [&latencies](std::size_t p) { return latencies[(latencies.size() - 1U) * p / 100U]; };
+  out.p50_ms = percentile(50);
+  out.p90_ms = percentile(90);
+  out.p99_ms = percentile(99);
+  out.max_ms = latencies.back();
+  return out;
+}
+
+void Simulation::record_receipts() {
+  const std::int64_t now = network_.now_ms();
+  std::erase_if(outstanding_, [this, now](const std::string& id) {
+    TrackedEvent& tracked = tracked_.at(id);
+    for (std::size_t j = 0; j < nodes_.size(); ++j) {
+      if (tracked.held_ms[j] < 0 && nodes_[j]->has_event(id)) {
+        tracked.held_ms[j] = now;
+        --tracked.outstanding;
+      }
+    }
+    return tracked.outstanding == 0;
+  });
+}
+
+}  // namespace alpha::sim
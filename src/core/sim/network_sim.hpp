@@ -0,0 +1,204 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <optional>
+#include <random>
+#include <span>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <unordered_set>
+#include <vector>
+
+#include "core/model/types.hpp"
+#include "core/p2p/tcp_transport.hpp"
+#include "core/service/alpha_service.hpp"
+
+namespace alpha::sim {
+
+// One direction of every simulated link.
+struct LinkProfile {
+  std::int64_t latency_ms = 40;
+  std::int64_t jitter_ms = 10;  // uniform extra delay per frame
+  std::uint64_t bandwidth_bytes_per_second = 1U << 20U;  // 0 is unlimited
+  // Links carry TCP, so a lost segment delays its frame (and everything
+  // behind it) by a retransmission timeout instead of dropping it.
+  double loss_rate = 0.0;
+  std::int64_t retransmit_ms = 200;
+};
+
+struct VirtualNetworkStats {
+  std::uint64_t frames_delivered = 0;
+  std::uint64_t bytes_delivered = 0;  // frame headers included
+  std::uint64_t frames_retransmitted = 0;
+  std::uint64_t dials_refused = 0;
+  std::uint64_t links_cut = 0;  // by partitions
+};
+
+class VirtualTransport;
+
+// In-process stand-in for the TCP network between simulated nodes. Nothing
+// moves until advance_to(): deliveries are applied in time order, ties in
+// the order they were scheduled, and every random choice comes from the
+// seed, so a run replays exactly. Listeners are addressed as
+// 127.0.0.1:<port>. The network must outlive the transports it hands out.
+class VirtualNetwork {
+public:
+  VirtualNetwork(std::uint64_t seed, LinkProfile link);
+  VirtualNetwork(const VirtualNetwork&) = delete;
+  VirtualNetwork& operator=(const VirtualNetwork&) = delete;
+  ~VirtualNetwork();
+
+  [[nodiscard]] std::unique_ptr<IPeerTransport> make_transport();
+
+  [[nodiscard]] std::int64_t now_ms() const { return now_ms_; }
+  void advance_to(std::int64_t unix_ms);
+
+  // Cuts listeners on `ports` off from everyone else: links across the cut
+  // drop and dials across it are refused until heal().
+  void partition(std::span<const std::uint16_t> ports);
+  void heal();
+
+  [[nodiscard]] const VirtualNetworkStats& stats() const { return stats_; }
+
+private:
+  friend class VirtualTransport;
+
+  enum class DeliveryKind {
+    Accept,       // dial reaches the listener
+    Established,  // accept reaches the dialer
+    Refused,
+    Frame,
+    Close,
+  };
+
+  struct Delivery {
+    std::int64_t at_ms = 0;
+    std::uint64_t sequence = 0;
+    DeliveryKind kind = DeliveryKind::Frame;
+    std::size_t to_slot = 0;
+    PeerId to_peer = 0;
+    std::size_t from_slot = 0;
+    PeerId from_peer = 0;
+    std::uint16_t port = 0;  // Accept: the dialed listener
+    wire::MessageType type = wire::MessageType::Hello;
+    std::string body;
+  };
+
+  struct Later {
+    bool operator()(const Delivery& a, const Delivery& b) const {
+      return a.at_ms != b.at_ms ? a.at_ms > b.at_ms : a.sequence > b.sequence;
+    }
+  };
+
+  std::size_t attach(VirtualTransport* transport);
+  void detach(std::size_t slot);
+  Result listen(std::size_t slot, std::uint16_t& port);
+  void unlisten(std::size_t slot);
+  [[nodiscard]] std::uint16_t ephemeral_port();
+  void schedule(Delivery delivery);
+  // One-way delay of a frame of `bytes` sent now on a link that stays busy
+  // until `busy_until_ms`; updates the busy mark.
+  [[nodiscard]] std::int64_t frame_arrival(std::size_t bytes, std::int64_t& busy_until_ms);
+  [[nodiscard]] std::int64_t propagation_delay();
+  [[nodiscard]] bool crosses_partition(std::size_t a_slot, std::size_t b_slot) const;
+  void apply(Delivery delivery);
+
+  LinkProfile link_;
+  std::mt19937_64 rng_;
+  std::int64_t now_ms_ = 0;
+  std::uint64_t next_sequence_ = 0;
+  std::vector<Delivery> queue_;  // heap ordered by Later
+  std::vector<VirtualTransport*> slots_;  // null once detached
+  std::unordered_map<std::uint16_t, std::size_t> listeners_;
+  std::uint16_t next_ephemeral_port_ = 40000;
+  std::unordered_set<std::size_t> partitioned_;  // slots on the cut-off side
+  VirtualNetworkStats stats_;
+};
+
+struct SimulationConfig {
+  std::size_t nodes = 8;
+  // Seeds each node dials, picked at random from the other nodes.
+  std::size_t seeds_per_node = 3;
+  std::uint64_t seed = 1;
+  LinkProfile link;
+  std::int64_t tick_ms = 50;
+  std::int64_t start_unix_ms = 1780272000000;  // 2026-06-01T00:00:00Z
+  std::uint16_t base_port = 30000;
+  std::string data_dir;  // one subdirectory per node
+  std::uint64_t block_interval_seconds = 150;
+  bool compression = true;
+};
+
+struct PropagationReport {
+  std::size_t events = 0;
+  // Per (event, other node): virtual time from the tick that announced the
+  // event to the first tick it was held.
+  std::size_t receipts = 0;
+  std::size_t missing_receipts = 0;
+  std::int64_t p50_ms = 0;
+  std::int64_t p90_ms = 0;
+  std::int64_t p99_ms = 0;
+  std::int64_t max_ms = 0;
+  std::uint64_t bytes = 0;
+  std::uint64_t frames = 0;
+  // Nodes whose timeline hash differs from node 0's.
+  std::size_t timeline_mismatches = 0;
+};
+
+// Runs AlphaService nodes over a VirtualNetwork in alpha test mode, all on
+// the calling thread with the process clock pinned to virtual time. Ticks
+// run every node in index order; identities are still random, so event ids
+// differ between runs while the schedule itself does not.
+class Simulation {
+public:
+  explicit Simulation(SimulationConfig config);
+  Simulation(const Simulation&) = delete;
+  Simulation& operator=(const Simulation&) = delete;
+  ~Simulation();
+
+  Result start();
+
+  [[nodiscard]] std::size_t size() const { return nodes_.size(); }
+  [[nodiscard]] AlphaService& node(std::size_t index) { return *nodes_[index]; }
+  [[nodiscard]] VirtualNetwork& network() { return network_; }
+  [[nodiscard]] std::int64_t now_ms() const { return network_.now_ms(); }
+
+  // Posts a recipe from `node`; it is tracked once a tick announces it.
+  Result publish(std::size_t node, std::string_view title);
+  void step();
+  void run_for(std::int64_t duration_ms);
+  // Publishes from random nodes at Poisson-distributed times for
+  // `duration_ms` of virtual time.
+  Result run_load(double events_per_second, std::int64_t duration_ms);
+  // Steps until every node reports the same consensus hash (holds the same
+  // events); returns the virtual time that took, or nullopt after
+  // `limit_ms`. Timelines are only compared in the report: open blocks take
+  // events in local arrival order, so they can differ until confirmed.
+  std::optional<std::int64_t> run_until_converged(std::int64_t limit_ms);
+  [[nodiscard]] bool converged() const;
+
+  [[nodiscard]] PropagationReport report() const;
+
+private:
+  struct TrackedEvent {
+    std::size_t origin = 0;
+    std::int64_t announced_ms = 0;
+    std::vector<std::int64_t> held_ms;  // -1 until the node holds it
+    std::size_t outstanding = 0;
+  };
+
+  void record_receipts();
+
+  SimulationConfig config_;
+  VirtualNetwork network_;
+  std::mt19937_64 rng_;
+  std::vector<std::unique_ptr<AlphaService>> nodes_;
+  std::unordered_map<std::string, TrackedEvent> tracked_;
+  std::vector<std::string> outstanding_;
+  std::size_t published_ = 0;
+};
+
+}  // namespace alpha::sim
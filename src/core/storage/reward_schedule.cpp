@@ -0,0 +1,153 @@
+#include "core/storage/reward_schedule.hpp"
+
+#include <algorithm>
+#include <iterator>
+#include <limits>
+
+namespace alpha {
+namespace {
+
+constexpr std::uint64_t kNoMoreRuns = std::numeric_limits<std::uint64_t>::max();
+constexpr std::int64_t kMaxUnits = std::numeric_limits<std::int64_t>::max();
+
+// High 64 bits of a 64x64 product, i.e. fixed-point multiply for Q0.64 values.
+std::uint64_t mul_high(std::uint64_t a, std::uint64_t b) {
+  const std::uint64_t a_lo = a & 0xFFFFFFFFULL;
+  const std::uint64_t a_hi = a >> 32U;
+  const std::uint64_t b_lo = b & 0xFFFFFFFFULL;
+  const std::uint64_t b_hi = b >> 32U;
+
+  const std::uint64_t lo_lo = a_lo * b_lo;
+  const std::uint64_t hi_lo = a_hi * b_lo;
+  const std::uint64_t lo_hi = a_lo * b_hi;
+  const std::uint64_t hi_hi = a_hi * b_hi;
+
+  const std::uint64_t cross = (lo_lo >> 32U) + (hi_lo & 0xFFFFFFFFULL) + lo_hi;
+  return hi_hi + (hi_lo >> 32U) + (cross >> 32U);
+}
+
+// multiplier^exponent in Q0.64 for exponent >= 1, by repeated squaring.
+std::uint64_t pow_q64(std::uint64_t multiplier, std::uint64_t exponent) {
+  std::uint64_t result = 0;
+  bool result_is_one = true;
+  std::uint64_t square = multiplier;
+  while (exponent != 0) {
+    if ((exponent & 1U) != 0) {
+      result = result_is_one ? square : mul_high(result, square);
+      result_is_one = false;
+    }
+    exponent >>= 1U;
+    if (exponent != 0) {
+      square = mul_high(square, square);
+    }
+  }
+  return result;
+}
+
+std::int64_t saturating_add(std::int64_t a, std::int64_t b) {
+  return a > kMaxUnits - b ? kMaxUnits : a + b;
+}
+
+std::int64_t saturating_mul(std::int64_t reward, std::uint64_t blocks) {
+  if (reward <= 0 || blocks == 0) {
+    return 0;
+  }
+  if (blocks > static_cast<std::uint64_t>(kMaxUnits / reward)) {
+    return kMaxUnits;
+  }
+  return reward * static_cast<std::int64_t>(blocks);
+}
+
+}  // namespace
+
+RewardSchedule::RewardSchedule(RewardScheduleParams params) {
+  configure(params);
+}
+
+void RewardSchedule::configure(RewardScheduleParams params) {
+  params_ = params;
+  params_.base_units = std::max<std::int64_t>(0, params_.base_units);
+  params_.floor_units = std::max<std::int64_t>(1, params_.floor_units);
+  runs_.clear();
+  runs_.push_back({.first_block = 1, .reward = evaluate(1), .issued_before = 0});
+  next_run_first_block_ = find_run_end(runs_.back());
+}
+
+std::int64_t RewardSchedule::evaluate(std::uint64_t block_index) const {
+  if (block_index == 0) {
+    return 0;
+  }
+  std::int64_t reward = params_.base_units;
+  if (block_index > 1 && params_.decay_q64 != 0) {
+    // (1 - decay) in Q0.64; 2^64 - decay wraps to exactly that value.
+    const std::uint64_t multiplier = 0 - params_.decay_q64;
+    const std::uint64_t factor = pow_q64(multiplier, block_index - 1U);
+    reward = static_cast<std::int64_t>(mul_high(static_cast<std::uint64_t>(params_.base_units), factor));
+  }
+  return std::max(params_.floor_units, reward);
+}
+
+std::uint64_t RewardSchedule::find_run_end(const Run& run) const {
+  if (run.reward <= params_.floor_units || params_.decay_q64 == 0) {
+    return kNoMoreRuns;
+  }
+
+  // Gallop forward from the run start, then bisect for the first block whose
+  // reward drops below the run's reward.
+  std::uint64_t low = run.first_block;
+  std::uint64_t step = 1;
+  std::uint64_t high = low + step;
+  while (evaluate(high) >= run.reward) {
+    low = high;
+    if (step > (kNoMoreRuns - high) / 2U) {
+      return kNoMoreRuns;
+    }
+    step *= 2U;
+    high = low + step;
+  }
+  while (high - low > 1U) {
+    const std::uint64_t mid = low + ((high - low) / 2U);
+    if (evaluate(mid) >= run.reward) {
+      low = mid;
+    } else {
+      high = mid;
+    }
+  }
+  return high;
+}
+
+const RewardSchedule::Run& RewardSchedule::run_for(std::uint64_t block_index) const {
+  if (runs_.empty()) {
+    runs_.push_back({.first_block = 1, .reward = evaluate(1), .issued_before = 0});
+    next_run_first_block_ = find_run_end(runs_.back());
+  }
+  while (block_index >= next_run_first_block_) {
+    const Run last = runs_.back();
+    const std::uint64_t first = next_run_first_block_;
+    runs_.push_back({
+        .first_block = first,
+        .reward = evaluate(first),
+        .issued_before = saturating_add(last.issued_before, saturating_mul(last.reward, first - last.first_block)),
+    });
+    next_run_first_block_ = find_run_end(runs_.back());
+  }
+  const auto it = std::ranges::upper_bound(runs_, block_index, {}, &Run::first_block);
+  return *std::prev(it);
+}
+
+std::int64_t RewardSchedule::reward_at(std::uint64_t block_index) const {
+  if (block_index == 0) {
+    return 0;
+  }
+  return run_for(block_index).reward;
+}
+
+std::int64_t RewardSchedule::issued_through(std::uint64_t block_index) const {
+  if (block_index == 0) {
+    return 0;
+  }
+  const Run& run = run_for(block_index);
+  return saturating_add(run.issued_before, saturating_mul(run.reward, block_index - run.first_block + 1U));
+}
+
+}  // namespace alpha
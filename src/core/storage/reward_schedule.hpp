@@ -0,0 +1,53 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+namespace alpha {
+
+struct RewardScheduleParams {
+  std::int64_t base_units = 115;
+  // Per-block decay as a Q0.64 fraction (decay * 2^64), so the schedule is
+  // identical on every platform regardless of `long double` width.
+  std::uint64_t decay_q64 = 30319066423296ULL;  // 0.0000016435998841934918
+  std::int64_t floor_units = 1;
+};
+
+// Deterministic block subsidy schedule: reward(n) = max(floor, floor(base * (1 - decay)^(n - 1)))
+// evaluated in 64-bit fixed point. The integer reward is piecewise constant, so
+// the schedule is stored as runs of equal rewards with the issuance before each
+// run; the run table is extended lazily as later blocks are queried. Lookups
+// are a binary search over runs, independent of the block index.
+class RewardSchedule {
+public:
+  RewardSchedule() = default;
+  explicit RewardSchedule(RewardScheduleParams params);
+
+  void configure(RewardScheduleParams params);
+
+  // Subsidy for `block_index`; the genesis block (0) pays nothing.
+  [[nodiscard]] std::int64_t reward_at(std::uint64_t block_index) const;
+  // Sum of reward_at(1..block_index), saturating at INT64_MAX.
+  [[nodiscard]] std::int64_t issued_through(std::uint64_t block_index) const;
+
+  [[nodiscard]] const RewardScheduleParams& params() const { return params_; }
+  [[nodiscard]] std::size_t cached_runs() const { return runs_.size(); }
+
+private:
+  struct Run {
+    std::uint64_t first_block = 1;
+    std::int64_t reward = 0;
+    std::int64_t issued_before = 0;
+  };
+
+  [[nodiscard]] std::int64_t evaluate(std::uint64_t block_index) const;
+  [[nodiscard]] std::uint64_t find_run_end(const Run& run) const;
+  const Run& run_for(std::uint64_t block_index) const;
+
+  RewardScheduleParams params_{};
+  mutable std::vector<Run> runs_;
+  mutable std::uint64_t next_run_first_block_ = 0;
+};
+
+}  // namespace alpha
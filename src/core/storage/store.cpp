@@ -3,7 +3,6 @@
 #include <algorithm>
 #include <array>
 #include <charconv>
-#include <cmath>
 #include <filesystem>
 #include <fstream>
 #include <functional>
@@ -15,6 +14,7 @@
 
 #include "core/util/canonical.hpp"
 #include "core/util/hash.hpp"
+#include "core/util/metrics.hpp"
 
 namespace alpha {
 namespace {
@@ -27,6 +27,13 @@ constexpr std::string_view kSnapshotFile = "state.snapshot";
 constexpr std::string_view kCheckpointsFile = "checkpoints.dat";
 constexpr std::string_view kBlockHeaderPrefix = "# got-soup blockdata";
 
+// Call sites keep the returned reference in a function-local static, so the
+// registry lock is only taken the first time an operation runs.
+util::LatencyHistogram& store_latency(std::string_view op) {
+  return util::metrics().histogram("gotsoup_store_duration_seconds", "Latency of Store operations.",
+                                   {.key = "op", .value = op});
+}
+
 std::string to_hex(std::string_view bytes) {
   static constexpr char kHex[] = "0123456789abcdef";
   std::string out;
@@ -428,9 +435,14 @@ void Store::set_genesis_psz_timestamp(std::string_view psz_timestamp) {
 void Store::set_block_reward_units(std::int64_t units) {
   block_reward_units_ = units <= 0 ? 115 : units;
   max_token_supply_units_ = 69359946;
-  per_block_subsidy_decay_fraction_ = 0.0000016435998841934918L;
+  per_block_subsidy_decay_q64_ = RewardScheduleParams{}.decay_q64;
   min_subsidy_units_ = 1;
   difficulty_adjustment_interval_blocks_ = 864;
+  reward_schedule_.configure({
+      .base_units = block_reward_units_,
+      .decay_q64 = per_block_subsidy_decay_q64_,
+      .floor_units = min_subsidy_units_,
+  });
 }
 
 void Store::set_chain_identity(std::string_view chain_id, std::string_view network_id) {
@@ -513,7 +525,87 @@ void Store::set_state_options(std::uint32_t blockdata_format_version, bool enabl
   prune_keep_recent_blocks_ = prune_keep_recent_blocks == 0 ? 4096 : prune_keep_recent_blocks;
 }
 
+void Store::set_change_listener(std::function<void(const StoreChange&)> listener) {
+  change_listener_ = std::move(listener);
+}
+
+void Store::report_change(StoreChange change) const {
+  if (change_listener_) {
+    change_listener_(change);
+  }
+}
+
+void Store::report_event_applied(const EventEnvelope& event) const {
+  if (change_listener_) {
+    report_change({.kind = StoreChange::Kind::EventApplied,
+                   .id = event.event_id,
+                   .detail = event_kind_to_string(event.kind),
+                   .value = event.unix_ts});
+  }
+}
+
 Result Store::append_event(const EventEnvelope& event) {
+  static util::LatencyHistogram& latency = store_latency("append_event");
+  const util::ScopedTimer timer(latency);
+  const Result valid = validate_new_event(event, false, util::unix_timestamp_now());
+  if (!valid.ok) {
+    return valid;
+  }
+  if (has_event(event.event_id)) {
+    return Result::success("Event already exists (idempotent append).");
+  }
+
+  events_.push_back(event);
+  event_index_.emplace(event.event_id, events_.size() - 1U);
+  const Result persist = persist_event(event);
+  if (!persist.ok) {
+    return persist;
+  }
+  report_event_applied(event);
+  return commit_appended_events();
+}
+
+std::vector<Result> Store::append_events(std::span<const EventEnvelope> events, bool historical) {
+  static util::LatencyHistogram& latency = store_latency("append_events");
+  const util::ScopedTimer timer(latency);
+  std::vector<Result> results;
+  results.reserve(events.size());
+  const std::int64_t now = util::unix_timestamp_now();
+  bool appended = false;
+  for (const auto& event : events) {
+    Result valid = validate_new_event(event, historical, now);
+    if (!valid.ok) {
+      results.push_back(std::move(valid));
+      continue;
+    }
+    if (has_event(event.event_id)) {
+      results.push_back(Result::success("Event already exists (idempotent append)."));
+      continue;
+    }
+    events_.push_back(event);
+    event_index_.emplace(event.event_id, events_.size() - 1U);
+    results.push_back(persist_event(event));
+    if (results.back().ok) {
+      report_event_applied(event);
+    }
+    appended = true;
+  }
+  if (!appended) {
+    return results;
+  }
+
+  const Result committed = commit_appended_events();
+  if (!committed.ok) {
+    for (auto& result : results) {
+      if (result.ok) {
+        result = committed;
+      }
+    }
+  }
+  return results;
+}
+
+Result Store::validate_new_event(const EventEnvelope& event, bool historical, std::int64_t now_unix) {
   if (event.event_id.empty()) {
     record_invalid_event("", "append_event failed: missing event id.");
     return Result::failure("append_event failed: missing event id.");
@@ -531,26 +623,18 @@ Result Store::append_event(const EventEnvelope& event) {
     return Result::failure("append_event failed: payload exceeds max_event_bytes.");
   }
 
-  const std::int64_t now = util::unix_timestamp_now();
-  if (event.unix_ts > (now + validation_limits_.max_future_drift_seconds)) {
+  if (event.unix_ts > (now_unix + validation_limits_.max_future_drift_seconds)) {
     record_invalid_event(event.event_id, "append_event failed: timestamp exceeds future drift limit.");
     return Result::failure("append_event failed: timestamp exceeds future drift limit.");
   }
-  if (event.unix_ts < (now - validation_limits_.max_past_drift_seconds)) {
+  if (!historical && event.unix_ts < (now_unix - validation_limits_.max_past_drift_seconds)) {
     record_invalid_event(event.event_id, "append_event failed: timestamp exceeds past drift limit.");
     return Result::failure("append_event failed: timestamp exceeds past drift limit.");
   }
+  return Result::success("Event is valid for append.");
+}
 
-  if (has_event(event.event_id)) {
-    return Result::success("Event already exists (idempotent append).");
-  }
-
-  events_.push_back(event);
-  const Result persist = persist_event(event);
-  if (!persist.ok) {
-    return persist;
-  }
-
+Result Store::commit_appended_events() {
   assign_unassigned_events_to_blocks();
   ensure_block_slots_until(util::unix_timestamp_now());
   recompute_block_hashes();
@@ -570,12 +654,74 @@ Result Store::append_event(const EventEnvelope& event) {
 }
 
 bool Store::has_event(std::string_view event_id) const {
-  return std::ranges::any_of(events_, [event_id](const EventEnvelope& event) {
-    return event.event_id == event_id;
-  });
+  return find_event(event_id) != nullptr;
+}
+
+const EventEnvelope* Store::find_event(std::string_view event_id) const {
+  const auto it = event_index_.find(std::string{event_id});
+  return it == event_index_.end() ? nullptr : &events_[it->second];
+}
+
+void Store::rebuild_event_index() {
+  event_index_.clear();
+  event_index_.reserve(events_.size());
+  for (std::size_t i = 0; i < events_.size(); ++i) {
+    event_index_.emplace(events_[i].event_id, i);
+  }
 }
 
 Result Store::materialize_views() {
+  static util::LatencyHistogram& latency = store_latency("materialize_views");
+  const util::ScopedTimer timer(latency);
+  if (!change_listener_) {
+    const Result rebuilt = rebuild_views();
+    generation_.fetch_add(1, std::memory_order_release);
+    return rebuilt;
+  }
+
+  // The rebuild clears these anyway, so the old views are moved out rather
+  // than copied.
+  std::unordered_map<std::string, std::int64_t> balances_before;
+  std::unordered_set<std::string> hidden_before;
+  std::unordered_set<std::string> moderators_before;
+  balances_before.swap(reward_balances_);
+  hidden_before.swap(moderation_hidden_objects_);
+  moderators_before.swap(moderators_);
+  Result rebuilt = rebuild_views();
+  generation_.fetch_add(1, std::memory_order_release);
+
+  for (const auto& [cid, balance] : reward_balances_) {
+    const auto before = balances_before.find(cid);
+    const std::int64_t previous = before == balances_before.end() ? 0 : before->second;
+    if (balance != previous) {
+      report_change({.kind = StoreChange::Kind::BalanceChanged, .id = cid, .value = balance, .delta = balance - previous});
+    }
+  }
+  for (const auto& [cid, previous] : balances_before) {
+    if (previous != 0 && !reward_balances_.contains(cid)) {
+      report_change({.kind = StoreChange::Kind::BalanceChanged, .id = cid, .value = 0, .delta = -previous});
+    }
+  }
+  const auto report_set_changes = [this](const std::unordered_set<std::string>& before,
+                                         const std::unordered_set<std::string>& after, std::string_view added,
+                                         std::string_view removed) {
+    for (const std::string& id : after) {
+      if (!before.contains(id)) {
+        report_change({.kind = StoreChange::Kind::ModerationChanged, .id = id, .detail = std::string{added}});
+      }
+    }
+    for (const std::string& id : before) {
+      if (!after.contains(id)) {
+        report_change({.kind = StoreChange::Kind::ModerationChanged, .id = id, .detail = std::string{removed}});
+      }
+    }
+  };
+  report_set_changes(hidden_before, moderation_hidden_objects_, "hidden", "unhidden");
+  report_set_changes(moderators_before, moderators_, "moderator_added", "moderator_removed");
+  return rebuilt;
+}
+
+Result Store::rebuild_views() {
   recipes_.clear();
   threads_.clear();
   replies_by_thread_.clear();
@@ -1114,15 +1260,21 @@ Result Store::materialize_views() {
 }
 
 Result Store::routine_block_check(std::int64_t now_unix) {
+  static util::LatencyHistogram& latency = store_latency("routine_block_check");
+  const util::ScopedTimer timer(latency);
+  const std::size_t blocks_before = blocks_.size();
   ensure_genesis_block(now_unix);
   ensure_block_slots_until(now_unix);
   assign_unassigned_events_to_blocks();
 
   bool updated = false;
-  for (auto& block : blocks_) {
+  std::vector<std::size_t> newly_confirmed;
+  for (std::size_t i = 0; i < blocks_.size(); ++i) {
+    BlockRecord& block = blocks_[i];
     if (!block.confirmed && (now_unix - block.opened_unix) >= static_cast<std::int64_t>(block_interval_seconds_)) {
       block.confirmed = true;
       updated = true;
+      newly_confirmed.push_back(i);
     }
   }
 
@@ -1132,9 +1284,18 @@ Result Store::routine_block_check(std::int64_t now_unix) {
     // Hashes may still need recompute if new events were assigned.
     recompute_block_hashes();
   }
+  // Reported once the hashes are final.
+  for (const std::size_t i : newly_confirmed) {
+    report_change({.kind = StoreChange::Kind::BlockConfirmed,
+                   .id = blocks_[i].block_hash,
+                   .value = static_cast<std::int64_t>(blocks_[i].index)});
+  }
 
   apply_confirmation_metrics();
   prune_blocks_if_needed();
+  if (updated || blocks_.size() != blocks_before) {
+    generation_.fetch_add(1, std::memory_order_release);
+  }
   const Result block_persist = persist_block_log();
   if (!block_persist.ok) {
     return block_persist;
@@ -1148,6 +1309,8 @@ Result Store::routine_block_check(std::int64_t now_unix) {
 
 Result Store::backtest_validate(const std::function<std::string(std::string_view)>& content_id_fn,
                                 std::string_view expected_community_id) {
+  static util::LatencyHistogram& latency = store_latency("backtest_validate");
+  const util::ScopedTimer timer(latency);
   std::size_t issues = 0;
   std::size_t historical_timestamp_warnings = 0;
   std::ostringstream details;
@@ -1846,6 +2009,7 @@ std::optional<Store::BlockRecord> Store::latest_checkpoint_block() const {
 
 Result Store::load_event_log() {
   events_.clear();
+  event_index_.clear();
 
   std::ifstream in(event_log_path_);
   if (!in) {
@@ -1865,6 +2029,7 @@ Result Store::load_event_log() {
       record_invalid_event("load-event-log", "Failed to parse event line.");
     }
   }
+  rebuild_event_index();
 
   return materialize_views();
 }
@@ -1950,6 +2115,7 @@ Result Store::rollback_to_last_checkpoint(std::string_view reason) {
                   return !retained_event_ids.contains(event.event_id);
                 }),
                 events_.end());
+  rebuild_event_index();
   blocks_ = std::move(retained_blocks);
 
   rebuild_event_to_block_index();
@@ -2057,6 +2223,8 @@ Result Store::load_block_log() {
 }
 
 Result Store::persist_block_log() const {
+  static util::LatencyHistogram& latency = store_latency("persist_block_log");
+  const util::ScopedTimer timer(latency);
   std::ofstream out(block_log_path_, std::ios::out | std::ios::trunc);
   if (!out) {
     return Result::failure("Failed to write block log file.");
@@ -2222,12 +2390,7 @@ void Store::recompute_block_hashes() {
     block.merkle_root = compute_merkle_root(merkle_leaves);
     block.content_hash = stable_hash(join_event_ids(content_parts));
     block.prev_hash = prev_hash;
-
-    std::ostringstream digest_input;
-    digest_input << block.index << "|" << block.opened_unix << "|" << (block.reserved ? 1 : 0) << "|"
-                 << (block.confirmed ? 1 : 0) << "|" << (block.backfilled ? 1 : 0) << "|" << block.prev_hash
-                 << "|" << block.merkle_root << "|" << block.content_hash << "|" << block.psz_timestamp;
-    block.block_hash = stable_hash(digest_input.str());
+    block.block_hash = block_header_hash(block);
     if (block.index == 0 && block.event_ids.empty()) {
       if (!hardcoded_genesis_merkle_root_.empty()) {
         block.merkle_root = hardcoded_genesis_merkle_root_;
@@ -2240,17 +2403,34 @@ void Store::recompute_block_hashes() {
   }
 }
 
-std::int64_t Store::scheduled_reward_for_block(std::uint64_t block_index) const {
-  if (block_index == 0) {
-    return 0;
+std::string Store::block_header_hash(const BlockRecord& block) {
+  std::ostringstream digest_input;
+  digest_input << block.index << "|" << block.opened_unix << "|" << (block.reserved ? 1 : 0) << "|"
+               << (block.confirmed ? 1 : 0) << "|" << (block.backfilled ? 1 : 0) << "|" << block.prev_hash
+               << "|" << block.merkle_root << "|" << block.content_hash << "|" << block.psz_timestamp;
+  return stable_hash(digest_input.str());
+}
+
+std::string Store::block_merkle_root(std::span<const EventEnvelope> events) {
+  std::vector<std::string> leaves;
+  leaves.reserve(events.size());
+  for (const auto& event : events) {
+    leaves.push_back(stable_hash(event.event_id + ":" + stable_hash(event.payload)));
+  }
+  return compute_merkle_root(std::move(leaves));
+}
+
+std::string Store::block_content_hash(std::span<const EventEnvelope> events) {
+  std::vector<std::string> parts;
+  parts.reserve(events.size());
+  for (const auto& event : events) {
+    parts.push_back(event.event_id + ":" + stable_hash(event.payload));
   }
-  const long double decay = std::clamp(per_block_subsidy_decay_fraction_, 0.0L, 0.9999999999L);
-  const long double multiplier = 1.0L - decay;
-  const long double exponent = static_cast<long double>(block_index - 1U);
-  const long double raw = static_cast<long double>(block_reward_units_) * std::pow(multiplier, exponent);
-  const std::int64_t floor_units = std::max<std::int64_t>(1, min_subsidy_units_);
-  const std::int64_t reward = static_cast<std::int64_t>(raw);
-  return std::max<std::int64_t>(floor_units, reward);
+  return stable_hash(join_event_ids(parts));
+}
+
+std::int64_t Store::scheduled_reward_for_block(std::uint64_t block_index) const {
+  return reward_schedule_.reward_at(block_index);
 }
 
 std::int64_t Store::expected_claim_reward_for_block(std::uint64_t block_index,
@@ -2358,7 +2538,15 @@ Result Store::persist_snapshot() {
       std::filesystem::exists(snapshot_path_)) {
     return Result::success("Snapshot interval not reached.");
   }
+  return write_snapshot();
+}
 
+Result Store::write_snapshot() {
+  static util::LatencyHistogram& latency = store_latency("write_snapshot");
+  const util::ScopedTimer timer(latency);
+  if (!enable_snapshots_ || snapshot_path_.empty()) {
+    return Result::success("Snapshots disabled.");
+  }
   std::ofstream out(snapshot_path_, std::ios::out | std::ios::trunc);
   if (!out) {
     return Result::failure("Failed to write snapshot file.");
@@ -2384,6 +2572,8 @@ Result Store::persist_snapshot() {
 }
 
 Result Store::persist_checkpoints() {
+  static util::LatencyHistogram& latency = store_latency("persist_checkpoints");
+  const util::ScopedTimer timer(latency);
   if (checkpoints_path_.empty()) {
     return Result::success("Checkpoints path not configured.");
   }
@@ -2457,10 +2647,8 @@ std::size_t Store::block_event_bytes(const BlockRecord& block) const {
   std::size_t total = 0;
   for (const auto& event_id : block.event_ids) {
     total += event_id.size();
-    const auto it =
-        std::ranges::find_if(events_, [&event_id](const EventEnvelope& event) { return event.event_id == event_id; });
-    if (it != events_.end()) {
-      total += it->payload.size() + it->signature.size() + 24U;
+    if (const EventEnvelope* event = find_event(event_id); event != nullptr) {
+      total += event->payload.size() + event->signature.size() + 24U;
     } else {
       total += 64U;
     }
@@ -1,7 +1,10 @@
 #pragma once
 
+#include <atomic>
+#include <cstdint>
 #include <functional>
 #include <optional>
+#include <span>
 #include <string>
 #include <string_view>
 #include <unordered_map>
@@ -9,9 +12,26 @@
 #include <vector>
 
 #include "core/model/types.hpp"
+#include "core/storage/reward_schedule.hpp"
 
 namespace alpha {
 
+// One state change as the store applies it, reported to the listener set
+// with Store::set_change_listener.
+struct StoreChange {
+  enum class Kind : std::uint8_t {
+    EventApplied,       // id: event id, detail: event kind, value: unix_ts
+    BlockConfirmed,     // id: block hash, value: block index
+    BalanceChanged,     // id: wallet cid, value: new balance, delta: change
+    ModerationChanged,  // id: object or moderator cid, detail: hidden, unhidden, moderator_added, moderator_removed
+  };
+  Kind kind = Kind::EventApplied;
+  std::string id;
+  std::string detail;
+  std::int64_t value = 0;
+  std::int64_t delta = 0;
+};
+
 class Store {
 public:
   struct BlockRecord {
@@ -40,12 +60,32 @@ public:
   void set_state_options(std::uint32_t blockdata_format_version, bool enable_snapshots,
                          std::uint64_t snapshot_interval_blocks, bool enable_pruning,
                          std::uint64_t prune_keep_recent_blocks);
+  // Called synchronously, on the mutating thread, for each change applied
+  // from then on; it must not call back into the store. Balance and
+  // moderation changes are found by diffing the views each rebuild, which
+  // is skipped while no listener is set.
+  void set_change_listener(std::function<void(const StoreChange&)> listener);
+  // Advances whenever anything the query methods report may have changed:
+  // each view rebuild and each block check that touched the blocks. Readers
+  // on other threads may load it without the store's owner lock; a value
+  // read before a change is only advanced once the change is complete.
+  [[nodiscard]] std::uint64_t generation() const { return generation_.load(std::memory_order_acquire); }
 
   Result append_event(const EventEnvelope& event);
+  // Appends a batch and rebuilds blocks, views and checkpoints once. Results
+  // line up with `events`. `historical` events come from a validated header
+  // chain during initial sync and skip the past-drift window.
+  std::vector<Result> append_events(std::span<const EventEnvelope> events, bool historical = false);
   [[nodiscard]] bool has_event(std::string_view event_id) const;
+  // Returned pointer is invalidated by the next append, load or rollback.
+  [[nodiscard]] const EventEnvelope* find_event(std::string_view event_id) const;
+  void record_invalid_event(std::string_view event_id, std::string_view reason);
 
   Result materialize_views();
   Result routine_block_check(std::int64_t now_unix);
+  // Rewrites the state snapshot now; routine_block_check only does so every
+  // snapshot_interval_blocks.
+  Result write_snapshot();
   Result backtest_validate(const std::function<std::string(std::string_view)>& content_id_fn,
                            std::string_view expected_community_id);
   Result rollback_to_last_checkpoint(std::string_view reason);
@@ -60,11 +100,18 @@ public:
   [[nodiscard]] std::vector<BlockRecord> claimable_confirmed_blocks(std::string_view cid) const;
   [[nodiscard]] bool has_block_claim(std::uint64_t block_index) const;
   [[nodiscard]] std::int64_t next_claim_reward(std::uint64_t block_index) const;
+  [[nodiscard]] const RewardSchedule& reward_schedule() const { return reward_schedule_; }
   [[nodiscard]] std::uint64_t next_transfer_nonce(std::string_view cid) const;
   [[nodiscard]] std::int64_t transfer_burn_fee(std::int64_t amount) const;
   [[nodiscard]] ModerationStatus moderation_status() const;
   [[nodiscard]] bool is_moderator(std::string_view cid) const;
 
+  // Hash rules shared with initial sync so peers' headers and bodies can be
+  // checked without a Store instance.
+  [[nodiscard]] static std::string block_header_hash(const BlockRecord& block);
+  [[nodiscard]] static std::string block_merkle_root(std::span<const EventEnvelope> events);
+  [[nodiscard]] static std::string block_content_hash(std::span<const EventEnvelope> events);
+
   [[nodiscard]] const std::vector<EventEnvelope>& all_events() const { return events_; }
   [[nodiscard]] const std::vector<BlockRecord>& all_blocks() const { return blocks_; }
   [[nodiscard]] std::string schema_sql() const;
@@ -79,6 +126,7 @@ private:
   std::string checkpoints_path_;
 
   std::vector<EventEnvelope> events_;
+  std::unordered_map<std::string, std::size_t> event_index_;
   std::vector<BlockRecord> blocks_;
   std::unordered_map<std::string, std::size_t> event_to_block_;
   std::unordered_map<std::string, RecipeSummary> recipes_;
@@ -101,8 +149,9 @@ private:
   std::uint64_t block_interval_seconds_ = 150;
   std::int64_t block_reward_units_ = 115;
   std::int64_t max_token_supply_units_ = 69359946;
-  long double per_block_subsidy_decay_fraction_ = 0.0000016435998841934918L;
+  std::uint64_t per_block_subsidy_decay_q64_ = RewardScheduleParams{}.decay_q64;
   std::int64_t min_subsidy_units_ = 1;
+  RewardSchedule reward_schedule_{};
   std::uint64_t difficulty_adjustment_interval_blocks_ = 864;
   int pow_difficulty_nibbles_ = 4;
   std::string chain_id_ = "got-soup-mainnet-v3";
@@ -127,6 +176,14 @@ private:
   std::string backtest_details_ = "Backtest has not run.";
   std::int64_t last_backtest_unix_ = 0;
 
+  std::function<void(const StoreChange&)> change_listener_;
+  std::atomic<std::uint64_t> generation_{0};
+
+  Result validate_new_event(const EventEnvelope& event, bool historical, std::int64_t now_unix);
+  void report_change(StoreChange change) const;
+  void report_event_applied(const EventEnvelope& event) const;
+  Result rebuild_views();
+  Result commit_appended_events();
   Result load_event_log();
   Result persist_event(const EventEnvelope& event) const;
   Result persist_event_log() const;
@@ -139,6 +196,7 @@ private:
   void ensure_block_slots_until(std::int64_t now_unix);
   void assign_unassigned_events_to_blocks();
   void rebuild_event_to_block_index();
+  void rebuild_event_index();
   void recompute_block_hashes();
   [[nodiscard]] std::int64_t scheduled_reward_for_block(std::uint64_t block_index) const;
   [[nodiscard]] std::int64_t expected_claim_reward_for_block(std::uint64_t block_index,
@@ -152,7 +210,6 @@ private:
   [[nodiscard]] std::string timeline_hash() const;
   [[nodiscard]] std::size_t block_event_bytes(const BlockRecord& block) const;
   [[nodiscard]] std::optional<BlockRecord> latest_checkpoint_block() const;
-  void record_invalid_event(std::string_view event_id, std::string_view reason);
 };
 
 }  // namespace alpha
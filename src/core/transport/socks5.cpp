@@ -0,0 +1,156 @@
+#include "core/transport/socks5.hpp"
+
+#include <utility>
+
+namespace alpha {
+namespace {
+
+constexpr std::uint8_t kVersion = 0x05;
+constexpr std::uint8_t kAuthVersion = 0x01;
+constexpr std::uint8_t kMethodNone = 0x00;
+constexpr std::uint8_t kMethodPassword = 0x02;
+constexpr std::uint8_t kCommandConnect = 0x01;
+constexpr std::uint8_t kAddressIpv4 = 0x01;
+constexpr std::uint8_t kAddressDomain = 0x03;
+constexpr std::uint8_t kAddressIpv6 = 0x04;
+constexpr std::size_t kMaxField = 255;
+
+std::uint8_t byte_at(std::string_view in, std::size_t pos) {
+  return static_cast<std::uint8_t>(in[pos]);
+}
+
+void put_field(std::string& out, std::string_view value) {
+  out.push_back(static_cast<char>(value.size()));
+  out.append(value);
+}
+
+}  // namespace
+
+std::string Socks5Handshake::greeting() const {
+  std::string out;
+  out.push_back(static_cast<char>(kVersion));
+  out.push_back(1);
+  out.push_back(static_cast<char>(with_auth_ ? kMethodPassword : kMethodNone));
+  return out;
+}
+
+std::string Socks5Handshake::request(const Socks5Request& target) const {
+  const bool credentials = !target.username.empty() || !target.password.empty();
+  if (target.host.empty() || target.host.size() > kMaxField || credentials != with_auth_ ||
+      target.username.size() > kMaxField || target.password.size() > kMaxField) {
+    return {};
+  }
+  std::string out;
+  if (with_auth_) {
+    out.push_back(static_cast<char>(kAuthVersion));
+    put_field(out, target.username);
+    put_field(out, target.password);
+  }
+  out.push_back(static_cast<char>(kVersion));
+  out.push_back(static_cast<char>(kCommandConnect));
+  out.push_back(0);
+  out.push_back(static_cast<char>(kAddressDomain));
+  put_field(out, target.host);
+  out.push_back(static_cast<char>(target.port >> 8U));
+  out.push_back(static_cast<char>(target.port & 0xFFU));
+  return out;
+}
+
+std::size_t Socks5Handshake::feed(std::string_view in) {
+  std::size_t used = 0;
+  while (stage_ != Stage::Done && stage_ != Stage::Failed) {
+    const std::string_view rest = in.substr(used);
+    if (stage_ == Stage::MethodReply) {
+      if (rest.size() < 2U) {
+        break;
+      }
+      if (byte_at(rest, 0) != kVersion) {
+        return fail("SOCKS5 proxy answered with an unknown version.");
+      }
+      if (byte_at(rest, 1) != (with_auth_ ? kMethodPassword : kMethodNone)) {
+        return fail("SOCKS5 proxy refused the offered authentication method.");
+      }
+      used += 2U;
+      stage_ = with_auth_ ? Stage::AuthReply : Stage::ConnectReply;
+      continue;
+    }
+    if (stage_ == Stage::AuthReply) {
+      if (rest.size() < 2U) {
+        break;
+      }
+      if (byte_at(rest, 1) != 0) {
+        return fail("SOCKS5 proxy rejected the credentials.");
+      }
+      used += 2U;
+      stage_ = Stage::ConnectReply;
+      continue;
+    }
+
+    // VER REP RSV ATYP BND.ADDR BND.PORT; the bound address is ignored.
+    if (rest.size() < 2U) {
+      break;
+    }
+    if (byte_at(rest, 0) != kVersion) {
+      return fail("SOCKS5 proxy answered with an unknown version.");
+    }
+    if (byte_at(rest, 1) != 0) {
+      return fail("SOCKS5 connect failed: " + std::string{socks5_reply_message(byte_at(rest, 1))});
+    }
+    if (rest.size() < 5U) {
+      break;
+    }
+    std::size_t address = 0;
+    switch (byte_at(rest, 3)) {
+      case kAddressIpv4:
+        address = 4U;
+        break;
+      case kAddressIpv6:
+        address = 16U;
+        break;
+      case kAddressDomain:
+        address = 1U + byte_at(rest, 4);
+        break;
+      default:
+        return fail("SOCKS5 proxy sent an unknown address type.");
+    }
+    if (rest.size() < 4U + address + 2U) {
+      break;
+    }
+    used += 4U + address + 2U;
+    stage_ = Stage::Done;
+  }
+  return used;
+}
+
+std::size_t Socks5Handshake::fail(std::string message) {
+  stage_ = Stage::Failed;
+  error_ = std::move(message);
+  return 0;
+}
+
+std::string_view socks5_reply_message(std::uint8_t code) {
+  switch (code) {
+    case 0x00:
+      return "succeeded";
+    case 0x01:
+      return "general server failure";
+    case 0x02:
+      return "connection not allowed by ruleset";
+    case 0x03:
+      return "network unreachable";
+    case 0x04:
+      return "host unreachable";
+    case 0x05:
+      return "connection refused";
+    case 0x06:
+      return "TTL expired";
+    case 0x07:
+      return "command not supported";
+    case 0x08:
+      return "address type not supported";
+    default:
+      return "unknown reply code";
+  }
+}
+
+}  // namespace alpha
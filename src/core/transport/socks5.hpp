@@ -0,0 +1,69 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <string_view>
+
+namespace alpha {
+
+// Destination of a proxied connection. Hosts are always sent as domain
+// names, so .onion/.i2p names and clearnet names alike are resolved by the
+// proxy and never by the local resolver.
+struct Socks5Request {
+  std::string host;
+  std::uint16_t port = 0;
+  // Username/password (RFC 1929) when non-empty. Tor isolates streams with
+  // different credentials onto different circuits.
+  std::string username;
+  std::string password;
+};
+
+// Client side of a SOCKS5 (RFC 1928) CONNECT handshake over a non-blocking
+// socket. It does no I/O itself: the caller writes greeting() and request()
+// and feeds back whatever the proxy answers. Exactly one auth method is
+// offered, so the request can be pipelined right behind the greeting and
+// the whole handshake costs one round trip to the proxy. Application data
+// may follow the request too; Tor forwards it as optimistic data once the
+// stream opens.
+class Socks5Handshake {
+public:
+  enum class Stage {
+    MethodReply,
+    AuthReply,
+    ConnectReply,
+    Done,
+    Failed,
+  };
+
+  explicit Socks5Handshake(bool with_auth) : with_auth_(with_auth) {}
+
+  [[nodiscard]] std::string greeting() const;
+  // Auth sub-negotiation (when offered) followed by CONNECT. Empty when the
+  // request does not fit the protocol (host or credentials over 255 bytes,
+  // credentials that disagree with the offered method).
+  [[nodiscard]] std::string request(const Socks5Request& target) const;
+
+  // Consumes proxy replies from the front of `in` and returns how many bytes
+  // were used; anything after the CONNECT reply belongs to the tunnel.
+  std::size_t feed(std::string_view in);
+
+  [[nodiscard]] Stage stage() const { return stage_; }
+  [[nodiscard]] bool done() const { return stage_ == Stage::Done; }
+  [[nodiscard]] bool failed() const { return stage_ == Stage::Failed; }
+  // Method negotiated; the proxy is now waiting for the request.
+  [[nodiscard]] bool greeted() const { return stage_ != Stage::MethodReply; }
+  [[nodiscard]] const std::string& error() const { return error_; }
+
+private:
+  std::size_t fail(std::string message);
+
+  bool with_auth_ = false;
+  Stage stage_ = Stage::MethodReply;
+  std::string error_;
+};
+
+// Human-readable text for a CONNECT reply code.
+std::string_view socks5_reply_message(std::uint8_t code);
+
+}  // namespace alpha
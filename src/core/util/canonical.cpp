@@ -2,17 +2,40 @@
 
 #include <algorithm>
 #include <array>
+#include <atomic>
 #include <chrono>
 #include <cctype>
 #include <ranges>
 
 namespace alpha::util {
+namespace {
+
+// Negative while the system clocks are in use.
+std::atomic<std::int64_t> virtual_unix_ms{-1};
+
+}  // namespace
 
 std::int64_t unix_timestamp_now() {
+  const std::int64_t pinned = virtual_unix_ms.load(std::memory_order_relaxed);
+  if (pinned >= 0) {
+    return pinned / 1000;
+  }
   const auto now = std::chrono::system_clock::now();
   return std::chrono::duration_cast<std::chrono::seconds>(now.time_since_epoch()).count();
 }
 
+std::chrono::steady_clock::time_point monotonic_now() {
+  const std::int64_t pinned = virtual_unix_ms.load(std::memory_order_relaxed);
+  if (pinned >= 0) {
+    return std::chrono::steady_clock::time_point{std::chrono::milliseconds{pinned}};
+  }
+  return std::chrono::steady_clock::now();
+}
+
+void set_virtual_clock(std::optional<std::int64_t> unix_ms) {
+  virtual_unix_ms.store(unix_ms.has_value() ? std::max<std::int64_t>(*unix_ms, 0) : -1, std::memory_order_relaxed);
+}
+
 std::string lowercase_copy(std::string_view value) {
   std::string out;
   out.reserve(value.size());
@@ -119,6 +142,35 @@ std::unordered_map<std::string, std::string> parse_canonical_map(std::string_vie
   return parsed;
 }
 
+std::optional<std::string> canonical_field(std::string_view payload, std::string_view key) {
+  std::size_t line_start = 0;
+  while (line_start < payload.size()) {
+    std::size_t line_end = payload.find('\n', line_start);
+    if (line_end == std::string_view::npos) {
+      line_end = payload.size();
+    }
+    const std::string_view line = payload.substr(line_start, line_end - line_start);
+    if (line.size() > key.size() && line.starts_with(key) && line[key.size()] == '=') {
+      std::string value;
+      value.reserve(line.size() - key.size() - 1U);
+      bool escaping = false;
+      for (char c : line.substr(key.size() + 1U)) {
+        if (escaping) {
+          value.push_back(c == 'n' ? '\n' : c);
+          escaping = false;
+        } else if (c == '\\') {
+          escaping = true;
+        } else {
+          value.push_back(c);
+        }
+      }
+      return value;
+    }
+    line_start = line_end + 1U;
+  }
+  return std::nullopt;
+}
+
 bool contains_case_insensitive(std::string_view haystack, std::string_view needle) {
   if (needle.empty()) {
     return true;
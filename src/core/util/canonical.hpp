@@ -1,6 +1,8 @@
 #pragma once
 
+#include <chrono>
 #include <cstdint>
+#include <optional>
 #include <string>
 #include <string_view>
 #include <unordered_map>
@@ -10,12 +12,20 @@
 namespace alpha::util {
 
 std::int64_t unix_timestamp_now();
+// Monotonic time for timeouts and round-trip measurements.
+std::chrono::steady_clock::time_point monotonic_now();
+// Pins both clocks to a virtual time (milliseconds since the Unix epoch) so
+// a simulation replays identically; nullopt returns to the system clocks.
+// Process wide.
+void set_virtual_clock(std::optional<std::int64_t> unix_ms);
 
 std::string lowercase_copy(std::string_view value);
 std::string trim_copy(std::string_view value);
 
 std::string canonical_join(std::vector<std::pair<std::string, std::string>> fields);
 std::unordered_map<std::string, std::string> parse_canonical_map(std::string_view payload);
+// Single-field lookup without materializing the whole map.
+std::optional<std::string> canonical_field(std::string_view payload, std::string_view key);
 
 bool contains_case_insensitive(std::string_view haystack, std::string_view needle);
 
@@ -1,10 +1,13 @@
 #include "core/util/hash.hpp"
 
 #include <array>
+#include <chrono>
 #include <cstdint>
 #include <string_view>
 #include <vector>
 
+#include "core/util/metrics.hpp"
+
 #ifdef GOT_SOUP_HAVE_SODIUM
 #include <sodium.h>
 #endif
@@ -122,9 +125,7 @@ std::string sha256_fallback_hex(std::string_view payload) {
   return out;
 }
 
-}  // namespace
-
-std::string sha256_like_hex(std::string_view payload) {
+std::string sha256_hex(std::string_view payload) {
 #ifdef GOT_SOUP_HAVE_SODIUM
   std::array<unsigned char, crypto_hash_sha256_BYTES> digest{};
   crypto_hash_sha256(digest.data(), reinterpret_cast<const unsigned char*>(payload.data()),
@@ -135,6 +136,31 @@ std::string sha256_like_hex(std::string_view payload) {
   return sha256_fallback_hex(payload);
 }
 
+// A hash takes about as long as two clock reads, so only one call in
+// kHashTimingSample is timed; calls and bytes are always counted.
+constexpr std::uint32_t kHashTimingSample = 64;
+
+}  // namespace
+
+std::string sha256_like_hex(std::string_view payload) {
+  static Counter& calls = metrics().counter("gotsoup_hash_calls_total", "sha256 digests computed.");
+  static Counter& bytes = metrics().counter("gotsoup_hash_bytes_total", "Bytes passed to sha256.");
+  static LatencyHistogram& latency =
+      metrics().histogram("gotsoup_hash_duration_seconds", "Latency of one sha256 digest, sampled 1 in 64 calls.");
+  thread_local std::uint32_t until_sample = 0;
+
+  calls.add();
+  bytes.add(payload.size());
+  if (until_sample-- != 0) {
+    return sha256_hex(payload);
+  }
+  until_sample = kHashTimingSample - 1U;
+  const auto started = std::chrono::steady_clock::now();
+  std::string digest = sha256_hex(payload);
+  latency.record(std::chrono::steady_clock::now() - started);
+  return digest;
+}
+
 bool has_leading_zero_nibbles(std::string_view hex_hash, int nibbles) {
   if (nibbles <= 0) {
     return true;
@@ -150,4 +176,20 @@ bool has_leading_zero_nibbles(std::string_view hex_hash, int nibbles) {
   return true;
 }
 
+std::uint64_t mix64(std::uint64_t value) {
+  value += 0x9e3779b97f4a7c15ULL;
+  value = (value ^ (value >> 30U)) * 0xbf58476d1ce4e5b9ULL;
+  value = (value ^ (value >> 27U)) * 0x94d049bb133111ebULL;
+  return value ^ (value >> 31U);
+}
+
+std::uint64_t seeded_hash64(std::string_view text, std::uint64_t seed) {
+  std::uint64_t hash = 1469598103934665603ULL ^ seed;
+  for (const unsigned char c : text) {
+    hash ^= c;
+    hash *= 1099511628211ULL;
+  }
+  return mix64(hash);
+}
+
 }  // namespace alpha::util
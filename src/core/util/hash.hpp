@@ -1,5 +1,6 @@
 #pragma once
 
+#include <cstdint>
 #include <string>
 #include <string_view>
 
@@ -8,4 +9,9 @@ namespace alpha::util {
 std::string sha256_like_hex(std::string_view payload);
 bool has_leading_zero_nibbles(std::string_view hex_hash, int nibbles);
 
+// Fast non-cryptographic hashing for in-memory indexes and filters: a
+// splitmix64 finalizer and seeded FNV-1a passed through it.
+std::uint64_t mix64(std::uint64_t value);
+std::uint64_t seeded_hash64(std::string_view text, std::uint64_t seed);
+
 }  // namespace alpha::util
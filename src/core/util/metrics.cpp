@@ -0,0 +1,246 @@
+#include "core/util/metrics.hpp"
+
+#include <algorithm>
+#include <bit>
+#include <charconv>
+#include <cmath>
+
+namespace alpha::util {
+namespace {
+
+struct PrometheusBound {
+  std::uint64_t ns;
+  std::string_view le;
+};
+
+constexpr std::array<PrometheusBound, 21> kPrometheusBounds = {{
+    {1'000, "0.000001"},          {5'000, "0.000005"},         {10'000, "0.00001"},
+    {25'000, "0.000025"},         {50'000, "0.00005"},         {100'000, "0.0001"},
+    {250'000, "0.00025"},         {500'000, "0.0005"},         {1'000'000, "0.001"},
+    {2'500'000, "0.0025"},        {5'000'000, "0.005"},        {10'000'000, "0.01"},
+    {25'000'000, "0.025"},        {50'000'000, "0.05"},        {100'000'000, "0.1"},
+    {250'000'000, "0.25"},        {500'000'000, "0.5"},        {1'000'000'000, "1"},
+    {2'500'000'000, "2.5"},       {5'000'000'000, "5"},        {10'000'000'000, "10"},
+}};
+
+std::string format_double(double value) {
+  char digits[32];
+  const auto [end, ec] = std::to_chars(digits, digits + sizeof(digits), value);
+  return std::string(digits, end);
+}
+
+std::string format_uint(std::uint64_t value) {
+  char digits[24];
+  const auto [end, ec] = std::to_chars(digits, digits + sizeof(digits), value);
+  return std::string(digits, end);
+}
+
+void append_escaped(std::string& out, std::string_view text, bool quotes) {
+  for (const char c : text) {
+    if (c == '\\') {
+      out += "\\\\";
+    } else if (c == '\n') {
+      out += "\\n";
+    } else if (quotes && c == '"') {
+      out += "\\\"";
+    } else {
+      out.push_back(c);
+    }
+  }
+}
+
+void append_series_name(std::string& out, std::string_view name, MetricLabel label, std::string_view le) {
+  out.append(name);
+  if (label.key.empty() && le.empty()) {
+    return;
+  }
+  out.push_back('{');
+  if (!label.key.empty()) {
+    out.append(label.key).append("=\"");
+    append_escaped(out, label.value, true);
+    out.push_back('"');
+  }
+  if (!le.empty()) {
+    out.append(label.key.empty() ? "" : ",").append("le=\"").append(le).push_back('"');
+  }
+  out.push_back('}');
+}
+
+}  // namespace
+
+std::uint64_t HistogramSnapshot::percentile_ns(double q) const {
+  if (count == 0 || buckets.empty()) {
+    return 0;
+  }
+  q = std::clamp(q, 0.0, 1.0);
+  const auto rank = std::max<std::uint64_t>(1, static_cast<std::uint64_t>(std::ceil(q * static_cast<double>(count))));
+  std::uint64_t seen = 0;
+  for (std::size_t i = 0; i < buckets.size(); ++i) {
+    seen += buckets[i];
+    if (seen >= rank) {
+      return std::min(LatencyHistogram::bucket_highest(i), max_ns);
+    }
+  }
+  return max_ns;
+}
+
+double HistogramSnapshot::mean_ns() const {
+  return count == 0 ? 0.0 : static_cast<double>(sum_ns) / static_cast<double>(count);
+}
+
+std::size_t LatencyHistogram::bucket_index(std::uint64_t ns) {
+  if (ns < kSubBuckets) {
+    return static_cast<std::size_t>(ns);
+  }
+  const unsigned shift = static_cast<unsigned>(std::bit_width(ns)) - 1U - kSubBucketBits;
+  const auto sub = static_cast<std::size_t>((ns >> shift) - kSubBuckets);
+  return ((shift + 1U) * kSubBuckets) + sub;
+}
+
+std::uint64_t LatencyHistogram::bucket_lowest(std::size_t index) {
+  if (index < kSubBuckets) {
+    return index;
+  }
+  const std::size_t shift = (index / kSubBuckets) - 1U;
+  return static_cast<std::uint64_t>(kSubBuckets + (index % kSubBuckets)) << shift;
+}
+
+std::uint64_t LatencyHistogram::bucket_highest(std::size_t index) {
+  if (index < kSubBuckets) {
+    return index;
+  }
+  const std::size_t shift = (index / kSubBuckets) - 1U;
+  return bucket_lowest(index) + ((std::uint64_t{1} << shift) - 1U);
+}
+
+void LatencyHistogram::record(std::uint64_t ns) {
+  buckets_[bucket_index(ns)].fetch_add(1, std::memory_order_relaxed);
+  count_.fetch_add(1, std::memory_order_relaxed);
+  sum_ns_.fetch_add(ns, std::memory_order_relaxed);
+  std::uint64_t seen = max_ns_.load(std::memory_order_relaxed);
+  while (ns > seen && !max_ns_.compare_exchange_weak(seen, ns, std::memory_order_relaxed)) {
+  }
+}
+
+HistogramSnapshot LatencyHistogram::snapshot() const {
+  HistogramSnapshot out;
+  out.buckets.resize(kBucketCount);
+  std::uint64_t total = 0;
+  for (std::size_t i = 0; i < kBucketCount; ++i) {
+    out.buckets[i] = buckets_[i].load(std::memory_order_relaxed);
+    total += out.buckets[i];
+  }
+  // Buckets are the source of truth so percentiles and counts agree.
+  out.count = total;
+  out.sum_ns = sum_ns_.load(std::memory_order_relaxed);
+  out.max_ns = max_ns_.load(std::memory_order_relaxed);
+  return out;
+}
+
+MetricsRegistry::Series& MetricsRegistry::series(std::string_view name, std::string_view help, MetricLabel label,
+                                                 bool is_histogram) {
+  const std::lock_guard lock(mutex_);
+  auto it = families_.find(name);
+  if (it == families_.end()) {
+    it = families_.emplace(std::string{name}, Family{.help = std::string{help}, .is_histogram = is_histogram}).first;
+  }
+  Family& family = it->second;
+  auto found = std::ranges::find_if(family.series, [&](const Series& existing) {
+    return existing.label_key == label.key && existing.label_value == label.value;
+  });
+  Series* entry = found != family.series.end() ? &*found : nullptr;
+  if (entry == nullptr) {
+    entry = &family.series.emplace_back();
+    entry->label_key = label.key;
+    entry->label_value = label.value;
+    entry->counter = std::make_unique<Counter>();
+  }
+  // A family keeps the kind it was first registered as. Asking for the other
+  // kind still hands back a live object; it is just never exported.
+  if ((is_histogram || family.is_histogram) && !entry->histogram) {
+    entry->histogram = std::make_unique<LatencyHistogram>();
+  }
+  return *entry;
+}
+
+Counter& MetricsRegistry::counter(std::string_view name, std::string_view help, MetricLabel label) {
+  return *series(name, help, label, false).counter;
+}
+
+LatencyHistogram& MetricsRegistry::histogram(std::string_view name, std::string_view help, MetricLabel label) {
+  return *series(name, help, label, true).histogram;
+}
+
+std::vector<MetricSample> MetricsRegistry::snapshot() const {
+  const std::lock_guard lock(mutex_);
+  std::vector<MetricSample> out;
+  for (const auto& [name, family] : families_) {
+    for (const Series& entry : family.series) {
+      MetricSample sample{
+          .name = name,
+          .help = family.help,
+          .label_key = entry.label_key,
+          .label_value = entry.label_value,
+          .is_histogram = family.is_histogram,
+      };
+      if (family.is_histogram) {
+        sample.histogram = entry.histogram->snapshot();
+      } else {
+        sample.counter = entry.counter->value();
+      }
+      out.push_back(std::move(sample));
+    }
+  }
+  return out;
+}
+
+void MetricsRegistry::render_prometheus(std::string& out) const {
+  const std::vector<MetricSample> samples = snapshot();
+  std::string_view family;
+  for (const MetricSample& sample : samples) {
+    if (sample.name != family) {
+      family = sample.name;
+      append_prometheus_header(out, sample.name, sample.is_histogram ? "histogram" : "counter", sample.help);
+    }
+    const MetricLabel label{.key = sample.label_key, .value = sample.label_value};
+    if (!sample.is_histogram) {
+      append_prometheus_sample(out, sample.name, label, format_uint(sample.counter));
+      continue;
+    }
+
+    const HistogramSnapshot& histogram = sample.histogram;
+    const std::string bucket_name = sample.name + "_bucket";
+    std::size_t fine = 0;
+    std::uint64_t cumulative = 0;
+    for (const PrometheusBound& bound : kPrometheusBounds) {
+      while (fine < histogram.buckets.size() && LatencyHistogram::bucket_highest(fine) <= bound.ns) {
+        cumulative += histogram.buckets[fine++];
+      }
+      append_series_name(out, bucket_name, label, bound.le);
+      out.append(" ").append(format_uint(cumulative)).push_back('\n');
+    }
+    append_series_name(out, bucket_name, label, "+Inf");
+    out.append(" ").append(format_uint(histogram.count)).push_back('\n');
+    append_prometheus_sample(out, sample.name + "_sum", label,
+                             format_double(static_cast<double>(histogram.sum_ns) / 1e9));
+    append_prometheus_sample(out, sample.name + "_count", label, format_uint(histogram.count));
+  }
+}
+
+MetricsRegistry& metrics() {
+  static MetricsRegistry registry;
+  return registry;
+}
+
+void append_prometheus_header(std::string& out, std::string_view name, std::string_view type, std::string_view help) {
+  out.append("# HELP ").append(name).push_back(' ');
+  append_escaped(out, help, false);
+  out.append("\n# TYPE ").append(name).append(" ").append(type).push_back('\n');
+}
+
+void append_prometheus_sample(std::string& out, std::string_view name, MetricLabel label, std::string_view value) {
+  append_series_name(out, name, label, {});
+  out.append(" ").append(value).push_back('\n');
+}
+
+}  // namespace alpha::util
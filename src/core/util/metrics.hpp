@@ -0,0 +1,152 @@
+#pragma once
+
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <deque>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <string_view>
+#include <vector>
+
+namespace alpha::util {
+
+class Counter {
+public:
+  void add(std::uint64_t n = 1) { value_.fetch_add(n, std::memory_order_relaxed); }
+  [[nodiscard]] std::uint64_t value() const { return value_.load(std::memory_order_relaxed); }
+
+private:
+  std::atomic<std::uint64_t> value_{0};
+};
+
+struct HistogramSnapshot {
+  std::uint64_t count = 0;
+  std::uint64_t sum_ns = 0;
+  std::uint64_t max_ns = 0;
+  std::vector<std::uint64_t> buckets;  // per LatencyHistogram bucket index
+
+  // Upper bound of the bucket holding quantile `q` (0..1), capped at max_ns.
+  // Within 12.5% of the true value. 0 when nothing was recorded.
+  [[nodiscard]] std::uint64_t percentile_ns(double q) const;
+  [[nodiscard]] double mean_ns() const;
+};
+
+// HDR-style latency histogram over nanoseconds: values below 8 have their
+// own bucket, and every power of two above is split into 8 linear
+// sub-buckets, so the relative error is at most 1/8 from nanoseconds up to
+// centuries in 496 buckets. record() is a few relaxed atomic adds with no
+// allocation or lock; snapshots read the counters without stopping writers,
+// so a snapshot taken mid-record may be off by that one sample.
+class LatencyHistogram {
+public:
+  static constexpr unsigned kSubBucketBits = 3;
+  static constexpr std::size_t kSubBuckets = std::size_t{1} << kSubBucketBits;
+  static constexpr std::size_t kBucketCount = (64 - kSubBucketBits + 1) * kSubBuckets;
+
+  void record(std::uint64_t ns);
+  void record(std::chrono::nanoseconds elapsed) {
+    record(elapsed.count() > 0 ? static_cast<std::uint64_t>(elapsed.count()) : 0U);
+  }
+
+  [[nodiscard]] std::uint64_t count() const { return count_.load(std::memory_order_relaxed); }
+  [[nodiscard]] HistogramSnapshot snapshot() const;
+
+  [[nodiscard]] static std::size_t bucket_index(std::uint64_t ns);
+  // Smallest and largest value that land in bucket `index`.
+  [[nodiscard]] static std::uint64_t bucket_lowest(std::size_t index);
+  [[nodiscard]] static std::uint64_t bucket_highest(std::size_t index);
+
+private:
+  std::array<std::atomic<std::uint64_t>, kBucketCount> buckets_{};
+  std::atomic<std::uint64_t> count_{0};
+  std::atomic<std::uint64_t> sum_ns_{0};
+  std::atomic<std::uint64_t> max_ns_{0};
+};
+
+// Records the time from construction to destruction.
+class ScopedTimer {
+public:
+  explicit ScopedTimer(LatencyHistogram& histogram)
+      : histogram_(histogram), started_(std::chrono::steady_clock::now()) {}
+  ScopedTimer(const ScopedTimer&) = delete;
+  ScopedTimer& operator=(const ScopedTimer&) = delete;
+  ~ScopedTimer() { histogram_.record(std::chrono::steady_clock::now() - started_); }
+
+private:
+  LatencyHistogram& histogram_;
+  std::chrono::steady_clock::time_point started_;
+};
+
+struct MetricLabel {
+  std::string_view key;
+  std::string_view value;
+};
+
+struct MetricSample {
+  std::string name;
+  std::string help;
+  std::string label_key;  // empty for an unlabelled series
+  std::string label_value;
+  bool is_histogram = false;
+  std::uint64_t counter = 0;
+  HistogramSnapshot histogram;
+};
+
+// Process-wide set of named counters and histograms. Lookups take a lock and
+// return a reference that stays valid for the life of the process, so hot
+// paths look a series up once and keep the reference:
+//
+//   static util::LatencyHistogram& latency = util::metrics().histogram(...);
+//   const util::ScopedTimer timer(latency);
+//
+// Histograms are exported in seconds, as Prometheus expects; names should
+// say so (`..._duration_seconds`). Counter names end in `_total`.
+class MetricsRegistry {
+public:
+  MetricsRegistry() = default;
+  MetricsRegistry(const MetricsRegistry&) = delete;
+  MetricsRegistry& operator=(const MetricsRegistry&) = delete;
+
+  Counter& counter(std::string_view name, std::string_view help, MetricLabel label = {});
+  LatencyHistogram& histogram(std::string_view name, std::string_view help, MetricLabel label = {});
+
+  // Every series, families in name order and series in registration order.
+  [[nodiscard]] std::vector<MetricSample> snapshot() const;
+  // Prometheus text exposition format 0.0.4. Histogram buckets are the fine
+  // buckets folded into fixed `le` bounds from 1us to 10s; a fine bucket that
+  // straddles a bound is counted under the next one, so no `le` count ever
+  // includes a sample above its bound.
+  void render_prometheus(std::string& out) const;
+
+private:
+  struct Series {
+    std::string label_key;
+    std::string label_value;
+    std::unique_ptr<Counter> counter;
+    std::unique_ptr<LatencyHistogram> histogram;
+  };
+  struct Family {
+    std::string help;
+    bool is_histogram = false;
+    std::deque<Series> series;  // deque: entries never move
+  };
+
+  Series& series(std::string_view name, std::string_view help, MetricLabel label, bool is_histogram);
+
+  mutable std::mutex mutex_;
+  std::map<std::string, Family, std::less<>> families_;
+};
+
+[[nodiscard]] MetricsRegistry& metrics();
+
+// Appends the `# HELP` and `# TYPE` lines that open a family.
+void append_prometheus_header(std::string& out, std::string_view name, std::string_view type, std::string_view help);
+// Appends one sample line, `name{key="value"} value`, escaping the label value.
+void append_prometheus_sample(std::string& out, std::string_view name, MetricLabel label, std::string_view value);
+
+}  // namespace alpha::util
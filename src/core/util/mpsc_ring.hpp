@@ -0,0 +1,92 @@
+#pragma once
+
+#include <atomic>
+#include <bit>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <optional>
+#include <utility>
+
+namespace alpha::util {
+
+// Bounded lock-free queue for many producers and one consumer. Each slot
+// carries a sequence number (Vyukov's bounded queue): producers claim a
+// slot with one CAS on the tail and publish it by bumping its sequence, so
+// a full ring makes try_push fail at once instead of blocking. Capacity is
+// rounded up to a power of two.
+template <typename T>
+class MpscRing {
+public:
+  explicit MpscRing(std::size_t capacity)
+      : capacity_(std::bit_ceil(capacity < 2U ? std::size_t{2} : capacity)),
+        mask_(capacity_ - 1U),
+        slots_(std::make_unique<Slot[]>(capacity_)) {
+    for (std::size_t i = 0; i < capacity_; ++i) {
+      slots_[i].sequence.store(i, std::memory_order_relaxed);
+    }
+  }
+  MpscRing(const MpscRing&) = delete;
+  MpscRing& operator=(const MpscRing&) = delete;
+
+  // Any thread. Returns false without waiting when the ring is full.
+  bool try_push(T value) {
+    std::size_t tail = tail_.load(std::memory_order_relaxed);
+    Slot* slot = nullptr;
+    while (true) {
+      slot = &slots_[tail & mask_];
+      const std::size_t sequence = slot->sequence.load(std::memory_order_acquire);
+      const auto lag = static_cast<std::ptrdiff_t>(sequence) - static_cast<std::ptrdiff_t>(tail);
+      if (lag == 0) {
+        if (tail_.compare_exchange_weak(tail, tail + 1U, std::memory_order_relaxed)) {
+          break;
+        }
+      } else if (lag < 0) {
+        return false;
+      } else {
+        tail = tail_.load(std::memory_order_relaxed);
+      }
+    }
+    slot->value.emplace(std::move(value));
+    slot->sequence.store(tail + 1U, std::memory_order_release);
+    return true;
+  }
+
+  // Consumer thread only.
+  std::optional<T> try_pop() {
+    Slot& slot = slots_[head_ & mask_];
+    if (slot.sequence.load(std::memory_order_acquire) != head_ + 1U) {
+      return std::nullopt;
+    }
+    std::optional<T> out = std::move(slot.value);
+    slot.value.reset();
+    slot.sequence.store(head_ + capacity_, std::memory_order_release);
+    ++head_;
+    head_published_.store(head_, std::memory_order_relaxed);
+    return out;
+  }
+
+  // Approximate while producers are active.
+  [[nodiscard]] std::size_t size() const {
+    const std::size_t tail = tail_.load(std::memory_order_relaxed);
+    const std::size_t head = head_published_.load(std::memory_order_relaxed);
+    return tail > head ? tail - head : 0U;
+  }
+  [[nodiscard]] std::size_t capacity() const { return capacity_; }
+
+private:
+  struct Slot {
+    std::atomic<std::size_t> sequence{0};
+    std::optional<T> value;
+  };
+
+  const std::size_t capacity_;
+  const std::size_t mask_;
+  std::unique_ptr<Slot[]> slots_;
+  // Producers and the consumer touch separate cache lines.
+  alignas(64) std::atomic<std::size_t> tail_{0};
+  alignas(64) std::size_t head_ = 0;
+  std::atomic<std::size_t> head_published_{0};
+};
+
+}  // namespace alpha::util
@@ -0,0 +1,148 @@
+#include "core/util/poller.hpp"
+
+#include <array>
+
+#include "core/util/socket.hpp"
+
+#ifndef _WIN32
+#include <cerrno>
+#include <poll.h>
+#ifdef __linux__
+#include <sys/epoll.h>
+#endif
+#endif
+
+namespace alpha::util {
+
+#ifdef __linux__
+
+namespace {
+
+bool epoll_control(int epoll_fd, int op, int fd, std::uint64_t token, bool want_write) {
+  epoll_event event{};
+  event.events = EPOLLIN | (want_write ? EPOLLOUT : 0U);
+  event.data.u64 = token;
+  return ::epoll_ctl(epoll_fd, op, fd, &event) == 0;
+}
+
+}  // namespace
+
+Poller::Poller() : epoll_fd_(::epoll_create1(EPOLL_CLOEXEC)) {}
+
+Poller::~Poller() {
+  close_socket(epoll_fd_);
+}
+
+bool Poller::valid() const {
+  return epoll_fd_ >= 0;
+}
+
+bool Poller::add(int fd, std::uint64_t token, bool want_write) {
+  return epoll_control(epoll_fd_, EPOLL_CTL_ADD, fd, token, want_write);
+}
+
+bool Poller::modify(int fd, std::uint64_t token, bool want_write) {
+  return epoll_control(epoll_fd_, EPOLL_CTL_MOD, fd, token, want_write);
+}
+
+void Poller::remove(int fd) {
+  ::epoll_ctl(epoll_fd_, EPOLL_CTL_DEL, fd, nullptr);
+}
+
+std::vector<PollEvent> Poller::wait(int timeout_ms) {
+  std::array<epoll_event, 64> events{};
+  int rc = 0;
+  do {
+    rc = ::epoll_wait(epoll_fd_, events.data(), static_cast<int>(events.size()), timeout_ms);
+  } while (rc < 0 && errno == EINTR);
+  std::vector<PollEvent> out;
+  for (int i = 0; i < rc; ++i) {
+    const std::uint32_t mask = events[static_cast<std::size_t>(i)].events;
+    out.push_back({
+        .token = events[static_cast<std::size_t>(i)].data.u64,
+        .readable = (mask & (EPOLLIN | EPOLLHUP)) != 0,
+        .writable = (mask & EPOLLOUT) != 0,
+        .failed = (mask & EPOLLERR) != 0,
+    });
+  }
+  return out;
+}
+
+#elif !defined(_WIN32)
+
+Poller::Poller() = default;
+
+Poller::~Poller() = default;
+
+bool Poller::valid() const {
+  return true;
+}
+
+bool Poller::add(int fd, std::uint64_t token, bool want_write) {
+  entries_[fd] = {token, want_write};
+  return true;
+}
+
+bool Poller::modify(int fd, std::uint64_t token, bool want_write) {
+  return add(fd, token, want_write);
+}
+
+void Poller::remove(int fd) {
+  entries_.erase(fd);
+}
+
+std::vector<PollEvent> Poller::wait(int timeout_ms) {
+  std::vector<pollfd> fds;
+  std::vector<std::uint64_t> tokens;
+  fds.reserve(entries_.size());
+  tokens.reserve(entries_.size());
+  for (const auto& [fd, entry] : entries_) {
+    fds.push_back({fd, static_cast<short>(POLLIN | (entry.want_write ? POLLOUT : 0)), 0});
+    tokens.push_back(entry.token);
+  }
+  int rc = 0;
+  do {
+    rc = ::poll(fds.data(), static_cast<nfds_t>(fds.size()), timeout_ms);
+  } while (rc < 0 && errno == EINTR);
+  std::vector<PollEvent> out;
+  for (std::size_t i = 0; rc > 0 && i < fds.size(); ++i) {
+    if (fds[i].revents == 0) {
+      continue;
+    }
+    out.push_back({
+        .token = tokens[i],
+        .readable = (fds[i].revents & (POLLIN | POLLHUP)) != 0,
+        .writable = (fds[i].revents & POLLOUT) != 0,
+        .failed = (fds[i].revents & (POLLERR | POLLNVAL)) != 0,
+    });
+  }
+  return out;
+}
+
+#else
+
+Poller::Poller() = default;
+
+Poller::~Poller() = default;
+
+bool Poller::valid() const {
+  return false;
+}
+
+bool Poller::add(int, std::uint64_t, bool) {
+  return false;
+}
+
+bool Poller::modify(int, std::uint64_t, bool) {
+  return false;
+}
+
+void Poller::remove(int) {}
+
+std::vector<PollEvent> Poller::wait(int) {
+  return {};
+}
+
+#endif
+
+}  // namespace alpha::util
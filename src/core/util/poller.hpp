@@ -0,0 +1,46 @@
+#pragma once
+
+#include <cstdint>
+#include <unordered_map>
+#include <vector>
+
+namespace alpha::util {
+
+struct PollEvent {
+  std::uint64_t token = 0;
+  bool readable = false;  // includes hang-up, so the next read sees EOF
+  bool writable = false;
+  bool failed = false;
+};
+
+// Readiness poller over non-blocking sockets: epoll on Linux, poll()
+// elsewhere. Each descriptor is registered with a caller-chosen token that
+// comes back in its events. Never valid() on platforms without BSD sockets.
+class Poller {
+public:
+  Poller();
+  Poller(const Poller&) = delete;
+  Poller& operator=(const Poller&) = delete;
+  ~Poller();
+
+  [[nodiscard]] bool valid() const;
+
+  bool add(int fd, std::uint64_t token, bool want_write);
+  bool modify(int fd, std::uint64_t token, bool want_write);
+  void remove(int fd);
+  // Blocks up to `timeout_ms` (-1 forever); retries on EINTR.
+  std::vector<PollEvent> wait(int timeout_ms);
+
+private:
+#ifdef __linux__
+  int epoll_fd_ = -1;
+#else
+  struct Entry {
+    std::uint64_t token = 0;
+    bool want_write = false;
+  };
+  std::unordered_map<int, Entry> entries_;
+#endif
+};
+
+}  // namespace alpha::util
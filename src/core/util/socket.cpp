@@ -0,0 +1,322 @@
+#include "core/util/socket.hpp"
+
+#include <charconv>
+#include <cstring>
+
+#ifndef _WIN32
+#include <arpa/inet.h>
+#include <cerrno>
+#include <fcntl.h>
+#include <netdb.h>
+#include <netinet/in.h>
+#include <netinet/tcp.h>
+#include <sys/socket.h>
+#include <sys/stat.h>
+#include <sys/types.h>
+#include <sys/un.h>
+#include <unistd.h>
+#endif
+
+namespace alpha::util {
+
+#ifndef _WIN32
+
+namespace {
+
+#ifdef MSG_NOSIGNAL
+constexpr int kSendFlags = MSG_NOSIGNAL;
+#else
+constexpr int kSendFlags = 0;
+#endif
+
+void suppress_sigpipe(int fd) {
+#ifdef SO_NOSIGPIPE
+  int one = 1;
+  ::setsockopt(fd, SOL_SOCKET, SO_NOSIGPIPE, &one, sizeof(one));
+#else
+  (void)fd;
+#endif
+}
+
+bool unix_address(std::string_view path, sockaddr_un& addr) {
+  addr = {};
+  addr.sun_family = AF_UNIX;
+  if (path.empty() || path.size() >= sizeof(addr.sun_path)) {
+    return false;
+  }
+  std::memcpy(addr.sun_path, path.data(), path.size());
+  return true;
+}
+
+}  // namespace
+
+Result listen_tcp(std::string_view bind_host, std::uint16_t port, int backlog, int& out_fd) {
+  out_fd = kInvalidSocket;
+  sockaddr_in addr{};
+  addr.sin_family = AF_INET;
+  addr.sin_port = htons(port);
+  const std::string host = bind_host.empty() ? std::string{"0.0.0.0"} : std::string{bind_host};
+  if (::inet_pton(AF_INET, host.c_str(), &addr.sin_addr) != 1) {
+    return Result::failure("Invalid bind host: " + host);
+  }
+
+  const int fd = ::socket(AF_INET, SOCK_STREAM, 0);
+  if (fd < 0) {
+    return Result::failure(std::string{"socket() failed: "} + std::strerror(errno));
+  }
+  int opt = 1;
+  ::setsockopt(fd, SOL_SOCKET, SO_REUSEADDR, &opt, sizeof(opt));
+  suppress_sigpipe(fd);
+
+  if (::bind(fd, reinterpret_cast<sockaddr*>(&addr), sizeof(addr)) != 0) {
+    const std::string reason = std::strerror(errno);
+    ::close(fd);
+    return Result::failure("bind(" + host + ":" + std::to_string(port) + ") failed: " + reason);
+  }
+  if (::listen(fd, backlog) != 0) {
+    const std::string reason = std::strerror(errno);
+    ::close(fd);
+    return Result::failure("listen() failed: " + reason);
+  }
+
+  out_fd = fd;
+  return Result::success("Listening on " + host + ":" + std::to_string(local_port(fd)));
+}
+
+Result connect_tcp(std::string_view host, std::uint16_t port, bool non_blocking, int& out_fd) {
+  out_fd = kInvalidSocket;
+  addrinfo hints{};
+  hints.ai_family = AF_INET;
+  hints.ai_socktype = SOCK_STREAM;
+  addrinfo* resolved = nullptr;
+  const std::string host_text{host};
+  const std::string port_text = std::to_string(port);
+  if (::getaddrinfo(host_text.c_str(), port_text.c_str(), &hints, &resolved) != 0 || resolved == nullptr) {
+    return Result::failure("Unable to resolve host: " + host_text);
+  }
+
+  const int fd = ::socket(resolved->ai_family, resolved->ai_socktype, resolved->ai_protocol);
+  if (fd < 0) {
+    ::freeaddrinfo(resolved);
+    return Result::failure(std::string{"socket() failed: "} + std::strerror(errno));
+  }
+  suppress_sigpipe(fd);
+  if (non_blocking && !set_non_blocking(fd)) {
+    ::freeaddrinfo(resolved);
+    ::close(fd);
+    return Result::failure("Unable to make socket non-blocking.");
+  }
+
+  const int rc = ::connect(fd, resolved->ai_addr, resolved->ai_addrlen);
+  ::freeaddrinfo(resolved);
+  if (rc != 0 && !(non_blocking && errno == EINPROGRESS)) {
+    const std::string reason = std::strerror(errno);
+    ::close(fd);
+    return Result::failure("connect(" + host_text + ":" + port_text + ") failed: " + reason);
+  }
+
+  out_fd = fd;
+  return Result::success(rc == 0 ? "Connected." : "Connect in progress.");
+}
+
+Result listen_unix(std::string_view path, int backlog, int& out_fd) {
+  out_fd = kInvalidSocket;
+  const std::string path_text{path};
+  sockaddr_un addr{};
+  if (!unix_address(path, addr)) {
+    return Result::failure("Invalid unix socket path: " + path_text);
+  }
+
+  struct stat existing {};
+  if (::lstat(path_text.c_str(), &existing) == 0) {
+    if (!S_ISSOCK(existing.st_mode)) {
+      return Result::failure("Refusing to replace non-socket file: " + path_text);
+    }
+    int probe = kInvalidSocket;
+    if (connect_unix(path, probe).ok) {
+      close_socket(probe);
+      return Result::failure("Unix socket already in use: " + path_text);
+    }
+    ::unlink(path_text.c_str());
+  }
+
+  const int fd = ::socket(AF_UNIX, SOCK_STREAM, 0);
+  if (fd < 0) {
+    return Result::failure(std::string{"socket() failed: "} + std::strerror(errno));
+  }
+  suppress_sigpipe(fd);
+  if (::bind(fd, reinterpret_cast<sockaddr*>(&addr), sizeof(addr)) != 0) {
+    const std::string reason = std::strerror(errno);
+    ::close(fd);
+    return Result::failure("bind(" + path_text + ") failed: " + reason);
+  }
+  // Nobody can connect before listen(), so tightening the mode here leaves
+  // no window in which the umask's looser mode applies.
+  if (::chmod(path_text.c_str(), S_IRUSR | S_IWUSR) != 0 || ::listen(fd, backlog) != 0) {
+    const std::string reason = std::strerror(errno);
+    ::close(fd);
+    ::unlink(path_text.c_str());
+    return Result::failure("listen(" + path_text + ") failed: " + reason);
+  }
+
+  out_fd = fd;
+  return Result::success("Listening on " + path_text);
+}
+
+Result connect_unix(std::string_view path, int& out_fd) {
+  out_fd = kInvalidSocket;
+  const std::string path_text{path};
+  sockaddr_un addr{};
+  if (!unix_address(path, addr)) {
+    return Result::failure("Invalid unix socket path: " + path_text);
+  }
+  const int fd = ::socket(AF_UNIX, SOCK_STREAM, 0);
+  if (fd < 0) {
+    return Result::failure(std::string{"socket() failed: "} + std::strerror(errno));
+  }
+  suppress_sigpipe(fd);
+  if (::connect(fd, reinterpret_cast<sockaddr*>(&addr), sizeof(addr)) != 0) {
+    const std::string reason = std::strerror(errno);
+    ::close(fd);
+    return Result::failure("connect(" + path_text + ") failed: " + reason);
+  }
+  out_fd = fd;
+  return Result::success("Connected.");
+}
+
+std::uint16_t local_port(int fd) {
+  sockaddr_in addr{};
+  socklen_t len = sizeof(addr);
+  if (::getsockname(fd, reinterpret_cast<sockaddr*>(&addr), &len) != 0) {
+    return 0;
+  }
+  return ntohs(addr.sin_port);
+}
+
+bool set_non_blocking(int fd) {
+  const int flags = ::fcntl(fd, F_GETFL, 0);
+  return flags >= 0 && ::fcntl(fd, F_SETFL, flags | O_NONBLOCK) == 0;
+}
+
+void set_no_delay(int fd) {
+  int one = 1;
+  ::setsockopt(fd, IPPROTO_TCP, TCP_NODELAY, &one, sizeof(one));
+}
+
+void close_socket(int& fd) {
+  if (fd >= 0) {
+    ::close(fd);
+  }
+  fd = kInvalidSocket;
+}
+
+bool send_all(int fd, std::string_view data) {
+  std::size_t sent = 0;
+  while (sent < data.size()) {
+    const ssize_t n = ::send(fd, data.data() + sent, data.size() - sent, kSendFlags);
+    if (n < 0) {
+      if (errno == EINTR) {
+        continue;
+      }
+      return false;
+    }
+    sent += static_cast<std::size_t>(n);
+  }
+  return true;
+}
+
+WakePipe::WakePipe() {
+  int fds[2] = {kInvalidSocket, kInvalidSocket};
+  if (::pipe(fds) == 0) {
+    read_fd_ = fds[0];
+    write_fd_ = fds[1];
+    set_non_blocking(read_fd_);
+    set_non_blocking(write_fd_);
+  }
+}
+
+WakePipe::~WakePipe() {
+  close_socket(read_fd_);
+  close_socket(write_fd_);
+}
+
+void WakePipe::notify() const {
+  const char byte = 1;
+  // A full pipe already has a wakeup pending.
+  (void)!::write(write_fd_, &byte, 1);
+}
+
+void WakePipe::drain() const {
+  char buffer[64];
+  while (::read(read_fd_, buffer, sizeof(buffer)) > 0) {
+  }
+}
+
+#else
+
+Result listen_tcp(std::string_view, std::uint16_t, int, int& out_fd) {
+  out_fd = kInvalidSocket;
+  return Result::failure("TCP listeners are not available in this build.");
+}
+
+Result connect_tcp(std::string_view, std::uint16_t, bool, int& out_fd) {
+  out_fd = kInvalidSocket;
+  return Result::failure("TCP connections are not available in this build.");
+}
+
+Result listen_unix(std::string_view, int, int& out_fd) {
+  out_fd = kInvalidSocket;
+  return Result::failure("Unix sockets are not available in this build.");
+}
+
+Result connect_unix(std::string_view, int& out_fd) {
+  out_fd = kInvalidSocket;
+  return Result::failure("Unix sockets are not available in this build.");
+}
+
+std::uint16_t local_port(int) {
+  return 0;
+}
+
+bool set_non_blocking(int) {
+  return false;
+}
+
+void set_no_delay(int) {}
+
+void close_socket(int& fd) {
+  fd = kInvalidSocket;
+}
+
+bool send_all(int, std::string_view) {
+  return false;
+}
+
+WakePipe::WakePipe() = default;
+
+WakePipe::~WakePipe() = default;
+
+void WakePipe::notify() const {}
+
+void WakePipe::drain() const {}
+
+#endif
+
+bool split_host_port(std::string_view endpoint, std::string& host, std::uint16_t& port) {
+  const std::size_t colon = endpoint.rfind(':');
+  if (colon == std::string_view::npos || colon == 0 || colon + 1U >= endpoint.size()) {
+    return false;
+  }
+  unsigned int parsed = 0;
+  const std::string_view port_text = endpoint.substr(colon + 1U);
+  const auto result = std::from_chars(port_text.data(), port_text.data() + port_text.size(), parsed);
+  if (result.ec != std::errc() || result.ptr != port_text.data() + port_text.size() || parsed == 0 ||
+      parsed > 65535U) {
+    return false;
+  }
+  host = std::string{endpoint.substr(0, colon)};
+  port = static_cast<std::uint16_t>(parsed);
+  return true;
+}
+
+}  // namespace alpha::util
@@ -0,0 +1,54 @@
+#pragma once
+
+#include <cstdint>
+#include <string>
+#include <string_view>
+
+#include "core/model/types.hpp"
+
+namespace alpha::util {
+
+// Thin POSIX socket helpers shared by the daemon-side listeners and the P2P
+// transport. On platforms without BSD sockets every call fails with a
+// descriptive Result so callers can keep their feature toggles off.
+inline constexpr int kInvalidSocket = -1;
+
+Result listen_tcp(std::string_view bind_host, std::uint16_t port, int backlog, int& out_fd);
+Result connect_tcp(std::string_view host, std::uint16_t port, bool non_blocking, int& out_fd);
+// AF_UNIX stream listener at `path`, readable and writable by the owner only
+// (mode 0600), so file permissions decide who may connect. A stale socket
+// left by a dead process is replaced; a live one, or any other file at the
+// path, makes this fail.
+Result listen_unix(std::string_view path, int backlog, int& out_fd);
+Result connect_unix(std::string_view path, int& out_fd);
+std::uint16_t local_port(int fd);
+bool set_non_blocking(int fd);
+void set_no_delay(int fd);
+void close_socket(int& fd);
+
+// Writes the whole buffer to a blocking socket, retrying on EINTR. Returns
+// false once the peer is gone.
+bool send_all(int fd, std::string_view data);
+
+// Self-pipe that wakes a thread blocked in poll()/epoll_wait on read_fd().
+// notify() is safe from any thread for the lifetime of the object.
+class WakePipe {
+public:
+  WakePipe();
+  WakePipe(const WakePipe&) = delete;
+  WakePipe& operator=(const WakePipe&) = delete;
+  ~WakePipe();
+
+  [[nodiscard]] int read_fd() const { return read_fd_; }
+  void notify() const;
+  void drain() const;
+
+private:
+  int read_fd_ = kInvalidSocket;
+  int write_fd_ = kInvalidSocket;
+};
+
+// Parses "host:port" peer entries as stored in peers.dat.
+bool split_host_port(std::string_view endpoint, std::string& host, std::uint16_t& port);
+
+}  // namespace alpha::util
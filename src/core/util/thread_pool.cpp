@@ -0,0 +1,126 @@
+#include "core/util/thread_pool.hpp"
+
+#include <algorithm>
+#include <atomic>
+#include <exception>
+
+namespace alpha::util {
+
+ThreadPool::ThreadPool(std::size_t worker_count) {
+  const std::size_t count = worker_count == 0 ? default_worker_count() : worker_count;
+  workers_.reserve(count);
+  for (std::size_t i = 0; i < count; ++i) {
+    workers_.emplace_back([this] { worker_loop(); });
+  }
+}
+
+ThreadPool::~ThreadPool() {
+  {
+    std::lock_guard lock(mutex_);
+    stopping_ = true;
+  }
+  cv_.notify_all();
+  for (auto& worker : workers_) {
+    if (worker.joinable()) {
+      worker.join();
+    }
+  }
+}
+
+std::size_t ThreadPool::default_worker_count() {
+  const unsigned int hw = std::thread::hardware_concurrency();
+  return std::max<std::size_t>(1, hw == 0 ? 2 : hw);
+}
+
+void ThreadPool::submit(std::function<void()> task) {
+  {
+    std::lock_guard lock(mutex_);
+    tasks_.push(std::move(task));
+  }
+  cv_.notify_one();
+}
+
+std::size_t ThreadPool::pending() const {
+  std::lock_guard lock(mutex_);
+  return tasks_.size();
+}
+
+void ThreadPool::parallel_for(std::size_t count, const std::function<void(std::size_t)>& fn) {
+  if (count == 0) {
+    return;
+  }
+  if (count == 1 || workers_.empty()) {
+    for (std::size_t i = 0; i < count; ++i) {
+      fn(i);
+    }
+    return;
+  }
+
+  // Workers and the caller pull fixed-size chunks from a shared cursor so an
+  // uneven batch (slow verifies, cache hits) still balances across threads.
+  const std::size_t participants = workers_.size() + 1U;
+  const std::size_t chunk = std::max<std::size_t>(1, count / (participants * 4U));
+  std::atomic<std::size_t> cursor{0};
+  std::atomic<std::size_t> finished_helpers{0};
+  std::mutex done_mutex;
+  std::condition_variable done_cv;
+  std::exception_ptr failure;
+  std::mutex failure_mutex;
+
+  const auto drain = [&] {
+    while (true) {
+      const std::size_t begin = cursor.fetch_add(chunk);
+      if (begin >= count) {
+        return;
+      }
+      const std::size_t end = std::min(count, begin + chunk);
+      try {
+        for (std::size_t i = begin; i < end; ++i) {
+          fn(i);
+        }
+      } catch (...) {
+        std::lock_guard lock(failure_mutex);
+        if (!failure) {
+          failure = std::current_exception();
+        }
+      }
+    }
+  };
+
+  const std::size_t helpers = std::min(workers_.size(), (count + chunk - 1U) / chunk);
+  for (std::size_t i = 0; i < helpers; ++i) {
+    submit([&] {
+      drain();
+      {
+        std::lock_guard lock(done_mutex);
+        finished_helpers.fetch_add(1);
+      }
+      done_cv.notify_one();
+    });
+  }
+  drain();
+
+  std::unique_lock lock(done_mutex);
+  done_cv.wait(lock, [&] { return finished_helpers.load() == helpers; });
+  if (failure) {
+    std::rethrow_exception(failure);
+  }
+}
+
+void ThreadPool::worker_loop() {
+  while (true) {
+    std::function<void()> task;
+    {
+      std::unique_lock lock(mutex_);
+      cv_.wait(lock, [this] { return stopping_ || !tasks_.empty(); });
+      if (stopping_ && tasks_.empty()) {
+        return;
+      }
+      task = std::move(tasks_.front());
+      tasks_.pop();
+    }
+    task();
+  }
+}
+
+}  // namespace alpha::util
@@ -1,35 +1,59 @@
-#include <arpa/inet.h>
+#include <algorithm>
 #include <cctype>
+#include <charconv>
+#include <chrono>
 #include <cstdint>
 #include <csignal>
-#include <cerrno>
 #include <cstring>
 #include <cstdlib>
 #include <filesystem>
 #include <fstream>
+#include <future>
 #include <iostream>
 #include <map>
-#include <netinet/in.h>
+#include <memory>
+#include <mutex>
 #include <optional>
-#include <sstream>
 #include <stdexcept>
 #include <string>
 #include <string_view>
-#include <sys/socket.h>
-#include <sys/types.h>
-#include <unistd.h>
+#include <thread>
 #include <vector>
 
 #include "core/api/core_api.hpp"
+#include "core/mining/stratum_server.hpp"
 #include "core/model/app_meta.hpp"
+#include "core/rpc/http_server.hpp"
+#include "core/rpc/json.hpp"
+#include "core/rpc/response_cache.hpp"
+#include "core/service/change_feed.hpp"
+#include "core/service/maintenance_scheduler.hpp"
 #include "core/util/canonical.hpp"
 #include "core/util/hash.hpp"
+#include "core/util/metrics.hpp"
 
 namespace {
 
 using alpha::CoreApi;
 using alpha::Result;
 
+// Enough for a bot to post or query a few hundred items per round trip.
+constexpr std::size_t kMaxBatchCalls = 1000;
+// Cached results are serialized whole; recipes.search answers with more
+// results than this are not cached and are streamed chunked as they are
+// serialized, a slice of kRecipesPerChunk at a time. Cached results of at
+// least kStreamCachedBytesAt are streamed from the cache kCachedSliceBytes
+// at a time.
+constexpr std::size_t kMaxCachedRecipes = 16384;
+constexpr std::size_t kRecipesPerChunk = 128;
+constexpr std::size_t kStreamCachedBytesAt = 32U << 10U;
+constexpr std::size_t kCachedSliceBytes = 64U << 10U;
+// GET /events writes at most this many changes per slice, and a comment
+// line after this long without one so clients can tell a quiet stream from
+// a dead one.
+constexpr std::size_t kChangesPerChunk = 256;
+constexpr auto kEventHeartbeat = std::chrono::seconds(15);
+
 volatile std::sig_atomic_t g_running = 1;
 
 void handle_signal(int) {
@@ -48,248 +72,473 @@ std::string trim_copy(std::string_view text) {
   return alpha::util::trim_copy(text);
 }
 
-std::string json_escape(std::string_view value) {
-  std::string out;
-  out.reserve(value.size() + 8U);
-  for (char c : value) {
-    switch (c) {
-      case '\\': out += "\\\\"; break;
-      case '"': out += "\\\""; break;
-      case '\n': out += "\\n"; break;
-      case '\r': out += "\\r"; break;
-      case '\t': out += "\\t"; break;
-      default:
-        out.push_back(c);
-        break;
+// JSON-RPC 2.0 carries arguments in "params"; older clients put them next to
+// "method". Named arguments are looked up in the former, then the latter.
+std::optional<alpha::JsonValue> param(const alpha::JsonValue& call, std::string_view key) {
+  if (const std::optional<alpha::JsonValue> params = call.find("params"); params.has_value() && params->is_object()) {
+    if (std::optional<alpha::JsonValue> value = params->find(key)) {
+      return value;
     }
   }
-  return out;
+  return call.find(key);
 }
 
-std::string json_string(std::string_view value) {
-  return "\"" + json_escape(value) + "\"";
+std::optional<std::string> param_string(const alpha::JsonValue& call, std::string_view key) {
+  const std::optional<alpha::JsonValue> value = param(call, key);
+  return value.has_value() ? value->as_string() : std::nullopt;
 }
 
-std::optional<std::string> extract_json_string(std::string_view body, std::string_view key) {
-  const std::string needle = "\"" + std::string{key} + "\"";
-  const std::size_t key_pos = body.find(needle);
-  if (key_pos == std::string_view::npos) {
-    return std::nullopt;
-  }
-  const std::size_t colon = body.find(':', key_pos + needle.size());
-  if (colon == std::string_view::npos) {
-    return std::nullopt;
+std::optional<long long> param_int(const alpha::JsonValue& call, std::string_view key) {
+  const std::optional<alpha::JsonValue> value = param(call, key);
+  return value.has_value() ? value->as_int() : std::nullopt;
+}
+
+std::optional<bool> param_bool(const alpha::JsonValue& call, std::string_view key) {
+  const std::optional<alpha::JsonValue> value = param(call, key);
+  return value.has_value() ? value->as_bool() : std::nullopt;
+}
+
+// Ids are echoed back verbatim; anything but a string or number is null.
+std::string call_id(const alpha::JsonValue& call) {
+  const std::optional<alpha::JsonValue> id = call.find("id");
+  if (!id.has_value() || (id->type() != alpha::JsonType::String && id->type() != alpha::JsonType::Number)) {
+    return "null";
   }
-  std::size_t cursor = colon + 1U;
-  while (cursor < body.size() && std::isspace(static_cast<unsigned char>(body[cursor])) != 0) {
-    ++cursor;
+  return std::string{id->raw()};
+}
+
+// Opens a JSON-RPC response up to its "result" value; the caller writes the
+// result and closes the object.
+void begin_rpc_result(alpha::JsonWriter& out, std::string_view id) {
+  out.begin_object().member("jsonrpc", "2.0").key("id").raw(id).key("result");
+}
+
+std::string json_rpc_error(std::string_view id, int code, std::string_view message) {
+  std::string body;
+  alpha::JsonWriter out(body);
+  out.begin_object().member("jsonrpc", "2.0").key("id").raw(id).key("error").begin_object();
+  out.member("code", code).member("message", message).end_object().end_object();
+  return body;
+}
+
+std::string ensure_token_file(const std::string& path) {
+  std::filesystem::create_directories(std::filesystem::path(path).parent_path());
+  std::ifstream in(path);
+  std::string token;
+  if (in.good()) {
+    std::getline(in, token);
+    token = trim_copy(token);
+    if (!token.empty()) {
+      return token;
+    }
   }
-  if (cursor >= body.size() || body[cursor] != '"') {
-    return std::nullopt;
+  token = alpha::util::sha256_like_hex(std::to_string(alpha::util::unix_timestamp_now()) + "|" + path).substr(0, 48);
+  std::ofstream out(path, std::ios::trunc);
+  out << token << "\n";
+  return token;
+}
+
+void write_node_status(alpha::JsonWriter& out, const alpha::NodeStatusReport& status) {
+  out.begin_object()
+      .member("network", status.p2p.network)
+      .member("bind_host", status.p2p.bind_host)
+      .member("bind_port", status.p2p.bind_port)
+      .member("peer_count", status.p2p.peer_count)
+      .member("listening", status.p2p.listening)
+      .member("connected_peers", status.p2p.connected_peers)
+      .member("initial_sync_active", status.p2p.initial_sync_active)
+      .member("consensus_hash", status.db.consensus_hash)
+      .member("timeline_hash", status.db.timeline_hash)
+      .member("chain_id", status.genesis.chain_id)
+      .member("genesis_block_hash", status.genesis.block_hash)
+      .member("wallet_locked", status.wallet.locked)
+      .member("backup_verified", status.wallet.backup_verified)
+      .member("crypto_mode", status.wallet.crypto_mode)
+      .member("startup_recovery_summary", status.startup_recovery_summary)
+      .end_object();
+}
+
+void write_health(alpha::JsonWriter& out, const alpha::NodeStatusReport& status) {
+  out.begin_object()
+      .member("healthy", status.db.healthy)
+      .member("details", status.db.details)
+      .member("backtest_ok", status.db.backtest_ok)
+      .member("recovered_from_corruption", status.db.recovered_from_corruption)
+      .member("data_dir", status.data_dir)
+      .member("last_checkpoint_block_hash", status.db.last_checkpoint_block_hash)
+      .end_object();
+}
+
+void write_receive_info(alpha::JsonWriter& out, const alpha::ReceiveAddressInfo& info) {
+  out.begin_object()
+      .member("cid", info.cid)
+      .member("display_name", info.display_name)
+      .member("address", info.address)
+      .member("public_key", info.public_key)
+      .end_object();
+}
+
+void write_mining_template(alpha::JsonWriter& out, const alpha::MiningTemplate& tpl) {
+  out.begin_object()
+      .member("chain_id", tpl.chain_id)
+      .member("network_id", tpl.network_id)
+      .member("community_id", tpl.community_id)
+      .member("miner_cid", tpl.miner_cid)
+      .member("algorithm", tpl.algorithm)
+      .member("pool_protocol_hint", tpl.pool_protocol_hint)
+      .member("next_block_index", tpl.next_block_index)
+      .member("next_open_unix", tpl.next_open_unix)
+      .member("prev_hash", tpl.prev_hash)
+      .member("merkle_root", tpl.merkle_root)
+      .member("content_hash", tpl.content_hash)
+      .member("anticipated_block_hash", tpl.anticipated_block_hash)
+      .member("difficulty_nibbles", tpl.difficulty_nibbles)
+      .member("pow_material", tpl.pow_material)
+      .member("sample_nonce_hash", tpl.sample_nonce_hash)
+      .end_object();
+}
+
+void write_recipe(alpha::JsonWriter& out, const alpha::RecipeSummary& recipe) {
+  out.begin_object()
+      .member("recipe_id", recipe.recipe_id)
+      .member("title", recipe.title)
+      .member("category", recipe.category)
+      .member("author_cid", recipe.author_cid)
+      .member("thumbs_up_count", recipe.thumbs_up_count)
+      .member("review_count", recipe.review_count)
+      .member("average_rating", recipe.average_rating)
+      .end_object();
+}
+
+void write_recipes(alpha::JsonWriter& out, const std::vector<alpha::RecipeSummary>& recipes) {
+  out.begin_array();
+  for (const alpha::RecipeSummary& recipe : recipes) {
+    write_recipe(out, recipe);
   }
-  ++cursor;
-  std::string out;
-  bool escape = false;
-  for (; cursor < body.size(); ++cursor) {
-    const char c = body[cursor];
-    if (escape) {
-      out.push_back(c == 'n' ? '\n' : c);
-      escape = false;
-      continue;
+  out.end_array();
+}
+
+// A recipes.search answer sent as it is serialized. The results are owned
+// by the stream and written a slice at a time into the connection's send
+// buffer, so the full JSON body never exists at once.
+alpha::HttpBodyStream recipe_stream(std::string id, std::vector<alpha::RecipeSummary> recipes) {
+  struct State {
+    std::string id;
+    std::vector<alpha::RecipeSummary> recipes;
+    std::size_t next = 0;
+  };
+  auto state = std::make_shared<State>(State{.id = std::move(id), .recipes = std::move(recipes)});
+  return [state](std::string& out) {
+    if (state->next == 0) {
+      out += R"({"jsonrpc":"2.0","id":)";
+      out += state->id;
+      out += R"(,"result":[)";
     }
-    if (c == '\\') {
-      escape = true;
-      continue;
+    const std::size_t end = std::min(state->recipes.size(), state->next + kRecipesPerChunk);
+    for (; state->next < end; ++state->next) {
+      if (state->next > 0) {
+        out.push_back(',');
+      }
+      alpha::JsonWriter item(out);
+      write_recipe(item, state->recipes[state->next]);
     }
-    if (c == '"') {
-      return out;
+    if (state->next < state->recipes.size()) {
+      return true;
     }
-    out.push_back(c);
-  }
-  return std::nullopt;
+    out += "]}";
+    return false;
+  };
 }
 
-std::optional<long long> extract_json_int(std::string_view body, std::string_view key) {
-  const std::string needle = "\"" + std::string{key} + "\"";
-  const std::size_t key_pos = body.find(needle);
-  if (key_pos == std::string_view::npos) {
-    return std::nullopt;
-  }
-  const std::size_t colon = body.find(':', key_pos + needle.size());
-  if (colon == std::string_view::npos) {
-    return std::nullopt;
-  }
-  std::size_t cursor = colon + 1U;
-  while (cursor < body.size() && std::isspace(static_cast<unsigned char>(body[cursor])) != 0) {
-    ++cursor;
+void write_change(alpha::JsonWriter& out, const alpha::StoreChange& change) {
+  using Kind = alpha::StoreChange::Kind;
+  out.begin_object();
+  switch (change.kind) {
+    case Kind::EventApplied:
+      out.member("event_id", change.id).member("kind", change.detail).member("unix_ts", change.value);
+      break;
+    case Kind::BlockConfirmed:
+      out.member("block_hash", change.id).member("index", change.value);
+      break;
+    case Kind::BalanceChanged:
+      out.member("cid", change.id).member("balance", change.value).member("delta", change.delta);
+      break;
+    case Kind::ModerationChanged:
+      out.member("id", change.id).member("action", change.detail);
+      break;
   }
-  std::size_t end = cursor;
-  while (end < body.size() &&
-         (std::isdigit(static_cast<unsigned char>(body[end])) != 0 || body[end] == '-')) {
-    ++end;
+  out.end_object();
+}
+
+// Server-sent events for GET /events. The stream keeps only its cursor into
+// the change feed; when it has nothing to send it appends nothing, which
+// parks the connection until the feed's publish hook (or the heartbeat job)
+// wakes the server's streams.
+alpha::HttpBodyStream change_stream(const alpha::ChangeFeed& feed, std::uint64_t cursor, std::uint32_t topics) {
+  struct State {
+    std::uint64_t cursor = 0;
+    std::uint32_t topics = 0;
+    bool opened = false;
+    std::chrono::steady_clock::time_point last_write;
+  };
+  auto state = std::make_shared<State>(State{.cursor = cursor, .topics = topics});
+  return [&feed, state](std::string& out) {
+    const std::size_t before = out.size();
+    const auto now = std::chrono::steady_clock::now();
+    if (!state->opened) {
+      // Sends the head at once, before any change arrives.
+      state->opened = true;
+      out += "retry: 3000\n\n";
+    }
+    const alpha::ChangeBatch batch = feed.read_after(state->cursor, state->topics, kChangesPerChunk);
+    if (batch.missed) {
+      // The client fell further behind than the feed remembers and should
+      // refetch whatever state it mirrors.
+      out += "event: reset\ndata: {}\n\n";
+    }
+    for (const alpha::ChangeNotice& notice : batch.notices) {
+      out.append("id: ").append(std::to_string(notice.seq));
+      out.append("\nevent: ").append(alpha::change_topic_name(notice.change.kind)).append("\ndata: ");
+      alpha::JsonWriter data(out);
+      write_change(data, notice.change);
+      out += "\n\n";
+    }
+    state->cursor = batch.cursor;
+    // Half the heartbeat period, so a stream that went quiet just after one
+    // heartbeat job run still gets a comment on the next.
+    if (out.size() == before && now - state->last_write >= kEventHeartbeat / 2) {
+      out += ": keep-alive\n\n";
+    }
+    if (out.size() != before) {
+      state->last_write = now;
+    }
+    return true;
+  };
+}
+
+// Query string values, which clients may send as `event%2Cblock`.
+std::string percent_decode(std::string_view text) {
+  std::string out;
+  out.reserve(text.size());
+  for (std::size_t i = 0; i < text.size(); ++i) {
+    unsigned value = 0;
+    if (text[i] == '%' && i + 2U < text.size() &&
+        std::from_chars(text.data() + i + 1U, text.data() + i + 3U, value, 16).ptr == text.data() + i + 3U) {
+      out.push_back(static_cast<char>(value));
+      i += 2U;
+    } else {
+      out.push_back(text[i] == '+' ? ' ' : text[i]);
+    }
   }
-  if (end == cursor) {
+  return out;
+}
+
+// Value of `name` in the target's query string, undecoded.
+std::optional<std::string_view> query_param(std::string_view target, std::string_view name) {
+  const std::size_t question = target.find('?');
+  if (question == std::string_view::npos) {
     return std::nullopt;
   }
-  try {
-    return std::stoll(std::string{body.substr(cursor, end - cursor)});
-  } catch (...) {
-    return std::nullopt;
+  std::string_view query = target.substr(question + 1U);
+  while (!query.empty()) {
+    const std::size_t amp = query.find('&');
+    const std::string_view pair = query.substr(0, amp);
+    const std::size_t equals = pair.find('=');
+    if (pair.substr(0, equals) == name) {
+      return equals == std::string_view::npos ? std::string_view{} : pair.substr(equals + 1U);
+    }
+    if (amp == std::string_view::npos) {
+      break;
+    }
+    query.remove_prefix(amp + 1U);
   }
+  return std::nullopt;
 }
 
-std::optional<bool> extract_json_bool(std::string_view body, std::string_view key) {
-  const std::string needle = "\"" + std::string{key} + "\"";
-  const std::size_t key_pos = body.find(needle);
-  if (key_pos == std::string_view::npos) {
-    return std::nullopt;
+// GET /events[?topics=event,block,balance,moderation][&since=SEQ]. Without
+// `since` (or a Last-Event-ID header from a reconnecting EventSource) the
+// stream starts with the next change.
+alpha::HttpResponse events_response(const alpha::ChangeFeed& feed, const alpha::HttpRequest& request) {
+  const auto bad_request = [](std::string_view message) {
+    return alpha::HttpResponse{.status = 400, .body = "{\"error\":\"" + std::string{message} + "\"}"};
+  };
+  if (request.version != "HTTP/1.1") {
+    return bad_request("Event streams need HTTP/1.1.");
   }
-  const std::size_t colon = body.find(':', key_pos + needle.size());
-  if (colon == std::string_view::npos) {
-    return std::nullopt;
+  const std::optional<std::uint32_t> topics =
+      alpha::parse_change_topics(percent_decode(query_param(request.target, "topics").value_or("")));
+  if (!topics.has_value()) {
+    return bad_request("Unknown topic; use event, block, balance or moderation.");
   }
-  std::size_t cursor = colon + 1U;
-  while (cursor < body.size() && std::isspace(static_cast<unsigned char>(body[cursor])) != 0) {
-    ++cursor;
+  std::uint64_t cursor = feed.last_seq();
+  std::optional<std::string_view> since = query_param(request.target, "since");
+  if (!since.has_value()) {
+    since = request.header("last-event-id");
   }
-  if (body.substr(cursor, 4) == "true") {
-    return true;
-  }
-  if (body.substr(cursor, 5) == "false") {
-    return false;
+  if (since.has_value()) {
+    const std::string_view digits = *since;
+    const auto [end, ec] = std::from_chars(digits.data(), digits.data() + digits.size(), cursor);
+    if (ec != std::errc{} || end != digits.data() + digits.size()) {
+      return bad_request("since must be an event id.");
+    }
   }
-  return std::nullopt;
+  return {.status = 200, .content_type = "text/event-stream", .stream = change_stream(feed, cursor, *topics)};
+}
+
+void write_stratum_status(alpha::JsonWriter& out, const alpha::StratumServerStats& stats) {
+  out.begin_object()
+      .member("running", stats.running)
+      .member("port", stats.bound_port)
+      .member("clients", stats.connected_clients)
+      .member("active_jobs", stats.active_jobs)
+      .member("accepted_shares", stats.accepted_shares)
+      .member("rejected_shares", stats.rejected_shares)
+      .member("blocks_found", stats.blocks_found)
+      .member("blocks_rejected", stats.blocks_rejected)
+      .end_object();
 }
 
-std::string extract_json_id(std::string_view body) {
-  if (const auto string_id = extract_json_string(body, "id"); string_id.has_value()) {
-    return json_string(*string_id);
+void write_maintenance(alpha::JsonWriter& out, const alpha::MaintenanceScheduler& scheduler) {
+  out.begin_object().member("running", scheduler.running()).key("jobs").begin_array();
+  for (const alpha::MaintenanceJobStats& job : scheduler.stats()) {
+    out.begin_object()
+        .member("name", job.name)
+        .member("interval_ms", job.interval_ms)
+        .member("runs", job.runs)
+        .member("failures", job.failures)
+        .member("deferrals", job.deferrals)
+        .member("last_duration_us", job.last_duration_us)
+        .member("max_duration_us", job.max_duration_us)
+        .member("total_duration_us", job.total_duration_us)
+        .member("last_run_unix", job.last_run_unix)
+        .member("next_due_ms", job.next_due_ms)
+        .member("last_message", job.last_message)
+        .end_object();
   }
-  if (const auto int_id = extract_json_int(body, "id"); int_id.has_value()) {
-    return std::to_string(*int_id);
+  out.end_array().end_object();
+}
+
+void write_result(alpha::JsonWriter& out, const Result& result, bool with_data = false) {
+  out.begin_object().member("ok", result.ok).member("message", result.message);
+  if (with_data) {
+    out.member("data", result.data);
   }
-  return "null";
+  out.end_object();
 }
 
-std::string http_response(int status, std::string_view status_text, std::string_view body) {
-  std::ostringstream out;
-  out << "HTTP/1.1 " << status << " " << status_text << "\r\n";
-  out << "Content-Type: application/json\r\n";
-  out << "Content-Length: " << body.size() << "\r\n";
-  out << "Connection: close\r\n\r\n";
-  out << body;
-  return out.str();
+void write_pending(alpha::JsonWriter& out, std::string_view message) {
+  out.begin_object().member("ok", true).member("pending", true).member("message", message).end_object();
 }
 
-std::string json_rpc_result(std::string_view id, std::string_view result_json) {
-  return "{\"jsonrpc\":\"2.0\",\"id\":" + std::string{id} + ",\"result\":" + std::string{result_json} + "}";
+void write_metrics(alpha::JsonWriter& out) {
+  const auto us = [](double ns) { return ns / 1000.0; };
+  out.begin_object().key("metrics").begin_array();
+  for (const alpha::util::MetricSample& sample : alpha::util::metrics().snapshot()) {
+    out.begin_object().member("name", sample.name);
+    if (!sample.label_key.empty()) {
+      out.key("labels").begin_object().member(sample.label_key, sample.label_value).end_object();
+    }
+    if (!sample.is_histogram) {
+      out.member("type", "counter").member("value", sample.counter).end_object();
+      continue;
+    }
+    const alpha::util::HistogramSnapshot& histogram = sample.histogram;
+    out.member("type", "histogram")
+        .member("count", histogram.count)
+        .member("sum_us", us(static_cast<double>(histogram.sum_ns)))
+        .member("mean_us", us(histogram.mean_ns()))
+        .member("p50_us", us(static_cast<double>(histogram.percentile_ns(0.50))))
+        .member("p90_us", us(static_cast<double>(histogram.percentile_ns(0.90))))
+        .member("p99_us", us(static_cast<double>(histogram.percentile_ns(0.99))))
+        .member("p999_us", us(static_cast<double>(histogram.percentile_ns(0.999))))
+        .member("max_us", us(static_cast<double>(histogram.max_ns)))
+        .end_object();
+  }
+  out.end_array().end_object();
 }
 
-std::string json_rpc_error(std::string_view id, int code, std::string_view message) {
-  return "{\"jsonrpc\":\"2.0\",\"id\":" + std::string{id} + ",\"error\":{\"code\":" + std::to_string(code) +
-         ",\"message\":" + json_string(message) + "}}";
+// Prometheus scrape body: the metrics registry plus the RPC server's own
+// connection counters and the response cache's size.
+alpha::HttpResponse metrics_response(const alpha::HttpServer& rpc_server, const alpha::ResponseCache& cache) {
+  std::string body;
+  alpha::util::metrics().render_prometheus(body);
+  const alpha::HttpServerStats http = rpc_server.stats();
+  const alpha::ResponseCacheStats cached = cache.stats();
+  struct ServerSeries {
+    std::string_view name;
+    std::string_view type;
+    std::string_view help;
+    std::uint64_t value;
+  };
+  const ServerSeries server_series[] = {
+      {"gotsoup_http_open_connections", "gauge", "Open RPC connections.", http.open_connections},
+      {"gotsoup_http_handlers_in_flight", "gauge", "RPC handlers running on the worker pool.",
+       http.handlers_in_flight},
+      {"gotsoup_http_connections_accepted_total", "counter", "RPC connections accepted.", http.connections_accepted},
+      {"gotsoup_http_connections_rejected_total", "counter", "RPC connections refused over the connection limit.",
+       http.connections_rejected},
+      {"gotsoup_http_requests_total", "counter", "HTTP requests parsed.", http.requests},
+      {"gotsoup_http_keep_alive_reuses_total", "counter", "Requests served on a reused connection.",
+       http.keep_alive_reuses},
+      {"gotsoup_http_bad_requests_total", "counter", "Malformed HTTP requests.", http.bad_requests},
+      {"gotsoup_http_timeouts_total", "counter", "Connections closed for idling past their deadline.", http.timeouts},
+      {"gotsoup_http_streamed_responses_total", "counter", "Responses sent with a chunked body.",
+       http.streamed_responses},
+      {"gotsoup_http_local_connections_total", "counter", "RPC connections accepted on the unix socket.",
+       http.local_connections},
+      {"gotsoup_http_framed_requests_total", "counter", "Length-prefixed RPC requests on the unix socket.",
+       http.framed_requests},
+      {"gotsoup_http_parked_streams", "gauge", "Event streams idle until the next change.", http.parked_streams},
+      {"gotsoup_rpc_cache_entries", "gauge", "Results held in the RPC response cache.", cached.entries},
+      {"gotsoup_rpc_cache_bytes", "gauge", "Bytes of results held in the RPC response cache.", cached.bytes},
+      {"gotsoup_rpc_cache_evictions_total", "counter", "Response cache entries evicted to stay within bounds.",
+       cached.evictions},
+      {"gotsoup_rpc_cache_stale_total", "counter", "Response cache misses that found a result from older state.",
+       cached.stale},
+  };
+  for (const ServerSeries& series : server_series) {
+    alpha::util::append_prometheus_header(body, series.name, series.type, series.help);
+    alpha::util::append_prometheus_sample(body, series.name, {}, std::to_string(series.value));
+  }
+  return {.status = 200, .content_type = "text/plain; version=0.0.4; charset=utf-8", .body = std::move(body)};
 }
 
-std::string ensure_token_file(const std::string& path) {
-  std::filesystem::create_directories(std::filesystem::path(path).parent_path());
-  std::ifstream in(path);
-  std::string token;
-  if (in.good()) {
-    std::getline(in, token);
-    token = trim_copy(token);
-    if (!token.empty()) {
-      return token;
-    }
+// One latency series per RPC method. Calls that did not name a known method
+// share a series, so arbitrary method strings cannot grow the registry.
+alpha::util::LatencyHistogram& rpc_latency(std::string_view method) {
+  thread_local std::map<std::string, alpha::util::LatencyHistogram*, std::less<>> cache;
+  const auto it = cache.find(method);
+  if (it != cache.end()) {
+    return *it->second;
   }
-  token = alpha::util::sha256_like_hex(std::to_string(alpha::util::unix_timestamp_now()) + "|" + path).substr(0, 48);
-  std::ofstream out(path, std::ios::trunc);
-  out << token << "\n";
-  return token;
+  alpha::util::LatencyHistogram& histogram = alpha::util::metrics().histogram(
+      "gotsoup_rpc_duration_seconds", "Latency of JSON-RPC calls, until the response or its stream is ready.",
+      {.key = "method", .value = method});
+  cache.emplace(std::string{method}, &histogram);
+  return histogram;
 }
 
-std::string node_status_json(const alpha::NodeStatusReport& status) {
-  std::ostringstream out;
-  out << "{"
-      << "\"network\":" << json_string(status.p2p.network) << ","
-      << "\"bind_host\":" << json_string(status.p2p.bind_host) << ","
-      << "\"bind_port\":" << status.p2p.bind_port << ","
-      << "\"peer_count\":" << status.p2p.peer_count << ","
-      << "\"consensus_hash\":" << json_string(status.db.consensus_hash) << ","
-      << "\"timeline_hash\":" << json_string(status.db.timeline_hash) << ","
-      << "\"chain_id\":" << json_string(status.genesis.chain_id) << ","
-      << "\"genesis_block_hash\":" << json_string(status.genesis.block_hash) << ","
-      << "\"wallet_locked\":" << (status.wallet.locked ? "true" : "false") << ","
-      << "\"backup_verified\":" << (status.wallet.backup_verified ? "true" : "false") << ","
-      << "\"crypto_mode\":" << json_string(status.wallet.crypto_mode) << ","
-      << "\"startup_recovery_summary\":" << json_string(status.startup_recovery_summary) << "}";
-  return out.str();
-}
-
-std::string health_json(const alpha::NodeStatusReport& status) {
-  std::ostringstream out;
-  out << "{"
-      << "\"healthy\":" << (status.db.healthy ? "true" : "false") << ","
-      << "\"details\":" << json_string(status.db.details) << ","
-      << "\"backtest_ok\":" << (status.db.backtest_ok ? "true" : "false") << ","
-      << "\"recovered_from_corruption\":" << (status.db.recovered_from_corruption ? "true" : "false") << ","
-      << "\"data_dir\":" << json_string(status.data_dir) << ","
-      << "\"last_checkpoint_block_hash\":" << json_string(status.db.last_checkpoint_block_hash) << "}";
-  return out.str();
-}
-
-std::string receive_info_json(const alpha::ReceiveAddressInfo& info) {
-  return "{"
-         "\"cid\":" + json_string(info.cid) + "," +
-         "\"display_name\":" + json_string(info.display_name) + "," +
-         "\"address\":" + json_string(info.address) + "," +
-         "\"public_key\":" + json_string(info.public_key) + "}";
-}
-
-std::string mining_template_json(const alpha::MiningTemplate& tpl) {
-  std::ostringstream out;
-  out << "{"
-      << "\"chain_id\":" << json_string(tpl.chain_id) << ","
-      << "\"network_id\":" << json_string(tpl.network_id) << ","
-      << "\"community_id\":" << json_string(tpl.community_id) << ","
-      << "\"miner_cid\":" << json_string(tpl.miner_cid) << ","
-      << "\"algorithm\":" << json_string(tpl.algorithm) << ","
-      << "\"pool_protocol_hint\":" << json_string(tpl.pool_protocol_hint) << ","
-      << "\"next_block_index\":" << tpl.next_block_index << ","
-      << "\"next_open_unix\":" << tpl.next_open_unix << ","
-      << "\"prev_hash\":" << json_string(tpl.prev_hash) << ","
-      << "\"merkle_root\":" << json_string(tpl.merkle_root) << ","
-      << "\"content_hash\":" << json_string(tpl.content_hash) << ","
-      << "\"anticipated_block_hash\":" << json_string(tpl.anticipated_block_hash) << ","
-      << "\"difficulty_nibbles\":" << tpl.difficulty_nibbles << ","
-      << "\"pow_material\":" << json_string(tpl.pow_material) << ","
-      << "\"sample_nonce_hash\":" << json_string(tpl.sample_nonce_hash) << "}";
-  return out.str();
-}
-
-std::string recipes_json(const std::vector<alpha::RecipeSummary>& recipes) {
-  std::ostringstream out;
-  out << "[";
-  for (std::size_t i = 0; i < recipes.size(); ++i) {
-    if (i > 0) {
-      out << ",";
-    }
-    const auto& recipe = recipes[i];
-    out << "{"
-        << "\"recipe_id\":" << json_string(recipe.recipe_id) << ","
-        << "\"title\":" << json_string(recipe.title) << ","
-        << "\"category\":" << json_string(recipe.category) << ","
-        << "\"author_cid\":" << json_string(recipe.author_cid) << ","
-        << "\"thumbs_up_count\":" << recipe.thumbs_up_count << ","
-        << "\"review_count\":" << recipe.review_count << ","
-        << "\"average_rating\":" << recipe.average_rating
-        << "}";
+alpha::SearchQuery search_query(const alpha::JsonValue& call) {
+  return {
+      .text = param_string(call, "text").value_or(""),
+      .category = param_string(call, "category").value_or(""),
+  };
+}
+
+// Unix socket clients already passed the socket file's owner-only mode;
+// everyone else presents the bearer token.
+bool authorized(const alpha::HttpRequest& request, std::string_view token) {
+  if (request.local) {
+    return true;
   }
-  out << "]";
-  return out.str();
+  const std::optional<std::string_view> authorization = request.header("authorization");
+  constexpr std::string_view kBearer = "Bearer ";
+  return authorization.has_value() && authorization->starts_with(kBearer) &&
+         authorization->substr(kBearer.size()) == token;
 }
 
-std::string require_auth_response(std::string_view id) {
-  return http_response(401, "Unauthorized", json_rpc_error(id, -32001, "Missing or invalid bearer token."));
+alpha::HttpResponse require_auth_response(std::string_view id) {
+  return {.status = 401, .body = json_rpc_error(id, -32001, "Missing or invalid bearer token.")};
 }
 
 struct Args {
@@ -297,8 +546,15 @@ struct Args {
   std::string bind_host = "127.0.0.1";
   std::string token_file = default_data_dir() + "/daemon.token";
   std::string community_profile = "tomato-soup";
+  std::string stratum_bind_host = "127.0.0.1";
+  std::string rpc_socket;  // empty: no unix socket listener
   int port = 4888;
+  int stratum_port = 0;
+  int stratum_share_nibbles = 2;
+  int kdf_cache_ttl_seconds = 300;
+  int rpc_threads = 4;
   bool alpha_test_mode = false;
+  bool external_mining = false;
 };
 
 Args parse_args(int argc, char** argv) {
@@ -322,150 +578,467 @@ Args parse_args(int argc, char** argv) {
       args.port = std::max(1, std::atoi(argv[++i]));
     } else if (arg == "--testnet") {
       args.alpha_test_mode = true;
+    } else if (arg == "--stratum-port" && i + 1 < argc) {
+      args.stratum_port = std::clamp(std::atoi(argv[++i]), 0, 65535);
+    } else if (arg == "--stratum-bind-host") {
+      take(args.stratum_bind_host);
+    } else if (arg == "--stratum-share-nibbles" && i + 1 < argc) {
+      args.stratum_share_nibbles = std::clamp(std::atoi(argv[++i]), 0, 16);
+    } else if (arg == "--external-mining") {
+      args.external_mining = true;
+    } else if (arg == "--kdf-cache-ttl" && i + 1 < argc) {
+      args.kdf_cache_ttl_seconds = std::max(0, std::atoi(argv[++i]));
+    } else if (arg == "--rpc-socket") {
+      take(args.rpc_socket);
+    } else if (arg == "--rpc-threads" && i + 1 < argc) {
+      args.rpc_threads = std::clamp(std::atoi(argv[++i]), 1, 64);
     }
   }
   return args;
 }
 
-std::string method_result_json(CoreApi& api, std::string_view method, std::string_view body) {
+// Writes the result of one call; recipes.search is answered in cached_call
+// so large results can stream.
+void write_method_result(CoreApi& api, std::mutex& api_mutex, const alpha::StratumServer& stratum,
+                         std::string_view method, const alpha::JsonValue& call, alpha::JsonWriter& out) {
   if (method == "node.status") {
-    return node_status_json(api.node_status());
+    write_node_status(out, api.node_status());
+    return;
   }
   if (method == "system.health") {
-    return health_json(api.node_status());
+    write_health(out, api.node_status());
+    return;
   }
   if (method == "wallet.lock") {
     const Result result = api.lock_wallet();
-    return "{\"ok\":" + std::string{result.ok ? "true" : "false"} + ",\"message\":" + json_string(result.message) + "}";
+    write_result(out, result);
+    return;
+  }
+  if (method == "wallet.unlock" && param_bool(call, "async").value_or(false)) {
+    // Argon2id runs on the KDF worker; the unlock itself happens once the key is cached.
+    // The outcome is reported by wallet.unlock_status.
+    std::string passphrase = param_string(call, "passphrase").value_or("");
+    api.begin_wallet_task("wallet.unlock");
+    api.prepare_unlock_async(passphrase, [&api, &api_mutex, passphrase](const Result& derived) {
+      std::lock_guard lock(api_mutex);
+      const Result result = derived.ok ? api.unlock_wallet(passphrase) : derived;
+      api.finish_wallet_task(result);
+      std::cout << "wallet.unlock (async): " << result.message << "\n";
+    });
+    write_pending(out, "Wallet unlock queued; poll wallet.unlock_status.");
+    return;
+  }
+  if (method == "wallet.unlock_status") {
+    const alpha::WalletStatus wallet = api.node_status().wallet;
+    out.begin_object()
+        .member("task", wallet.task)
+        .member("pending", wallet.task_pending)
+        .member("ok", wallet.task_ok)
+        .member("message", wallet.task_message)
+        .member("finished_unix", wallet.task_finished_unix)
+        .member("wallet_locked", wallet.locked)
+        .end_object();
+    return;
   }
   if (method == "wallet.unlock") {
-    const Result result = api.unlock_wallet(extract_json_string(body, "passphrase").value_or(""));
-    return "{\"ok\":" + std::string{result.ok ? "true" : "false"} + ",\"message\":" + json_string(result.message) + "}";
+    const Result result = api.unlock_wallet(param_string(call, "passphrase").value_or(""));
+    write_result(out, result);
+    return;
   }
   if (method == "wallet.backup") {
-    const Result result = api.export_key_backup(extract_json_string(body, "path").value_or(""),
-                                                extract_json_string(body, "password").value_or(""),
-                                                extract_json_string(body, "salt").value_or(""));
-    return "{\"ok\":" + std::string{result.ok ? "true" : "false"} + ",\"message\":" + json_string(result.message) +
-           ",\"data\":" + json_string(result.data) + "}";
+    const Result result = api.export_key_backup(param_string(call, "path").value_or(""),
+                                                param_string(call, "password").value_or(""),
+                                                param_string(call, "salt").value_or(""));
+    write_result(out, result, true);
+    return;
+  }
+  if (method == "wallet.verify_backup" && param_bool(call, "async").value_or(false)) {
+    std::string path = param_string(call, "path").value_or("");
+    std::string password = param_string(call, "password").value_or("");
+    api.begin_wallet_task("wallet.verify_backup");
+    api.prepare_backup_async(path, password, [&api, &api_mutex, path, password](const Result& derived) {
+      std::lock_guard lock(api_mutex);
+      const Result result = derived.ok ? api.verify_key_backup(path, password) : derived;
+      api.finish_wallet_task(result);
+      std::cout << "wallet.verify_backup (async): " << result.message << "\n";
+    });
+    write_pending(out, "Key backup verification queued; poll wallet.unlock_status.");
+    return;
   }
   if (method == "wallet.verify_backup") {
-    const Result result = api.verify_key_backup(extract_json_string(body, "path").value_or(""),
-                                                extract_json_string(body, "password").value_or(""));
-    return "{\"ok\":" + std::string{result.ok ? "true" : "false"} + ",\"message\":" + json_string(result.message) +
-           ",\"data\":" + json_string(result.data) + "}";
+    const Result result = api.verify_key_backup(param_string(call, "path").value_or(""),
+                                                param_string(call, "password").value_or(""));
+    write_result(out, result, true);
+    return;
   }
   if (method == "wallet.import_backup") {
-    const Result result = api.import_key_backup(extract_json_string(body, "path").value_or(""),
-                                                extract_json_string(body, "password").value_or(""));
-    return "{\"ok\":" + std::string{result.ok ? "true" : "false"} + ",\"message\":" + json_string(result.message) + "}";
+    const Result result = api.import_key_backup(param_string(call, "path").value_or(""),
+                                                param_string(call, "password").value_or(""));
+    write_result(out, result);
+    return;
   }
   if (method == "wallet.recover") {
-    const Result result = api.recover_wallet(extract_json_string(body, "backup_path").value_or(""),
-                                             extract_json_string(body, "backup_password").value_or(""),
-                                             extract_json_string(body, "new_local_passphrase").value_or(""));
-    return "{\"ok\":" + std::string{result.ok ? "true" : "false"} + ",\"message\":" + json_string(result.message) + "}";
+    const Result result = api.recover_wallet(param_string(call, "backup_path").value_or(""),
+                                             param_string(call, "backup_password").value_or(""),
+                                             param_string(call, "new_local_passphrase").value_or(""));
+    write_result(out, result);
+    return;
   }
   if (method == "wallet.receive_info") {
-    return receive_info_json(api.receive_info());
+    write_receive_info(out, api.receive_info());
+    return;
   }
   if (method == "wallet.sign") {
-    const auto signed_message = api.sign_message(extract_json_string(body, "message").value_or(""));
-    return "{"
-           "\"message\":" + json_string(signed_message.message) + "," +
-           "\"signature\":" + json_string(signed_message.signature) + "," +
-           "\"public_key\":" + json_string(signed_message.public_key) + "," +
-           "\"cid\":" + json_string(signed_message.cid) + "," +
-           "\"address\":" + json_string(signed_message.address) + "," +
-           "\"wallet_locked\":" + std::string{signed_message.wallet_locked ? "true" : "false"} + "}";
+    const auto signed_message = api.sign_message(param_string(call, "message").value_or(""));
+    out.begin_object()
+        .member("message", signed_message.message)
+        .member("signature", signed_message.signature)
+        .member("public_key", signed_message.public_key)
+        .member("cid", signed_message.cid)
+        .member("address", signed_message.address)
+        .member("wallet_locked", signed_message.wallet_locked)
+        .end_object();
+    return;
   }
   if (method == "wallet.transfer") {
     const Result result = api.transfer_rewards_to_address({
-        .to_address = extract_json_string(body, "to_address").value_or(""),
-        .amount = extract_json_int(body, "amount").value_or(0),
-        .memo = extract_json_string(body, "memo").value_or(""),
+        .to_address = param_string(call, "to_address").value_or(""),
+        .amount = param_int(call, "amount").value_or(0),
+        .memo = param_string(call, "memo").value_or(""),
     });
-    return "{\"ok\":" + std::string{result.ok ? "true" : "false"} + ",\"message\":" + json_string(result.message) + "}";
-  }
-  if (method == "recipes.search") {
-    return recipes_json(api.search({
-        .text = extract_json_string(body, "text").value_or(""),
-        .category = extract_json_string(body, "category").value_or(""),
-    }));
+    write_result(out, result);
+    return;
   }
   if (method == "recipes.create") {
     const Result result = api.create_recipe({
-        .category = extract_json_string(body, "category").value_or(""),
-        .title = extract_json_string(body, "title").value_or(""),
-        .markdown = extract_json_string(body, "markdown").value_or(""),
-        .core_topic = extract_json_bool(body, "core_topic").value_or(false),
-        .menu_segment = extract_json_string(body, "menu_segment").value_or("community-post"),
-        .value_units = extract_json_int(body, "value_units").value_or(0),
+        .category = param_string(call, "category").value_or(""),
+        .title = param_string(call, "title").value_or(""),
+        .markdown = param_string(call, "markdown").value_or(""),
+        .core_topic = param_bool(call, "core_topic").value_or(false),
+        .menu_segment = param_string(call, "menu_segment").value_or("community-post"),
+        .value_units = param_int(call, "value_units").value_or(0),
     });
-    return "{\"ok\":" + std::string{result.ok ? "true" : "false"} + ",\"message\":" + json_string(result.message) + "}";
+    write_result(out, result);
+    return;
   }
   if (method == "threads.create") {
     const Result result = api.create_thread({
-        .recipe_id = extract_json_string(body, "recipe_id").value_or(""),
-        .title = extract_json_string(body, "title").value_or(""),
-        .markdown = extract_json_string(body, "markdown").value_or(""),
-        .value_units = extract_json_int(body, "value_units").value_or(0),
+        .recipe_id = param_string(call, "recipe_id").value_or(""),
+        .title = param_string(call, "title").value_or(""),
+        .markdown = param_string(call, "markdown").value_or(""),
+        .value_units = param_int(call, "value_units").value_or(0),
     });
-    return "{\"ok\":" + std::string{result.ok ? "true" : "false"} + ",\"message\":" + json_string(result.message) + "}";
+    write_result(out, result);
+    return;
   }
   if (method == "replies.create") {
     const Result result = api.create_reply({
-        .thread_id = extract_json_string(body, "thread_id").value_or(""),
-        .markdown = extract_json_string(body, "markdown").value_or(""),
-        .value_units = extract_json_int(body, "value_units").value_or(0),
+        .thread_id = param_string(call, "thread_id").value_or(""),
+        .markdown = param_string(call, "markdown").value_or(""),
+        .value_units = param_int(call, "value_units").value_or(0),
     });
-    return "{\"ok\":" + std::string{result.ok ? "true" : "false"} + ",\"message\":" + json_string(result.message) + "}";
+    write_result(out, result);
+    return;
   }
   if (method == "forum.downvote_purge") {
-    const Result result = api.downvote_and_purge_content(extract_json_string(body, "object_id").value_or(""),
-                                                         extract_json_string(body, "reason").value_or(""));
-    return "{\"ok\":" + std::string{result.ok ? "true" : "false"} + ",\"message\":" + json_string(result.message) + "}";
+    const Result result = api.downvote_and_purge_content(param_string(call, "object_id").value_or(""),
+                                                         param_string(call, "reason").value_or(""));
+    write_result(out, result);
+    return;
   }
   if (method == "mining.template") {
-    return mining_template_json(api.mining_template());
+    write_mining_template(out, api.mining_template());
+    return;
+  }
+  if (method == "mining.stratum") {
+    write_stratum_status(out, stratum.stats());
+    return;
   }
   if (method == "genesis.spec") {
     const auto node = api.node_status();
-    return "{"
-           "\"chain_id\":" + json_string(node.genesis.chain_id) + "," +
-           "\"network_id\":" + json_string(node.genesis.network_id) + "," +
-           "\"psz_timestamp\":" + json_string(node.genesis.psz_timestamp) + "," +
-           "\"merkle_root\":" + json_string(node.genesis.merkle_root) + "," +
-           "\"block_hash\":" + json_string(node.genesis.block_hash) + "}";
+    out.begin_object()
+        .member("chain_id", node.genesis.chain_id)
+        .member("network_id", node.genesis.network_id)
+        .member("psz_timestamp", node.genesis.psz_timestamp)
+        .member("merkle_root", node.genesis.merkle_root)
+        .member("block_hash", node.genesis.block_hash)
+        .end_object();
+    return;
   }
   throw std::runtime_error("Unknown method");
 }
 
-std::string read_request_body(int fd) {
-  std::string request;
-  char buffer[4096];
-  while (true) {
-    const ssize_t n = ::read(fd, buffer, sizeof(buffer));
-    if (n <= 0) {
-      break;
+// Synchronous unlock and backup verification derive their key on the KDF
+// worker first, so Argon2id runs without the API lock and other RPCs keep
+// flowing; the call that follows finds the key in the session cache.
+bool write_kdf_method_result(CoreApi& api, std::mutex& api_mutex, const alpha::StratumServer& stratum,
+                             std::string_view method, const alpha::JsonValue& call, alpha::JsonWriter& out) {
+  const bool unlock = method == "wallet.unlock";
+  if ((!unlock && method != "wallet.verify_backup") || param_bool(call, "async").value_or(false)) {
+    return false;
+  }
+  std::promise<Result> derived;
+  std::future<Result> ready = derived.get_future();
+  const auto on_ready = [&derived](const Result& result) { derived.set_value(result); };
+  {
+    std::lock_guard lock(api_mutex);
+    if (unlock) {
+      api.prepare_unlock_async(param_string(call, "passphrase").value_or(""), on_ready);
+    } else {
+      api.prepare_backup_async(param_string(call, "path").value_or(""),
+                               param_string(call, "password").value_or(""), on_ready);
     }
-    request.append(buffer, static_cast<std::size_t>(n));
-    const std::size_t header_end = request.find("\r\n\r\n");
-    if (header_end == std::string::npos) {
-      continue;
+  }
+  const Result prewarmed = ready.get();
+  if (!prewarmed.ok) {
+    write_result(out, prewarmed, !unlock);
+    return true;
+  }
+  std::lock_guard lock(api_mutex);
+  write_method_result(api, api_mutex, stratum, method, call, out);
+  return true;
+}
+
+struct CallOutcome {
+  int status = 200;
+  std::string body;
+  alpha::HttpBodyStream stream;
+};
+
+// Read-only methods answered from the response cache. The key is the method
+// plus the parameters it reads, so member order, unrelated members and
+// params-versus-top-level placement all share an entry.
+std::optional<std::string> response_cache_key(std::string_view method, const alpha::JsonValue& call) {
+  if (method == "recipes.search") {
+    const alpha::SearchQuery query = search_query(call);
+    return std::string{method} + '\n' + std::to_string(query.text.size()) + ':' + query.text + query.category;
+  }
+  if (method == "genesis.spec" || method == "mining.template" || method == "node.status") {
+    return std::string{method};
+  }
+  return std::nullopt;
+}
+
+// node.status reports live peer counters, so its entries also age out with
+// each network tick.
+std::uint64_t response_generation(const CoreApi& api, std::string_view method) {
+  return method == "node.status" ? api.status_generation() : api.state_generation();
+}
+
+struct CacheCounters {
+  alpha::util::Counter* hits = nullptr;
+  alpha::util::Counter* misses = nullptr;
+};
+
+CacheCounters cache_counters(std::string_view method) {
+  thread_local std::map<std::string, CacheCounters, std::less<>> cache;
+  const auto it = cache.find(method);
+  if (it != cache.end()) {
+    return it->second;
+  }
+  const alpha::util::MetricLabel label{.key = "method", .value = method};
+  const CacheCounters counters{
+      .hits = &alpha::util::metrics().counter("gotsoup_rpc_cache_hits_total",
+                                              "Read-only RPC calls answered from the response cache.", label),
+      .misses = &alpha::util::metrics().counter("gotsoup_rpc_cache_misses_total",
+                                                "Read-only RPC calls computed and stored in the response cache.",
+                                                label),
+  };
+  cache.emplace(std::string{method}, counters);
+  return counters;
+}
+
+// Wraps a cached result in its response. Large results are streamed out of
+// the shared cache entry a slice at a time instead of being copied.
+CallOutcome cached_outcome(const std::string& id, alpha::ResponseCache::Body result, bool allow_stream) {
+  CallOutcome outcome;
+  if (allow_stream && result->size() >= kStreamCachedBytesAt) {
+    auto sent = std::make_shared<std::size_t>(0);
+    outcome.stream = [id, result = std::move(result), sent](std::string& out) {
+      if (*sent == 0) {
+        out += R"({"jsonrpc":"2.0","id":)";
+        out += id;
+        out += R"(,"result":)";
+      }
+      const std::size_t slice = std::min(kCachedSliceBytes, result->size() - *sent);
+      out.append(*result, *sent, slice);
+      *sent += slice;
+      if (*sent < result->size()) {
+        return true;
+      }
+      out.push_back('}');
+      return false;
+    };
+    return outcome;
+  }
+  alpha::JsonWriter out(outcome.body);
+  begin_rpc_result(out, id);
+  out.raw(*result);
+  out.end_object();
+  return outcome;
+}
+
+// A cacheable read. Hits take no API lock; a miss computes the result under
+// the lock, together with the generation it belongs to, and stores it.
+CallOutcome cached_call(CoreApi& api, std::mutex& api_mutex, const alpha::StratumServer& stratum,
+                        alpha::ResponseCache& cache, std::string_view method, const std::string& key,
+                        const alpha::JsonValue& call, const std::string& id, bool allow_stream) {
+  const CacheCounters counters = cache_counters(method);
+  alpha::ResponseCache::Body result = cache.find(key, response_generation(api, method));
+  if (result) {
+    counters.hits->add();
+    return cached_outcome(id, std::move(result), allow_stream);
+  }
+  counters.misses->add();
+  std::string json;
+  alpha::JsonWriter out(json);
+  std::uint64_t generation = 0;
+  if (method == "recipes.search") {
+    std::vector<alpha::RecipeSummary> recipes;
+    {
+      std::lock_guard lock(api_mutex);
+      generation = response_generation(api, method);
+      recipes = api.search(search_query(call));
+    }
+    if (recipes.size() > kMaxCachedRecipes) {
+      // Too large to keep; streamed while it is serialized, as before.
+      if (allow_stream) {
+        return {.stream = recipe_stream(id, std::move(recipes))};
+      }
+      CallOutcome outcome;
+      alpha::JsonWriter body(outcome.body);
+      begin_rpc_result(body, id);
+      write_recipes(body, recipes);
+      body.end_object();
+      return outcome;
+    }
+    write_recipes(out, recipes);
+  } else {
+    std::lock_guard lock(api_mutex);
+    generation = response_generation(api, method);
+    write_method_result(api, api_mutex, stratum, method, call, out);
+  }
+  result = std::make_shared<const std::string>(std::move(json));
+  cache.insert(key, generation, result);
+  return cached_outcome(id, std::move(result), allow_stream);
+}
+
+CallOutcome dispatch_call(CoreApi& api, std::mutex& api_mutex, const alpha::StratumServer& stratum,
+                          const alpha::MaintenanceScheduler& maintenance, alpha::ResponseCache& cache,
+                          const alpha::JsonValue& call, bool allow_stream) {
+  const std::string id = call_id(call);
+  const std::optional<alpha::JsonValue> method_value = call.find("method");
+  const std::optional<std::string> method = method_value.has_value() ? method_value->as_string() : std::nullopt;
+  if (!method.has_value()) {
+    return {.status = 400, .body = json_rpc_error(id, -32600, "Missing JSON-RPC method.")};
+  }
+  CallOutcome outcome;
+  alpha::JsonWriter out(outcome.body);
+  try {
+    if (const std::optional<std::string> key = response_cache_key(*method, call); key.has_value()) {
+      return cached_call(api, api_mutex, stratum, cache, *method, *key, call, id, allow_stream);
+    }
+    if (*method == "system.maintenance") {
+      // Scheduler stats have their own lock; a running job holding
+      // api_mutex does not delay this call.
+      begin_rpc_result(out, id);
+      write_maintenance(out, maintenance);
+    } else if (*method == "system.metrics") {
+      begin_rpc_result(out, id);
+      write_metrics(out);
+    } else {
+      begin_rpc_result(out, id);
+      if (!write_kdf_method_result(api, api_mutex, stratum, *method, call, out)) {
+        std::lock_guard lock(api_mutex);
+        write_method_result(api, api_mutex, stratum, *method, call, out);
+      }
     }
-    const std::size_t len_pos = request.find("Content-Length:");
-    std::size_t content_length = 0;
-    if (len_pos != std::string::npos) {
-      const std::size_t line_end = request.find("\r\n", len_pos);
-      const std::string value = trim_copy(request.substr(len_pos + 15, line_end - (len_pos + 15)));
-      content_length = static_cast<std::size_t>(std::strtoull(value.c_str(), nullptr, 10));
+    out.end_object();
+    return outcome;
+  } catch (const std::exception& ex) {
+    return {.status = 404, .body = json_rpc_error(id, -32601, ex.what())};
+  }
+}
+
+CallOutcome run_call(CoreApi& api, std::mutex& api_mutex, const alpha::StratumServer& stratum,
+                     const alpha::MaintenanceScheduler& maintenance, alpha::ResponseCache& cache,
+                     const alpha::JsonValue& call, bool allow_stream) {
+  const auto started = std::chrono::steady_clock::now();
+  CallOutcome outcome = dispatch_call(api, api_mutex, stratum, maintenance, cache, call, allow_stream);
+  const auto elapsed = std::chrono::steady_clock::now() - started;
+  std::string_view method = "unknown";
+  if (outcome.status != 404 && outcome.status != 400) {
+    method = call.find("method")->as_string_view().value_or("unknown");
+  }
+  rpc_latency(method).record(elapsed);
+  return outcome;
+}
+
+// A batch answers every call that has an id, in order, inside one 200
+// response. Each call takes the API lock on its own so a large batch does
+// not shut out other clients.
+alpha::HttpResponse run_batch(CoreApi& api, std::mutex& api_mutex, const alpha::StratumServer& stratum,
+                              const alpha::MaintenanceScheduler& maintenance, alpha::ResponseCache& cache,
+                              const alpha::JsonValue& batch) {
+  if (batch.size() == 0 || batch.size() > kMaxBatchCalls) {
+    return {.status = 400,
+            .body = json_rpc_error("null", -32600,
+                                   batch.size() == 0 ? "Empty batch."
+                                                     : "Batch exceeds " + std::to_string(kMaxBatchCalls) + " calls.")};
+  }
+  std::string body = "[";
+  for (std::size_t i = 0; i < batch.size(); ++i) {
+    const alpha::JsonValue call = batch.at(i);
+    std::string response;
+    if (!call.is_object()) {
+      response = json_rpc_error("null", -32600, "Batch entries must be objects.");
+    } else {
+      CallOutcome outcome = run_call(api, api_mutex, stratum, maintenance, cache, call, false);
+      if (!call.find("id").has_value()) {
+        continue;  // notification
+      }
+      response = std::move(outcome.body);
     }
-    if (request.size() >= header_end + 4U + content_length) {
-      return request;
+    if (body.size() > 1U) {
+      body.push_back(',');
     }
+    body += response;
+  }
+  if (body.size() == 1U) {
+    return {.status = 204};
+  }
+  body.push_back(']');
+  return {.body = std::move(body)};
+}
+
+alpha::HttpResponse handle_rpc_request(CoreApi& api, std::mutex& api_mutex, const alpha::StratumServer& stratum,
+                                       const alpha::MaintenanceScheduler& maintenance, alpha::ResponseCache& cache,
+                                       const alpha::HttpServer& rpc_server, const alpha::ChangeFeed& changes,
+                                       const std::string& token, const alpha::HttpRequest& request) {
+  if (request.method == "GET" && request.target == "/metrics") {
+    return authorized(request, token) ? metrics_response(rpc_server, cache) : require_auth_response("null");
+  }
+  if (request.method == "GET" && (request.target == "/events" || request.target.starts_with("/events?"))) {
+    return authorized(request, token) ? events_response(changes, request) : require_auth_response("null");
+  }
+  std::string parse_error;
+  const std::optional<alpha::JsonDocument> document = alpha::JsonDocument::parse(request.body, &parse_error);
+  const std::string id = document.has_value() && document->root().is_object() ? call_id(document->root()) : "null";
+  if (!authorized(request, token)) {
+    return require_auth_response(id);
+  }
+  if (!document.has_value()) {
+    return {.status = 400, .body = json_rpc_error("null", -32700, "Parse error: " + parse_error)};
+  }
+  const alpha::JsonValue root = document->root();
+  if (root.is_array()) {
+    return run_batch(api, api_mutex, stratum, maintenance, cache, root);
+  }
+  if (!root.is_object()) {
+    return {.status = 400, .body = json_rpc_error("null", -32600, "Request must be an object or a batch array.")};
   }
-  return request;
+  CallOutcome outcome = run_call(api, api_mutex, stratum, maintenance, cache, root, true);
+  return {.status = outcome.status, .body = std::move(outcome.body), .stream = std::move(outcome.stream)};
 }
 
 }  // namespace
@@ -478,6 +1051,12 @@ int main(int argc, char** argv) {
   const std::string token = ensure_token_file(args.token_file);
   std::filesystem::create_directories(args.data_dir);
 
+  // CoreApi is single-threaded; the Stratum adapter thread and KDF completions
+  // share it with the RPC loop. Declared before `api` so it outlives the KDF worker.
+  // The change feed is declared first too, since the store's listener
+  // publishes into it.
+  alpha::ChangeFeed changes;
+  std::mutex api_mutex;
   CoreApi api;
   const Result init = api.init({
       .app_data_dir = args.data_dir,
@@ -489,6 +1068,8 @@ int main(int argc, char** argv) {
       .alpha_test_mode = args.alpha_test_mode,
       .community_profile_path = args.community_profile,
       .production_swap = true,
+      .external_mining = args.external_mining,
+      .kdf_cache_ttl_seconds = args.kdf_cache_ttl_seconds,
       .p2p_mainnet_port = 4001,
       .p2p_testnet_port = 14001,
   });
@@ -496,72 +1077,128 @@ int main(int argc, char** argv) {
     std::cerr << "got-soupd init failed: " << init.message << "\n";
     return 1;
   }
+  // Runs under api_mutex on whichever thread changed the store.
+  api.set_change_listener([&changes](const alpha::StoreChange& change) { changes.publish(change); });
 
   std::cout << "got-soupd " << alpha::kAppVersion << " listening on " << args.bind_host << ":" << args.port << "\n";
   std::cout << "token file: " << args.token_file << "\n";
   std::cout << "auth mode: bearer token required for all RPC methods\n";
-
-  const int server_fd = ::socket(AF_INET, SOCK_STREAM, 0);
-  if (server_fd < 0) {
-    std::perror("socket");
-    return 1;
+  if (!args.rpc_socket.empty()) {
+    std::cout << "rpc socket: " << args.rpc_socket << " (mode 0600, no token needed)\n";
   }
-  int opt = 1;
-  ::setsockopt(server_fd, SOL_SOCKET, SO_REUSEADDR, &opt, sizeof(opt));
 
-  sockaddr_in addr{};
-  addr.sin_family = AF_INET;
-  addr.sin_port = htons(static_cast<std::uint16_t>(args.port));
-  if (::inet_pton(AF_INET, args.bind_host.c_str(), &addr.sin_addr) != 1) {
-    std::cerr << "invalid bind host: " << args.bind_host << "\n";
-    ::close(server_fd);
-    return 1;
+  alpha::StratumServer stratum;
+  if (args.stratum_port > 0) {
+    const Result stratum_start = stratum.start(
+        {
+            .bind_host = args.stratum_bind_host,
+            .port = static_cast<std::uint16_t>(args.stratum_port),
+            .share_difficulty_nibbles = args.stratum_share_nibbles,
+        },
+        [&api, &api_mutex] {
+          std::lock_guard lock(api_mutex);
+          return api.mining_jobs();
+        },
+        [&api, &api_mutex](const alpha::MiningJob& job, std::string_view nonce) {
+          std::lock_guard lock(api_mutex);
+          return api.submit_mining_solution(job.block_index, nonce);
+        });
+    std::cout << "stratum: " << stratum_start.message << "\n";
+    if (!args.external_mining) {
+      std::cout << "stratum: in-process mining still active; pass --external-mining to leave PoW to miners\n";
+    }
   }
-  if (::bind(server_fd, reinterpret_cast<sockaddr*>(&addr), sizeof(addr)) != 0) {
-    std::perror("bind");
-    ::close(server_fd);
-    return 1;
+
+  // Chain upkeep the RPC surface used to leave undone: block checks, reward
+  // claims, validation, peer sync and persistence, each on its own timer.
+  // Jobs only try api_mutex and back off when an RPC holds it, so
+  // maintenance waits for clients and never the other way round.
+  alpha::MaintenanceScheduler maintenance;
+  const auto with_api = [&api, &api_mutex](auto step) {
+    return [&api, &api_mutex, step]() -> std::optional<Result> {
+      std::unique_lock lock(api_mutex, std::try_to_lock);
+      if (!lock.owns_lock()) {
+        return std::nullopt;
+      }
+      return step(api);
+    };
+  };
+  const std::int64_t block_interval_seconds = std::max<std::int64_t>(static_cast<std::int64_t>(api.node_status().db.block_interval_seconds), 1);
+  const std::vector<alpha::MaintenanceJob> maintenance_jobs = {
+      {.name = "network",
+       .interval = std::chrono::milliseconds(250),
+       .jitter = 0.2,
+       .retry = std::chrono::milliseconds(20),
+       .run_at_start = true,
+       .run = with_api([](CoreApi& core) {
+         const std::size_t published = core.network_tick().size();
+         return Result::success("Published " + std::to_string(published) + " events.");
+       })},
+      {.name = "blocks",
+       .interval = std::chrono::seconds(std::max<std::int64_t>(block_interval_seconds / 5, 5)),
+       .run_at_start = true,
+       .run = with_api([](CoreApi& core) { return core.check_blocks(); })},
+      {.name = "rewards",
+       .interval = std::chrono::seconds(block_interval_seconds),
+       .run = with_api([](CoreApi& core) { return core.claim_block_rewards(); })},
+      {.name = "validation",
+       .interval = std::chrono::minutes(10),
+       .run = with_api([](CoreApi& core) { return core.run_backtest_validation(); })},
+      {.name = "peers",
+       .interval = std::chrono::minutes(5),
+       .run = with_api([](CoreApi& core) { return core.save_peers(); })},
+      {.name = "snapshot",
+       .interval = std::chrono::minutes(10),
+       .run = with_api([](CoreApi& core) { return core.write_snapshot(); })},
+  };
+  for (const alpha::MaintenanceJob& job : maintenance_jobs) {
+    (void)maintenance.add_job(job);
   }
-  if (::listen(server_fd, 16) != 0) {
-    std::perror("listen");
-    ::close(server_fd);
+
+  // CoreApi calls still take api_mutex one at a time; the pool keeps slow
+  // calls from stalling accepts, reads and keep-alive connections.
+  // Repeated read-only calls between state changes are served from memory.
+  alpha::ResponseCache response_cache;
+  alpha::HttpServer rpc_server;
+  const Result rpc_start = rpc_server.start(
+      {
+          .bind_host = args.bind_host,
+          .port = static_cast<std::uint16_t>(args.port),
+          .worker_threads = static_cast<std::size_t>(args.rpc_threads),
+          .unix_socket_path = args.rpc_socket,
+      },
+      [&](const alpha::HttpRequest& request) {
+        return handle_rpc_request(api, api_mutex, stratum, maintenance, response_cache, rpc_server, changes, token,
+                                  request);
+      });
+  if (!rpc_start.ok) {
+    std::cerr << "got-soupd: " << rpc_start.message << "\n";
+    stratum.stop();
     return 1;
   }
+  // Parked /events streams run again on each change, and on the heartbeat
+  // job so an idle stream still sends its keep-alive.
+  changes.set_publish_hook([&rpc_server] { rpc_server.wake_streams(); });
+  (void)maintenance.add_job({.name = "event-heartbeat",
+                             .interval = kEventHeartbeat,
+                             .run = [&rpc_server]() -> std::optional<Result> {
+                               rpc_server.wake_streams();
+                               return Result::success("Woke event streams.");
+                             }});
+  std::cout << "maintenance: " << maintenance.start().message << "\n";
 
   while (g_running) {
-    sockaddr_in client_addr{};
-    socklen_t client_len = sizeof(client_addr);
-    const int client_fd = ::accept(server_fd, reinterpret_cast<sockaddr*>(&client_addr), &client_len);
-    if (client_fd < 0) {
-      if (errno == EINTR) {
-        continue;
-      }
-      std::perror("accept");
-      break;
-    }
-
-    const std::string request = read_request_body(client_fd);
-    const std::string id = extract_json_id(request);
-    std::string response;
-    if (request.find("Authorization: Bearer " + token) == std::string::npos) {
-      response = require_auth_response(id);
-    } else {
-      const std::optional<std::string> method = extract_json_string(request, "method");
-      if (!method.has_value()) {
-        response = http_response(400, "Bad Request", json_rpc_error(id, -32600, "Missing JSON-RPC method."));
-      } else {
-        try {
-          response = http_response(200, "OK", json_rpc_result(id, method_result_json(api, *method, request)));
-        } catch (const std::exception& ex) {
-          response = http_response(404, "Not Found", json_rpc_error(id, -32601, ex.what()));
-        }
-      }
-    }
-
-    (void)::write(client_fd, response.data(), response.size());
-    ::close(client_fd);
+    std::this_thread::sleep_for(std::chrono::milliseconds(200));
   }
 
-  ::close(server_fd);
+  changes.set_publish_hook(nullptr);
+  rpc_server.stop();
+  maintenance.stop();
+  stratum.stop();
+  {
+    std::lock_guard lock(api_mutex);
+    (void)api.save_peers();
+    (void)api.write_snapshot();
+  }
   return 0;
 }
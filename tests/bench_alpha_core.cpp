@@ -0,0 +1,1171 @@
+// Microbenchmarks for core hot paths. Built alongside the unit tests but not
+// registered with ctest; run `alpha_benchmarks` manually and compare runs.
+#include <algorithm>
+#include <array>
+#include <chrono>
+#include <cstdint>
+#include <cstdlib>
+#include <filesystem>
+#include <iostream>
+#include <memory>
+#include <optional>
+#include <sstream>
+#include <string>
+#include <string_view>
+#include <thread>
+#include <unordered_set>
+#include <vector>
+
+#include "core/crypto/crypto.hpp"
+#include "core/p2p/compact_block.hpp"
+#include "core/p2p/compression.hpp"
+#include "core/p2p/node.hpp"
+#include "core/p2p/rolling_bloom.hpp"
+#include "core/p2p/tcp_transport.hpp"
+#include "core/p2p/wire.hpp"
+#include "core/rpc/http_server.hpp"
+#include "core/rpc/json.hpp"
+#include "core/rpc/response_cache.hpp"
+#include "core/service/alpha_service.hpp"
+#include "core/service/change_feed.hpp"
+#include "core/service/ingest_pipeline.hpp"
+#include "core/sim/network_sim.hpp"
+#include "core/util/canonical.hpp"
+#include "core/util/hash.hpp"
+#include "core/util/metrics.hpp"
+#include "core/util/socket.hpp"
+
+#ifndef _WIN32
+#include <sys/socket.h>
+#endif
+
+namespace {
+
+using Clock = std::chrono::steady_clock;
+
+template <typename Fn>
+void run_case(std::string_view name, std::size_t iterations, Fn&& fn) {
+  // Warm caches and buffers before timing.
+  for (std::size_t i = 0; i < iterations / 10U + 1U; ++i) {
+    fn(i);
+  }
+  const auto start = Clock::now();
+  for (std::size_t i = 0; i < iterations; ++i) {
+    fn(i);
+  }
+  const auto elapsed = std::chrono::duration<double, std::nano>(Clock::now() - start).count();
+  std::cout << name << ": " << (elapsed / static_cast<double>(iterations)) << " ns/op over " << iterations
+            << " iterations\n";
+}
+
+void require(bool condition, std::string_view what) {
+  if (!condition) {
+    std::cerr << "benchmark precondition failed: " << what << "\n";
+    std::exit(1);
+  }
+}
+
+// Compatibility-mode hash as formatted before the buffer-reusing path existed.
+std::string legacy_hash_bytes(std::string_view payload) {
+  std::uint64_t hash = 1469598103934665603ULL;
+  for (unsigned char c : payload) {
+    hash ^= static_cast<std::uint64_t>(c);
+    hash *= 1099511628211ULL;
+  }
+  std::ostringstream out;
+  out << std::hex << hash;
+  return out.str();
+}
+
+// got-soupd's field lookup before the JSON parser: a substring search of the
+// whole body per field.
+std::optional<std::string> legacy_extract_string(std::string_view body, std::string_view key) {
+  const std::string needle = "\"" + std::string{key} + "\"";
+  const std::size_t key_pos = body.find(needle);
+  if (key_pos == std::string_view::npos) {
+    return std::nullopt;
+  }
+  std::size_t cursor = body.find(':', key_pos + needle.size());
+  if (cursor == std::string_view::npos) {
+    return std::nullopt;
+  }
+  for (++cursor; cursor < body.size() && body[cursor] == ' '; ++cursor) {
+  }
+  if (cursor >= body.size() || body[cursor] != '"') {
+    return std::nullopt;
+  }
+  std::string out;
+  bool escape = false;
+  for (++cursor; cursor < body.size(); ++cursor) {
+    const char c = body[cursor];
+    if (escape) {
+      out.push_back(c == 'n' ? '\n' : c);
+      escape = false;
+    } else if (c == '\\') {
+      escape = true;
+    } else if (c == '"') {
+      return out;
+    } else {
+      out.push_back(c);
+    }
+  }
+  return std::nullopt;
+}
+
+std::vector<std::string> sample_payloads(const alpha::CryptoEngine& crypto, std::size_t count) {
+  std::vector<std::string> payloads;
+  payloads.reserve(count);
+  for (std::size_t i = 0; i < count; ++i) {
+    payloads.push_back(alpha::util::canonical_join({
+        {"title", "Benchmark recipe " + std::to_string(i)},
+        {"markdown", std::string(256U + (i % 64U), 'x')},
+        {"author_cid", crypto.identity().cid.value},
+        {"author_pubkey", crypto.identity().public_key},
+        {"unix_ts", std::to_string(1700000000U + i)},
+    }));
+  }
+  return payloads;
+}
+
+void bench_crypto_engine() {
+  const auto dir = std::filesystem::temp_directory_path() / "got-soup-bench" / "crypto";
+  std::error_code ec;
+  std::filesystem::remove_all(dir, ec);
+  std::filesystem::create_directories(dir, ec);
+
+  alpha::CryptoEngine crypto;
+  require(crypto.initialize(dir.string(), "bench-passphrase", true).ok, "crypto initialize");
+  const std::vector<std::string> payloads = sample_payloads(crypto, 1024);
+  const std::string& public_key = crypto.identity().public_key;
+  constexpr std::size_t kIterations = 200000;
+
+  std::string scratch;
+  for (const auto& payload : payloads) {
+    crypto.content_id_into(payload, scratch);
+    require(scratch == crypto.content_id(payload), "content_id_into matches content_id");
+    if (!crypto.production_mode_active()) {
+      require(crypto.hash_bytes(payload) == legacy_hash_bytes(payload), "hash_bytes is bit-identical");
+      require(crypto.sign(payload) == legacy_hash_bytes(payload + "::" + public_key), "sign is bit-identical");
+    }
+  }
+
+  std::size_t sink = 0;
+  if (!crypto.production_mode_active()) {
+    run_case("content_id legacy (ostringstream + concat)", kIterations, [&](std::size_t i) {
+      sink += ("evt-" + legacy_hash_bytes(payloads[i % payloads.size()])).size();
+    });
+    run_case("sign legacy (ostringstream + concat)", kIterations, [&](std::size_t i) {
+      sink += legacy_hash_bytes(payloads[i % payloads.size()] + "::" + public_key).size();
+    });
+  }
+  run_case("content_id", kIterations, [&](std::size_t i) {
+    sink += crypto.content_id(payloads[i % payloads.size()]).size();
+  });
+  run_case("content_id_into", kIterations, [&](std::size_t i) {
+    crypto.content_id_into(payloads[i % payloads.size()], scratch);
+    sink += scratch.size();
+  });
+  run_case("sign", kIterations, [&](std::size_t i) {
+    sink += crypto.sign(payloads[i % payloads.size()]).size();
+  });
+  run_case("sign_into", kIterations, [&](std::size_t i) {
+    (void)crypto.sign_into(payloads[i % payloads.size()], scratch);
+    sink += scratch.size();
+  });
+
+  std::vector<std::string> signatures;
+  run_case("sign_many (1024 payloads)", kIterations / payloads.size(), [&](std::size_t) {
+    require(crypto.sign_many(payloads, signatures), "sign_many");
+    sink += signatures.back().size();
+  });
+  std::cout << "checksum: " << sink << "\n";
+}
+
+
+std::uint16_t free_loopback_port() {
+  int fd = alpha::util::kInvalidSocket;
+  require(alpha::util::listen_tcp("127.0.0.1", 0, 1, fd).ok, "reserve loopback port");
+  const std::uint16_t port = alpha::util::local_port(fd);
+  alpha::util::close_socket(fd);
+  return port;
+}
+
+std::vector<alpha::EventEnvelope> gossip_events(std::size_t count) {
+  std::vector<alpha::EventEnvelope> events;
+  events.reserve(count);
+  for (std::size_t i = 0; i < count; ++i) {
+    const std::string payload = alpha::util::canonical_join({
+        {"title", "Gossip recipe " + std::to_string(i)},
+        {"markdown", std::string(480U + (i % 64U), 'g')},
+    });
+    events.push_back({
+        .event_id = "evt-bench-" + std::to_string(i),
+        .kind = alpha::EventKind::RecipeCreated,
+        .author_cid = "cid-bench-origin",
+        .unix_ts = 1700000000 + static_cast<std::int64_t>(i),
+        .payload = payload,
+        .signature = std::string(128, 's'),
+    });
+  }
+  return events;
+}
+
+// Every node pushes each new event body to all other peers, as the transport
+// did before inventory gossip. Used as the bandwidth baseline.
+std::uint64_t full_push_bytes(const std::vector<alpha::EventEnvelope>& events, std::size_t node_count) {
+  std::vector<std::unique_ptr<alpha::TcpTransport>> nodes;
+  std::vector<std::unordered_set<std::string>> seen(node_count);
+  for (std::size_t i = 0; i < node_count; ++i) {
+    nodes.push_back(std::make_unique<alpha::TcpTransport>());
+    require(nodes.back()->start({.bind_host = "127.0.0.1"}).ok, "full-push transport start");
+  }
+  for (std::size_t i = 0; i < node_count; ++i) {
+    for (std::size_t j = i + 1U; j < node_count; ++j) {
+      alpha::PeerId peer = 0;
+      require(nodes[i]->dial("127.0.0.1:" + std::to_string(nodes[j]->bound_port()), peer).ok, "full-push dial");
+    }
+  }
+  for (int round = 0; round < 200; ++round) {
+    std::size_t links = 0;
+    for (auto& node : nodes) {
+      (void)node->poll(1);
+      links += node->peer_ids().size();
+    }
+    if (links == node_count * (node_count - 1U)) {
+      break;
+    }
+  }
+
+  for (const auto& event : events) {
+    seen[0].insert(event.event_id);
+    for (const alpha::PeerId peer : nodes[0]->peer_ids()) {
+      nodes[0]->send(peer, alpha::wire::MessageType::Events, alpha::wire::encode_events({event}));
+    }
+  }
+  const std::size_t expected = events.size() * node_count;
+  for (int round = 0; round < 20000; ++round) {
+    std::size_t delivered = 0;
+    for (std::size_t i = 0; i < node_count; ++i) {
+      for (const auto& frame : nodes[i]->poll(0).frames) {
+        const auto decoded = alpha::wire::decode_events(frame.body);
+        require(decoded.has_value(), "full-push decode");
+        for (const auto& event : *decoded) {
+          if (!seen[i].insert(event.event_id).second) {
+            continue;
+          }
+          for (const alpha::PeerId peer : nodes[i]->peer_ids()) {
+            if (peer != frame.peer) {
+              nodes[i]->send(peer, alpha::wire::MessageType::Events, alpha::wire::encode_events({event}));
+            }
+          }
+        }
+      }
+      delivered += seen[i].size();
+    }
+    if (delivered == expected) {
+      break;
+    }
+    std::this_thread::sleep_for(std::chrono::microseconds(200));
+  }
+
+  std::uint64_t bytes = 0;
+  for (std::size_t i = 0; i < node_count; ++i) {
+    require(seen[i].size() == events.size(), "full-push delivered every event");
+    bytes += nodes[i]->stats().bytes_out;
+  }
+  return bytes;
+}
+
+std::uint64_t inventory_gossip_bytes(const std::vector<alpha::EventEnvelope>& events, std::size_t node_count) {
+  std::vector<std::uint16_t> ports;
+  for (std::size_t i = 0; i < node_count; ++i) {
+    ports.push_back(free_loopback_port());
+  }
+  std::vector<std::unique_ptr<alpha::P2PNode>> nodes;
+  std::vector<std::size_t> received(node_count, 0);
+  for (std::size_t i = 0; i < node_count; ++i) {
+    std::vector<std::string> seeds;
+    for (std::size_t j = 0; j < node_count; ++j) {
+      if (j != i) {
+        seeds.push_back("127.0.0.1:" + std::to_string(ports[j]));
+      }
+    }
+    nodes.push_back(std::make_unique<alpha::P2PNode>());
+    // Raw frames, like the full-push baseline; bench_wire_compression covers
+    // what compression adds on top.
+    nodes.back()->set_compression(false);
+    require(nodes.back()
+                ->start(seeds, {.host = "127.0.0.1", .port = 4444}, "cid-bench-" + std::to_string(i), true,
+                        ports[i], "testnet")
+                .ok,
+            "gossip node start");
+  }
+  const auto tick_all = [&] {
+    for (std::size_t i = 0; i < node_count; ++i) {
+      (void)nodes[i]->sync_tick();
+      for (const auto& event : nodes[i]->take_received_events()) {
+        if (nodes[i]->ingest_remote_event(event)) {
+          ++received[i];
+          nodes[i]->relay_event(event);
+        }
+      }
+    }
+  };
+  for (int round = 0; round < 400; ++round) {
+    tick_all();
+    std::size_t links = 0;
+    for (const auto& node : nodes) {
+      links += node->runtime_status().connected_peers;
+    }
+    if (links == node_count * (node_count - 1U)) {
+      break;
+    }
+    std::this_thread::sleep_for(std::chrono::milliseconds(1));
+  }
+  std::uint64_t handshake_bytes = 0;
+  for (const auto& node : nodes) {
+    handshake_bytes += node->runtime_status().bytes_out;
+  }
+
+  for (const auto& event : events) {
+    nodes[0]->queue_local_event(event);
+  }
+  for (int round = 0; round < 20000; ++round) {
+    tick_all();
+    std::size_t delivered = 0;
+    for (std::size_t i = 1; i < node_count; ++i) {
+      delivered += received[i];
+    }
+    if (delivered == events.size() * (node_count - 1U)) {
+      break;
+    }
+    std::this_thread::sleep_for(std::chrono::microseconds(200));
+  }
+
+  std::uint64_t bytes = 0;
+  for (std::size_t i = 0; i < node_count; ++i) {
+    require(i == 0 || received[i] == events.size(), "gossip delivered every event");
+    bytes += nodes[i]->runtime_status().bytes_out;
+  }
+  return bytes - handshake_bytes;
+}
+
+void bench_event_propagation() {
+#ifndef _WIN32
+  constexpr std::size_t kNodes = 6;
+  const std::vector<alpha::EventEnvelope> events = gossip_events(200);
+  std::uint64_t body_bytes = 0;
+  for (const auto& event : events) {
+    body_bytes += alpha::wire::kFrameHeaderBytes + alpha::wire::encode_events({event}).size();
+  }
+  // One body per receiving node is the unavoidable cost; the rest is redundant.
+  const std::uint64_t useful = body_bytes * (kNodes - 1U);
+  const auto report = [&](std::string_view name, std::uint64_t bytes) {
+    const double per_event = static_cast<double>(bytes) / static_cast<double>(events.size());
+    const double redundant =
+        static_cast<double>(bytes > useful ? bytes - useful : 0U) / static_cast<double>(events.size());
+    std::cout << name << ": " << per_event << " bytes/event on the wire, " << redundant
+              << " redundant bytes/event (" << kNodes << "-node loopback mesh)\n";
+    return redundant;
+  };
+  const double push = report("event propagation full push", full_push_bytes(events, kNodes));
+  const double gossip = report("event propagation inventory gossip", inventory_gossip_bytes(events, kNodes));
+  std::cout << "redundant byte reduction: " << (gossip > 0.0 ? push / gossip : 0.0) << "x\n";
+#endif
+}
+
+// Events shaped like make_event() output: canonical keys and chain fields
+// repeat, while ids, keys, signatures and text do not.
+std::vector<alpha::EventEnvelope> canonical_events(std::size_t count) {
+  constexpr std::array<std::string_view, 4> kWords{"simmer ", "tomato ", "basil ", "stock "};
+  std::vector<alpha::EventEnvelope> events;
+  events.reserve(count);
+  for (std::size_t i = 0; i < count; ++i) {
+    const std::string author = "cid-" + alpha::util::sha256_like_hex("author-" + std::to_string(i % 16U)).substr(0, 16);
+    std::string markdown;
+    for (std::size_t w = 0; w < 24U + i % 40U; ++w) {
+      markdown += kWords[(i * 7U + w * 3U) % kWords.size()];
+    }
+    const std::string ts = std::to_string(1790000000 + i);
+    const std::string id = "evt-" + alpha::util::sha256_like_hex("event-" + std::to_string(i));
+    events.push_back({
+        .event_id = id,
+        .kind = alpha::EventKind::RecipeCreated,
+        .author_cid = author,
+        .unix_ts = 1790000000 + static_cast<std::int64_t>(i),
+        .payload = alpha::util::canonical_join({
+            {"author_cid", author},
+            {"author_pubkey", alpha::util::sha256_like_hex("pub-" + author)},
+            {"category", "Soup"},
+            {"chain_id", "got-soup-mainnet-v3"},
+            {"community_id", "recipes"},
+            {"core_topic", "0"},
+            {"kind", "0"},
+            {"markdown", markdown},
+            {"menu_segment", "community-post"},
+            {"network_id", "mainnet"},
+            {"post_value", "0"},
+            {"recipe_id", "rcp-" + alpha::util::sha256_like_hex("recipe-" + std::to_string(i)).substr(0, 16)},
+            {"title", "Recipe " + std::to_string(i)},
+            {"unix_ts", ts},
+        }),
+        .signature = alpha::util::sha256_like_hex("sig-a-" + id) + alpha::util::sha256_like_hex("sig-b-" + id),
+    });
+  }
+  return events;
+}
+
+void bench_wire_compression() {
+  const std::vector<alpha::EventEnvelope> events = canonical_events(1000);
+  for (const std::size_t batch : {std::size_t{1}, std::size_t{10}, std::size_t{100}, std::size_t{1000}}) {
+    std::uint64_t raw_bytes = 0;
+    std::uint64_t wire_bytes = 0;
+    std::vector<std::string> bodies;
+    for (std::size_t offset = 0; offset < events.size(); offset += batch) {
+      const std::vector<alpha::EventEnvelope> chunk(events.begin() + static_cast<std::ptrdiff_t>(offset),
+                                                    events.begin() + static_cast<std::ptrdiff_t>(offset + batch));
+      bodies.push_back(alpha::wire::encode_events(chunk));
+      const auto packed = alpha::wire::encode_compressed(alpha::wire::MessageType::Events, bodies.back());
+      raw_bytes += alpha::wire::kFrameHeaderBytes + bodies.back().size();
+      wire_bytes += alpha::wire::kFrameHeaderBytes + (packed.has_value() ? packed->size() : bodies.back().size());
+    }
+    std::cout << "wire bytes/event, " << batch << " per frame: raw "
+              << static_cast<double>(raw_bytes) / static_cast<double>(events.size()) << ", compressed "
+              << static_cast<double>(wire_bytes) / static_cast<double>(events.size()) << " ("
+              << 100.0 * (1.0 - static_cast<double>(wire_bytes) / static_cast<double>(raw_bytes)) << "% saved)\n";
+  }
+
+  const std::string body = alpha::wire::encode_events(
+      std::vector<alpha::EventEnvelope>(events.begin(), events.begin() + 100));
+  const std::string packed = *alpha::wire::encode_compressed(alpha::wire::MessageType::Events, body);
+  std::size_t sink = 0;
+  run_case("compress 100-event frame", 200, [&](std::size_t) {
+    sink += alpha::wire::encode_compressed(alpha::wire::MessageType::Events, body)->size();
+  });
+  run_case("decompress 100-event frame", 200, [&](std::size_t) {
+    sink += alpha::wire::decode_compressed(packed)->second.size();
+  });
+  require(sink > 0, "compression round trips");
+}
+
+void bench_seen_filter() {
+  // A long-lived relay's seen set: 1M content ids (64 hex chars) held in the
+  // old unbounded set versus the default 1 MiB rolling filter.
+  constexpr std::size_t kIds = 1'000'000;
+  std::vector<std::string> ids;
+  ids.reserve(kIds + 100'000U);
+  for (std::size_t i = 0; i < kIds + 100'000U; ++i) {
+    ids.push_back(alpha::util::sha256_like_hex("seen-" + std::to_string(i)));
+  }
+
+  std::unordered_set<std::string> set;
+  alpha::RollingBloomFilter filter;
+  run_case("seen set insert", kIds, [&](std::size_t i) { set.insert(ids[i % kIds]); });
+  run_case("seen filter insert", kIds, [&](std::size_t i) { filter.insert(ids[i % kIds]); });
+  std::size_t hits = 0;
+  run_case("seen set contains", kIds, [&](std::size_t i) { hits += set.contains(ids[i % kIds]) ? 1U : 0U; });
+  run_case("seen filter contains", kIds, [&](std::size_t i) { hits += filter.contains(ids[i % kIds]) ? 1U : 0U; });
+  require(hits > 0, "seen lookups hit");
+
+  // Node, cached hash and string heap per entry plus the bucket array.
+  std::size_t set_bytes = set.bucket_count() * sizeof(void*);
+  for (const auto& id : set) {
+    set_bytes += sizeof(std::string) + 2U * sizeof(void*) + id.capacity() + 1U;
+  }
+  std::size_t false_positives = 0;
+  for (std::size_t i = kIds; i < ids.size(); ++i) {
+    false_positives += filter.contains(ids[i]) ? 1U : 0U;
+  }
+  const alpha::RollingBloomStats stats = filter.stats();
+  std::cout << "seen set memory: ~" << set_bytes / 1024U << " KiB for " << set.size() << " ids (unbounded)\n";
+  std::cout << "seen filter memory: " << stats.bytes / 1024U << " KiB, window " << stats.window << " ids, "
+            << stats.hash_functions << " hashes, " << stats.rotations << " rotations\n";
+  std::cout << "seen filter false positives: " << false_positives << " of " << ids.size() - kIds
+            << " unseen ids (target " << filter.config().false_positive_rate << ")\n";
+}
+
+}  // namespace
+
+void bench_compact_block_relay() {
+  // One 1000-event block announced to a peer that already holds 990 of its
+  // events: full id-list header versus compact block plus the missing bodies.
+  const std::vector<alpha::EventEnvelope> events = canonical_events(1000);
+  alpha::Store::BlockRecord block{.index = 42, .opened_unix = 1790000000, .confirmed = true};
+  std::vector<const alpha::EventEnvelope*> bodies;
+  for (const auto& event : events) {
+    block.event_ids.push_back(event.event_id);
+    bodies.push_back(&event);
+  }
+  block.merkle_root = alpha::Store::block_merkle_root(events);
+  block.content_hash = alpha::Store::block_content_hash(events);
+  block.block_hash = alpha::util::sha256_like_hex("bench-block");
+
+  const std::string header = alpha::wire::encode_headers(std::vector<alpha::Store::BlockRecord>{block});
+  const alpha::CompactBlock compact = alpha::make_compact_block(block, bodies, 7);
+  const std::string compact_body = alpha::wire::encode_compact_block(compact);
+  std::vector<std::string> candidates;
+  std::vector<alpha::EventEnvelope> missing;
+  for (std::size_t i = 0; i < events.size(); ++i) {
+    if (i % 100U == 0) {
+      missing.push_back(events[i]);
+    } else {
+      candidates.push_back(events[i].event_id);
+    }
+  }
+  const std::string fetched = alpha::wire::encode_block_events(block.block_hash, missing);
+  std::cout << "block announce bytes, 1000 events: full ids " << header.size() << ", compact "
+            << compact_body.size() << " + " << fetched.size() << " for 10 missing bodies\n";
+
+  std::size_t sink = 0;
+  run_case("compact block reconstruct (1000 events, 10 missing)", 50, [&](std::size_t) {
+    alpha::CompactBlockAssembly assembly(*alpha::wire::decode_compact_block(compact_body), candidates);
+    for (const auto& event : missing) {
+      sink += assembly.accept(event) ? 1U : 0U;
+    }
+    sink += assembly.complete() ? 1U : 0U;
+  });
+  require(sink > 0, "compact block reconstructs");
+}
+
+std::int64_t percentile_us(std::vector<std::int64_t> samples, double fraction) {
+  if (samples.empty()) {
+    return 0;
+  }
+  std::ranges::sort(samples);
+  const auto index = static_cast<std::size_t>(fraction * static_cast<double>(samples.size() - 1U));
+  return samples[index];
+}
+
+std::unique_ptr<alpha::AlphaService> ingest_service(std::string_view name) {
+  const auto dir = std::filesystem::temp_directory_path() / "got-soup-bench" / "ingest" / name;
+  std::error_code ec;
+  std::filesystem::remove_all(dir, ec);
+  auto service = std::make_unique<alpha::AlphaService>();
+  require(service
+              ->init({
+                  .app_data_dir = dir.string(),
+                  .passphrase = "bench-passphrase",
+                  .mode = alpha::AnonymityMode::Tor,
+                  .alpha_test_mode = true,
+                  .community_profile_path = "recipes",
+                  .production_swap = true,
+                  .p2p_testnet_port = free_loopback_port(),
+                  .p2p_network_thread = false,
+              })
+              .ok,
+          "ingest service init");
+  const std::string backup = (dir / "backup" / "identity.dat").string();
+  require(service->export_key_backup(backup, "bench-backup", "bench-salt").ok, "ingest backup export");
+  require(service->verify_key_backup(backup, "bench-backup").ok, "ingest backup verify");
+  return service;
+}
+
+void bench_ingest_pipeline() {
+  // A burst of signed remote recipes arriving at once, applied one event at
+  // a time (the old per-delivery path) versus in 256-event frames through a
+  // batched verify and store apply. Latency runs from the start of the burst
+  // to the moment each event is in the store.
+  constexpr std::size_t kBurst = 250;
+  constexpr std::size_t kFrame = 256;
+  std::vector<alpha::EventEnvelope> burst;
+  {
+    const auto source = ingest_service("source");
+    const std::int64_t start_unix = alpha::util::unix_timestamp_now() - static_cast<std::int64_t>(kBurst) - 60;
+    for (std::size_t i = 0; i < kBurst; ++i) {
+      // Posts from one author need distinct seconds; backdate them so the
+      // burst stays inside the drift limits.
+      alpha::util::set_virtual_clock((start_unix + static_cast<std::int64_t>(i)) * 1000);
+      require(source
+                  ->create_recipe({
+                      .category = "Soup",
+                      .title = "Burst recipe " + std::to_string(i),
+                      .markdown = std::string(256U + i % 64U, 'x'),
+                  })
+                  .ok,
+              "burst recipe");
+    }
+    burst = source->sync_tick();
+    alpha::util::set_virtual_clock(std::nullopt);
+  }
+  require(burst.size() == kBurst, "burst published");
+
+  const auto report = [&](std::string_view name, const std::vector<std::int64_t>& latencies, std::int64_t total_us) {
+    std::cout << "ingest " << name << ": " << kBurst << " events in " << total_us / 1000 << " ms ("
+              << (static_cast<double>(kBurst) * 1e6 / static_cast<double>(std::max<std::int64_t>(total_us, 1)))
+              << " events/s), latency p50 " << percentile_us(latencies, 0.5) / 1000 << " ms, p99 "
+              << percentile_us(latencies, 0.99) / 1000 << " ms, max " << percentile_us(latencies, 1.0) / 1000
+              << " ms\n";
+  };
+  const auto elapsed_us = [](Clock::time_point start) {
+    return std::chrono::duration_cast<std::chrono::microseconds>(Clock::now() - start).count();
+  };
+
+  {
+    const auto target = ingest_service("per-event");
+    std::vector<std::int64_t> latencies;
+    const auto start = Clock::now();
+    for (const auto& event : burst) {
+      require(target->ingest_remote_event(event).ok, "per-event ingest");
+      latencies.push_back(elapsed_us(start));
+    }
+    report("per event", latencies, elapsed_us(start));
+  }
+  {
+    const auto target = ingest_service("batched");
+    std::vector<std::int64_t> latencies;
+    const auto start = Clock::now();
+    for (std::size_t offset = 0; offset < burst.size(); offset += kFrame) {
+      const std::vector<alpha::EventEnvelope> frame(
+          burst.begin() + static_cast<std::ptrdiff_t>(offset),
+          burst.begin() + static_cast<std::ptrdiff_t>(std::min(offset + kFrame, burst.size())));
+      for (const alpha::Result& result : target->ingest_remote_events(frame)) {
+        require(result.ok, "batched ingest");
+      }
+      latencies.insert(latencies.end(), frame.size(), elapsed_us(start));
+    }
+    report("batched frames", latencies, elapsed_us(start));
+  }
+
+  // The pre-store stages alone, on their own threads versus inline.
+  alpha::CryptoEngine crypto;
+  const auto dir = std::filesystem::temp_directory_path() / "got-soup-bench" / "ingest" / "stages";
+  std::error_code ec;
+  std::filesystem::remove_all(dir, ec);
+  require(crypto.initialize(dir.string(), "bench-passphrase", true).ok, "stage crypto init");
+  for (const bool threaded : {false, true}) {
+    alpha::SignatureVerifier verifier(crypto);
+    alpha::IngestPipeline pipeline(verifier, {}, {.threaded = threaded});
+    std::vector<std::int64_t> latencies;
+    const auto start = Clock::now();
+    for (std::size_t offset = 0; offset < burst.size(); offset += kFrame) {
+      std::vector<alpha::EventEnvelope> frame(
+          burst.begin() + static_cast<std::ptrdiff_t>(offset),
+          burst.begin() + static_cast<std::ptrdiff_t>(std::min(offset + kFrame, burst.size())));
+      require(pipeline.submit(frame) > 0, "stage submit");
+    }
+    std::size_t drained = 0;
+    while (drained < burst.size()) {
+      const alpha::IngestBatch batch = pipeline.drain(burst.size());
+      require(batch.rejected.empty(), "stage verify");
+      drained += batch.events.size();
+      latencies.insert(latencies.end(), batch.events.size(), elapsed_us(start));
+      if (batch.events.empty()) {
+        pipeline.wait_idle();
+      }
+    }
+    report(threaded ? "stages threaded" : "stages inline", latencies, elapsed_us(start));
+  }
+}
+
+#ifndef _WIN32
+// Sends one JSON-RPC POST and reads the response off a blocking socket;
+// false once the server hung up.
+bool http_round_trip(int fd, const std::string& request, std::string& buffer) {
+  if (!alpha::util::send_all(fd, request)) {
+    return false;
+  }
+  std::array<char, 4096> chunk{};
+  while (true) {
+    const std::size_t head_end = buffer.find("\r\n\r\n");
+    if (head_end != std::string::npos) {
+      const std::size_t length_at = buffer.find("Content-Length: ") + 16U;
+      const std::size_t length = std::strtoul(buffer.c_str() + length_at, nullptr, 10);
+      if (buffer.size() >= head_end + 4U + length) {
+        buffer.erase(0, head_end + 4U + length);
+        return true;
+      }
+    }
+    const ssize_t n = ::recv(fd, chunk.data(), chunk.size(), 0);
+    if (n <= 0) {
+      return false;
+    }
+    buffer.append(chunk.data(), static_cast<std::size_t>(n));
+  }
+}
+
+bool frame_round_trip(int fd, const std::string& request, std::string& buffer) {
+  if (!alpha::util::send_all(fd, request)) {
+    return false;
+  }
+  std::array<char, 4096> chunk{};
+  while (true) {
+    const std::optional<std::size_t> length = alpha::rpc_frame_length(buffer);
+    if (length.has_value() && buffer.size() >= alpha::kRpcFrameHeaderBytes + *length) {
+      buffer.erase(0, alpha::kRpcFrameHeaderBytes + *length);
+      return true;
+    }
+    const ssize_t n = ::recv(fd, chunk.data(), chunk.size(), 0);
+    if (n <= 0) {
+      return false;
+    }
+    buffer.append(chunk.data(), static_cast<std::size_t>(n));
+  }
+}
+#endif
+
+void bench_http_rpc() {
+#ifndef _WIN32
+  // Small JSON-RPC calls against a trivial handler, so the numbers are the
+  // server's own overhead: a fresh connection per call (the old daemon's
+  // only mode) versus keep-alive, then several keep-alive clients at once.
+  alpha::HttpServer server;
+  require(server
+              .start({.bind_host = "127.0.0.1", .port = 0, .worker_threads = 4},
+                     [](const alpha::HttpRequest& request) {
+                       return alpha::HttpResponse{.body = R"({"jsonrpc":"2.0","id":1,"result":)" +
+                                                          std::to_string(request.body.size()) + "}"};
+                     })
+              .ok,
+          "http server start");
+  const std::string body = R"({"jsonrpc":"2.0","id":1,"method":"node.status","params":{}})";
+  const auto request = [&body](bool keep_alive) {
+    return "POST /rpc HTTP/1.1\r\nHost: 127.0.0.1\r\nContent-Type: application/json\r\nContent-Length: " +
+           std::to_string(body.size()) + (keep_alive ? "\r\n\r\n" : "\r\nConnection: close\r\n\r\n") + body;
+  };
+  const auto report = [](std::string_view name, std::size_t calls, std::int64_t total_us,
+                         std::vector<std::int64_t>& latencies) {
+    std::cout << "http rpc " << name << ": " << (static_cast<double>(calls) * 1e6 / static_cast<double>(total_us))
+              << " calls/s, latency p50 " << percentile_us(latencies, 0.5) << " us, p99 "
+              << percentile_us(latencies, 0.99) << " us\n";
+  };
+
+  for (const bool keep_alive : {false, true}) {
+    constexpr std::size_t kCalls = 5000;
+    const std::string wire = request(keep_alive);
+    std::vector<std::int64_t> latencies;
+    latencies.reserve(kCalls);
+    int fd = alpha::util::kInvalidSocket;
+    std::string buffer;
+    const auto start = Clock::now();
+    for (std::size_t i = 0; i < kCalls; ++i) {
+      const auto call_start = Clock::now();
+      if (fd == alpha::util::kInvalidSocket) {
+        require(alpha::util::connect_tcp("127.0.0.1", server.bound_port(), false, fd).ok, "http connect");
+        buffer.clear();
+      }
+      require(http_round_trip(fd, wire, buffer), "http round trip");
+      if (!keep_alive) {
+        alpha::util::close_socket(fd);
+      }
+      latencies.push_back(
+          std::chrono::duration_cast<std::chrono::microseconds>(Clock::now() - call_start).count());
+    }
+    alpha::util::close_socket(fd);
+    const auto total = std::chrono::duration_cast<std::chrono::microseconds>(Clock::now() - start).count();
+    report(keep_alive ? "keep-alive, 1 client" : "connection per call, 1 client", kCalls, total, latencies);
+  }
+
+  constexpr std::size_t kClients = 8;
+  constexpr std::size_t kCallsPerClient = 2000;
+  std::vector<std::vector<std::int64_t>> per_client(kClients);
+  std::vector<std::thread> clients;
+  const std::string wire = request(true);
+  const auto start = Clock::now();
+  for (std::size_t c = 0; c < kClients; ++c) {
+    clients.emplace_back([&, c] {
+      int fd = alpha::util::kInvalidSocket;
+      require(alpha::util::connect_tcp("127.0.0.1", server.bound_port(), false, fd).ok, "http connect");
+      std::string buffer;
+      for (std::size_t i = 0; i < kCallsPerClient; ++i) {
+        const auto call_start = Clock::now();
+        require(http_round_trip(fd, wire, buffer), "http round trip");
+        per_client[c].push_back(
+            std::chrono::duration_cast<std::chrono::microseconds>(Clock::now() - call_start).count());
+      }
+      alpha::util::close_socket(fd);
+    });
+  }
+  for (auto& client : clients) {
+    client.join();
+  }
+  const auto total = std::chrono::duration_cast<std::chrono::microseconds>(Clock::now() - start).count();
+  std::vector<std::int64_t> latencies;
+  for (const auto& samples : per_client) {
+    latencies.insert(latencies.end(), samples.begin(), samples.end());
+  }
+  report("keep-alive, 8 clients", kClients * kCallsPerClient, total, latencies);
+  server.stop();
+#endif
+}
+
+void bench_unix_socket_rpc() {
+#ifndef _WIN32
+  // One local client making small calls against a trivial handler: HTTP
+  // with a bearer token over TCP loopback (the desktop shells' path), HTTP
+  // over the unix socket, and length-prefixed frames over the unix socket.
+  const std::string path = (std::filesystem::temp_directory_path() / "got-soup-bench-rpc.sock").string();
+  alpha::HttpServer server;
+  require(server
+              .start({.bind_host = "127.0.0.1", .port = 0, .worker_threads = 4, .unix_socket_path = path},
+                     [](const alpha::HttpRequest& request) {
+                       return alpha::HttpResponse{.body = R"({"jsonrpc":"2.0","id":1,"result":)" +
+                                                          std::to_string(request.body.size()) + "}"};
+                     })
+              .ok,
+          "unix rpc server start");
+  const std::string body = R"({"jsonrpc":"2.0","id":1,"method":"node.status","params":{}})";
+  const std::string http = "POST /rpc HTTP/1.1\r\nHost: 127.0.0.1\r\nContent-Type: application/json\r\n"
+                           "Authorization: Bearer " + std::string(64, 'f') + "\r\nContent-Length: " +
+                           std::to_string(body.size()) + "\r\n\r\n" + body;
+  std::string framed;
+  alpha::append_rpc_frame(framed, body);
+
+  struct Case {
+    std::string_view name;
+    bool unix_socket;
+    bool frames;
+  };
+  for (const Case& mode : {Case{"tcp loopback, http", false, false}, Case{"unix socket, http", true, false},
+                           Case{"unix socket, frames", true, true}}) {
+    constexpr std::size_t kCalls = 10000;
+    int fd = alpha::util::kInvalidSocket;
+    require(mode.unix_socket ? alpha::util::connect_unix(path, fd).ok
+                             : alpha::util::connect_tcp("127.0.0.1", server.bound_port(), false, fd).ok,
+            "local rpc connect");
+    std::string buffer;
+    std::vector<std::int64_t> latencies;
+    latencies.reserve(kCalls);
+    const auto start = Clock::now();
+    for (std::size_t i = 0; i < kCalls; ++i) {
+      const auto call_start = Clock::now();
+      require(mode.frames ? frame_round_trip(fd, framed, buffer) : http_round_trip(fd, http, buffer),
+              "local rpc round trip");
+      latencies.push_back(
+          std::chrono::duration_cast<std::chrono::microseconds>(Clock::now() - call_start).count());
+    }
+    const auto total = std::chrono::duration_cast<std::chrono::microseconds>(Clock::now() - start).count();
+    alpha::util::close_socket(fd);
+    std::cout << "local rpc " << mode.name << ": "
+              << (static_cast<double>(kCalls) * 1e6 / static_cast<double>(total)) << " calls/s, latency p50 "
+              << percentile_us(latencies, 0.5) << " us, p99 " << percentile_us(latencies, 0.99) << " us\n";
+  }
+  server.stop();
+#endif
+}
+
+void bench_http_streamed_response() {
+#ifndef _WIN32
+  // A 100k-item result (about 11 MB of JSON) built whole and sent with a
+  // length versus streamed chunked from the writer, which only ever holds
+  // a send window of it.
+  static constexpr std::size_t kItems = 100000;
+  static constexpr std::size_t kItemsPerSlice = 256;
+  const auto write_item = [](alpha::JsonWriter& out, std::size_t i) {
+    out.begin_object()
+        .member("recipe_id", "rcp-" + std::to_string(i))
+        .member("title", "Benchmark recipe " + std::to_string(i))
+        .member("category", "soup")
+        .member("review_count", i % 17U)
+        .member("average_rating", static_cast<double>(i % 50U) / 10.0)
+        .end_object();
+  };
+  alpha::HttpServer server;
+  require(server
+              .start({.bind_host = "127.0.0.1", .port = 0, .worker_threads = 1},
+                     [&](const alpha::HttpRequest& request) {
+                       if (request.target == "/buffered") {
+                         alpha::HttpResponse response;
+                         alpha::JsonWriter out(response.body);
+                         out.begin_array();
+                         for (std::size_t i = 0; i < kItems; ++i) {
+                           write_item(out, i);
+                         }
+                         out.end_array();
+                         return response;
+                       }
+                       auto next = std::make_shared<std::size_t>(0);
+                       return alpha::HttpResponse{.stream = [next, &write_item](std::string& out) {
+                         out += *next == 0 ? "[" : ",";
+                         const std::size_t end = std::min(kItems, *next + kItemsPerSlice);
+                         for (; *next < end; ++*next) {
+                           if (*next % kItemsPerSlice != 0) {
+                             out.push_back(',');
+                           }
+                           alpha::JsonWriter item(out);
+                           write_item(item, *next);
+                         }
+                         if (*next < kItems) {
+                           return true;
+                         }
+                         out += "]";
+                         return false;
+                       }};
+                     })
+              .ok,
+          "http server start");
+  for (const std::string_view target : {"/streamed", "/buffered"}) {
+    int fd = alpha::util::kInvalidSocket;
+    require(alpha::util::connect_tcp("127.0.0.1", server.bound_port(), false, fd).ok, "http connect");
+    const auto start = Clock::now();
+    require(alpha::util::send_all(fd, "GET " + std::string{target} + " HTTP/1.1\r\nConnection: close\r\n\r\n"),
+            "http send");
+    std::array<char, 65536> chunk{};
+    std::size_t received = 0;
+    std::int64_t first_byte_us = -1;
+    while (true) {
+      const ssize_t n = ::recv(fd, chunk.data(), chunk.size(), 0);
+      if (n <= 0) {
+        break;
+      }
+      if (first_byte_us < 0) {
+        first_byte_us = std::chrono::duration_cast<std::chrono::microseconds>(Clock::now() - start).count();
+      }
+      received += static_cast<std::size_t>(n);
+    }
+    const auto total_us = std::chrono::duration_cast<std::chrono::microseconds>(Clock::now() - start).count();
+    alpha::util::close_socket(fd);
+    std::cout << "http " << target.substr(1) << " 100k-item response: " << received << " bytes, first byte "
+              << first_byte_us << " us, complete " << total_us << " us\n";
+  }
+  server.stop();
+#endif
+}
+
+void bench_event_stream_fanout() {
+#ifndef _WIN32
+  // Push subscribers parked on GET /events: what a crowd of idle watchers
+  // costs everyone else's RPC calls, and how long one change takes to reach
+  // all of them.
+  static constexpr std::size_t kWatchers = 2000;
+  static constexpr std::size_t kCalls = 5000;
+  static constexpr std::size_t kRounds = 20;
+  alpha::ChangeFeed feed;
+  alpha::HttpServer server;
+  require(server
+              .start({.bind_host = "127.0.0.1", .port = 0, .worker_threads = 2},
+                     [&feed](const alpha::HttpRequest& request) {
+                       if (request.target != "/events") {
+                         return alpha::HttpResponse{.body = R"({"jsonrpc":"2.0","id":1,"result":true})"};
+                       }
+                       auto cursor = std::make_shared<std::uint64_t>(feed.last_seq());
+                       auto opened = std::make_shared<bool>(false);
+                       return alpha::HttpResponse{
+                           .content_type = "text/event-stream", .stream = [&feed, cursor, opened](std::string& out) {
+                             if (!*opened) {
+                               *opened = true;
+                               out += ": open\n\n";
+                             }
+                             const alpha::ChangeBatch batch = feed.read_after(*cursor, alpha::kAllChangeTopics, 64);
+                             for (const alpha::ChangeNotice& notice : batch.notices) {
+                               out += "id: " + std::to_string(notice.seq) + "\ndata: " + notice.change.id + "\n\n";
+                             }
+                             *cursor = batch.cursor;
+                             return true;
+                           }};
+                     })
+              .ok,
+          "event stream server start");
+  feed.set_publish_hook([&server] { server.wake_streams(); });
+
+  const std::string body = R"({"jsonrpc":"2.0","id":1,"method":"node.status","params":{}})";
+  const std::string call = "POST /rpc HTTP/1.1\r\nHost: 127.0.0.1\r\nContent-Length: " + std::to_string(body.size()) +
+                           "\r\n\r\n" + body;
+  const auto rpc_p50_us = [&] {
+    int fd = alpha::util::kInvalidSocket;
+    require(alpha::util::connect_tcp("127.0.0.1", server.bound_port(), false, fd).ok, "rpc connect");
+    std::string buffer;
+    std::vector<std::int64_t> latencies;
+    latencies.reserve(kCalls);
+    for (std::size_t i = 0; i < kCalls; ++i) {
+      const auto start = Clock::now();
+      require(http_round_trip(fd, call, buffer), "rpc round trip");
+      latencies.push_back(std::chrono::duration_cast<std::chrono::microseconds>(Clock::now() - start).count());
+    }
+    alpha::util::close_socket(fd);
+    return percentile_us(latencies, 0.5);
+  };
+  const std::int64_t quiet_p50 = rpc_p50_us();
+
+  // Reads until `marker` arrives on a blocking watcher socket.
+  const auto read_until = [](int fd, std::string& buffer, std::string_view marker) {
+    std::array<char, 4096> chunk{};
+    while (buffer.find(marker) == std::string::npos) {
+      const ssize_t n = ::recv(fd, chunk.data(), chunk.size(), 0);
+      require(n > 0, "event stream read");
+      buffer.append(chunk.data(), static_cast<std::size_t>(n));
+    }
+    buffer.clear();
+  };
+  std::vector<int> watchers(kWatchers, alpha::util::kInvalidSocket);
+  std::vector<std::string> buffers(kWatchers);
+  for (std::size_t i = 0; i < kWatchers; ++i) {
+    require(alpha::util::connect_tcp("127.0.0.1", server.bound_port(), false, watchers[i]).ok, "watcher connect");
+    require(alpha::util::send_all(watchers[i], "GET /events HTTP/1.1\r\nHost: 127.0.0.1\r\n\r\n"), "watcher send");
+    read_until(watchers[i], buffers[i], ": open");
+  }
+  while (server.stats().parked_streams < kWatchers) {
+    std::this_thread::sleep_for(std::chrono::milliseconds(1));
+  }
+  const std::int64_t crowded_p50 = rpc_p50_us();
+
+  std::vector<std::int64_t> fanout;
+  for (std::size_t round = 0; round < kRounds; ++round) {
+    const std::string id = "evt-" + std::to_string(round);
+    const auto start = Clock::now();
+    feed.publish({.id = id});
+    for (std::size_t i = 0; i < kWatchers; ++i) {
+      read_until(watchers[i], buffers[i], id + "\n\n");
+    }
+    fanout.push_back(std::chrono::duration_cast<std::chrono::microseconds>(Clock::now() - start).count());
+  }
+  std::cout << "event streams: rpc p50 " << quiet_p50 << " us alone, " << crowded_p50 << " us beside " << kWatchers
+            << " parked watchers; one change reaches all of them in p50 " << percentile_us(fanout, 0.5)
+            << " us (max " << percentile_us(fanout, 1.0) << " us)\n";
+  for (int& fd : watchers) {
+    alpha::util::close_socket(fd);
+  }
+  feed.set_publish_hook(nullptr);
+  server.stop();
+#endif
+}
+
+void bench_json_rpc_parse() {
+  // A recipes.create call with a 4 KiB body: field-by-field substring scans
+  // against one parse plus member lookups, then a 200-call batch.
+  const std::string markdown(4096, 'x');
+  const auto call = [&markdown](std::size_t id) {
+    return R"({"jsonrpc":"2.0","id":)" + std::to_string(id) +
+           R"(,"method":"recipes.create","params":{"category":"soup","title":"Tomato soup )" + std::to_string(id) +
+           R"(","markdown":")" + markdown + R"(","menu_segment":"community-post","value_units":5,"core_topic":false}})";
+  };
+  const std::string body = call(1);
+  constexpr std::array<std::string_view, 4> kFields = {"category", "title", "markdown", "menu_segment"};
+  std::size_t sink = 0;
+  run_case("rpc params, substring scan per field", 20000, [&](std::size_t) {
+    for (const std::string_view field : kFields) {
+      sink += legacy_extract_string(body, field)->size();
+    }
+  });
+  run_case("rpc params, single-pass parse", 20000, [&](std::size_t) {
+    const std::optional<alpha::JsonDocument> document = alpha::JsonDocument::parse(body);
+    const alpha::JsonValue params = *document->root().find("params");
+    for (const std::string_view field : kFields) {
+      sink += params.find(field)->as_string_view()->size();
+    }
+  });
+
+  std::string batch = "[";
+  for (std::size_t i = 0; i < 200; ++i) {
+    batch += (i == 0 ? "" : ",") + call(i);
+  }
+  batch += "]";
+  run_case("rpc batch of 200 calls, parse", 200, [&](std::size_t) {
+    sink += alpha::JsonDocument::parse(batch)->root().size();
+  });
+  require(sink > 0, "json parse");
+}
+
+void bench_rpc_response_cache() {
+  // Read-heavy traffic between store changes: answering recipes.search and
+  // node.status from the service each time versus one response cache lookup
+  // at the current state generation.
+  static constexpr std::size_t kRecipes = 300;
+  const std::unique_ptr<alpha::AlphaService> service = ingest_service("response-cache");
+  const std::int64_t start_unix = alpha::util::unix_timestamp_now() - static_cast<std::int64_t>(kRecipes) - 60;
+  for (std::size_t i = 0; i < kRecipes; ++i) {
+    alpha::util::set_virtual_clock((start_unix + static_cast<std::int64_t>(i)) * 1000);
+    require(service
+                ->create_recipe({
+                    .category = "Soup",
+                    .title = "Cached soup " + std::to_string(i),
+                    .markdown = "Simmer for " + std::to_string(i) + " minutes.",
+                })
+                .ok,
+            "cache bench recipe");
+  }
+  alpha::util::set_virtual_clock(std::nullopt);
+  const auto write_search = [&service](std::string& json) {
+    alpha::JsonWriter out(json);
+    out.begin_array();
+    for (const alpha::RecipeSummary& recipe : service->search({.text = "soup", .category = {}})) {
+      out.begin_object()
+          .member("recipe_id", recipe.recipe_id)
+          .member("title", recipe.title)
+          .member("category", recipe.category)
+          .member("author_cid", recipe.author_cid)
+          .end_object();
+    }
+    out.end_array();
+  };
+  std::size_t sink = 0;
+  run_case("recipes.search (300 results), computed", 200, [&](std::size_t) {
+    std::string json;
+    write_search(json);
+    sink += json.size();
+  });
+  run_case("node.status, computed", 2000, [&](std::size_t) { sink += service->node_status().db.event_count; });
+
+  alpha::ResponseCache cache;
+  std::string json;
+  write_search(json);
+  cache.insert("recipes.search\n4:soup", service->state_generation(),
+               std::make_shared<const std::string>(std::move(json)));
+  run_case("recipes.search (300 results), cache hit", 200000, [&](std::size_t) {
+    sink += cache.find("recipes.search\n4:soup", service->state_generation())->size();
+  });
+  const alpha::ResponseCacheStats stats = cache.stats();
+  std::cout << "response cache: " << stats.hits << " hits, " << stats.misses << " misses, " << stats.bytes
+            << " bytes held\n";
+  require(sink > 0, "response cache");
+}
+
+void bench_metrics_recording() {
+  // What instrumentation adds to a hot path: one histogram record, a scoped
+  // timer (two clock reads and a record), and for scale the sha256 call
+  // that the hash metrics wrap.
+  alpha::util::LatencyHistogram histogram;
+  run_case("metrics histogram record", 5'000'000, [&](std::size_t i) { histogram.record(std::uint64_t{i * 37U}); });
+  run_case("metrics scoped timer", 5'000'000, [&](std::size_t) { const alpha::util::ScopedTimer timer(histogram); });
+  alpha::util::Counter counter;
+  run_case("metrics counter add", 5'000'000, [&](std::size_t) { counter.add(); });
+  const std::string payload(200, 'e');
+  std::size_t sink = 0;
+  run_case("sha256 of 200 bytes, counted and sampled", 200'000,
+           [&](std::size_t) { sink += alpha::util::sha256_like_hex(payload).size(); });
+  require(sink > 0 && histogram.count() > 0 && counter.value() > 0, "metrics recorded");
+}
+
+void bench_network_simulation() {
+  // Sixteen services on 40 ms links under rising publish rates. Latencies
+  // and convergence are virtual time; identical seeds replay identical
+  // schedules.
+  for (const double rate : {1.0, 5.0, 20.0}) {
+    alpha::sim::Simulation simulation({
+        .nodes = 16,
+        .seeds_per_node = 3,
+        .seed = 42,
+        .link = {.loss_rate = 0.01},
+        .data_dir = (std::filesystem::temp_directory_path() / "got-soup-bench" / "sim").string(),
+    });
+    require(simulation.start().ok, "simulation starts");
+    simulation.run_for(3000);
+    const alpha::sim::VirtualNetworkStats warmup = simulation.network().stats();
+    require(simulation.run_load(rate, 10000).ok, "simulation load runs");
+    const std::optional<std::int64_t> converged = simulation.run_until_converged(60000);
+    require(converged.has_value(), "simulation converges");
+    const alpha::sim::PropagationReport report = simulation.report();
+    std::cout << "sim 16 nodes, " << rate << " events/s: " << report.events << " events, propagation p50 "
+              << report.p50_ms << " ms, p90 " << report.p90_ms << " ms, p99 " << report.p99_ms
+              << " ms, converged " << *converged << " ms after load, " << (report.bytes - warmup.bytes_delivered)
+              << " bytes in " << (report.frames - warmup.frames_delivered) << " frames, " << report.timeline_mismatches
+              << " timelines differ\n";
+  }
+}
+
+int main() {
+  bench_crypto_engine();
+  bench_event_propagation();
+  bench_seen_filter();
+  bench_wire_compression();
+  bench_compact_block_relay();
+  bench_ingest_pipeline();
+  bench_http_rpc();
+  bench_unix_socket_rpc();
+  bench_json_rpc_parse();
+  bench_http_streamed_response();
+  bench_event_stream_fanout();
+  bench_rpc_response_cache();
+  bench_metrics_recording();
+  bench_network_simulation();
+  return 0;
+}
@@ -1,17 +1,50 @@
+#include <algorithm>
+#include <array>
+#include <atomic>
 #include <cassert>
 #include <chrono>
+#include <cmath>
 #include <filesystem>
 #include <fstream>
+#include <future>
 #include <iostream>
+#include <memory>
+#include <mutex>
 #include <ranges>
 #include <string>
 #include <thread>
 
 #include "core/api/core_api.hpp"
 #include "core/crypto/crypto.hpp"
+#include "core/crypto/signature_verifier.hpp"
+#include "core/mining/stratum_server.hpp"
+#include "core/p2p/compact_block.hpp"
+#include "core/p2p/compression.hpp"
+#include "core/p2p/node.hpp"
+#include "core/p2p/peer_table.hpp"
+#include "core/p2p/reconcile.hpp"
+#include "core/p2p/rolling_bloom.hpp"
+#include "core/rpc/http_server.hpp"
+#include "core/rpc/json.hpp"
+#include "core/rpc/response_cache.hpp"
+#include "core/service/change_feed.hpp"
+#include "core/service/ingest_pipeline.hpp"
+#include "core/service/maintenance_scheduler.hpp"
+#include "core/sim/network_sim.hpp"
+#include "core/storage/reward_schedule.hpp"
 #include "core/storage/store.hpp"
+#include "core/transport/socks5.hpp"
 #include "core/util/canonical.hpp"
 #include "core/util/hash.hpp"
+#include "core/util/metrics.hpp"
+#include "core/util/mpsc_ring.hpp"
+#include "core/util/socket.hpp"
+
+#ifndef _WIN32
+#include <poll.h>
+#include <sys/socket.h>
+#include <sys/time.h>
+#endif
 
 namespace {
 
@@ -34,6 +67,312 @@ std::string hex_encode(std::string_view bytes) {
   return out;
 }
 
+#ifndef _WIN32
+// Minimal blocking line client used to drive loopback servers from tests.
+class LoopbackLineClient {
+public:
+  explicit LoopbackLineClient(std::uint16_t port) {
+    const alpha::Result connected = alpha::util::connect_tcp("127.0.0.1", port, false, fd_);
+    assert(connected.ok);
+    timeval timeout{.tv_sec = 5, .tv_usec = 0};
+    ::setsockopt(fd_, SOL_SOCKET, SO_RCVTIMEO, &timeout, sizeof(timeout));
+  }
+  ~LoopbackLineClient() { alpha::util::close_socket(fd_); }
+
+  void send_line(std::string_view line) {
+    const bool sent = alpha::util::send_all(fd_, std::string{line} + "\n");
+    assert(sent);
+  }
+
+  std::string read_line() {
+    while (true) {
+      const std::size_t newline = buffer_.find('\n');
+      if (newline != std::string::npos) {
+        std::string line = buffer_.substr(0, newline);
+        buffer_.erase(0, newline + 1U);
+        return line;
+      }
+      char chunk[1024];
+      const ssize_t n = ::recv(fd_, chunk, sizeof(chunk), 0);
+      if (n <= 0) {
+        return {};
+      }
+      buffer_.append(chunk, static_cast<std::size_t>(n));
+    }
+  }
+
+  // Reads until a line containing `needle` arrives (or the socket times out).
+  std::string read_until(std::string_view needle) {
+    for (int i = 0; i < 64; ++i) {
+      std::string line = read_line();
+      if (line.empty() || line.find(needle) != std::string::npos) {
+        return line;
+      }
+    }
+    return {};
+  }
+
+private:
+  int fd_ = alpha::util::kInvalidSocket;
+  std::string buffer_;
+};
+
+// Keep-alive HTTP/1.1 client for the RPC server tests.
+class LoopbackHttpClient {
+public:
+  explicit LoopbackHttpClient(std::uint16_t port) {
+    const alpha::Result connected = alpha::util::connect_tcp("127.0.0.1", port, false, fd_);
+    assert(connected.ok);
+    timeval timeout{.tv_sec = 5, .tv_usec = 0};
+    ::setsockopt(fd_, SOL_SOCKET, SO_RCVTIMEO, &timeout, sizeof(timeout));
+  }
+  explicit LoopbackHttpClient(const std::string& unix_path) {
+    const alpha::Result connected = alpha::util::connect_unix(unix_path, fd_);
+    assert(connected.ok);
+    timeval timeout{.tv_sec = 5, .tv_usec = 0};
+    ::setsockopt(fd_, SOL_SOCKET, SO_RCVTIMEO, &timeout, sizeof(timeout));
+  }
+  ~LoopbackHttpClient() { alpha::util::close_socket(fd_); }
+
+  void send_raw(std::string_view bytes) {
+    const bool sent = alpha::util::send_all(fd_, bytes);
+    assert(sent);
+  }
+
+  void send_request(std::string_view target, std::string_view body, std::string_view extra_headers = {}) {
+    send_raw("POST " + std::string{target} + " HTTP/1.1\r\nHost: 127.0.0.1\r\nContent-Length: " +
+             std::to_string(body.size()) + "\r\n" + std::string{extra_headers} + "\r\n" + std::string{body});
+  }
+
+  // Returns the status line plus headers and the body; empty once the
+  // server has closed the connection.
+  std::pair<std::string, std::string> read_response() {
+    std::size_t head_end = std::string::npos;
+    while ((head_end = buffer_.find("\r\n\r\n")) == std::string::npos) {
+      if (!fill()) {
+        return {};
+      }
+    }
+    const std::string head = buffer_.substr(0, head_end);
+    if (head.find("Transfer-Encoding: chunked") != std::string::npos) {
+      buffer_.erase(0, head_end + 4U);
+      return {head, read_chunked_body()};
+    }
+    const std::size_t length_at = head.find("Content-Length: ") + 16U;
+    const std::size_t length = std::stoul(head.substr(length_at, head.find("\r\n", length_at) - length_at));
+    while (buffer_.size() < head_end + 4U + length) {
+      if (!fill()) {
+        return {};
+      }
+    }
+    std::string body = buffer_.substr(head_end + 4U, length);
+    buffer_.erase(0, head_end + 4U + length);
+    return {head, body};
+  }
+
+  // Length-prefixed frame payload; nullopt once the server has closed.
+  std::optional<std::string> read_frame() {
+    std::optional<std::size_t> length;
+    while (!(length = alpha::rpc_frame_length(buffer_)).has_value() ||
+           buffer_.size() < alpha::kRpcFrameHeaderBytes + *length) {
+      if (!fill()) {
+        return std::nullopt;
+      }
+    }
+    std::string payload = buffer_.substr(alpha::kRpcFrameHeaderBytes, *length);
+    buffer_.erase(0, alpha::kRpcFrameHeaderBytes + *length);
+    return payload;
+  }
+
+  // For streams read a piece at a time: the head of a chunked response,
+  // then one chunk per call (empty after the last).
+  std::string read_head() {
+    std::size_t head_end = std::string::npos;
+    while ((head_end = buffer_.find("\r\n\r\n")) == std::string::npos) {
+      if (!fill()) {
+        return {};
+      }
+    }
+    std::string head = buffer_.substr(0, head_end);
+    buffer_.erase(0, head_end + 4U);
+    return head;
+  }
+  std::optional<std::string> read_chunk() {
+    std::size_t line_end = std::string::npos;
+    while ((line_end = buffer_.find("\r\n")) == std::string::npos) {
+      if (!fill()) {
+        return std::nullopt;
+      }
+    }
+    const std::size_t size = std::stoul(buffer_.substr(0, line_end), nullptr, 16);
+    while (buffer_.size() < line_end + 2U + size + 2U) {
+      if (!fill()) {
+        return std::nullopt;
+      }
+    }
+    std::string chunk = buffer_.substr(line_end + 2U, size);
+    buffer_.erase(0, line_end + 2U + size + 2U);
+    return chunk;
+  }
+
+  bool closed_by_peer() { return buffer_.empty() && !fill(); }
+  std::size_t chunks_read() const { return chunks_read_; }
+
+private:
+  std::string read_chunked_body() {
+    std::string body;
+    while (true) {
+      std::size_t line_end = std::string::npos;
+      while ((line_end = buffer_.find("\r\n")) == std::string::npos) {
+        if (!fill()) {
+          return {};
+        }
+      }
+      const std::size_t size = std::stoul(buffer_.substr(0, line_end), nullptr, 16);
+      while (buffer_.size() < line_end + 2U + size + 2U) {
+        if (!fill()) {
+          return {};
+        }
+      }
+      body += buffer_.substr(line_end + 2U, size);
+      buffer_.erase(0, line_end + 2U + size + 2U);
+      if (size == 0) {
+        return body;
+      }
+      ++chunks_read_;
+    }
+  }
+
+  bool fill() {
+    char chunk[4096];
+    const ssize_t n = ::recv(fd_, chunk, sizeof(chunk), 0);
+    if (n <= 0) {
+      return false;
+    }
+    buffer_.append(chunk, static_cast<std::size_t>(n));
+    return true;
+  }
+
+  int fd_ = alpha::util::kInvalidSocket;
+  std::string buffer_;
+  std::size_t chunks_read_ = 0;
+};
+#endif
+
+#ifndef _WIN32
+// SOCKS5 stand-in for transport tests. Answers the handshake with whatever
+// method the client offers, sends every requested host to 127.0.0.1 and
+// splices bytes both ways. Requests are recorded as "user:pass@host:port".
+class Socks5StandIn {
+public:
+  Socks5StandIn() {
+    const alpha::Result listening = alpha::util::listen_tcp("127.0.0.1", 0, 16, listen_fd_);
+    assert(listening.ok);
+    port_ = alpha::util::local_port(listen_fd_);
+    acceptor_ = std::thread([this] { accept_loop(); });
+  }
+  ~Socks5StandIn() {
+    stopping_ = true;
+    ::shutdown(listen_fd_, SHUT_RDWR);
+    acceptor_.join();
+    alpha::util::close_socket(listen_fd_);
+    for (auto& session : sessions_) {
+      session.join();
+    }
+  }
+
+  [[nodiscard]] std::uint16_t port() const { return port_; }
+  [[nodiscard]] std::vector<std::string> requests() const {
+    const std::lock_guard lock(mutex_);
+    return requests_;
+  }
+
+private:
+  void accept_loop() {
+    while (!stopping_) {
+      const int fd = ::accept(listen_fd_, nullptr, nullptr);
+      if (fd < 0) {
+        return;
+      }
+      timeval timeout{.tv_sec = 0, .tv_usec = 50000};
+      ::setsockopt(fd, SOL_SOCKET, SO_RCVTIMEO, &timeout, sizeof(timeout));
+      sessions_.emplace_back([this, fd] { serve(fd); });
+    }
+  }
+
+  bool read_exact(int fd, std::string& out, std::size_t count) {
+    out.clear();
+    while (out.size() < count && !stopping_) {
+      char chunk[256];
+      const ssize_t n = ::recv(fd, chunk, std::min(sizeof(chunk), count - out.size()), 0);
+      if (n == 0 || (n < 0 && errno != EAGAIN && errno != EWOULDBLOCK && errno != EINTR)) {
+        return false;
+      }
+      if (n > 0) {
+        out.append(chunk, static_cast<std::size_t>(n));
+      }
+    }
+    return out.size() == count;
+  }
+
+  void serve(int client) {
+    std::string head;
+    std::string field;
+    std::string user;
+    std::string pass;
+    bool ok = read_exact(client, head, 3) && head[0] == 5;
+    const char method = ok ? head[2] : '\xff';
+    ok = ok && alpha::util::send_all(client, std::string{"\x05"} + method);
+    if (ok && method == 2) {
+      ok = read_exact(client, head, 2) && read_exact(client, user, static_cast<unsigned char>(head[1])) &&
+           read_exact(client, head, 1) && read_exact(client, pass, static_cast<unsigned char>(head[0])) &&
+           alpha::util::send_all(client, std::string{"\x01\x00", 2});
+    }
+    ok = ok && read_exact(client, head, 5) && head[1] == 1 && head[3] == 3 &&
+         read_exact(client, field, static_cast<unsigned char>(head[4]) + 2U);
+    int upstream = alpha::util::kInvalidSocket;
+    if (ok) {
+      const std::string host = field.substr(0, field.size() - 2U);
+      const auto port = static_cast<std::uint16_t>((static_cast<unsigned char>(field[field.size() - 2U]) << 8U) |
+                                                   static_cast<unsigned char>(field.back()));
+      {
+        const std::lock_guard lock(mutex_);
+        requests_.push_back(user + ":" + pass + "@" + host + ":" + std::to_string(port));
+      }
+      const bool connected = alpha::util::connect_tcp("127.0.0.1", port, false, upstream).ok;
+      const std::string reply{connected ? "\x05\x00\x00\x01\x00\x00\x00\x00\x00\x00"
+                                        : "\x05\x05\x00\x01\x00\x00\x00\x00\x00\x00",
+                              10};
+      ok = alpha::util::send_all(client, reply) && connected;
+    }
+    while (ok && !stopping_) {
+      std::array<pollfd, 2> fds{{{client, POLLIN, 0}, {upstream, POLLIN, 0}}};
+      if (::poll(fds.data(), fds.size(), 50) <= 0) {
+        continue;
+      }
+      for (std::size_t i = 0; i < fds.size() && ok; ++i) {
+        if (fds[i].revents == 0) {
+          continue;
+        }
+        char chunk[16384];
+        const ssize_t n = ::recv(fds[i].fd, chunk, sizeof(chunk), 0);
+        ok = n > 0 && alpha::util::send_all(fds[1U - i].fd, std::string_view{chunk, static_cast<std::size_t>(n)});
+      }
+    }
+    alpha::util::close_socket(upstream);
+    alpha::util::close_socket(client);
+  }
+
+  int listen_fd_ = alpha::util::kInvalidSocket;
+  std::uint16_t port_ = 0;
+  std::atomic<bool> stopping_{false};
+  std::thread acceptor_;
+  std::vector<std::thread> sessions_;
+  mutable std::mutex mutex_;
+  std::vector<std::string> requests_;
+};
+#endif
+
 void prepare_verified_backup(alpha::CoreApi& api, const std::filesystem::path& dir) {
   const auto backup_path = dir / "backup" / "identity.dat";
   const alpha::Result export_key = api.export_key_backup(backup_path.string(), "backup-pass", "backup-salt");
@@ -59,6 +398,25 @@ void test_crypto_signatures() {
   assert(crypto.verify(payload, signature, crypto.identity().public_key));
   assert(!crypto.verify(payload + "-x", signature, crypto.identity().public_key));
 
+  // Buffer-reusing variants must stay bit-identical with the allocating ones.
+  std::string scratch = "stale contents";
+  crypto.hash_bytes_into(payload, scratch);
+  assert(scratch == hash_a);
+  crypto.content_id_into(payload, scratch);
+  assert(scratch == crypto.content_id(payload));
+  assert(scratch == "evt-" + hash_a);
+  const bool signed_into = crypto.sign_into(payload, scratch);
+  assert(signed_into);
+  assert(scratch == signature);
+  const std::vector<std::string> payloads = {payload, "second", ""};
+  std::vector<std::string> signatures;
+  const bool signed_many = crypto.sign_many(payloads, signatures);
+  assert(signed_many);
+  assert(signatures.size() == payloads.size());
+  for (std::size_t i = 0; i < payloads.size(); ++i) {
+    assert(signatures[i] == crypto.sign(payloads[i]));
+  }
+
   const std::string phase_status = crypto.core_phase_status();
   assert(!phase_status.empty());
 }
@@ -219,12 +577,15 @@ void test_core_api_flow() {
   assert(init.ok);
   prepare_verified_backup(api, dir);
 
+  const std::uint64_t generation = api.state_generation();
+  assert(api.state_generation() == generation && api.status_generation() >= generation);
   alpha::Result create_recipe = api.create_recipe({
       .category = "Dinner",
       .title = "Garlic Pasta",
       .markdown = "Cook pasta and add garlic butter.",
   });
   assert(create_recipe.ok);
+  assert(api.state_generation() > generation);
 
   auto recipes = api.search({.text = "garlic", .category = {}});
   assert(!recipes.empty());
@@ -585,12 +946,12 @@ void test_reward_claim_and_high_value_gating() {
       .peers_dat_path = {},
       .community_profile_path = "recipes",
       .production_swap = true,
-      .p2p_mainnet_port = 4001,
-      .p2p_testnet_port = 14001,
       .block_interval_seconds = 1,
       .block_reward_units = 6,
       .minimum_post_value = 3,
       .genesis_psz_timestamp = "Alpha-One genesis: got-soup reward ledger start",
+      .p2p_mainnet_port = 4001,
+      .p2p_testnet_port = 14001,
   });
   assert(init.ok);
   prepare_verified_backup(api, dir);
@@ -636,6 +997,46 @@ void test_reward_claim_and_high_value_gating() {
   assert(balance_after_post <= balance_after_claim - 3);
 }
 
+void test_reward_schedule_matches_float_reference() {
+  // The long double formula the store used before the fixed-point schedule.
+  const auto float_reward = [](std::int64_t base, long double decay, std::uint64_t block_index) -> std::int64_t {
+    if (block_index == 0) {
+      return 0;
+    }
+    const long double raw =
+        static_cast<long double>(base) * std::pow(1.0L - decay, static_cast<long double>(block_index - 1U));
+    return std::max<std::int64_t>(1, static_cast<std::int64_t>(raw));
+  };
+  constexpr long double kDecay = 0.0000016435998841934918L;
+
+  const alpha::RewardSchedule schedule;
+  std::int64_t issued = 0;
+  for (std::uint64_t block = 0; block <= 50000; ++block) {
+    const std::int64_t expected = float_reward(115, kDecay, block);
+    assert(schedule.reward_at(block) == expected);
+    issued += expected;
+    assert(schedule.issued_through(block) == issued);
+  }
+  // Sparse sweep out past the point where the subsidy reaches its floor.
+  for (std::uint64_t block = 50000; block <= 4000000; block += 7919) {
+    assert(schedule.reward_at(block) == float_reward(115, kDecay, block));
+    assert(schedule.issued_through(block) - schedule.issued_through(block - 1U) == schedule.reward_at(block));
+  }
+  assert(schedule.reward_at(4000000) == 1);
+  assert(schedule.cached_runs() <= 115U);
+  assert(schedule.issued_through(10000000) - schedule.issued_through(9000000) == 1000000);
+
+  // Large bases change reward every block; the run table must still agree.
+  const alpha::RewardSchedule steep({.base_units = 50000000, .decay_q64 = alpha::RewardScheduleParams{}.decay_q64, .floor_units = 1});
+  for (std::uint64_t block = 1; block <= 2000; ++block) {
+    assert(steep.reward_at(block) == float_reward(50000000, kDecay, block));
+  }
+
+  const alpha::RewardSchedule flat({.base_units = 7, .decay_q64 = 0, .floor_units = 1});
+  assert(flat.reward_at(1) == 7 && flat.reward_at(123456789) == 7);
+  assert(flat.issued_through(1000) == 7000);
+}
+
 void test_genesis_merkle_and_transfer_flow() {
   alpha::CoreApi api;
   const auto dir = temp_dir("genesis-merkle-transfer");
@@ -649,11 +1050,11 @@ void test_genesis_merkle_and_transfer_flow() {
       .peers_dat_path = {},
       .community_profile_path = "recipes",
       .production_swap = true,
-      .p2p_mainnet_port = 4001,
-      .p2p_testnet_port = 14001,
       .block_interval_seconds = 1,
       .block_reward_units = 4,
       .genesis_psz_timestamp = "The Times 14/Feb/2026 got-soup genesis",
+      .p2p_mainnet_port = 4001,
+      .p2p_testnet_port = 14001,
   });
   assert(init.ok);
   prepare_verified_backup(api, dir);
@@ -867,6 +1268,1939 @@ void test_downvote_purge_and_mining_template() {
   assert(tpl.difficulty_nibbles >= 3);
 }
 
+void test_json_document_parser() {
+  // A key spelled out inside another value must not be found as a member.
+  const std::string body =
+      R"({"jsonrpc":"2.0","id":7,"method":"recipes.create","params":{"title":"say \"title\": no",)"
+      R"("markdown":"café 🍅\n","value_units":-12,"core_topic":true,"nested":[1,[2,{"x":null}]]}})";
+  const std::optional<alpha::JsonDocument> document = alpha::JsonDocument::parse(body);
+  assert(document.has_value());
+  const alpha::JsonValue root = document->root();
+  assert(root.is_object() && root.size() == 4);
+  assert(root.find("id")->raw() == "7");
+  assert(root.find("method")->as_string_view() == "recipes.create");
+  assert(!root.find("title").has_value());
+  const alpha::JsonValue params = *root.find("params");
+  assert(params.find("title")->as_string() == "say \"title\": no");
+  assert(!params.find("title")->as_string_view().has_value());
+  assert(params.find("markdown")->as_string() == "caf\xC3\xA9 \xF0\x9F\x8D\x85\n");
+  assert(params.find("value_units")->as_int() == -12);
+  assert(params.find("core_topic")->as_bool() == true);
+  const alpha::JsonValue nested = *params.find("nested");
+  assert(nested.is_array() && nested.size() == 2);
+  assert(nested.at(0).as_int() == 1);
+  assert(nested.at(1).raw() == R"([2,{"x":null}])");
+  assert(nested.at(1).at(1).find("x")->is_null());
+
+  const std::optional<alpha::JsonDocument> batch = alpha::JsonDocument::parse(
+      R"( [ {"id":"a","method":"node.status"}, {"method":"x"}, 3, [] ] )");
+  assert(batch.has_value() && batch->root().is_array() && batch->root().size() == 4);
+  assert(batch->root().at(0).find("id")->raw() == "\"a\"");
+  assert(batch->root().at(3).is_array() && batch->root().at(3).size() == 0);
+  assert(alpha::JsonDocument::parse(R"({"a":1,"a":2})")->root().find("a")->as_int() == 2);
+  assert(!alpha::JsonDocument::parse("1.5")->root().as_int().has_value());
+
+  for (const std::string_view bad : {"", "{", R"({"a":1,})", "[1 2]", R"({"a" 1})", "01", "-", "1.", "tru",
+                                     R"("\x")", R"("\u12g4")", "\"a\nb\"", "{} x", R"({'a':1})"}) {
+    std::string error;
+    assert(!alpha::JsonDocument::parse(bad, &error).has_value());
+    assert(!error.empty());
+  }
+  assert(!alpha::json_unescape(R"(\ud83c)").has_value());
+  assert(!alpha::json_unescape(R"(\udf45)").has_value());
+  const std::string deep(alpha::JsonDocument::kMaxDepth + 1U, '[');
+  assert(!alpha::JsonDocument::parse(deep + std::string(deep.size(), ']')).has_value());
+  const std::string shallow(alpha::JsonDocument::kMaxDepth, '[');
+  assert(alpha::JsonDocument::parse(shallow + std::string(shallow.size(), ']')).has_value());
+}
+
+void test_json_writer_and_chunked_responses() {
+  std::string text;
+  alpha::JsonWriter writer(text);
+  writer.begin_object()
+      .member("s", std::string_view{"q\"\\\n\x01\xC3\xA9"})
+      .member("n", -42)
+      .member("u", std::uint64_t{18446744073709551615ULL})
+      .member("d", 0.5)
+      .member("nan", std::nan(""))
+      .member("b", false)
+      .key("a")
+      .begin_array()
+      .value("x")
+      .begin_object()
+      .end_object()
+      .null()
+      .raw("[1]")
+      .end_array()
+      .end_object();
+  assert(text == R"({"s":"q\"\\\n\u0001é","n":-42,"u":18446744073709551615,"d":0.5,"nan":null,"b":false,)"
+                 R"("a":["x",{},null,[1]]})");
+  const std::optional<alpha::JsonDocument> reparsed = alpha::JsonDocument::parse(text);
+  assert(reparsed.has_value());
+  assert(reparsed->root().find("s")->as_string() == "q\"\\\n\x01\xC3\xA9");
+
+#ifndef _WIN32
+  // A streamed body goes out chunked, slice by slice, and the connection
+  // carries on with the next pipelined request afterwards.
+  alpha::HttpServer server;
+  const alpha::Result started = server.start(
+      {.bind_host = "127.0.0.1", .port = 0, .worker_threads = 1}, [](const alpha::HttpRequest& request) {
+        if (request.target != "/stream") {
+          return alpha::HttpResponse{.body = "plain"};
+        }
+        auto next = std::make_shared<int>(0);
+        return alpha::HttpResponse{.stream = [next](std::string& out) {
+          alpha::JsonWriter item(out);
+          if (*next == 0) {
+            out += "[";
+          } else {
+            out += ",";
+          }
+          item.value(std::string(1000, static_cast<char>('a' + (*next % 26))));
+          if (++*next < 200) {
+            return true;
+          }
+          out += "]";
+          return false;
+        }};
+      });
+  assert(started.ok);
+  LoopbackHttpClient client(server.bound_port());
+  client.send_raw("POST /stream HTTP/1.1\r\nContent-Length: 0\r\n\r\nPOST /after HTTP/1.1\r\nContent-Length: 0\r\n\r\n");
+  const auto [head, body] = client.read_response();
+  assert(head.find("Transfer-Encoding: chunked") != std::string::npos);
+  assert(head.find("Content-Length") == std::string::npos);
+  assert(client.chunks_read() == 200);
+  const std::optional<alpha::JsonDocument> streamed = alpha::JsonDocument::parse(body);
+  assert(streamed.has_value() && streamed->root().size() == 200);
+  assert(streamed->root().at(199).as_string() == std::string(1000, 'a' + (199 % 26)));
+  const auto [plain_head, plain_body] = client.read_response();
+  assert(plain_body == "plain");
+
+  // HTTP/1.0 cannot take chunks, so the same body arrives with a length.
+  LoopbackHttpClient legacy(server.bound_port());
+  legacy.send_raw("GET /stream HTTP/1.0\r\n\r\n");
+  const auto [legacy_head, legacy_body] = legacy.read_response();
+  assert(legacy_head.find("Content-Length: " + std::to_string(body.size())) != std::string::npos);
+  assert(legacy_body == body);
+  assert(server.stats().streamed_responses == 1);
+  server.stop();
+#endif
+}
+
+void test_batch_signature_verification() {
+  alpha::CryptoEngine crypto;
+  const auto dir = temp_dir("batch-signature-verification");
+  const alpha::Result init = crypto.initialize(dir.string(), "test-passphrase", true);
+  assert(init.ok);
+
+  std::vector<alpha::EventEnvelope> events;
+  for (int i = 0; i < 32; ++i) {
+    const std::string payload = alpha::util::canonical_join({
+        {"title", "batch-" + std::to_string(i)},
+        {"author_cid", crypto.identity().cid.value},
+        {"author_pubkey", crypto.identity().public_key},
+        {"kind", std::to_string(static_cast<int>(alpha::EventKind::RecipeCreated))},
+        {"unix_ts", std::to_string(1700000000 + i)},
+    });
+    events.push_back({
+        .event_id = crypto.content_id(payload),
+        .kind = alpha::EventKind::RecipeCreated,
+        .author_cid = crypto.identity().cid.value,
+        .unix_ts = 1700000000 + i,
+        .payload = payload,
+        .signature = crypto.sign(payload),
+    });
+  }
+  const alpha::EventEnvelope genuine = events[3];
+  events[3].signature = crypto.sign("something else");
+  events[7].payload += "\ntampered=1";
+  events[11].author_cid = "cid-impostor";
+  events[13].signature.clear();
+  // Envelope fields outside the signature must agree with the signed payload.
+  events[17].unix_ts += 3600;
+  events[19].kind = alpha::EventKind::ReviewAdded;
+
+  alpha::SignatureVerifier verifier(crypto, {.worker_threads = 3, .min_parallel_batch = 4});
+  const auto first = verifier.verify_batch(events);
+  assert(first.size() == events.size());
+  assert(first[17].reason == "Remote event timestamp does not match its signed payload.");
+  assert(first[19].reason == "Remote event kind does not match its signed payload.");
+  for (std::size_t i = 0; i < first.size(); ++i) {
+    const bool tampered = i == 3 || i == 7 || i == 11 || i == 13 || i == 17 || i == 19;
+    assert(first[i].ok == !tampered);
+    assert(!first[i].cache_hit);
+    assert(tampered == !first[i].reason.empty());
+  }
+
+  // Re-gossiped copies are served from the verified-pair cache.
+  const auto second = verifier.verify_batch(events);
+  assert(second[0].ok && second[0].cache_hit);
+  assert(!second[3].ok && !second[3].cache_hit);
+  const alpha::SignatureVerifierStats stats = verifier.stats();
+  assert(stats.batches == 2);
+  assert(stats.verified == 52);
+  assert(stats.rejected == 12);
+  assert(stats.cache_hits == 26);
+  assert(stats.cached_pairs == 26);
+  assert(stats.cached_keys == 1);
+
+  // The service drops forged remote events and records them as invalid.
+  alpha::CoreApi api;
+  const auto api_dir = temp_dir("batch-signature-verification-api");
+  const alpha::Result api_init = api.init({
+      .app_data_dir = api_dir.string(),
+      .passphrase = "integration-passphrase",
+      .mode = alpha::AnonymityMode::Tor,
+      .seed_peers = {"seed-a"},
+      .alpha_test_mode = false,
+      .community_profile_path = "recipes",
+      .production_swap = true,
+  });
+  assert(api_init.ok);
+  const std::size_t drops_before = api.node_status().db.invalid_event_drop_count;
+  const auto results = api.ingest_remote_events({events[3], events[11], events[17]});
+  assert(results.size() == 3);
+  assert(!results[0].ok && !results[1].ok && !results[2].ok);
+  assert(api.node_status().db.invalid_event_drop_count == drops_before + 3);
+  // The forged copy arrived first, but the valid one is not shadowed by it.
+  const alpha::Result genuine_result = api.ingest_remote_event(genuine);
+  // (It reaches the store, which refuses its 2023 timestamp.)
+  assert(genuine_result.message.find("append_event") != std::string::npos);
+}
+
+void test_staged_ingest_pipeline() {
+  alpha::CryptoEngine crypto;
+  const auto dir = temp_dir("staged-ingest-pipeline");
+  const alpha::Result init = crypto.initialize(dir.string(), "test-passphrase", true);
+  assert(init.ok);
+  const std::int64_t now = alpha::util::unix_timestamp_now();
+
+  // Arrival order is newest first; drains hand events back oldest first.
+  std::vector<alpha::EventEnvelope> events;
+  for (int i = 0; i < 10; ++i) {
+    const std::string payload = alpha::util::canonical_join({
+        {"title", "staged-" + std::to_string(i)},
+        {"author_cid", crypto.identity().cid.value},
+        {"author_pubkey", crypto.identity().public_key},
+        {"kind", std::to_string(static_cast<int>(alpha::EventKind::RecipeCreated))},
+        {"unix_ts", std::to_string(now - i)},
+    });
+    events.push_back({
+        .event_id = crypto.content_id(payload),
+        .kind = alpha::EventKind::RecipeCreated,
+        .author_cid = crypto.identity().cid.value,
+        .unix_ts = now - i,
+        .payload = payload,
+        .signature = crypto.sign(payload),
+    });
+  }
+  events[1].signature = crypto.sign("something else");
+  events[2].unix_ts = now + 3600;
+  events[3].signature.clear();
+  const std::string forged_id = events[1].event_id;
+
+  alpha::SignatureVerifier verifier(crypto, {.worker_threads = 1});
+  alpha::IngestPipeline inline_pipeline(verifier, {}, {.capacity = 8, .stage_batch = 3, .threaded = false});
+  assert(inline_pipeline.room() == 8);
+  std::vector<alpha::EventEnvelope> pending = events;
+  const std::size_t admitted = inline_pipeline.submit(pending);
+  assert(admitted == 8);
+  assert(pending.size() == 2);
+  assert(inline_pipeline.room() == 0);
+  const std::size_t admitted_full = inline_pipeline.submit(pending);
+  assert(admitted_full == 0);
+
+  const alpha::IngestBatch first = inline_pipeline.drain(4);
+  assert(first.events.size() == 4);
+  assert(first.rejected.size() == 3);
+  for (std::size_t i = 1; i < first.events.size(); ++i) {
+    assert(first.events[i - 1].unix_ts <= first.events[i].unix_ts);
+  }
+  assert(std::ranges::any_of(first.rejected, [&](const alpha::IngestRejection& r) { return r.event_id == forged_id; }));
+  // Rejections leave immediately; verified events wait for the next drain.
+  assert(inline_pipeline.room() == 7);
+  const std::size_t admitted_rest = inline_pipeline.submit(pending);
+  assert(admitted_rest == 2);
+  const alpha::IngestBatch second = inline_pipeline.drain(100);
+  assert(second.events.size() == 3);
+  assert(second.rejected.empty());
+  assert(inline_pipeline.room() == 8);
+
+  const alpha::IngestPipelineStats stats = inline_pipeline.stats();
+  assert(stats.admitted == 10);
+  assert(stats.rejected_limits == 2);
+  assert(stats.rejected_signature == 1);
+  assert(stats.drained == 7);
+  assert(stats.batches == 2);
+  assert(stats.in_flight == 0);
+
+  // Threaded stages produce the same result once idle.
+  alpha::IngestPipeline threaded(verifier, {}, {.capacity = 64, .stage_batch = 2});
+  pending = events;
+  const std::size_t admitted_threaded = threaded.submit(pending);
+  assert(admitted_threaded == events.size());
+  threaded.wait_idle();
+  const alpha::IngestBatch all = threaded.drain(100);
+  assert(all.events.size() == 7);
+  assert(all.rejected.size() == 3);
+  assert(threaded.stats().in_flight == 0);
+
+  // The same event relayed by two peers is verified once while queued.
+  alpha::SignatureVerifier counted(crypto, {.worker_threads = 1});
+  alpha::IngestPipeline deduped(counted, {}, {.capacity = 8, .threaded = false});
+  pending = {events[0], events[0]};
+  const std::size_t admitted_once = deduped.submit(pending);
+  assert(admitted_once == 1);
+  assert(pending.empty());
+  pending = {events[0]};
+  const std::size_t admitted_queued = deduped.submit(pending);
+  assert(admitted_queued == 0);
+  const alpha::IngestBatch once = deduped.drain(100);
+  assert(once.events.size() == 1);
+  assert(counted.stats().verified == 1);
+  assert(deduped.stats().duplicates == 2);
+  // Once drained the id may come back; the node's seen filter stops it.
+  pending = {events[0]};
+  const std::size_t admitted_again = deduped.submit(pending);
+  assert(admitted_again == 1);
+}
+
+void test_maintenance_scheduler_timers_and_deferral() {
+  alpha::MaintenanceScheduler scheduler(42);
+  std::atomic<int> fast_runs{0};
+  std::atomic<int> busy_attempts{0};
+  const alpha::Result empty = scheduler.add_job({.name = "empty", .run = {}});
+  assert(!empty.ok);
+  const alpha::Result fast_added = scheduler.add_job({.name = "fast",
+                                                      .interval = std::chrono::milliseconds(10),
+                                                      .run = [&]() -> std::optional<alpha::Result> {
+                                                        ++fast_runs;
+                                                        return alpha::Result::success("fast ok");
+                                                      }});
+  assert(fast_added.ok);
+  const alpha::Result duplicate =
+      scheduler.add_job({.name = "fast", .run = [] { return std::optional<alpha::Result>{}; }});
+  assert(!duplicate.ok);
+  // Defers three times as if its lock were busy, then runs.
+  const alpha::Result busy_added = scheduler.add_job({.name = "busy",
+                                                      .interval = std::chrono::hours(1),
+                                                      .retry = std::chrono::milliseconds(5),
+                                                      .run_at_start = true,
+                                                      .run = [&]() -> std::optional<alpha::Result> {
+                                                        if (++busy_attempts <= 3) {
+                                                          return std::nullopt;
+                                                        }
+                                                        return alpha::Result::success("busy ok");
+                                                      }});
+  assert(busy_added.ok);
+  const alpha::Result failing_added = scheduler.add_job(
+      {.name = "failing",
+       .interval = std::chrono::milliseconds(15),
+       .run_at_start = true,
+       .run = [] { return std::optional<alpha::Result>{alpha::Result::failure("nope")}; }});
+  assert(failing_added.ok);
+
+  const alpha::Result started = scheduler.start();
+  assert(started.ok);
+  assert(scheduler.running());
+  const alpha::Result late =
+      scheduler.add_job({.name = "late", .run = [] { return std::optional<alpha::Result>{}; }});
+  assert(!late.ok);
+  const auto deadline = std::chrono::steady_clock::now() + std::chrono::seconds(10);
+  while ((fast_runs.load() < 5 || busy_attempts.load() < 4) && std::chrono::steady_clock::now() < deadline) {
+    std::this_thread::sleep_for(std::chrono::milliseconds(5));
+  }
+  scheduler.stop();
+  assert(!scheduler.running());
+  const int runs_at_stop = fast_runs.load();
+  std::this_thread::sleep_for(std::chrono::milliseconds(40));
+  assert(fast_runs.load() == runs_at_stop);
+
+  const std::vector<alpha::MaintenanceJobStats> stats = scheduler.stats();
+  assert(stats.size() == 3);
+  const auto find = [&](std::string_view name) {
+    return *std::ranges::find_if(stats, [&](const alpha::MaintenanceJobStats& job) { return job.name == name; });
+  };
+  const alpha::MaintenanceJobStats fast = find("fast");
+  assert(fast.runs >= 5 && fast.runs == static_cast<std::uint64_t>(runs_at_stop));
+  assert(fast.failures == 0 && fast.deferrals == 0);
+  assert(fast.interval_ms == 10);
+  assert(fast.last_message == "fast ok");
+  assert(fast.last_run_unix > 0);
+  assert(fast.total_duration_us >= fast.max_duration_us && fast.max_duration_us >= fast.last_duration_us);
+  const alpha::MaintenanceJobStats busy = find("busy");
+  assert(busy.deferrals == 3);
+  assert(busy.runs == 1 && busy.last_message == "busy ok");
+  const alpha::MaintenanceJobStats failing = find("failing");
+  assert(failing.runs >= 1 && failing.failures == failing.runs);
+}
+
+void test_metrics_histograms_and_exposition() {
+  using alpha::util::LatencyHistogram;
+  // Bucket bounds tile the range with at most 1/8 relative width.
+  for (const std::uint64_t ns : {0ULL, 7ULL, 8ULL, 15ULL, 16ULL, 1000ULL, 123456789ULL, ~0ULL}) {
+    const std::size_t index = LatencyHistogram::bucket_index(ns);
+    assert(index < LatencyHistogram::kBucketCount);
+    assert(LatencyHistogram::bucket_lowest(index) <= ns && ns <= LatencyHistogram::bucket_highest(index));
+  }
+  for (std::size_t i = 1; i < LatencyHistogram::kBucketCount; ++i) {
+    assert(LatencyHistogram::bucket_lowest(i) == LatencyHistogram::bucket_highest(i - 1) + 1);
+  }
+
+  LatencyHistogram histogram;
+  for (std::uint64_t us = 1; us <= 1000; ++us) {
+    histogram.record(us * 1000);
+  }
+  const alpha::util::HistogramSnapshot snapshot = histogram.snapshot();
+  assert(snapshot.count == 1000 && snapshot.max_ns == 1'000'000);
+  assert(snapshot.sum_ns == 500'500'000);
+  const auto near = [](std::uint64_t got, double want) {
+    return std::abs(static_cast<double>(got) - want) <= want * 0.125;
+  };
+  assert(near(snapshot.percentile_ns(0.5), 500'000));
+  assert(near(snapshot.percentile_ns(0.99), 990'000));
+  assert(snapshot.percentile_ns(1.0) == 1'000'000);
+  assert(alpha::util::HistogramSnapshot{}.percentile_ns(0.5) == 0);
+
+  alpha::util::MetricsRegistry registry;
+  alpha::util::Counter& hits = registry.counter("test_hits_total", "Hits.", {.key = "kind", .value = "a\"b"});
+  assert(&hits == &registry.counter("test_hits_total", "Hits.", {.key = "kind", .value = "a\"b"}));
+  hits.add(3);
+  LatencyHistogram& latency = registry.histogram("test_duration_seconds", "Latency.");
+  latency.record(std::uint64_t{2'000});       // 2us
+  latency.record(std::uint64_t{3'000'000});   // 3ms
+  std::string text;
+  registry.render_prometheus(text);
+  assert(text.find("# TYPE test_hits_total counter\ntest_hits_total{kind=\"a\\\"b\"} 3\n") != std::string::npos);
+  assert(text.find("# TYPE test_duration_seconds histogram\n") != std::string::npos);
+  assert(text.find("test_duration_seconds_bucket{le=\"0.000001\"} 0\n") != std::string::npos);
+  assert(text.find("test_duration_seconds_bucket{le=\"0.000005\"} 1\n") != std::string::npos);
+  assert(text.find("test_duration_seconds_bucket{le=\"0.0025\"} 1\n") != std::string::npos);
+  assert(text.find("test_duration_seconds_bucket{le=\"0.005\"} 2\n") != std::string::npos);
+  assert(text.find("test_duration_seconds_bucket{le=\"+Inf\"} 2\n") != std::string::npos);
+  assert(text.find("test_duration_seconds_sum 0.003002\n") != std::string::npos);
+  assert(text.find("test_duration_seconds_count 2\n") != std::string::npos);
+  // Families render in name order.
+  assert(text.find("test_duration_seconds") < text.find("test_hits_total"));
+
+  // The process registry sees hashing and the store operations run above.
+  const auto global_count = [](std::string_view name, std::string_view label) {
+    for (const alpha::util::MetricSample& sample : alpha::util::metrics().snapshot()) {
+      if (sample.name == name && sample.label_value == label) {
+        return sample.is_histogram ? sample.histogram.count : sample.counter;
+      }
+    }
+    return std::uint64_t{0};
+  };
+  const std::uint64_t hashes_before = global_count("gotsoup_hash_calls_total", "");
+  (void)alpha::util::sha256_like_hex("metrics");
+  assert(global_count("gotsoup_hash_calls_total", "") == hashes_before + 1);
+  assert(global_count("gotsoup_store_duration_seconds", "append_event") > 0);
+  assert(global_count("gotsoup_store_duration_seconds", "materialize_views") > 0);
+}
+
+void test_kdf_session_cache_and_async_unlock() {
+  alpha::CryptoEngine crypto;
+  const auto dir = temp_dir("kdf-session-cache");
+  crypto.configure_kdf_cache({.capacity = 4, .ttl_seconds = 300});
+  const alpha::Result init = crypto.initialize(dir.string(), "kdf-passphrase", true);
+  assert(init.ok);
+  assert(crypto.kdf_cache_stats().entries >= 1);
+
+  // Export derives the backup key once; later verifications reuse it.
+  const auto backup_path = dir / "backup" / "kdf.dat";
+  const alpha::Result exported = crypto.export_identity_backup(backup_path.string(), "backup-pass", "salt");
+  assert(exported.ok);
+  const alpha::KdfCacheStats before_verify = crypto.kdf_cache_stats();
+  const alpha::Result first_verify = crypto.verify_identity_backup(backup_path.string(), "backup-pass");
+  const alpha::Result second_verify = crypto.verify_identity_backup(backup_path.string(), "backup-pass");
+  assert(first_verify.ok && second_verify.ok);
+  const alpha::KdfCacheStats after_verify = crypto.kdf_cache_stats();
+  assert(after_verify.hits == before_verify.hits + 2U);
+  assert(after_verify.misses == before_verify.misses);
+  const alpha::Result wrong = crypto.verify_identity_backup(backup_path.string(), "wrong-pass");
+  assert(!wrong.ok);
+
+  // Off-thread forms read only the snapshot, so rewriting the file after it
+  // was taken changes nothing.
+  const alpha::CryptoEngine::KdfSnapshot backup_snapshot = crypto.snapshot_backup(backup_path.string());
+  std::filesystem::remove(backup_path);
+  const alpha::Result from_snapshot = crypto.verify_identity_backup(backup_snapshot, "backup-pass");
+  assert(from_snapshot.ok);
+  const alpha::Result from_missing_file = crypto.verify_identity_backup(backup_path.string(), "backup-pass");
+  assert(!from_missing_file.ok);
+  const alpha::Result reexported = crypto.export_identity_backup(backup_path.string(), "backup-pass", "salt");
+  assert(reexported.ok);
+
+  // Locking wipes the session; a prewarm then makes the unlock a cache hit.
+  const alpha::Result locked = crypto.lock_identity();
+  assert(locked.ok);
+  assert(crypto.kdf_cache_stats().entries == 0);
+  const alpha::Result prewarm = crypto.prewarm_unlock("kdf-passphrase");
+  assert(prewarm.ok);
+  const alpha::KdfCacheStats prewarmed = crypto.kdf_cache_stats();
+  const alpha::Result unlocked_identity = crypto.unlock_identity("kdf-passphrase");
+  assert(unlocked_identity.ok);
+  assert(crypto.kdf_cache_stats().hits == prewarmed.hits + 1U);
+
+  crypto.configure_kdf_cache({.capacity = 0, .ttl_seconds = 300});
+  const alpha::Result uncached = crypto.verify_identity_backup(backup_path.string(), "backup-pass");
+  assert(uncached.ok);
+  assert(crypto.kdf_cache_stats().entries == 0);
+  assert(crypto.kdf_cache_stats().capacity == 0);
+
+  alpha::CoreApi api;
+  const auto api_dir = temp_dir("kdf-async-unlock");
+  const alpha::Result api_init = api.init({
+      .app_data_dir = api_dir.string(),
+      .passphrase = "integration-passphrase",
+      .mode = alpha::AnonymityMode::Tor,
+      .seed_peers = {"seed-a"},
+      .alpha_test_mode = false,
+      .community_profile_path = "recipes",
+      .production_swap = true,
+      .kdf_cache_entries = 4,
+  });
+  assert(api_init.ok);
+  prepare_verified_backup(api, api_dir);
+  const alpha::Result wallet_locked = api.lock_wallet();
+  assert(wallet_locked.ok);
+  assert(api.node_status().wallet.locked);
+  assert(api.node_status().wallet.kdf_cache_entries == 0);
+
+  std::promise<alpha::Result> derived;
+  api.begin_wallet_task("wallet.unlock");
+  api.prepare_unlock_async("integration-passphrase", [&derived](alpha::Result result) {
+    derived.set_value(std::move(result));
+  });
+  assert(api.node_status().wallet.task_pending);
+  const alpha::Result prepared = derived.get_future().get();
+  assert(prepared.ok);
+  assert(api.node_status().wallet.kdf_cache_entries >= 1);
+  api.finish_wallet_task(api.unlock_wallet("integration-passphrase"));
+  const alpha::WalletStatus unlocked = api.node_status().wallet;
+  assert(!unlocked.locked);
+  assert(unlocked.task == "wallet.unlock" && !unlocked.task_pending && unlocked.task_ok);
+  assert(unlocked.task_finished_unix > 0);
+
+  std::promise<alpha::Result> verified;
+  api.prepare_backup_async((api_dir / "backup" / "identity.dat").string(), "backup-pass",
+                           [&verified](alpha::Result result) { verified.set_value(std::move(result)); });
+  const alpha::Result backup_verified = verified.get_future().get();
+  assert(backup_verified.ok);
+}
+
+void test_stratum_adapter_loopback_miner() {
+#ifndef _WIN32
+  alpha::CoreApi api;
+  const auto dir = temp_dir("stratum-adapter");
+
+  const alpha::Result init = api.init({
+      .app_data_dir = dir.string(),
+      .passphrase = "integration-passphrase",
+      .mode = alpha::AnonymityMode::Tor,
+      .seed_peers = {"seed-a"},
+      .alpha_test_mode = false,
+      .community_profile_path = "recipes",
+      .production_swap = true,
+      .block_interval_seconds = 1,
+      .external_mining = true,
+  });
+  assert(init.ok);
+  prepare_verified_backup(api, dir);
+
+  // External mining leaves confirmed blocks unclaimed until a miner submits.
+  std::vector<alpha::MiningJob> jobs;
+  for (int i = 0; i < 20 && jobs.empty(); ++i) {
+    std::this_thread::sleep_for(std::chrono::milliseconds(200));
+    (void)api.sync_tick();
+    jobs = api.mining_jobs();
+  }
+  assert(!jobs.empty());
+  assert(api.local_reward_balance() == 0);
+  const alpha::Result empty_solution = api.submit_mining_solution(jobs.front().block_index, "");
+  assert(!empty_solution.ok);
+
+  alpha::StratumServer server;
+  const alpha::Result started = server.start(
+      {.bind_host = "127.0.0.1", .port = 0, .share_difficulty_nibbles = 1, .job_refresh_ms = 100},
+      [&api] { return api.mining_jobs(); },
+      [&api](const alpha::MiningJob& job, std::string_view nonce) {
+        return api.submit_mining_solution(job.block_index, nonce);
+      });
+  assert(started.ok);
+  assert(server.bound_port() != 0);
+
+  // result: [subscriptions, extranonce1, extranonce2_size]
+  const auto extranonce1_of = [](const std::string& subscribed) {
+    const std::size_t at = subscribed.find("]],\"") + 4U;
+    return subscribed.substr(at, subscribed.find('"', at) - at);
+  };
+  LoopbackLineClient miner(server.bound_port());
+  miner.send_line(R"({"id":1,"method":"mining.subscribe","params":["loopback-miner/1.0"]})");
+  const std::string subscribed = miner.read_until("\"id\":1");
+  assert(subscribed.find("mining.notify") != std::string::npos);
+  assert(subscribed.find("\"," + std::to_string(alpha::StratumServer::kExtranonce2Bytes) + "]") != std::string::npos);
+  const std::string extranonce1 = extranonce1_of(subscribed);
+  assert(extranonce1.size() == 8U);
+  miner.send_line(R"({"id":2,"method":"mining.authorize","params":["worker.1","x"]})");
+  const std::string notify = miner.read_until("mining.notify");
+  assert(!notify.empty());
+
+  // params: [job_id, pow_material, block_index, difficulty_nibbles, reward, clean_jobs]
+  const std::size_t params_at = notify.find("\"params\":[\"") + 11U;
+  const std::string job_id = notify.substr(params_at, notify.find('"', params_at) - params_at);
+  const std::size_t material_at = notify.find('"', params_at + job_id.size() + 1U) + 1U;
+  const std::string pow_material = notify.substr(material_at, notify.find('"', material_at) - material_at);
+  const auto job_it = std::ranges::find_if(jobs, [&job_id](const alpha::MiningJob& job) {
+    return job.job_id == job_id;
+  });
+  assert(job_it != jobs.end());
+  assert(job_it->pow_material == pow_material);
+
+  // Shares hash the session's extranonce1 and the miner's extranonce2 ahead
+  // of its nonce, so two sessions sending the same values do different work.
+  LoopbackLineClient second(server.bound_port());
+  // Lines are parsed as JSON: keys inside strings are not members, escapes
+  // decode, and the echoed id stays valid JSON.
+  second.send_line(R"({"params":["say \"id\":7\tok","x"],"method":"mining.authorize","id":"a\u0001b"})");
+  const std::string echoed = second.read_line();
+  const std::optional<alpha::JsonDocument> reply = alpha::JsonDocument::parse(echoed);
+  assert(reply.has_value());
+  assert(reply->root().find("id")->as_string() == std::optional<std::string>{"a\001b"});
+  assert(reply->root().find("result")->as_bool() == std::optional<bool>{true});
+  second.send_line("{\"id\":9,\"method\":");
+  const std::string parse_error = second.read_line();
+  assert(parse_error.find("Parse error") != std::string::npos);
+  second.send_line(R"({"id":1,"method":"mining.subscribe","params":["loopback-miner/1.0"]})");
+  const std::string extranonce1_b = extranonce1_of(second.read_until("\"id\":1"));
+  assert(extranonce1_b.size() == 8U && extranonce1_b != extranonce1);
+  second.send_line(R"({"id":2,"method":"mining.authorize","params":["worker.2","x"]})");
+  const std::string second_notify = second.read_until("mining.notify");
+  assert(!second_notify.empty());
+
+  const std::string extranonce2 = "00000000000000a1";
+  const auto share_hash = [&](std::string_view session, std::string_view nonce) {
+    return alpha::util::sha256_like_hex(pow_material + "|" +
+                                        alpha::StratumServer::share_nonce(session, extranonce2, nonce));
+  };
+  std::string low_share;
+  std::string split_share;  // a share for this session, low difficulty for the other
+  std::string winning_nonce;
+  for (std::uint64_t nonce = 0; winning_nonce.empty() && nonce < 5000000; ++nonce) {
+    const std::string candidate = "loop-" + std::to_string(nonce);
+    const std::string hash = share_hash(extranonce1, candidate);
+    if (alpha::util::has_leading_zero_nibbles(hash, job_it->difficulty_nibbles)) {
+      winning_nonce = candidate;
+    } else if (!alpha::util::has_leading_zero_nibbles(hash, 1)) {
+      low_share = low_share.empty() ? candidate : low_share;
+    } else if (split_share.empty() && !alpha::util::has_leading_zero_nibbles(share_hash(extranonce1_b, candidate), 1)) {
+      split_share = candidate;
+    }
+  }
+  assert(!winning_nonce.empty() && !split_share.empty());
+  assert(share_hash(extranonce1, winning_nonce) != share_hash(extranonce1_b, winning_nonce));
+
+  const auto submit = [&](LoopbackLineClient& client, int id, std::string_view job, std::string_view en2,
+                          std::string_view nonce) {
+    const std::string tag = "\"id\":" + std::to_string(id);
+    client.send_line(R"({"id":)" + std::to_string(id) + R"(,"method":"mining.submit","params":["worker",")" +
+                     std::string{job} + R"(",")" + std::string{en2} + R"(",")" + std::string{nonce} + R"("]})");
+    return client.read_until(tag);
+  };
+  const std::string low = submit(miner, 3, job_id, extranonce2, low_share);
+  assert(low.find("Low difficulty share") != std::string::npos);
+  const std::string stale = submit(miner, 4, "stale-job", extranonce2, "0");
+  assert(stale.find("\"error\":[21") != std::string::npos);
+  const std::string short_en2 = submit(miner, 5, job_id, "a1", split_share);
+  assert(short_en2.find("\"error\":[20") != std::string::npos);
+  const std::string accepted = submit(miner, 6, job_id, extranonce2, split_share);
+  assert(accepted.find("\"result\":true") != std::string::npos);
+  const std::string other_session = submit(second, 3, job_id, extranonce2, split_share);
+  assert(other_session.find("Low difficulty share") != std::string::npos);
+  const std::string duplicate = submit(miner, 7, job_id, extranonce2, split_share);
+  assert(duplicate.find("Duplicate share") != std::string::npos);
+  const std::string winning = submit(miner, 8, job_id, extranonce2, winning_nonce);
+  assert(winning.find("\"result\":true") != std::string::npos);
+
+  const alpha::StratumServerStats stats = server.stats();
+  server.stop();
+  assert(stats.blocks_found == 1);
+  assert(stats.rejected_shares == 5);
+  assert(api.local_reward_balance() == job_it->reward_units);
+  assert(std::ranges::none_of(api.mining_jobs(), [&job_it](const alpha::MiningJob& job) {
+    return job.block_index == job_it->block_index;
+  }));
+#endif
+}
+
+void test_http_server_keep_alive_and_workers() {
+  // The parser resumes across partial reads and leaves pipelined bytes.
+  alpha::HttpRequestParser parser(256, 64);
+  std::string buffer = "POST /rpc HTTP/1.1\r\nContent-Length: 5\r\n\r";
+  alpha::HttpRequest request;
+  assert(parser.parse(buffer, request) == alpha::HttpRequestParser::State::NeedMore);
+  buffer += "\nhel";
+  assert(parser.parse(buffer, request) == alpha::HttpRequestParser::State::NeedMore);
+  buffer += "loGET /metrics HTTP/1.0\r\nX-Trace: a\r\n\r\n";
+  assert(parser.parse(buffer, request) == alpha::HttpRequestParser::State::Complete);
+  assert(request.method == "POST" && request.target == "/rpc" && request.body == "hello");
+  assert(request.keep_alive);
+  assert(request.header("content-length") == std::optional<std::string_view>{"5"});
+  assert(parser.parse(buffer, request) == alpha::HttpRequestParser::State::Complete);
+  assert(request.target == "/metrics" && request.body.empty() && !request.keep_alive);
+  assert(request.header("x-trace") == std::optional<std::string_view>{"a"});
+  assert(buffer.empty());
+
+  const auto parse_error = [](std::string text) {
+    alpha::HttpRequestParser fresh(256, 64);
+    alpha::HttpRequest ignored;
+    assert(fresh.parse(text, ignored) == alpha::HttpRequestParser::State::Error);
+    return fresh.error_status();
+  };
+  assert(parse_error("garbage\r\n\r\n") == 400);
+  assert(parse_error("POST / HTTP/1.1\r\nContent-Length: nope\r\n\r\n") == 400);
+  assert(parse_error("POST / HTTP/1.1\r\nTransfer-Encoding: chunked\r\n\r\n") == 501);
+  assert(parse_error("POST / HTTP/1.1\r\nContent-Length: 65\r\n\r\n") == 413);
+  assert(parse_error("GET / HTTP/1.1\r\nX-Big: " + std::string(300, 'x')) == 431);
+
+#ifndef _WIN32
+  alpha::HttpServer server;
+  const alpha::Result started = server.start(
+      {.bind_host = "127.0.0.1", .port = 0, .worker_threads = 2, .request_timeout_ms = 2000, .idle_timeout_ms = 300},
+      [](const alpha::HttpRequest& request) {
+        if (request.target == "/slow") {
+          std::this_thread::sleep_for(std::chrono::milliseconds(400));
+        }
+        return alpha::HttpResponse{.body = request.target + ":" + request.body};
+      });
+  assert(started.ok);
+  assert(server.bound_port() != 0);
+
+  // A slow handler holds one worker while another connection is served.
+  LoopbackHttpClient slow(server.bound_port());
+  slow.send_request("/slow", "1");
+  const auto fast_started = std::chrono::steady_clock::now();
+  LoopbackHttpClient fast(server.bound_port());
+  for (int i = 0; i < 3; ++i) {
+    fast.send_request("/fast", std::to_string(i));
+    const auto [head, body] = fast.read_response();
+    assert(head.starts_with("HTTP/1.1 200 OK"));
+    assert(head.find("Connection: keep-alive") != std::string::npos);
+    assert(body == "/fast:" + std::to_string(i));
+  }
+  assert(std::chrono::steady_clock::now() - fast_started < std::chrono::milliseconds(350));
+  const auto [slow_head, slow_body] = slow.read_response();
+  assert(slow_body == "/slow:1");
+
+  // Pipelined requests come back in order; Connection: close ends the link.
+  LoopbackHttpClient pipelined(server.bound_port());
+  pipelined.send_raw("POST /a HTTP/1.1\r\nContent-Length: 1\r\n\r\nxPOST /b HTTP/1.1\r\nContent-Length: 1\r\n"
+                     "Connection: close\r\n\r\ny");
+  const auto [first_head, first_body] = pipelined.read_response();
+  assert(first_body == "/a:x");
+  const auto [closing_head, closing_body] = pipelined.read_response();
+  assert(closing_body == "/b:y");
+  assert(closing_head.find("Connection: close") != std::string::npos);
+  assert(pipelined.closed_by_peer());
+
+  // Malformed requests get an error status and a closed connection.
+  LoopbackHttpClient broken(server.bound_port());
+  broken.send_raw("POST / HTTP/1.1\r\nTransfer-Encoding: chunked\r\n\r\n");
+  const auto [broken_head, broken_body] = broken.read_response();
+  assert(broken_head.starts_with("HTTP/1.1 501"));
+  assert(broken.closed_by_peer());
+
+  // Idle keep-alive connections are closed on their deadline.
+  LoopbackHttpClient idle(server.bound_port());
+  idle.send_request("/once", "");
+  const auto [idle_head, idle_body] = idle.read_response();
+  assert(idle_body == "/once:");
+  assert(idle.closed_by_peer());
+
+  const alpha::HttpServerStats stats = server.stats();
+  assert(stats.requests == 7);
+  assert(stats.keep_alive_reuses == 3);
+  assert(stats.bad_requests == 1);
+  assert(stats.timeouts >= 1);
+  assert(stats.handlers_in_flight == 0);
+  server.stop();
+  assert(!server.running());
+  assert(server.stats().open_connections == 0);
+#endif
+}
+
+void test_unix_socket_rpc_framing() {
+#ifndef _WIN32
+  std::string frames;
+  alpha::append_rpc_frame(frames, "abc");
+  alpha::append_rpc_frame(frames, "");
+  assert(frames == std::string("\0\0\0\x03" "abc" "\0\0\0\0", 11));
+  assert(alpha::rpc_frame_length(frames) == std::optional<std::size_t>{3});
+  assert(!alpha::rpc_frame_length(std::string_view{"\0\0", 2}).has_value());
+
+  const auto dir = temp_dir("unix-rpc");
+  const std::string path = (dir / "rpc.sock").string();
+  alpha::HttpServer server;
+  const alpha::Result started = server.start(
+      {.bind_host = "127.0.0.1", .port = 0, .worker_threads = 2, .max_body_bytes = 1024, .unix_socket_path = path},
+      [](const alpha::HttpRequest& request) {
+        if (request.body == "empty") {
+          return alpha::HttpResponse{.status = 204};
+        }
+        if (request.body == "stream") {
+          auto left = std::make_shared<int>(3);
+          return alpha::HttpResponse{.stream = [left](std::string& out) {
+            out += std::to_string((*left)--);
+            return *left > 0;
+          }};
+        }
+        return alpha::HttpResponse{.body = std::string{request.local ? "local:" : "tcp:"} + request.body};
+      });
+  assert(started.ok);
+  assert((std::filesystem::status(path).permissions() & std::filesystem::perms::all) ==
+         (std::filesystem::perms::owner_read | std::filesystem::perms::owner_write));
+
+  // A second server cannot take over a live socket.
+  alpha::HttpServer rival;
+  const alpha::Result taken_over = rival.start({.port = 0, .unix_socket_path = path},
+                                               [](const alpha::HttpRequest&) { return alpha::HttpResponse{}; });
+  assert(!taken_over.ok);
+
+  // HTTP works on the unix socket too, and is marked local; TCP is not.
+  LoopbackHttpClient http(path);
+  http.send_request("/", "hi");
+  const auto [local_head, local_body] = http.read_response();
+  assert(local_body == "local:hi");
+  LoopbackHttpClient tcp(server.bound_port());
+  tcp.send_request("/", "hi");
+  const auto [tcp_head, tcp_body] = tcp.read_response();
+  assert(tcp_body == "tcp:hi");
+
+  // Frames: pipelined, streams collected, 204 as an empty frame.
+  LoopbackHttpClient framed(path);
+  std::string requests;
+  for (const std::string_view body : {"one", "stream", "empty", "two"}) {
+    alpha::append_rpc_frame(requests, body);
+  }
+  framed.send_raw(requests.substr(0, 5));
+  std::this_thread::sleep_for(std::chrono::milliseconds(20));
+  framed.send_raw(requests.substr(5));
+  for (const std::string_view expected : {"local:one", "321", "", "local:two"}) {
+    const std::optional<std::string> frame = framed.read_frame();
+    assert(frame == std::optional<std::string>{expected});
+  }
+
+  // An oversized frame is refused and the connection closed.
+  LoopbackHttpClient oversized(path);
+  oversized.send_raw(std::string("\0\0\x08\0", 4));
+  const std::optional<std::string> refused = oversized.read_frame();
+  assert(refused.value().find("Content Too Large") != std::string::npos);
+  assert(oversized.closed_by_peer());
+
+  const alpha::HttpServerStats stats = server.stats();
+  assert(stats.local_connections == 4);  // the rival's liveness probe included
+  assert(stats.framed_requests == 4);
+  server.stop();
+  assert(!std::filesystem::exists(path));
+
+  // A stale socket left behind by a dead process is replaced.
+  int stale = alpha::util::kInvalidSocket;
+  const alpha::Result stale_listening = alpha::util::listen_unix(path, 1, stale);
+  assert(stale_listening.ok);
+  alpha::util::close_socket(stale);
+  assert(std::filesystem::exists(path));
+  const alpha::Result restarted = server.start({.port = 0, .unix_socket_path = path},
+                                               [](const alpha::HttpRequest&) { return alpha::HttpResponse{}; });
+  assert(restarted.ok);
+  server.stop();
+#endif
+}
+
+std::uint16_t free_loopback_port() {
+  int fd = alpha::util::kInvalidSocket;
+  const alpha::Result listening = alpha::util::listen_tcp("127.0.0.1", 0, 1, fd);
+  assert(listening.ok);
+  const std::uint16_t port = alpha::util::local_port(fd);
+  alpha::util::close_socket(fd);
+  return port;
+}
+
+#ifndef _WIN32
+// Starts P2P nodes on free loopback ports for multi-node tests. Node i dials
+// the nodes listed in dials[i] and serves bodies from stores[i], which must
+// outlive it; unless told otherwise it also indexes that store.
+void start_loopback_nodes(std::span<alpha::P2PNode> nodes, std::span<std::vector<alpha::EventEnvelope>> stores,
+                          std::string_view cid_prefix, const std::vector<std::vector<std::size_t>>& dials,
+                          bool index_stores = true) {
+  assert(stores.size() == nodes.size() && dials.size() == nodes.size());
+  std::vector<std::uint16_t> ports;
+  for (std::size_t i = 0; i < nodes.size(); ++i) {
+    ports.push_back(free_loopback_port());
+  }
+  for (std::size_t i = 0; i < nodes.size(); ++i) {
+    std::vector<std::string> seeds;
+    for (const std::size_t peer : dials[i]) {
+      seeds.push_back("127.0.0.1:" + std::to_string(ports[peer]));
+    }
+    const std::string cid = std::string{cid_prefix} + std::to_string(i);
+    const alpha::Result started =
+        nodes[i].start(seeds, {.host = "127.0.0.1", .port = 4444}, cid, true, ports[i], "testnet");
+    assert(started.ok);
+    auto& store = stores[i];
+    nodes[i].set_event_lookup([&store](std::string_view id) -> const alpha::EventEnvelope* {
+      const auto it = std::ranges::find(store, id, &alpha::EventEnvelope::event_id);
+      return it == store.end() ? nullptr : &*it;
+    });
+    if (index_stores) {
+      nodes[i].index_events(store);
+    }
+  }
+}
+
+// Moves what each node received into its store.
+void deliver_received(std::span<alpha::P2PNode> nodes, std::span<std::vector<alpha::EventEnvelope>> stores) {
+  for (std::size_t i = 0; i < nodes.size(); ++i) {
+    for (auto& event : nodes[i].take_received_events()) {
+      stores[i].push_back(std::move(event));
+    }
+  }
+}
+#endif
+
+// Ticks every node until done() holds or the rounds run out. done() runs
+// after each round, so it may also collect what the nodes produced.
+template <typename Nodes, typename Done>
+bool pump_until(Nodes& nodes, Done&& done, int rounds = 400,
+                std::chrono::milliseconds pause = std::chrono::milliseconds(2)) {
+  for (int round = 0; round < rounds; ++round) {
+    for (auto& node : nodes) {
+      (void)node.sync_tick();
+    }
+    if (done()) {
+      return true;
+    }
+    std::this_thread::sleep_for(pause);
+  }
+  return false;
+}
+
+void test_change_feed_and_event_streams() {
+  using Kind = alpha::StoreChange::Kind;
+  alpha::ChangeFeed feed(4);
+  for (int i = 0; i < 6; ++i) {
+    feed.publish({.kind = i % 2 == 0 ? Kind::EventApplied : Kind::BlockConfirmed, .id = std::to_string(i)});
+  }
+  assert(feed.last_seq() == 6);
+  alpha::ChangeBatch batch = feed.read_after(0, alpha::kAllChangeTopics, 100);
+  assert(batch.missed && batch.cursor == 6 && batch.notices.size() == 4);
+  assert(batch.notices.front().seq == 3 && batch.notices.front().change.id == "2");
+  batch = feed.read_after(3, alpha::change_topic_bit(Kind::BlockConfirmed), 100);
+  assert(!batch.missed && batch.cursor == 6 && batch.notices.size() == 2);
+  assert(batch.notices[0].seq == 4 && batch.notices[1].seq == 6);
+  batch = feed.read_after(3, alpha::kAllChangeTopics, 1);
+  assert(batch.notices.size() == 1 && batch.cursor == 4);
+  batch = feed.read_after(6, alpha::kAllChangeTopics, 100);
+  assert(batch.notices.empty() && !batch.missed && batch.cursor == 6);
+  assert(alpha::parse_change_topics("block, balance") ==
+         (alpha::change_topic_bit(Kind::BlockConfirmed) | alpha::change_topic_bit(Kind::BalanceChanged)));
+  assert(alpha::parse_change_topics("") == alpha::kAllChangeTopics);
+  assert(!alpha::parse_change_topics("event,blocks").has_value());
+
+  // The store reports appends, confirmations and balance moves.
+  alpha::Store store;
+  const auto dir = temp_dir("store-changes");
+  const alpha::Result opened = store.open(dir.string(), "vault-key");
+  assert(opened.ok);
+  std::vector<alpha::StoreChange> changes;
+  store.set_change_listener([&changes](const alpha::StoreChange& change) { changes.push_back(change); });
+  store.set_block_timing(1);
+  const std::int64_t now = alpha::util::unix_timestamp_now();
+  const alpha::Result checked = store.routine_block_check(now + 5);
+  assert(checked.ok);
+  const auto confirmed = std::ranges::find_if(changes, [](const alpha::StoreChange& change) {
+    return change.kind == Kind::BlockConfirmed;
+  });
+  assert(confirmed != changes.end() && confirmed->id.size() == 64);
+
+  const std::uint64_t claimed_block = 4;
+  const std::int64_t reward = store.next_claim_reward(claimed_block);
+  const std::string pow_material = "claim|4|cid-a|" + std::to_string(now);
+  int nonce = 0;
+  while (!alpha::util::has_leading_zero_nibbles(
+      alpha::util::sha256_like_hex(pow_material + "|" + std::to_string(nonce)), 1)) {
+    ++nonce;
+  }
+  const std::string pow_hash = alpha::util::sha256_like_hex(pow_material + "|" + std::to_string(nonce));
+  alpha::EventEnvelope claim{
+      .event_id = "evt-claim-1",
+      .kind = alpha::EventKind::BlockRewardClaimed,
+      .author_cid = "cid-a",
+      .unix_ts = now,
+      .payload = alpha::util::canonical_join({
+          {"block_index", std::to_string(claimed_block)},
+          {"reward", std::to_string(reward)},
+          {"pow_difficulty", "1"},
+          {"pow_nonce", std::to_string(nonce)},
+          {"pow_hash", pow_hash},
+          {"pow_material", pow_material},
+          {"witness_root", alpha::util::sha256_like_hex("cid-a|4|" + std::to_string(reward) + "|" + pow_hash)},
+      }),
+      .signature = "sig",
+  };
+  changes.clear();
+  const alpha::Result claimed = store.append_event(claim);
+  assert(claimed.ok);
+  assert(!changes.empty() && changes.front().kind == Kind::EventApplied && changes.front().id == "evt-claim-1");
+  assert(changes.front().detail == "BlockRewardClaimed");
+  const auto credited = std::ranges::find_if(changes, [](const alpha::StoreChange& change) {
+    return change.kind == Kind::BalanceChanged && change.id == "cid-a";
+  });
+  assert(credited != changes.end() && credited->value == reward && credited->delta == reward);
+  changes.clear();
+  const alpha::Result materialized = store.materialize_views();
+  assert(materialized.ok);
+  assert(changes.empty());  // nothing moved
+
+#ifndef _WIN32
+  // An event stream with nothing to send parks: no timeout, no polling,
+  // until wake_streams() runs it again.
+  alpha::ChangeFeed live;
+  alpha::HttpServer server;
+  const alpha::Result started = server.start(
+      {.bind_host = "127.0.0.1", .port = 0, .worker_threads = 1, .request_timeout_ms = 100, .idle_timeout_ms = 100},
+      [&live](const alpha::HttpRequest&) {
+        auto cursor = std::make_shared<std::uint64_t>(0);
+        return alpha::HttpResponse{.content_type = "text/event-stream", .stream = [&live, cursor](std::string& out) {
+          const alpha::ChangeBatch next = live.read_after(*cursor, alpha::kAllChangeTopics, 16);
+          for (const alpha::ChangeNotice& notice : next.notices) {
+            out += notice.change.id + "\n";
+          }
+          *cursor = next.cursor;
+          return true;
+        }};
+      });
+  assert(started.ok);
+  live.set_publish_hook([&server] { server.wake_streams(); });
+
+  LoopbackHttpClient watcher(server.bound_port());
+  watcher.send_raw("GET /events HTTP/1.1\r\nHost: 127.0.0.1\r\n\r\n");
+  const std::string watcher_head = watcher.read_head();
+  assert(watcher_head.find("Transfer-Encoding: chunked") != std::string::npos);
+  const auto wait_parked = [&server](std::size_t parked) {
+    for (int i = 0; i < 200 && server.stats().parked_streams != parked; ++i) {
+      std::this_thread::sleep_for(std::chrono::milliseconds(5));
+    }
+    return server.stats().parked_streams == parked;
+  };
+  const bool parked = wait_parked(1);
+  assert(parked);
+  std::this_thread::sleep_for(std::chrono::milliseconds(300));  // past both timeouts
+  live.publish({.id = "first"});
+  const std::optional<std::string> first_chunk = watcher.read_chunk();
+  assert(first_chunk == std::optional<std::string>{"first\n"});
+  live.publish({.id = "second"});
+  live.publish({.id = "third"});
+  std::string seen;
+  while (seen.size() < std::string_view{"second\nthird\n"}.size()) {
+    const std::optional<std::string> chunk = watcher.read_chunk();
+    assert(chunk.has_value());
+    seen += *chunk;
+  }
+  assert(seen == "second\nthird\n");
+  const bool parked_again = wait_parked(1);
+  assert(parked_again && server.stats().timeouts == 0);
+
+  // Collected bodies end at the first empty piece instead of waiting.
+  LoopbackHttpClient legacy(server.bound_port());
+  legacy.send_raw("GET /events HTTP/1.0\r\n\r\n");
+  const auto [head, body] = legacy.read_response();
+  assert(head.find("Content-Length: 19") != std::string::npos && body == "first\nsecond\nthird\n");
+
+  live.set_publish_hook(nullptr);
+  server.stop();
+  assert(server.stats().parked_streams == 0);
+  server.wake_streams();  // harmless once stopped
+#endif
+}
+
+void test_response_cache_generations_and_lru() {
+  alpha::ResponseCache cache({.max_entries = 3, .max_bytes = 64, .max_entry_bytes = 32});
+  const auto body = [](std::string text) { return std::make_shared<const std::string>(std::move(text)); };
+  assert(cache.find("node.status", 1) == nullptr);
+  cache.insert("node.status", 1, body("{\"peers\":1}"));
+  const alpha::ResponseCache::Body hit = cache.find("node.status", 1);
+  assert(hit && *hit == "{\"peers\":1}");
+
+  // A newer generation never sees the old answer, and the entry goes.
+  assert(cache.find("node.status", 2) == nullptr);
+  assert(cache.stats().stale == 1 && cache.stats().entries == 0);
+  assert(*hit == "{\"peers\":1}");  // still held by whoever got it
+
+  cache.insert("a", 5, body("1"));
+  cache.insert("b", 5, body("2"));
+  cache.insert("c", 5, body("3"));
+  assert(cache.find("a", 5) != nullptr);  // a is now the most recent
+  cache.insert("d", 5, body("4"));        // evicts b, the least recent
+  assert(cache.find("b", 5) == nullptr && cache.find("c", 5) && cache.find("a", 5) && cache.find("d", 5));
+  cache.insert("a", 6, body("one"));  // replaces in place
+  assert(cache.stats().entries == 3 && *cache.find("a", 6) == "one");
+
+  // Byte bounds: oversized results are not kept, and a large one pushes
+  // out as many cold entries as it takes.
+  cache.insert("huge", 6, body(std::string(33, 'x')));
+  assert(cache.find("huge", 6) == nullptr && cache.stats().oversized == 1);
+  cache.insert("big", 6, body(std::string(30, 'x')));
+  cache.insert("big2", 6, body(std::string(32, 'y')));  // over 64 bytes until a goes too
+  const alpha::ResponseCacheStats stats = cache.stats();
+  assert(stats.bytes == 62 && stats.entries == 2 && stats.evictions == 4);
+  assert(cache.find("big2", 6) && cache.find("big", 6) && !cache.find("a", 6));
+  assert(cache.stats().hits + cache.stats().misses == 13);
+
+  cache.clear();
+  assert(cache.stats().entries == 0 && cache.stats().bytes == 0 && cache.find("big", 6) == nullptr);
+
+  // The store's generation moves with each applied change and not on reads.
+  alpha::Store store;
+  const auto dir = temp_dir("store-generation");
+  const alpha::Result opened = store.open(dir.string(), "vault-key");
+  assert(opened.ok);
+  std::uint64_t generation = store.generation();
+  (void)store.query_recipes({.text = "soup", .category = {}});
+  assert(store.generation() == generation);
+  alpha::EventEnvelope event{
+      .event_id = "evt-gen-1",
+      .kind = alpha::EventKind::RecipeCreated,
+      .author_cid = "cid-test",
+      .unix_ts = alpha::util::unix_timestamp_now(),
+      .payload = alpha::util::canonical_join({{"recipe_id", "rcp-gen"}, {"category", "Soup"}, {"title", "Gen Soup"},
+                                              {"markdown", "Stir"}}),
+      .signature = "sig",
+  };
+  const alpha::Result appended = store.append_event(event);
+  assert(appended.ok);
+  assert(store.generation() > generation);
+  generation = store.generation();
+  store.set_block_timing(1);
+  const alpha::Result checked = store.routine_block_check(alpha::util::unix_timestamp_now() + 5);
+  assert(checked.ok);
+  assert(store.generation() > generation);
+}
+
+void test_rolling_seen_filter() {
+  alpha::RollingBloomFilter filter({.max_bytes = 16U * 1024U, .false_positive_rate = 0.001});
+  const alpha::RollingBloomStats empty = filter.stats();
+  assert(empty.bytes == 16U * 1024U);
+  assert(empty.window > 1000U && empty.hash_functions >= 10U);
+  const auto id = [](std::size_t i) { return "evt-seen-" + std::to_string(i); };
+
+  // Every key of the latest window is remembered, with no false negatives.
+  const std::size_t window = empty.window;
+  for (std::size_t i = 0; i < window; ++i) {
+    filter.insert(id(i));
+  }
+  for (std::size_t i = 0; i < window; ++i) {
+    assert(filter.contains(id(i)));
+  }
+  std::size_t false_positives = 0;
+  for (std::size_t i = 0; i < 10000; ++i) {
+    false_positives += filter.contains("evt-unseen-" + std::to_string(i)) ? 1U : 0U;
+  }
+  assert(false_positives < 40U);
+
+  // Memory stays fixed while ids roll through; old generations are forgotten.
+  for (std::size_t i = window; i < 3U * window; ++i) {
+    filter.insert(id(i));
+  }
+  assert(filter.stats().bytes == empty.bytes);
+  assert(filter.stats().rotations == 2U);
+  for (std::size_t i = 2U * window; i < 3U * window; ++i) {
+    assert(filter.contains(id(i)));
+  }
+  std::size_t remembered = 0;
+  for (std::size_t i = 0; i < window; ++i) {
+    remembered += filter.contains(id(i)) ? 1U : 0U;
+  }
+  assert(remembered < window / 50U);
+
+  // The node remembers ids once they are stored. Misses cost no store call,
+  // and positives are confirmed against the store.
+  alpha::P2PNode node;
+  node.configure_seen_filter({.max_bytes = 4096, .false_positive_rate = 0.01});
+  const alpha::Result node_started =
+      node.start({}, {.host = "127.0.0.1", .port = 4444}, "cid-seen", false, free_loopback_port(), "testnet");
+  assert(node_started.ok);
+  std::size_t lookups = 0;
+  std::vector<alpha::EventEnvelope> stored;
+  node.set_event_lookup([&](std::string_view event_id) -> const alpha::EventEnvelope* {
+    ++lookups;
+    const auto it = std::ranges::find(stored, event_id, &alpha::EventEnvelope::event_id);
+    return it == stored.end() ? nullptr : &*it;
+  });
+  const alpha::EventEnvelope event{.event_id = "evt-seen-node", .kind = alpha::EventKind::RecipeCreated};
+  const bool fresh = node.ingest_remote_event(event);
+  assert(fresh);
+  assert(lookups == 0U);
+  stored.push_back(event);
+  node.mark_seen(std::vector<std::string>{event.event_id});
+  const bool repeated = node.ingest_remote_event(event);
+  assert(!repeated);
+  assert(lookups == 1U);
+  // A rejected copy is never marked, so a valid copy from another peer still
+  // gets through.
+  const alpha::EventEnvelope rejected{.event_id = "evt-seen-rejected", .kind = alpha::EventKind::RecipeCreated};
+  const bool first_copy = node.ingest_remote_event(rejected);
+  const bool second_copy = node.ingest_remote_event(rejected);
+  assert(first_copy && second_copy);
+  assert(lookups == 1U);
+  // A positive the store cannot confirm is treated as unseen.
+  node.mark_seen(std::vector<std::string>{"evt-seen-lost"});
+  const bool lost = node.ingest_remote_event({.event_id = "evt-seen-lost", .kind = alpha::EventKind::RecipeCreated});
+  assert(lost);
+  const alpha::NodeRuntimeStats stats = node.runtime_status();
+  assert(stats.seen_filter_bytes == 4096U);
+  assert(stats.seen_filter_store_checks == 2U);
+  assert(stats.seen_filter_false_positives == 1U);
+  node.stop();
+}
+
+void test_peer_table_scoring_and_persistence() {
+  constexpr std::int64_t kNow = 1700000000;
+  alpha::PeerTable table;
+  for (const std::string_view endpoint : {"10.0.0.1:4001", "10.0.0.2:4001"}) {
+    const bool added = table.add(endpoint, true);
+    assert(added);
+  }
+  const bool learned = table.add("10.0.0.3:4001", false);
+  assert(learned);
+  const bool readded = table.add("10.0.0.3:4001", true);
+  assert(!readded);
+  assert(table.find("10.0.0.3:4001")->configured);
+  table.record_rtt("10.0.0.1:4001", 20.0);
+  table.record_throughput("10.0.0.1:4001", 64 * 1024, 0.05);
+  table.record_rtt("10.0.0.2:4001", 800.0);
+  assert(table.score("10.0.0.1:4001", kNow) > table.score("10.0.0.2:4001", kNow));
+  // An untried peer ranks below measured healthy ones.
+  assert(table.score("10.0.0.2:4001", kNow) > table.score("10.0.0.3:4001", kNow));
+
+  // Three selections keep the two best; the fourth explores the untried one.
+  const std::vector<std::string> best{"10.0.0.1:4001", "10.0.0.2:4001"};
+  for (int round = 0; round < 3; ++round) {
+    const std::vector<std::string> picked = table.select(2, kNow, {});
+    assert(picked == best);
+  }
+  const std::vector<std::string> explored = table.select(2, kNow, {});
+  assert((explored == std::vector<std::string>{"10.0.0.1:4001", "10.0.0.3:4001"}));
+  assert(table.stats(kNow).explorations == 1);
+  const std::vector<std::string> filtered =
+      table.select(1, kNow, [](const alpha::PeerRecord& record) { return record.endpoint != "10.0.0.1:4001"; });
+  assert((filtered == std::vector<std::string>{"10.0.0.2:4001"}));
+
+  // Failures and misbehavior pull a peer down; crossing the threshold bans it.
+  const double healthy = table.score("10.0.0.1:4001", kNow);
+  table.record_failure("10.0.0.1:4001", kNow);
+  assert(table.score("10.0.0.1:4001", kNow) < healthy);
+  table.record_connected("10.0.0.1:4001", kNow);
+  assert(table.find("10.0.0.1:4001")->failures == 0);
+  const bool banned_early = table.record_misbehavior("10.0.0.2:4001", 60, kNow);
+  assert(!banned_early);
+  const bool banned_now = table.record_misbehavior("10.0.0.2:4001", 60, kNow);
+  assert(banned_now);
+  assert(table.banned("10.0.0.2:4001", kNow));
+  assert(!table.banned("10.0.0.2:4001", kNow + 2 * 24 * 60 * 60));
+  assert(table.stats(kNow).banned == 1);
+  for (const auto& picked : table.select(3, kNow, {})) {
+    assert(picked != "10.0.0.2:4001");
+  }
+
+  alpha::PeerTable capped({.max_learned = 2});
+  const bool capped_first = capped.add("10.0.1.1:4001", false);
+  assert(capped_first);
+  capped.record_failure("10.0.1.1:4001", kNow);
+  for (const std::string_view endpoint : {"10.0.1.2:4001", "10.0.1.3:4001"}) {
+    const bool added = capped.add(endpoint, false);
+    assert(added);
+  }
+  assert(capped.size() == 2 && !capped.contains("10.0.1.1:4001"));
+
+  // The node keeps peers.dat as a plain endpoint list and stores the table
+  // beside it; learned peers only appear in the table.
+  const auto dir = temp_dir("peer-table");
+  const std::string peers_dat = (dir / "peers.dat").string();
+  const alpha::Result table_saved = table.save(alpha::P2PNode::peer_table_path(peers_dat));
+  assert(table_saved.ok);
+  {
+    std::ofstream out(peers_dat);
+    out << "# test peers\n10.0.0.1:4001\n";
+  }
+  alpha::P2PNode node;
+  const alpha::Result loaded = node.load_peers_dat(peers_dat);
+  assert(loaded.ok);
+  assert((node.peers() == std::vector<std::string>{"10.0.0.1:4001"}));
+  assert(node.runtime_status().peer_table_size == 3);
+  const alpha::Result peer_added = node.add_peer("10.0.0.9:4001");
+  assert(peer_added.ok);
+  const alpha::Result peers_saved = node.save_peers_dat(peers_dat);
+  assert(peers_saved.ok);
+
+  alpha::PeerTable reloaded;
+  const alpha::Result reloaded_table = reloaded.load(alpha::P2PNode::peer_table_path(peers_dat));
+  assert(reloaded_table.ok);
+  assert(reloaded.size() == 4);
+  const alpha::PeerRecord* fast = reloaded.find("10.0.0.1:4001");
+  assert(fast != nullptr && std::abs(fast->rtt_ms - 20.0) < 1e-9 && fast->successes == 1);
+  assert(reloaded.find("10.0.0.2:4001")->banned_until_unix > kNow);
+  std::ifstream saved(peers_dat);
+  const std::string contents((std::istreambuf_iterator<char>(saved)), std::istreambuf_iterator<char>());
+  assert(contents.find("10.0.0.9:4001") != std::string::npos);
+  assert(contents.find("10.0.0.3:4001") == std::string::npos);
+}
+
+void test_wire_frame_compression() {
+  // A frame of canonical events shrinks well below its raw size and decodes
+  // back bit for bit.
+  std::vector<alpha::EventEnvelope> events;
+  for (int i = 0; i < 40; ++i) {
+    const std::string id = "evt-" + alpha::util::sha256_like_hex("compress-" + std::to_string(i)).substr(0, 16);
+    events.push_back({
+        .event_id = id,
+        .kind = alpha::EventKind::RecipeCreated,
+        .author_cid = "cid-0123456789abcdef",
+        .unix_ts = 1700000000 + i,
+        .payload = alpha::util::canonical_join({
+            {"author_cid", "cid-0123456789abcdef"},
+            {"author_pubkey", "a1b2c3d4e5f60718"},
+            {"category", "Soup"},
+            {"chain_id", "got-soup-mainnet-v3"},
+            {"community_id", "recipes"},
+            {"kind", "0"},
+            {"markdown", "Simmer tomatoes for " + std::to_string(i) + " minutes."},
+            {"network_id", "mainnet"},
+            {"recipe_id", "rcp-" + std::to_string(i)},
+            {"title", "Soup " + std::to_string(i)},
+            {"unix_ts", std::to_string(1700000000 + i)},
+        }),
+        .signature = alpha::util::sha256_like_hex("sig-" + id).substr(0, 16),
+    });
+  }
+  const std::string raw = alpha::wire::encode_events(events);
+  const auto packed = alpha::wire::encode_compressed(alpha::wire::MessageType::Events, raw);
+  assert(packed.has_value());
+  assert(packed->size() * 2U < raw.size());
+  const auto unpacked = alpha::wire::decode_compressed(*packed);
+  assert(unpacked.has_value() && unpacked->first == alpha::wire::MessageType::Events);
+  assert(unpacked->second == raw);
+
+  // The dictionary alone carries a single event's repeated keys.
+  const std::string one = alpha::wire::encode_events({events.front()});
+  assert(alpha::wire::compress(one, alpha::wire::event_dictionary()).size() <
+         alpha::wire::compress(one, {}).size());
+  assert(alpha::wire::decompress(alpha::wire::compress({}, {}), {}, 16) == std::string{});
+  const std::string runs(5000, 'x');
+  assert(alpha::wire::decompress(alpha::wire::compress(runs, {}), {}, runs.size()) == runs);
+
+  // Tiny bodies stay raw; damaged or oversized streams are rejected.
+  assert(!alpha::wire::encode_compressed(alpha::wire::MessageType::Events, "short body").has_value());
+  assert(!alpha::wire::decompress(alpha::wire::compress(runs, {}), {}, runs.size() - 1U).has_value());
+  std::string truncated = *packed;
+  truncated.resize(truncated.size() / 2U);
+  assert(!alpha::wire::decode_compressed(truncated).has_value());
+  std::string nested = *packed;
+  nested.front() = static_cast<char>(alpha::wire::MessageType::Compressed);
+  assert(!alpha::wire::decode_compressed(nested).has_value());
+  const std::string bad_distance{"\x08\x00\x04\x7f"};
+  assert(!alpha::wire::decompress(bad_distance, {}, 64).has_value());
+
+#ifndef _WIN32
+  // A serves its events to B (compression off) and C. Only the C link
+  // negotiates the dictionary; B is served raw frames.
+  std::array<alpha::P2PNode, 3> nodes;
+  nodes[1].set_compression(false);
+  std::array<std::vector<alpha::EventEnvelope>, 3> stores{events, {}, {}};
+  start_loopback_nodes(nodes, stores, "cid-compress-", {{}, {0}, {0}});
+  const bool relayed = pump_until(nodes, [&] {
+    deliver_received(nodes, stores);
+    return stores[1].size() == events.size() && stores[2].size() == events.size();
+  });
+  assert(relayed);
+  const auto served = nodes[0].runtime_status();
+  assert(served.frames_compressed > 0 && served.compression_saved_bytes > raw.size() / 2U);
+  assert(nodes[1].runtime_status().frames_compressed == 0);
+#endif
+}
+
+void test_compact_block_relay() {
+  std::vector<alpha::EventEnvelope> events;
+  for (int i = 0; i < 30; ++i) {
+    const std::string id = "evt-" + alpha::util::sha256_like_hex("compact-" + std::to_string(i)).substr(0, 16);
+    events.push_back({
+        .event_id = id,
+        .kind = alpha::EventKind::RecipeCreated,
+        .author_cid = "cid-compact",
+        .unix_ts = 1700000000 + i * 10,
+        .payload = "title=Soup " + std::to_string(i) + "\n",
+        .signature = "sig-" + id,
+    });
+  }
+  alpha::Store::BlockRecord block{.index = 5, .opened_unix = 1700000000, .confirmed = true};
+  std::vector<const alpha::EventEnvelope*> bodies;
+  for (const auto& event : events) {
+    block.event_ids.push_back(event.event_id);
+    bodies.push_back(&event);
+  }
+  block.merkle_root = alpha::Store::block_merkle_root(events);
+  block.content_hash = alpha::Store::block_content_hash(events);
+  block.block_hash = alpha::util::sha256_like_hex("compact-block");
+
+  // Six bytes per event instead of the id list; the header survives the
+  // round trip.
+  const alpha::CompactBlock compact = alpha::make_compact_block(block, bodies, 99);
+  const std::string body = alpha::wire::encode_compact_block(compact);
+  assert(body.size() < alpha::wire::encode_headers(std::vector<alpha::Store::BlockRecord>{block}).size() / 2U);
+  const auto decoded = alpha::wire::decode_compact_block(body);
+  assert(decoded.has_value() && decoded->short_ids == compact.short_ids);
+  assert(decoded->header.merkle_root == block.merkle_root && decoded->header.event_ids.empty());
+  assert(decoded->min_unix_ts == 1700000000 && decoded->max_unix_ts == 1700000290);
+  assert(!alpha::wire::decode_compact_block(body.substr(0, body.size() - 1U)).has_value());
+  // The salt changes with the nonce.
+  assert(alpha::make_compact_block(block, bodies, 100).short_ids != compact.short_ids);
+
+  // Matched locally except three; the fetched bodies complete the block.
+  const auto lookup = [&events](std::string_view id) -> const alpha::EventEnvelope* {
+    const auto it = std::ranges::find(events, id, &alpha::EventEnvelope::event_id);
+    return it == events.end() ? nullptr : &*it;
+  };
+  std::vector<std::string> candidates{"evt-unrelated"};
+  for (std::size_t i = 3; i < events.size(); ++i) {
+    candidates.push_back(events[i].event_id);
+  }
+  alpha::CompactBlockAssembly assembly(*decoded, candidates);
+  assert(assembly.matched() == 27 && (assembly.missing() == std::vector<std::uint32_t>{0, 1, 2}));
+  const bool unrelated = assembly.accept(events[5]);
+  assert(!unrelated);
+  for (std::size_t i = 0; i < 3; ++i) {
+    const bool filled = assembly.accept(events[i]);
+    assert(filled);
+  }
+  assert(assembly.complete() && assembly.verify(lookup));
+  const std::vector<alpha::EventEnvelope> fetched = assembly.take_fetched();
+  assert(fetched.size() == 3);
+
+  // A body that does not match the header fails verification; after
+  // forgetting matches the whole block is missing.
+  alpha::CompactBlockAssembly tampered(*decoded, candidates);
+  alpha::EventEnvelope forged = events[0];
+  forged.payload = "title=Not soup\n";
+  for (const alpha::EventEnvelope* body : {&forged, &events[1], &events[2]}) {
+    const bool filled = tampered.accept(*body);
+    assert(filled);
+  }
+  assert(!tampered.verify(lookup));
+  tampered.forget_matches();
+  assert(tampered.missing().size() == events.size() && tampered.matched() == 0);
+
+#ifndef _WIN32
+  // A announces the block to B, which holds all but three of its events.
+  // Both index the same 27 events, so reconciliation finds nothing to do
+  // and the three can only arrive through the compact block.
+  std::array<alpha::P2PNode, 2> nodes;
+  std::array<std::vector<alpha::EventEnvelope>, 2> stores{events, {events.begin() + 3, events.end()}};
+  start_loopback_nodes(nodes, stores, "cid-compact-", {{}, {0}}, false);
+  for (auto& node : nodes) {
+    node.index_events(std::span<const alpha::EventEnvelope>(events).subspan(3));
+  }
+  const bool linked = pump_until(nodes, [&nodes] {
+    return nodes[0].runtime_status().connected_peers != 0 && nodes[1].runtime_status().connected_peers != 0;
+  });
+  assert(linked);
+
+  alpha::Store::BlockRecord open_block = block;
+  open_block.confirmed = false;
+  nodes[0].announce_confirmed_blocks(std::span(&open_block, 1));
+  nodes[0].announce_confirmed_blocks(std::span(&open_block, 1));
+  assert(nodes[0].runtime_status().compact_blocks_sent == 0);
+  nodes[0].announce_confirmed_blocks(std::span(&block, 1));
+  nodes[0].announce_confirmed_blocks(std::span(&block, 1));
+  assert(nodes[0].runtime_status().compact_blocks_sent == 1);
+
+  const bool filled = pump_until(nodes, [&] {
+    deliver_received(nodes, stores);
+    return stores[1].size() == events.size();
+  });
+  assert(filled);
+  const auto received = nodes[1].runtime_status();
+  assert(received.compact_blocks_received == 1 && received.compact_blocks_reconstructed == 1);
+  assert(received.compact_block_events_fetched == 3);
+#endif
+}
+
+void test_socks5_proxied_transport() {
+  // The request rides right behind the greeting; replies may arrive split
+  // anywhere, and bytes after the CONNECT reply belong to the tunnel.
+  alpha::Socks5Handshake handshake(true);
+  assert(handshake.greeting() == std::string("\x05\x01\x02", 3));
+  const std::string request =
+      handshake.request({.host = "peer.onion", .port = 4001, .username = "u", .password = "pw"});
+  assert(request == std::string("\x01\x01u\x02pw\x05\x01\x00\x03\x0apeer.onion\x0f\xa1", 23));
+  assert(handshake.request({.host = "peer.onion", .port = 4001}).empty());
+  const std::size_t partial = handshake.feed(std::string_view{"\x05", 1});
+  assert(partial == 0 && !handshake.greeted());
+  const std::size_t method = handshake.feed(std::string_view{"\x05\x02\x01", 3});
+  assert(method == 2 && handshake.greeted());
+  const std::string replies("\x01\x00\x05\x00\x00\x03\x04host\x00\x50tail", 17);
+  const std::size_t consumed = handshake.feed(replies);
+  assert(consumed == replies.size() - 4U && handshake.done());
+
+  alpha::Socks5Handshake refused(false);
+  const std::size_t refused_used = refused.feed(std::string_view{"\x05\x00\x05\x05\x00\x01", 6});
+  assert(refused_used == 0 && refused.failed());
+  assert(refused.error().find("connection refused") != std::string::npos);
+  alpha::Socks5Handshake wrong_method(false);
+  const std::size_t wrong_used = wrong_method.feed(std::string_view{"\x05\xff", 2});
+  assert(wrong_used == 0 && wrong_method.failed());
+
+#ifndef _WIN32
+  Socks5StandIn proxy;
+  alpha::TcpTransport server;
+  const alpha::Result server_started = server.start({.bind_host = "127.0.0.1", .port = 0});
+  assert(server_started.ok);
+  alpha::TcpTransport client;
+  const alpha::Result client_started =
+      client.start({.listen = false,
+                    .socks_proxy = alpha::ProxyEndpoint{.host = "127.0.0.1", .port = proxy.port()},
+                    .socks_warm_connections = 1});
+  assert(client_started.ok);
+  for (int i = 0; i < 50 && client.stats().socks_warm == 0; ++i) {
+    (void)client.poll(5);
+  }
+  for (int i = 0; i < 10; ++i) {
+    (void)client.poll(5);
+  }
+  assert(client.stats().socks_warm == 1);
+
+  // A name the local resolver has never heard of: only the proxy sees it.
+  // The frame is queued before the tunnel exists and goes out behind the
+  // request.
+  const std::string endpoint = "peer-b.test:" + std::to_string(server.bound_port());
+  alpha::PeerId dialed = 0;
+  const alpha::Result dial = client.dial(endpoint, dialed);
+  assert(dial.ok && dialed != 0);
+  const bool queued = client.send(dialed, alpha::wire::MessageType::Inventory, "ping");
+  assert(queued);
+  assert(client.peer_ids().empty());
+  bool connected = false;
+  alpha::PeerId accepted = 0;
+  std::string server_got;
+  std::string client_got;
+  for (int i = 0; i < 400 && client_got.empty(); ++i) {
+    alpha::TransportPollResult polled = client.poll(2);
+    connected = connected || std::ranges::find(polled.connected, dialed) != polled.connected.end();
+    for (auto& frame : polled.frames) {
+      client_got = frame.body;
+    }
+    for (auto& frame : server.poll(2).frames) {
+      server_got = frame.body;
+      accepted = frame.peer;
+      const bool replied = server.send(accepted, alpha::wire::MessageType::Inventory, "pong");
+      assert(replied);
+    }
+  }
+  assert(connected && server_got == "ping" && client_got == "pong");
+  assert(client.peer_ids() == std::vector<alpha::PeerId>{dialed} && client.peer_endpoint(dialed) == endpoint);
+  const alpha::TcpTransportStats tunneled = client.stats();
+  assert(tunneled.socks_handshakes == 1 && tunneled.socks_warm_hits == 1);
+  // Per-destination credentials put each peer on its own circuit.
+  assert(proxy.requests().size() == 1U && proxy.requests().front() == "got-soup:" + endpoint + "@" + endpoint);
+
+  // A refused CONNECT surfaces as a disconnect of the dialed peer.
+  alpha::PeerId refused_peer = 0;
+  const alpha::Result refused_dial = client.dial("peer-c.test:" + std::to_string(free_loopback_port()), refused_peer);
+  assert(refused_dial.ok);
+  bool dropped = false;
+  for (int i = 0; i < 400 && !dropped; ++i) {
+    const alpha::TransportPollResult polled = client.poll(2);
+    dropped = std::ranges::find(polled.disconnected, refused_peer) != polled.disconnected.end();
+  }
+  assert(dropped && client.stats().socks_failures == 1);
+  client.stop();
+  server.stop();
+#endif
+}
+
+void test_outbound_ring_backpressure() {
+  // Four producers race one consumer through a small ring; every item must
+  // arrive once and in per-producer order, and a full ring refuses at once.
+  constexpr std::size_t kProducers = 4;
+  constexpr std::size_t kPerProducer = 20000;
+  alpha::util::MpscRing<std::pair<std::size_t, std::size_t>> ring(1000);
+  assert(ring.capacity() == 1024);
+  std::vector<std::thread> producers;
+  for (std::size_t p = 0; p < kProducers; ++p) {
+    producers.emplace_back([&ring, p] {
+      for (std::size_t i = 0; i < kPerProducer; ++i) {
+        while (!ring.try_push({p, i})) {
+          std::this_thread::yield();
+        }
+      }
+    });
+  }
+  std::array<std::size_t, kProducers> next{};
+  for (std::size_t received = 0; received < kProducers * kPerProducer;) {
+    const auto item = ring.try_pop();
+    if (!item.has_value()) {
+      std::this_thread::yield();
+      continue;
+    }
+    assert(item->second == next[item->first]);
+    ++next[item->first];
+    ++received;
+  }
+  for (auto& producer : producers) {
+    producer.join();
+  }
+  const auto drained = ring.try_pop();
+  assert(!drained.has_value());
+  for (std::size_t i = 0; i < ring.capacity(); ++i) {
+    const bool pushed = ring.try_push({0, i});
+    assert(pushed);
+  }
+  const bool overflowed = ring.try_push({0, 0});
+  assert(!overflowed);
+  assert(ring.size() == ring.capacity());
+
+#ifndef _WIN32
+  const auto make_event = [](const std::string& id, std::int64_t unix_ts) {
+    return alpha::EventEnvelope{
+        .event_id = id,
+        .kind = alpha::EventKind::RecipeCreated,
+        .author_cid = "cid-ring",
+        .unix_ts = unix_ts,
+        .payload = "title=" + id,
+        .signature = "sig-" + id,
+    };
+  };
+  alpha::P2PNode node;
+  const bool queued_stopped = node.queue_local_event(make_event("evt-not-running", 1700000000));
+  assert(!queued_stopped);
+  const alpha::Result started =
+      node.start({}, {.host = "127.0.0.1", .port = 4444}, "cid-ring", true, free_loopback_port(), "testnet");
+  assert(started.ok);
+  for (std::size_t i = 0; i < alpha::P2PNode::kOutboundRingCapacity; ++i) {
+    const bool queued = node.queue_local_event(make_event("evt-ring-" + std::to_string(i), 1700000000));
+    assert(queued);
+  }
+  const bool queued_overflow = node.queue_local_event(make_event("evt-ring-overflow", 1700000000));
+  assert(!queued_overflow);
+  auto status = node.runtime_status();
+  assert(status.outbound_queue == alpha::P2PNode::kOutboundRingCapacity);
+  assert(status.outbound_rejected == 1);
+  const auto ticked = node.sync_tick();
+  assert(ticked.size() == alpha::P2PNode::kOutboundRingCapacity);
+  assert(node.runtime_status().outbound_queue == 0);
+
+  // With the network thread running the ring drains without a sync tick.
+  node.start_network_thread();
+  assert(node.network_thread_running());
+  const bool queued_threaded = node.queue_local_event(make_event("evt-ring-threaded", 1700000001));
+  assert(queued_threaded);
+  for (int round = 0; round < 500 && node.runtime_status().outbound_queue != 0; ++round) {
+    std::this_thread::sleep_for(std::chrono::milliseconds(2));
+  }
+  assert(node.runtime_status().outbound_queue == 0);
+  const auto published = node.sync_tick();
+  assert(published.size() == 1 && published.front().event_id == "evt-ring-threaded");
+  node.stop();
+  assert(!node.network_thread_running());
+  assert(!node.running());
+#endif
+}
+
+void test_p2p_loopback_inventory_gossip() {
+#ifndef _WIN32
+  // Chain topology A -> B <-> C: C only learns A's event through B's relay,
+  // and the B/C pair dials both ways so one duplicate link must be dropped.
+  std::array<std::uint16_t, 3> ports{};
+  for (auto& port : ports) {
+    port = free_loopback_port();
+  }
+  std::array<alpha::CoreApi, 3> nodes;
+  std::array<std::filesystem::path, 3> dirs;
+  for (std::size_t i = 0; i < nodes.size(); ++i) {
+    dirs[i] = temp_dir("p2p-loopback-" + std::to_string(i));
+    std::vector<std::string> seeds;
+    if (i + 1U < nodes.size()) {
+      seeds.push_back("127.0.0.1:" + std::to_string(ports[i + 1U]));
+    } else {
+      seeds.push_back("127.0.0.1:" + std::to_string(ports[i - 1U]));
+    }
+    const alpha::Result init = nodes[i].init({
+        .app_data_dir = dirs[i].string(),
+        .passphrase = "integration-passphrase",
+        .mode = alpha::AnonymityMode::Tor,
+        .seed_peers_testnet = seeds,
+        .alpha_test_mode = true,
+        .community_profile_path = "recipes",
+        .production_swap = true,
+        .p2p_mainnet_port = 4001,
+        .p2p_testnet_port = ports[i],
+    });
+    assert(init.ok);
+    assert(nodes[i].node_status().p2p.listening);
+    assert(nodes[i].node_status().p2p.bind_port == ports[i]);
+  }
+  prepare_verified_backup(nodes[0], dirs[0]);
+
+  const alpha::Result created = nodes[0].create_recipe({
+      .category = "Soup",
+      .title = "Loopback Tomato Soup",
+      .markdown = "Simmer tomatoes, relay over TCP.",
+  });
+  assert(created.ok);
+
+  const auto has_recipe = [](alpha::CoreApi& api) {
+    return !api.search({.text = "loopback tomato", .category = {}}).empty();
+  };
+  const bool gossiped = pump_until(
+      nodes, [&] { return has_recipe(nodes[1]) && has_recipe(nodes[2]); }, 400, std::chrono::milliseconds(5));
+  assert(gossiped);
+  (void)pump_until(nodes, [] { return false; }, 20);  // let the duplicate link settle
+
+  // The alpha-mode self seed is detected by cid and never counted as a peer.
+  const alpha::NodeStatusReport middle = nodes[1].node_status();
+  assert(middle.p2p.connected_peers == 2);
+  assert(middle.p2p.frames_in > 0 && middle.p2p.frames_out > 0);
+  assert(nodes[0].node_status().p2p.connected_peers == 1);
+  assert(nodes[2].node_status().p2p.connected_peers == 1);
+
+  // Bodies move only on request: each downstream node fetched the event once.
+  assert(middle.p2p.events_requested == 1);
+  assert(middle.p2p.events_served == 1);
+  assert(nodes[2].node_status().p2p.events_requested == 1);
+  assert(nodes[0].node_status().p2p.events_served == 1);
+#endif
+}
+
+void test_p2p_reconnect_set_reconciliation() {
+  const auto make_event = [](const std::string& id, std::int64_t unix_ts) {
+    return alpha::EventEnvelope{
+        .event_id = id,
+        .kind = alpha::EventKind::RecipeCreated,
+        .author_cid = "cid-reconcile",
+        .unix_ts = unix_ts,
+        .payload = "title=" + id,
+        .signature = "sig-" + id,
+    };
+  };
+  std::vector<alpha::EventEnvelope> shared;
+  for (int i = 0; i < 3000; ++i) {
+    shared.push_back(make_event("evt-shared-" + std::to_string(i), 1700000000 + i * 37));
+  }
+
+  // Digests are order independent and splits partition the queried range.
+  alpha::EventSetIndex forward;
+  alpha::EventSetIndex backward;
+  forward.insert_all(shared);
+  for (auto it = shared.rbegin(); it != shared.rend(); ++it) {
+    const bool inserted = backward.insert(it->event_id, it->unix_ts);
+    assert(inserted);
+  }
+  const bool reinserted = backward.insert(shared.front().event_id, shared.front().unix_ts);
+  assert(!reinserted);
+  const auto all = forward.digest(alpha::EventSetIndex::kMinBucket, alpha::EventSetIndex::kMaxBucket);
+  assert(all == backward.digest(alpha::EventSetIndex::kMinBucket, alpha::EventSetIndex::kMaxBucket));
+  assert(all.count == shared.size());
+  const auto parts = forward.split(alpha::EventSetIndex::kMinBucket, alpha::EventSetIndex::kMaxBucket, 16);
+  assert(parts.size() == 16);
+  assert(parts.front().lo == alpha::EventSetIndex::kMinBucket);
+  assert(parts.back().hi == alpha::EventSetIndex::kMaxBucket);
+  std::uint32_t split_total = 0;
+  for (std::size_t i = 0; i < parts.size(); ++i) {
+    split_total += parts[i].digest.count;
+    assert(i == 0 || parts[i].lo == parts[i - 1U].hi);
+  }
+  assert(split_total == shared.size());
+
+#ifndef _WIN32
+  // Two nodes share a long history, then each picks up a few events while
+  // apart. Reconnecting must move only the difference.
+  std::array<alpha::P2PNode, 2> nodes;
+  std::array<std::vector<alpha::EventEnvelope>, 2> stores{shared, shared};
+  stores[0].push_back(make_event("evt-only-a-1", 1700050000));
+  stores[0].push_back(make_event("evt-only-a-2", 1700090000));
+  stores[0].push_back(make_event("evt-only-a-3", 1700110000));
+  stores[1].push_back(make_event("evt-only-b-1", 1700000100));
+  stores[1].push_back(make_event("evt-only-b-2", 1700100000));
+  start_loopback_nodes(nodes, stores, "cid-node-", {{1}, {}});
+
+  std::array<std::vector<std::string>, 2> fetched;
+  (void)pump_until(nodes, [&] {
+    for (std::size_t i = 0; i < nodes.size(); ++i) {
+      for (const auto& event : nodes[i].take_received_events()) {
+        fetched[i].push_back(event.event_id);
+      }
+    }
+    return fetched[0].size() >= 2U && fetched[1].size() >= 3U;
+  });
+  std::ranges::sort(fetched[0]);
+  std::ranges::sort(fetched[1]);
+  assert((fetched[0] == std::vector<std::string>{"evt-only-b-1", "evt-only-b-2"}));
+  assert((fetched[1] == std::vector<std::string>{"evt-only-a-1", "evt-only-a-2", "evt-only-a-3"}));
+
+  // Sending every shared id once would already cost ~50 KB.
+  const auto a = nodes[0].runtime_status();
+  const auto b = nodes[1].runtime_status();
+  assert(a.reconcile_messages > 0 && b.reconcile_messages > 0);
+  assert(a.bytes_out + b.bytes_out < 16U * 1024U);
+#endif
+}
+
+void test_p2p_headers_first_initial_sync() {
+#ifndef _WIN32
+  // Two seeded nodes hold the same 400-event chain; a fresh node pulls the
+  // headers from one of them and asks both for bodies. Node B serves a
+  // tampered body in every block, which must fail the merkle check and be
+  // refetched from A.
+  std::vector<alpha::EventEnvelope> events;
+  std::vector<alpha::Store::BlockRecord> chain(1);
+  chain[0].prev_hash = "genesis";
+  chain[0].block_hash = "test-genesis-hash";
+  for (std::uint64_t index = 1; index <= 50; ++index) {
+    alpha::Store::BlockRecord block;
+    block.index = index;
+    block.opened_unix = 1700000000 + static_cast<std::int64_t>(index) * 150;
+    std::vector<alpha::EventEnvelope> body;
+    for (int i = 0; index % 5 != 0 && i < 10; ++i) {
+      const std::string id = "evt-sync-" + std::to_string(index) + "-" + std::to_string(i);
+      body.push_back({
+          .event_id = id,
+          .kind = alpha::EventKind::RecipeCreated,
+          .author_cid = "cid-sync",
+          .unix_ts = block.opened_unix + i,
+          .payload = "title=" + id,
+          .signature = "sig-" + id,
+      });
+      block.event_ids.push_back(id);
+    }
+    block.prev_hash = chain.back().block_hash;
+    block.merkle_root = alpha::Store::block_merkle_root(body);
+    block.content_hash = alpha::Store::block_content_hash(body);
+    block.block_hash = alpha::Store::block_header_hash(block);
+    chain.push_back(std::move(block));
+    events.insert(events.end(), body.begin(), body.end());
+  }
+  assert(events.size() == 400);
+
+  std::array<alpha::P2PNode, 3> nodes;
+  std::array<std::vector<alpha::EventEnvelope>, 3> stores{events, events, {}};
+  for (std::size_t i = 3; i < stores[1].size(); i += 10) {
+    stores[1][i].payload = "title=forged";
+  }
+  for (auto& node : nodes) {
+    node.configure_initial_sync({.min_peer_events = 100, .blocks_per_range = 4});
+  }
+  start_loopback_nodes(nodes, stores, "cid-sync-", {{}, {}, {0, 1}});
+  const std::vector<alpha::Store::BlockRecord> fresh_chain(chain.begin(), chain.begin() + 1);
+  for (std::size_t i = 0; i < nodes.size(); ++i) {
+    const auto& served = i == 2 ? fresh_chain : chain;
+    nodes[i].set_chain_lookup([&served](std::uint64_t from, std::size_t max_count) {
+      const std::size_t begin = std::min<std::size_t>(from, served.size());
+      const std::size_t end = begin + std::min(max_count, served.size() - begin);
+      return std::vector<alpha::Store::BlockRecord>(served.begin() + static_cast<std::ptrdiff_t>(begin),
+                                                    served.begin() + static_cast<std::ptrdiff_t>(end));
+    });
+  }
+
+  std::vector<alpha::EventEnvelope> synced;
+  (void)pump_until(
+      nodes,
+      [&] {
+        for (auto& event : nodes[2].take_synced_events()) {
+          synced.push_back(std::move(event));
+        }
+        return synced.size() >= events.size();
+      },
+      600);
+
+  // Bodies arrive verified and in chain order, forged payload excluded.
+  assert(synced.size() == events.size());
+  for (std::size_t i = 0; i < events.size(); ++i) {
+    assert(synced[i].event_id == events[i].event_id);
+    assert(synced[i].payload == events[i].payload);
+  }
+  const alpha::InitialSyncStats stats = nodes[2].initial_sync_stats();
+  assert(!stats.active && stats.headers_complete);
+  assert(stats.headers == chain.size());
+  assert(stats.blocks_applied == chain.size());
+  assert(stats.body_mismatches >= 1);
+  assert(stats.peers_used == 2);
+  assert(nodes[0].runtime_status().events_served > 0);
+  assert(nodes[1].runtime_status().events_served > 0);
+  const auto received = nodes[2].take_received_events();
+  assert(received.empty());
+  // Seeded nodes never bootstrap: their own index is not empty.
+  assert(nodes[0].initial_sync_stats().headers == 0);
+#endif
+}
+
+void test_network_simulator_partition_and_convergence() {
+  // Four services on lossy virtual links. The process clock follows the
+  // simulation, so every duration below is virtual.
+  std::int64_t begin_ms = 0;
+  {
+    alpha::sim::Simulation simulation({
+        .nodes = 4,
+        .seeds_per_node = 2,
+        .seed = 7,
+        .link = {.latency_ms = 30, .jitter_ms = 5, .loss_rate = 0.05},
+        .data_dir = temp_dir("network-sim").string(),
+    });
+    const alpha::Result started = simulation.start();
+    assert(started.ok);
+    begin_ms = simulation.now_ms();
+    assert(alpha::util::unix_timestamp_now() == begin_ms / 1000);
+    simulation.run_for(2000);
+    for (std::size_t i = 0; i < simulation.size(); ++i) {
+      assert(simulation.node(i).node_status().p2p.connected_peers >= 1);
+    }
+
+    const alpha::Result published = simulation.publish(0, "Virtual Minestrone");
+    assert(published.ok);
+    const std::optional<std::int64_t> converged = simulation.run_until_converged(10000);
+    assert(converged.has_value());
+    const alpha::sim::PropagationReport report = simulation.report();
+    assert(report.events == 1);
+    assert(report.receipts == 3 && report.missing_receipts == 0);
+    // Inventory, GetData and Events each cross at least one 30 ms link.
+    assert(report.p50_ms >= 90 && report.max_ms <= *converged);
+    assert(report.bytes > 0 && report.frames > 0);
+    assert(report.timeline_mismatches == 0);
+
+    // Node 3 misses a post made while it is cut off and catches up after the
+    // partition heals.
+    const std::array<std::uint16_t, 1> cut{30003};
+    simulation.network().partition(cut);
+    const alpha::Result published_cut = simulation.publish(0, "Partitioned Borscht");
+    assert(published_cut.ok);
+    simulation.run_for(3000);
+    assert(simulation.node(3).search({.text = "partitioned borscht", .category = {}}).empty());
+    assert(!simulation.node(1).search({.text = "partitioned borscht", .category = {}}).empty());
+    assert(!simulation.converged());
+    assert(simulation.network().stats().links_cut > 0);
+
+    simulation.network().heal();
+    const std::optional<std::int64_t> healed = simulation.run_until_converged(60000);
+    assert(healed.has_value());
+    assert(!simulation.node(3).search({.text = "partitioned borscht", .category = {}}).empty());
+    assert(simulation.report().missing_receipts == 0);
+    // Gossiped events reached the store through the staged ingest pipeline.
+    const alpha::IngestPipelineStats ingest = simulation.node(3).ingest_pipeline_stats();
+    assert(ingest.drained > 0 && ingest.in_flight == 0);
+  }
+  // Dropping the simulation hands the clock back to the system.
+  assert(alpha::util::unix_timestamp_now() != begin_ms / 1000);
+}
+
 }  // namespace
 
 int main() {
@@ -881,10 +3215,33 @@ int main() {
   test_profile_identity_controls();
   test_wallet_lock_unlock_and_recovery();
   test_reward_claim_and_high_value_gating();
+  test_reward_schedule_matches_float_reference();
   test_genesis_merkle_and_transfer_flow();
   test_testnet_genesis_defaults_to_today();
   test_moderation_controls();
   test_downvote_purge_and_mining_template();
+  test_stratum_adapter_loopback_miner();
+  test_http_server_keep_alive_and_workers();
+  test_unix_socket_rpc_framing();
+  test_change_feed_and_event_streams();
+  test_response_cache_generations_and_lru();
+  test_json_document_parser();
+  test_json_writer_and_chunked_responses();
+  test_batch_signature_verification();
+  test_staged_ingest_pipeline();
+  test_maintenance_scheduler_timers_and_deferral();
+  test_metrics_histograms_and_exposition();
+  test_kdf_session_cache_and_async_unlock();
+  test_rolling_seen_filter();
+  test_peer_table_scoring_and_persistence();
+  test_outbound_ring_backpressure();
+  test_wire_frame_compression();
+  test_compact_block_relay();
+  test_socks5_proxied_transport();
+  test_p2p_loopback_inventory_gossip();
+  test_p2p_reconnect_set_reconciliation();
+  test_p2p_headers_first_initial_sync();
+  test_network_simulator_partition_and_convergence();
 
   std::cout << "got_soup_unit_tests passed\n";
   return 0;